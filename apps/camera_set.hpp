@@ -0,0 +1,393 @@
+// apps/real_world_overlay/camera_set.hpp
+// The cameras of the overlay, one per nvstreammux source (source_id = index in config.toml). The top-level keys
+// describe a single camera; a [[camera]] array describes several, every entry overriding the top-level keys:
+//   device, resolution = [w, h], position = [x, y, z], rotation = [x, y, z], fov = [x, y],
+//   focal = [x, y], principal_point = [x, y], distortion = [k1, k2, p1, p2, k3], lut_step,
+//   roi = [[x, y], ...] (ground polygon, metres), roi_margin
+// Object boxes arrive in nvstreammux pixels, so each camera maps them back to its own full-frame pixels (through its
+// crop, see roi_crop.hpp) before its model is applied. The gather and per-source dispatch are templated on the
+// DeepStream meta types (NvDsBatchMeta, NvDsFrameMeta, NvDsObjectMeta in the app) so they can be exercised with
+// stand-in structs.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <toml.hpp>
+
+#include "image_to_world.hpp"
+
+struct CameraGeometry {
+    std::string device = "video0";
+    int width = 1920, height = 1080;
+    float pos_x = 0.0f, pos_y = 0.0f, pos_z = 0.0f;
+    float rot_x = 0.0f, rot_y = 0.0f, rot_z = 0.0f;
+    float fov_x = 1.0f, fov_y = 1.0f;
+    float focal_x = 0.0f, focal_y = 0.0f;          // pixels, 0 = derived from fov and position.z
+    float principal_x = -1.0f, principal_y = -1.0f;  // pixels, < 0 = image centre
+    float distortion[5] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};  // k1, k2, p1, p2, k3
+    int lut_step = 4;
+    std::vector<std::pair<float, float>> roi;  // world ground polygon inference is limited to, empty = whole frame
+    int roi_margin = 32;                        // pixels around the projected roi
+    int crop_x = 0, crop_y = 0, crop_width = 0, crop_height = 0;  // pixels sent to nvstreammux, width 0 = whole frame
+};
+
+namespace camera_set_detail {
+
+enum : unsigned { kResolution = 1, kPosition = 2, kRotation = 4, kFov = 8, kRequired = 15 };
+
+inline bool readFloats(toml::node_view<const toml::node> node, const char *key, size_t size, float *out,
+                       std::string &error) {
+    auto array = node[key].as_array();
+    if (!array)
+        return false;
+    if (array->size() != size) {
+        error = std::string("Invalid ") + key + " size in config.toml";
+        return false;
+    }
+    for (size_t i = 0; i < size; ++i)
+        out[i] = static_cast<float>(array->at(i).value_or(0.0));
+    return true;
+}
+
+// Reads the camera keys present in `node` over `g`, adding the required ones found to `given`
+inline bool parseCameraKeys(toml::node_view<const toml::node> node, CameraGeometry &g, unsigned &given,
+                            std::string &error) {
+    g.device = node["device"].value_or(g.device);
+
+    float v[5];
+    if (readFloats(node, "resolution", 2, v, error)) {
+        g.width = static_cast<int>(v[0]);
+        g.height = static_cast<int>(v[1]);
+        if (g.width <= 0 || g.height <= 0) {
+            error = "Invalid resolution in config.toml";
+            return false;
+        }
+        given |= kResolution;
+    }
+    if (readFloats(node, "position", 3, v, error)) {
+        g.pos_x = v[0];
+        g.pos_y = v[1];
+        g.pos_z = v[2];
+        given |= kPosition;
+    }
+    if (readFloats(node, "rotation", 3, v, error)) {
+        g.rot_x = v[0];
+        g.rot_y = v[1];
+        g.rot_z = v[2];
+        given |= kRotation;
+    }
+    if (readFloats(node, "fov", 2, v, error)) {
+        g.fov_x = v[0];
+        g.fov_y = v[1];
+        given |= kFov;
+    }
+    if (readFloats(node, "focal", 2, v, error)) {
+        g.focal_x = v[0];
+        g.focal_y = v[1];
+    }
+    if (readFloats(node, "principal_point", 2, v, error)) {
+        g.principal_x = v[0];
+        g.principal_y = v[1];
+    }
+    if (readFloats(node, "distortion", 5, v, error)) {
+        for (int i = 0; i < 5; ++i)
+            g.distortion[i] = v[i];
+    }
+    if (!error.empty())
+        return false;
+
+    g.lut_step = node["lut_step"].value_or(g.lut_step);
+    if (g.lut_step < 1) {
+        error = "Invalid lut_step in config.toml";
+        return false;
+    }
+
+    if (auto roi = node["roi"]) {
+        auto array = roi.as_array();
+        g.roi.clear();
+        for (size_t i = 0; array && i < array->size(); ++i) {
+            auto point = array->at(i).as_array();
+            if (!point || point->size() != 2)
+                break;
+            g.roi.emplace_back(static_cast<float>(point->at(0).value_or(0.0)),
+                               static_cast<float>(point->at(1).value_or(0.0)));
+        }
+        if (!array || g.roi.size() != array->size() || g.roi.size() < 3) {
+            error = "Invalid roi in config.toml (at least 3 [x, y] points)";
+            return false;
+        }
+    }
+    g.roi_margin = node["roi_margin"].value_or(g.roi_margin);
+    if (g.roi_margin < 0) {
+        error = "Invalid roi_margin in config.toml";
+        return false;
+    }
+    return true;
+}
+
+inline std::string missingKeys(unsigned given) {
+    std::string out;
+    const char *names[] = {"resolution", "position", "rotation", "fov"};
+    for (unsigned i = 0; i < 4; ++i) {
+        if (!(given & (1u << i)))
+            out += std::string(out.empty() ? "'" : ", '") + names[i] + "'";
+    }
+    return out;
+}
+
+}  // namespace camera_set_detail
+
+// Fills `cameras` from the top-level keys and the optional [[camera]] array
+inline bool parseCameras(const toml::table &data, std::vector<CameraGeometry> &cameras, std::string &error) {
+    using namespace camera_set_detail;
+    cameras.clear();
+    error.clear();
+
+    CameraGeometry top;
+    unsigned top_given = 0;
+    if (!parseCameraKeys(toml::node_view<const toml::node>(data), top, top_given, error))
+        return false;
+
+    auto list = data["camera"];
+    if (!list) {
+        if ((top_given & kRequired) != kRequired) {
+            error = "Missing or invalid " + missingKeys(top_given) + " in config.toml";
+            return false;
+        }
+        cameras.push_back(top);
+        return true;
+    }
+
+    auto array = list.as_array();
+    if (!array || array->empty() || !array->is_array_of_tables()) {
+        error = "Invalid [[camera]] array in config.toml";
+        return false;
+    }
+    for (size_t i = 0; i < array->size(); ++i) {
+        CameraGeometry g = top;
+        unsigned given = top_given;
+        if (!parseCameraKeys(toml::node_view<const toml::node>(array->at(i)), g, given, error)) {
+            error = "camera " + std::to_string(i) + ": " + error;
+            return false;
+        }
+        if ((given & kRequired) != kRequired) {
+            error = "camera " + std::to_string(i) + ": missing " + missingKeys(given) + " in config.toml";
+            return false;
+        }
+        cameras.push_back(g);
+    }
+    return true;
+}
+
+// Copies the calibration keys (position, rotation, fov, focal, principal_point, distortion, lut_step) of `from` over
+// `to`, leaving what the pipeline was built from (device, resolution, roi and its crop) as it is
+inline void applyCalibration(const CameraGeometry &from, CameraGeometry &to) {
+    to.pos_x = from.pos_x;
+    to.pos_y = from.pos_y;
+    to.pos_z = from.pos_z;
+    to.rot_x = from.rot_x;
+    to.rot_y = from.rot_y;
+    to.rot_z = from.rot_z;
+    to.fov_x = from.fov_x;
+    to.fov_y = from.fov_y;
+    to.focal_x = from.focal_x;
+    to.focal_y = from.focal_y;
+    to.principal_x = from.principal_x;
+    to.principal_y = from.principal_y;
+    for (int i = 0; i < 5; ++i)
+        to.distortion[i] = from.distortion[i];
+    to.lut_step = from.lut_step;
+}
+
+// Pinhole model of a camera with position.z > 0 (the linear fov model is used otherwise)
+inline CameraModel makeCameraModel(const CameraGeometry &g) {
+    CameraModel model;
+    model.width = g.width;
+    model.height = g.height;
+    model.fx = g.focal_x > 0.0f ? g.focal_x : g.width * g.pos_z / g.fov_x;
+    model.fy = g.focal_y > 0.0f ? g.focal_y : g.height * g.pos_z / g.fov_y;
+    model.cx = g.principal_x >= 0.0f ? g.principal_x : g.width / 2.0;
+    model.cy = g.principal_y >= 0.0f ? g.principal_y : g.height / 2.0;
+    model.k1 = g.distortion[0];
+    model.k2 = g.distortion[1];
+    model.p1 = g.distortion[2];
+    model.p2 = g.distortion[3];
+    model.k3 = g.distortion[4];
+    rotationFromEuler(g.rot_x, g.rot_y, g.rot_z, model.r);
+    model.tx = g.pos_x;
+    model.ty = g.pos_y;
+    model.tz = g.pos_z;
+    return model;
+}
+
+// One camera ready for the probe: the pinhole LUT when position.z > 0, otherwise the linear fov model
+struct CameraView {
+    CameraGeometry geometry;
+    CameraModel model;
+    GroundLut lut;  // empty = linear fov model
+    LinearWorldParams linear;
+    float to_camera_x = 1.0f, to_camera_y = 1.0f;  // nvstreammux pixels -> camera pixels: scale, then the crop offset
+    float crop_x = 0.0f, crop_y = 0.0f;
+
+    // Returns true when the pinhole model is used
+    bool build(const CameraGeometry &g, int mux_width, int mux_height) {
+        geometry = g;
+        lut = GroundLut();
+        linear = makeLinearWorldParams(g.width, g.height, g.fov_x, g.fov_y, g.pos_x, g.pos_y);
+        bool cropped = g.crop_width > 0 && g.crop_height > 0;
+        int sent_width = cropped ? g.crop_width : g.width, sent_height = cropped ? g.crop_height : g.height;
+        to_camera_x = mux_width > 0 ? static_cast<float>(sent_width) / mux_width : 1.0f;
+        to_camera_y = mux_height > 0 ? static_cast<float>(sent_height) / mux_height : 1.0f;
+        crop_x = cropped ? static_cast<float>(g.crop_x) : 0.0f;
+        crop_y = cropped ? static_cast<float>(g.crop_y) : 0.0f;
+        if (g.pos_z <= 0.0f)
+            return false;
+
+        model = makeCameraModel(g);
+        if (!lut.build(model, g.lut_step))
+            lut = GroundLut();  // never sees the ground
+        return pinhole();
+    }
+
+    bool pinhole() const { return !lut.empty(); }
+
+    // An nvstreammux box in full-frame camera pixels
+    void boxToCamera(float &left, float &top, float &width, float &height) const {
+        left = left * to_camera_x + crop_x;
+        top = top * to_camera_y + crop_y;
+        width *= to_camera_x;
+        height *= to_camera_y;
+    }
+
+    // A full-frame camera box in nvstreammux pixels, the inverse of boxToCamera
+    void boxToMux(float &left, float &top, float &width, float &height) const {
+        left = (left - crop_x) / to_camera_x;
+        top = (top - crop_y) / to_camera_y;
+        width /= to_camera_x;
+        height /= to_camera_y;
+    }
+
+    // Box centres in nvstreammux pixels, converted to camera pixels in place; valid[i] = 0 above the horizon
+    void transform(float *px, float *py, float *wx, float *wy, uint8_t *valid, size_t n) const {
+        if (to_camera_x != 1.0f || to_camera_y != 1.0f || crop_x != 0.0f || crop_y != 0.0f) {
+            for (size_t i = 0; i < n; ++i) {
+                px[i] = px[i] * to_camera_x + crop_x;
+                py[i] = py[i] * to_camera_y + crop_y;
+            }
+        }
+        if (pinhole()) {
+            lut.lookupBatch(px, py, wx, wy, valid, n);
+        } else {
+            imageToWorldBatch(linear, px, py, wx, wy, n);
+            for (size_t i = 0; i < n; ++i)
+                valid[i] = 1;
+        }
+    }
+
+    // d(x, y) / d(u, v) at a camera pixel, in metres per nvstreammux pixel. False next to the horizon.
+    bool jacobian(float px, float py, float j[4]) const {
+        if (pinhole()) {
+            if (!lut.jacobian(px, py, j))
+                return false;
+        } else {
+            j[0] = linear.sx;
+            j[1] = 0.0f;
+            j[2] = 0.0f;
+            j[3] = linear.sy;
+        }
+        j[0] *= to_camera_x;
+        j[1] *= to_camera_y;
+        j[2] *= to_camera_x;
+        j[3] *= to_camera_y;
+        return true;
+    }
+};
+
+class CameraSet {
+public:
+    // `mux_width` x `mux_height` is the nvstreammux output the boxes are expressed in. Returns the pinhole camera count.
+    size_t build(const std::vector<CameraGeometry> &cameras, int mux_width, int mux_height) {
+        views_.clear();
+        views_.resize(cameras.size());
+        size_t pinhole = 0;
+        for (size_t i = 0; i < cameras.size(); ++i)
+            pinhole += views_[i].build(cameras[i], mux_width, mux_height);
+        return pinhole;
+    }
+
+    size_t size() const { return views_.size(); }
+    const CameraView &operator[](size_t i) const { return views_[i]; }
+
+    // nullptr for a source without a camera
+    const CameraView *forSource(uint32_t source_id) const {
+        return source_id < views_.size() ? &views_[source_id] : nullptr;
+    }
+
+private:
+    std::vector<CameraView> views_;
+};
+
+// Structure-of-arrays box centres of the objects of one batch, reused across buffers. Objects are gathered in frame
+// order, so each frame owns a contiguous range.
+template <typename FrameMeta, typename ObjectMeta>
+struct CentrePointBatch {
+    std::vector<ObjectMeta *> objs;
+    std::vector<FrameMeta *> frames;
+    std::vector<float> px, py, wx, wy;
+    std::vector<uint8_t> valid;
+
+    void clear() {
+        objs.clear();
+        frames.clear();
+        px.clear();
+        py.clear();
+    }
+
+    void resizeResults() {
+        wx.resize(objs.size());
+        wy.resize(objs.size());
+        valid.resize(objs.size());
+    }
+};
+
+// Centre of every object box of the batch; `on_frame(frame_meta)` is called once per frame
+template <typename BatchMeta, typename FrameMeta, typename ObjectMeta, typename OnFrame>
+void gatherCentrePoints(BatchMeta *batch_meta, CentrePointBatch<FrameMeta, ObjectMeta> &ob, OnFrame &&on_frame) {
+    ob.clear();
+    for (auto *l_frame = batch_meta->frame_meta_list; l_frame != nullptr; l_frame = l_frame->next) {
+        FrameMeta *frame_meta = static_cast<FrameMeta *>(l_frame->data);
+        on_frame(frame_meta);
+        for (auto *l_obj = frame_meta->obj_meta_list; l_obj != nullptr; l_obj = l_obj->next) {
+            ObjectMeta *obj_meta = static_cast<ObjectMeta *>(l_obj->data);
+            ob.objs.push_back(obj_meta);
+            ob.frames.push_back(frame_meta);
+            ob.px.push_back(obj_meta->rect_params.left + obj_meta->rect_params.width / 2.0f);
+            ob.py.push_back(obj_meta->rect_params.top + obj_meta->rect_params.height / 2.0f);
+        }
+    }
+}
+
+// Transforms each frame's range with the camera of its source_id, one batched call per frame. Objects of a source
+// without a camera are left invalid; returns their number.
+template <typename FrameMeta, typename ObjectMeta>
+size_t transformCentrePoints(const CameraSet &cameras, CentrePointBatch<FrameMeta, ObjectMeta> &ob) {
+    ob.resizeResults();
+    size_t n = ob.objs.size(), unknown = 0;
+    for (size_t begin = 0, end; begin < n; begin = end) {
+        end = begin + 1;
+        while (end < n && ob.frames[end] == ob.frames[begin])
+            ++end;
+        const CameraView *cam = cameras.forSource(ob.frames[begin]->source_id);
+        if (!cam) {
+            for (size_t i = begin; i < end; ++i)
+                ob.valid[i] = 0;
+            unknown += end - begin;
+            continue;
+        }
+        cam->transform(&ob.px[begin], &ob.py[begin], &ob.wx[begin], &ob.wy[begin], &ob.valid[begin], end - begin);
+    }
+    return unknown;
+}
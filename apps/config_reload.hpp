@@ -0,0 +1,222 @@
+// apps/real_world_overlay/config_reload.hpp
+// Hot reload support: an immutable snapshot published to the pad probes through an atomic pointer, and an inotify
+// watcher for config.toml.
+//
+// SnapshotPublisher<T> is epoch based. Every reader role (the osd probe, the offload worker) owns a slot and brackets
+// each use of the snapshot with enter()/leave(): enter stores the global epoch in the slot and loads the pointer, leave
+// stores 0 (quiescent). Both are plain atomic stores and loads, never a lock or a wait. publish() swaps the pointer,
+// advances the epoch and retires the old snapshot with that epoch; reclaim() frees a retired snapshot once every slot
+// is quiescent or has entered at that epoch or later, i.e. once no reader can still hold it. A reader stuck inside
+// enter/leave only delays reclamation. publish() and reclaim() serialise on a mutex, the readers never touch it.
+#pragma once
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class SnapshotPublisher {
+public:
+    static constexpr int kMaxReaders = 8;
+
+    SnapshotPublisher() = default;
+    SnapshotPublisher(const SnapshotPublisher &) = delete;
+    SnapshotPublisher &operator=(const SnapshotPublisher &) = delete;
+    ~SnapshotPublisher() {
+        delete current_.load(std::memory_order_relaxed);
+        for (auto &r : retired_)
+            delete r.first;
+    }
+
+    // A slot for one reader role, -1 when all are taken. A slot must not be used by two threads at once.
+    int registerReader() {
+        int id = readers_.fetch_add(1, std::memory_order_relaxed);
+        return id < kMaxReaders ? id : -1;
+    }
+
+    // Pins the current snapshot (nullptr before the first publish) until leave()
+    const T *enter(int reader) {
+        slots_[reader].epoch.store(epoch_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+        return current_.load(std::memory_order_seq_cst);
+    }
+
+    void leave(int reader) { slots_[reader].epoch.store(0, std::memory_order_release); }
+
+    // Setup and writer side, no pinning
+    const T *current() const { return current_.load(std::memory_order_acquire); }
+    uint64_t version() const { return epoch_.load(std::memory_order_acquire) - 1; }  // snapshots published so far
+
+    void publish(std::unique_ptr<const T> next) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const T *old = current_.exchange(next.release(), std::memory_order_seq_cst);
+        uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        if (old)
+            retired_.emplace_back(old, epoch);
+        reclaimLocked();
+    }
+
+    // Frees the retired snapshots no reader can hold any more; returns how many are still waiting
+    size_t reclaim() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reclaimLocked();
+        return retired_.size();
+    }
+
+    uint64_t reclaimed() const { return reclaimed_.load(std::memory_order_relaxed); }
+
+private:
+    void reclaimLocked() {
+        if (retired_.empty())
+            return;
+        // Oldest epoch a reader is still inside; readers that enter from now on see the current pointer
+        uint64_t oldest = UINT64_MAX;
+        int readers = std::min(readers_.load(std::memory_order_relaxed), kMaxReaders);
+        for (int i = 0; i < readers; ++i) {
+            uint64_t e = slots_[i].epoch.load(std::memory_order_seq_cst);
+            if (e != 0 && e < oldest)
+                oldest = e;
+        }
+        size_t kept = 0;
+        for (auto &r : retired_) {
+            if (oldest >= r.second) {
+                delete r.first;
+                reclaimed_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                retired_[kept++] = r;
+            }
+        }
+        retired_.resize(kept);
+    }
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{0};  // 0 = quiescent
+    };
+
+    std::atomic<const T *> current_{nullptr};
+    std::atomic<uint64_t> epoch_{1};
+    std::atomic<int> readers_{0};
+    Slot slots_[kMaxReaders];
+
+    std::mutex mutex_;
+    std::vector<std::pair<const T *, uint64_t>> retired_;  // snapshot, epoch it was retired at
+    std::atomic<uint64_t> reclaimed_{0};
+};
+
+// enter() in the constructor, leave() in the destructor
+template <typename T>
+class PinnedSnapshot {
+public:
+    PinnedSnapshot(SnapshotPublisher<T> &publisher, int reader)
+        : publisher_(publisher), reader_(reader), snapshot_(publisher.enter(reader)) {}
+    ~PinnedSnapshot() { publisher_.leave(reader_); }
+    PinnedSnapshot(const PinnedSnapshot &) = delete;
+    PinnedSnapshot &operator=(const PinnedSnapshot &) = delete;
+
+    const T &operator*() const { return *snapshot_; }
+    const T *operator->() const { return snapshot_; }
+    const T *get() const { return snapshot_; }
+
+private:
+    SnapshotPublisher<T> &publisher_;
+    int reader_;
+    const T *snapshot_;
+};
+
+// Watches one file through its directory, so editors that save by writing a temporary file and renaming it over the
+// original are seen too
+class ConfigWatcher {
+public:
+    enum Result { kChanged, kTimeout, kStopped, kError };
+
+    ConfigWatcher() = default;
+    ConfigWatcher(const ConfigWatcher &) = delete;
+    ConfigWatcher &operator=(const ConfigWatcher &) = delete;
+    ~ConfigWatcher() { close(); }
+
+    bool open(const std::string &path) {
+        close();
+        size_t slash = path.rfind('/');
+        std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+        name_ = slash == std::string::npos ? path : path.substr(slash + 1);
+        fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd_ < 0 || stop_fd_ < 0 ||
+            inotify_add_watch(fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (fd_ >= 0)
+            ::close(fd_);
+        if (stop_fd_ >= 0)
+            ::close(stop_fd_);
+        fd_ = stop_fd_ = -1;
+    }
+
+    // Waits up to `timeout_ms` for the file to change. A change is reported once the directory has been quiet for
+    // `settle_ms`, so a save that touches the file several times is one reload.
+    Result wait(int timeout_ms, int settle_ms = 200) {
+        if (fd_ < 0)
+            return kError;
+        bool changed = false;
+        int wait_ms = timeout_ms;
+        for (;;) {
+            pollfd fds[2] = {{fd_, POLLIN, 0}, {stop_fd_, POLLIN, 0}};
+            int n = poll(fds, 2, wait_ms);
+            if (n < 0)
+                return errno == EINTR ? kTimeout : kError;
+            if (fds[1].revents)
+                return kStopped;
+            if (n == 0)
+                return changed ? kChanged : kTimeout;
+            if (drain())
+                changed = true;
+            if (changed)
+                wait_ms = settle_ms;
+        }
+    }
+
+    // Wakes wait() from another thread
+    void stop() {
+        uint64_t one = 1;
+        if (stop_fd_ >= 0) {
+            ssize_t n = ::write(stop_fd_, &one, sizeof(one));
+            (void)n;  // the counter is already non-zero if this fails
+        }
+    }
+
+private:
+    // Reads the pending events; true when one names the watched file
+    bool drain() {
+        alignas(inotify_event) char buf[4096];
+        bool hit = false;
+        for (;;) {
+            ssize_t len = ::read(fd_, buf, sizeof(buf));
+            if (len <= 0)
+                return hit;
+            for (char *p = buf; p < buf + len;) {
+                const inotify_event *e = reinterpret_cast<const inotify_event *>(p);
+                if (e->len > 0 && name_ == e->name)
+                    hit = true;
+                p += sizeof(inotify_event) + e->len;
+            }
+        }
+    }
+
+    int fd_ = -1;
+    int stop_fd_ = -1;
+    std::string name_;
+};
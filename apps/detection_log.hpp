@@ -0,0 +1,482 @@
+// apps/real_world_overlay/detection_log.hpp
+// Append-only on-disk log of the published detections, for audits and replays. The pipeline hands records to
+// DetectionLogWriter::append(), which only pushes into a DropNewest SpscQueue; a background thread drains the queue in
+// batches and appends them to segment files, so a slow disk costs dropped (and counted) log records, never frames.
+//
+// A log is a directory of segments named by their creation time (CLOCK_REALTIME ns, 20 digits, so names sort by age):
+//   <created>.dlog  DetectionLogHeader, then DetectionRecord as published. Records are fixed size and stored raw, so a
+//                   mapped segment is read in place as an array; a torn tail record after a crash is ignored.
+//   <created>.didx  Sparse index: one DetectionLogIndexEntry for every `index_every`-th record, written after the
+//                   records it points at. Records past the last entry are still found, the last block just runs to the
+//                   end of the segment.
+// Records are appended in publish order, so publish_ns never decreases within a segment. Queries take wall-clock times;
+// each segment header stores CLOCK_REALTIME - CLOCK_MONOTONIC at creation to convert (a clock step while the segment
+// is open shifts its records by the step).
+#pragma once
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shm_ring.hpp"
+#include "spsc_queue.hpp"
+
+constexpr char DETECTION_LOG_MAGIC[8] = {'R', 'O', 'W', 'D', 'L', 'O', 'G', '1'};
+constexpr uint32_t DETECTION_LOG_VERSION = 1;  // bump on any header, index or DetectionRecord layout change
+
+struct DetectionLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t created_realtime_ns;
+    int64_t realtime_offset_ns;  // CLOCK_REALTIME - CLOCK_MONOTONIC when the segment was created
+    uint32_t index_every;
+    uint8_t reserved[28];
+};
+
+struct DetectionLogIndexEntry {
+    uint64_t publish_ns;
+    uint64_t record;  // record number in the segment
+};
+
+static_assert(sizeof(DetectionLogHeader) == sizeof(DetectionRecord), "records stay 64-byte aligned in the file");
+static_assert(sizeof(DetectionLogIndexEntry) == 16, "index layout changed, bump DETECTION_LOG_VERSION");
+
+struct DetectionLogConfig {
+    uint64_t segment_bytes = 64ull << 20;  // rotate once a segment reaches this size
+    double segment_seconds = 3600.0;       // ... or has been open this long, 0 = size only
+    uint32_t index_every = 256;            // records per sparse index entry
+    size_t queue_capacity = 65536;         // records buffered between the pipeline and the writer thread
+    size_t batch = 4096;                   // records per write() call at most
+};
+
+struct DetectionLogCounters {
+    uint64_t appended = 0;  // accepted by append()
+    uint64_t dropped = 0;   // rejected because the queue was full
+    uint64_t written = 0;   // on disk
+    uint64_t segments = 0;  // segments opened by this writer
+    uint64_t write_errors = 0;
+};
+
+inline uint64_t detectionLogRealtimeNs() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+inline bool detectionLogWriteAll(int fd, const void *data, size_t bytes) {
+    const char *p = static_cast<const char *>(data);
+    while (bytes > 0) {
+        ssize_t n = ::write(fd, p, bytes);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Segment base names (without extension) in `dir`, oldest first
+inline std::vector<std::string> detectionLogSegments(const std::string &dir) {
+    std::vector<std::string> names;
+    DIR *d = opendir(dir.c_str());
+    if (!d)
+        return names;
+    while (dirent *e = readdir(d)) {
+        std::string name = e->d_name;
+        if (name.size() == 25 && name.compare(20, 5, ".dlog") == 0 &&
+            name.find_first_not_of("0123456789") == 20)
+            names.push_back(name.substr(0, 20));
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+class DetectionLogWriter {
+public:
+    DetectionLogWriter() = default;
+    DetectionLogWriter(const DetectionLogWriter &) = delete;
+    DetectionLogWriter &operator=(const DetectionLogWriter &) = delete;
+    ~DetectionLogWriter() { close(); }
+
+    // Creates `dir` if needed and starts the writer thread; the first segment is opened with the first record
+    bool open(const std::string &dir, const DetectionLogConfig &cfg, std::string &error) {
+        close();
+        if (cfg.index_every == 0 || cfg.batch == 0 || cfg.queue_capacity == 0 ||
+            cfg.segment_bytes < sizeof(DetectionLogHeader) + sizeof(DetectionRecord)) {
+            error = "invalid detection log configuration";
+            return false;
+        }
+        if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+            error = dir + ": " + std::strerror(errno);
+            return false;
+        }
+        struct stat st;
+        if (::stat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+            error = dir + ": not a directory";
+            return false;
+        }
+        dir_ = dir;
+        cfg_ = cfg;
+        queue_.reset(new SpscQueue<DetectionRecord>(cfg.queue_capacity, QueuePolicy::DropNewest));
+        stop_.store(false, std::memory_order_relaxed);
+        thread_ = std::thread(&DetectionLogWriter::run, this);
+        return true;
+    }
+
+    bool isOpen() const { return queue_ != nullptr; }
+    const std::string &directory() const { return dir_; }
+
+    // Pipeline side, never blocks. Returns false when the record was dropped.
+    bool append(const DetectionRecord &rec) { return queue_->push(rec); }
+
+    // Drains the queue, closes the current segment and joins the writer thread
+    void close() {
+        if (!queue_)
+            return;
+        stop_.store(true, std::memory_order_release);
+        thread_.join();
+        queue_.reset();
+    }
+
+    DetectionLogCounters counters() const {
+        DetectionLogCounters c;
+        if (queue_) {
+            QueueCounters q = queue_->counters();
+            c.appended = q.pushed;
+            c.dropped = q.dropped_newest;
+        }
+        c.written = written_.load(std::memory_order_relaxed);
+        c.segments = segments_.load(std::memory_order_relaxed);
+        c.write_errors = write_errors_.load(std::memory_order_relaxed);
+        return c;
+    }
+
+private:
+    void run() {
+        std::vector<DetectionRecord> batch(cfg_.batch);
+        unsigned idle = 0;
+        for (;;) {
+            size_t n = queue_->pop(batch.data(), batch.size());
+            if (n == 0) {
+                if (stop_.load(std::memory_order_acquire) && queue_->size() == 0)
+                    break;
+                // Latency does not matter here: once spscBackoff is past spinning, poll every millisecond
+                if (idle < 1024)
+                    spscBackoff(idle++);
+                else
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            idle = 0;
+            writeBatch(batch.data(), n);
+        }
+        closeSegment();
+    }
+
+    void writeBatch(DetectionRecord *recs, size_t n) {
+        while (n > 0) {
+            if (fd_ >= 0 && dueForRotation())
+                closeSegment();
+            if (fd_ < 0 && !openSegment()) {
+                write_errors_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            uint64_t room = (cfg_.segment_bytes - sizeof(DetectionLogHeader)) / sizeof(DetectionRecord);
+            size_t take = static_cast<size_t>(std::min<uint64_t>(n, room > records_ ? room - records_ : 1));
+
+            index_.clear();
+            for (size_t i = 0; i < take; ++i) {
+                // Keeps the segment sorted for the binary searches even if a producer's clock ran backwards
+                uint64_t record = records_ + i;
+                recs[i].publish_ns = std::max(recs[i].publish_ns, last_publish_ns_);
+                last_publish_ns_ = recs[i].publish_ns;
+                if (record % cfg_.index_every == 0)
+                    index_.push_back(DetectionLogIndexEntry{recs[i].publish_ns, record});
+            }
+            // Index entries only ever point at records already written
+            if (!detectionLogWriteAll(fd_, recs, take * sizeof(DetectionRecord)) ||
+                (!index_.empty() &&
+                 !detectionLogWriteAll(index_fd_, index_.data(), index_.size() * sizeof(DetectionLogIndexEntry)))) {
+                write_errors_.fetch_add(1, std::memory_order_relaxed);
+                closeSegment();
+                return;
+            }
+            records_ += take;
+            written_.fetch_add(take, std::memory_order_relaxed);
+            recs += take;
+            n -= take;
+        }
+    }
+
+    bool dueForRotation() const {
+        if (sizeof(DetectionLogHeader) + (records_ + 1) * sizeof(DetectionRecord) > cfg_.segment_bytes)
+            return true;
+        return cfg_.segment_seconds > 0.0 &&
+               static_cast<double>(shmRingNowNs() - opened_ns_) >= cfg_.segment_seconds * 1e9;
+    }
+
+    bool openSegment() {
+        DetectionLogHeader h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, DETECTION_LOG_MAGIC, sizeof(h.magic));
+        h.version = DETECTION_LOG_VERSION;
+        h.record_size = sizeof(DetectionRecord);
+        uint64_t mono = shmRingNowNs();
+        h.created_realtime_ns = detectionLogRealtimeNs();
+        h.realtime_offset_ns = static_cast<int64_t>(h.created_realtime_ns - mono);
+        h.index_every = cfg_.index_every;
+
+        // Names must be unique and increasing even when two segments open within the same nanosecond tick
+        uint64_t stamp = std::max(h.created_realtime_ns, last_stamp_ + 1);
+        char name[32];
+        std::snprintf(name, sizeof(name), "%020llu", static_cast<unsigned long long>(stamp));
+        std::string base = dir_ + "/" + name;
+
+        fd_ = ::open((base + ".dlog").c_str(), O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC, 0644);
+        if (fd_ < 0)
+            return false;
+        index_fd_ = ::open((base + ".didx").c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, 0644);
+        if (index_fd_ < 0 || !detectionLogWriteAll(fd_, &h, sizeof(h))) {
+            closeSegment();
+            return false;
+        }
+        last_stamp_ = stamp;
+        opened_ns_ = mono;
+        records_ = 0;
+        last_publish_ns_ = 0;
+        segments_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void closeSegment() {
+        if (fd_ >= 0) {
+            ::fdatasync(fd_);
+            ::close(fd_);
+            fd_ = -1;
+        }
+        if (index_fd_ >= 0) {
+            ::close(index_fd_);
+            index_fd_ = -1;
+        }
+    }
+
+    std::string dir_;
+    DetectionLogConfig cfg_;
+    std::unique_ptr<SpscQueue<DetectionRecord>> queue_;
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+
+    // Writer thread only
+    int fd_ = -1;
+    int index_fd_ = -1;
+    uint64_t records_ = 0;
+    uint64_t opened_ns_ = 0;
+    uint64_t last_publish_ns_ = 0;
+    uint64_t last_stamp_ = 0;
+    std::vector<DetectionLogIndexEntry> index_;
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> segments_{0};
+    std::atomic<uint64_t> write_errors_{0};
+};
+
+// One mapped segment and its index. Safe to open while the writer appends: the mapping covers what was on disk at
+// open() time.
+class DetectionLogSegment {
+public:
+    DetectionLogSegment() = default;
+    DetectionLogSegment(const DetectionLogSegment &) = delete;
+    DetectionLogSegment &operator=(const DetectionLogSegment &) = delete;
+    DetectionLogSegment(DetectionLogSegment &&o) noexcept { *this = std::move(o); }
+    DetectionLogSegment &operator=(DetectionLogSegment &&o) noexcept {
+        if (this != &o) {
+            close();
+            std::swap(data_, o.data_);
+            std::swap(bytes_, o.bytes_);
+            std::swap(index_data_, o.index_data_);
+            std::swap(index_bytes_, o.index_bytes_);
+            std::swap(records_, o.records_);
+            std::swap(count_, o.count_);
+            std::swap(index_, o.index_);
+            std::swap(index_count_, o.index_count_);
+            std::swap(header_, o.header_);
+        }
+        return *this;
+    }
+    ~DetectionLogSegment() { close(); }
+
+    // `base` is the path without extension
+    bool open(const std::string &base, std::string &error) {
+        close();
+        if (!mapFile(base + ".dlog", data_, bytes_, error))
+            return false;
+        if (bytes_ < sizeof(DetectionLogHeader)) {
+            error = base + ".dlog: truncated header";
+            close();
+            return false;
+        }
+        header_ = static_cast<const DetectionLogHeader *>(data_);
+        if (std::memcmp(header_->magic, DETECTION_LOG_MAGIC, sizeof(header_->magic)) != 0 ||
+            header_->version != DETECTION_LOG_VERSION || header_->record_size != sizeof(DetectionRecord) ||
+            header_->index_every == 0) {
+            error = base + ".dlog: not a version " + std::to_string(DETECTION_LOG_VERSION) + " detection log segment";
+            close();
+            return false;
+        }
+        records_ = reinterpret_cast<const DetectionRecord *>(static_cast<const char *>(data_) + sizeof(*header_));
+        count_ = (bytes_ - sizeof(*header_)) / sizeof(DetectionRecord);
+
+        // A missing index only costs speed: lowerBound() then searches the records themselves
+        std::string index_error;
+        if (mapFile(base + ".didx", index_data_, index_bytes_, index_error)) {
+            index_ = static_cast<const DetectionLogIndexEntry *>(index_data_);
+            index_count_ = index_bytes_ / sizeof(DetectionLogIndexEntry);
+            while (index_count_ > 0 && index_[index_count_ - 1].record >= count_)
+                --index_count_;
+        }
+        return true;
+    }
+
+    void close() {
+        if (data_)
+            ::munmap(data_, bytes_);
+        if (index_data_)
+            ::munmap(index_data_, index_bytes_);
+        data_ = index_data_ = nullptr;
+        bytes_ = index_bytes_ = 0;
+        header_ = nullptr;
+        records_ = nullptr;
+        index_ = nullptr;
+        count_ = index_count_ = 0;
+    }
+
+    const DetectionLogHeader &header() const { return *header_; }
+    const DetectionRecord *records() const { return records_; }
+    size_t size() const { return count_; }
+    size_t indexSize() const { return index_count_; }
+
+    int64_t offsetNs() const { return header_->realtime_offset_ns; }
+    uint64_t toWallNs(uint64_t publish_ns) const { return publish_ns + static_cast<uint64_t>(offsetNs()); }
+    // Wall time to this segment's publish_ns clock, clamped to its range
+    uint64_t toPublishNs(uint64_t wall_ns) const {
+        int64_t t = static_cast<int64_t>(wall_ns) - offsetNs();
+        return t < 0 ? 0 : static_cast<uint64_t>(t);
+    }
+
+    // First record with publish_ns >= t: binary search over the sparse index, then within one index block
+    size_t lowerBound(uint64_t t) const {
+        size_t lo = 0, hi = count_;
+        if (index_count_ > 0) {
+            const DetectionLogIndexEntry *end = index_ + index_count_;
+            const DetectionLogIndexEntry *it = std::lower_bound(
+                index_, end, t, [](const DetectionLogIndexEntry &e, uint64_t v) { return e.publish_ns < v; });
+            if (it != end)
+                hi = static_cast<size_t>(it->record);
+            if (it != index_)
+                lo = static_cast<size_t>((it - 1)->record);
+        }
+        const DetectionRecord *it = std::lower_bound(
+            records_ + lo, records_ + hi, t, [](const DetectionRecord &r, uint64_t v) { return r.publish_ns < v; });
+        return static_cast<size_t>(it - records_);
+    }
+
+private:
+    static bool mapFile(const std::string &path, void *&data, size_t &bytes, std::string &error) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            error = path + ": " + std::strerror(errno);
+            return false;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            error = path + ": " + std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        bytes = static_cast<size_t>(st.st_size);
+        data = nullptr;
+        if (bytes > 0) {
+            void *p = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED) {
+                error = path + ": " + std::strerror(errno);
+                ::close(fd);
+                bytes = 0;
+                return false;
+            }
+            ::madvise(p, bytes, MADV_RANDOM);
+            data = p;
+        }
+        ::close(fd);
+        return true;
+    }
+
+    void *data_ = nullptr;
+    size_t bytes_ = 0;
+    void *index_data_ = nullptr;
+    size_t index_bytes_ = 0;
+    const DetectionLogHeader *header_ = nullptr;
+    const DetectionRecord *records_ = nullptr;
+    size_t count_ = 0;
+    const DetectionLogIndexEntry *index_ = nullptr;
+    size_t index_count_ = 0;
+};
+
+// All segments of a log directory, mapped at open() time
+class DetectionLogReader {
+public:
+    bool open(const std::string &dir, std::string &error) {
+        segments_.clear();
+        for (const std::string &name : detectionLogSegments(dir)) {
+            DetectionLogSegment seg;
+            if (!seg.open(dir + "/" + name, error))
+                return false;
+            if (seg.size() > 0)
+                segments_.push_back(std::move(seg));
+        }
+        return true;
+    }
+
+    const std::vector<DetectionLogSegment> &segments() const { return segments_; }
+
+    // Calls fn(segment, first, count) for each run of records with from_ns <= wall time < to_ns, oldest segment
+    // first. The records are the mapped file itself, valid while the reader is open. Returns the number of records.
+    template <typename Fn>
+    size_t query(uint64_t from_ns, uint64_t to_ns, Fn &&fn) const {
+        size_t total = 0;
+        for (const DetectionLogSegment &seg : segments_) {
+            const DetectionRecord *recs = seg.records();
+            if (from_ns >= to_ns || seg.toWallNs(recs[seg.size() - 1].publish_ns) < from_ns ||
+                seg.toWallNs(recs[0].publish_ns) >= to_ns)
+                continue;
+            size_t begin = seg.lowerBound(seg.toPublishNs(from_ns));
+            size_t end = seg.lowerBound(seg.toPublishNs(to_ns));
+            if (end > begin) {
+                fn(seg, recs + begin, end - begin);
+                total += end - begin;
+            }
+        }
+        return total;
+    }
+
+private:
+    std::vector<DetectionLogSegment> segments_;
+};
@@ -0,0 +1,152 @@
+// apps/real_world_overlay/frame_processor.hpp
+// The per-batch work of the osd probe without GStreamer: box centres gathered and transformed to world coordinates,
+// one DetectionRecord per detection for the exports, and the X/Y labels. Templated on the meta types like the gather
+// in camera_set.hpp: NvDsBatchMeta, NvDsFrameMeta and NvDsObjectMeta in the app, or any structs with the same fields
+// (frame_meta_list / obj_meta_list lists of data and next, source_id, frame_num, buf_pts, rect_params, class_id,
+// confidence, object_id, text_params.display_text), which is how tools/probe_harness.cpp times it on synthetic or
+// replayed frames. What needs DeepStream itself (user meta, label buffers owned by the buffer meta) stays in main.cpp.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "camera_set.hpp"
+#include "overlay_policy.hpp"
+#include "shm_ring.hpp"
+
+template <typename FrameMeta, typename ObjectMeta>
+class FrameProcessor {
+public:
+    using Batch = CentrePointBatch<FrameMeta, ObjectMeta>;
+
+    struct LabelStats {
+        size_t drawn = 0;   // labels handed out
+        size_t reused = 0;  // of which copied from the label_every cache
+    };
+
+    // X/Y labels when `text_overlay` is set in full overlay mode; label_every applies when `cache_labels` is set
+    void configure(bool text_overlay, const OverlayConfig &overlay, bool cache_labels) {
+        labels_ = text_overlay && overlay.mode == OverlayMode::Full;
+        selector_.configure(overlay);
+        cache_.setInterval(cache_labels ? overlay.label_every : 1);
+    }
+
+    bool labels() const { return labels_; }
+    const LabelCache &labelCache() const { return cache_; }
+    Batch &batch() { return batch_; }
+    const Batch &batch() const { return batch_; }
+
+    // Gathers the objects of the batch and transforms each frame with the camera of its source; `on_frame(frame_meta)`
+    // is called once per frame. Returns the object count.
+    template <typename BatchMeta, typename OnFrame>
+    size_t transform(BatchMeta *batch_meta, const CameraSet &cameras, OnFrame &&on_frame) {
+        gatherCentrePoints(batch_meta, batch_, on_frame);
+        transformCentrePoints(cameras, batch_);
+        return batch_.objs.size();
+    }
+
+    // Hands `out(const DetectionRecord &)` one record per detection with world coordinates, or a single count = 0
+    // record for a frame without any. Frames of sources >= `camera_count` are tiles, merged onto their camera's frame
+    // before, and skipped. Boxes are mapped back to full-frame camera pixels.
+    template <typename BatchMeta, typename Out>
+    void exportDetections(BatchMeta *batch_meta, const CameraSet &cameras, size_t camera_count, uint64_t now_ns,
+                          Out &&out) const {
+        const Batch &ob = batch_;
+        size_t k = 0;
+        for (auto *l_frame = batch_meta->frame_meta_list; l_frame != nullptr; l_frame = l_frame->next) {
+            const FrameMeta *frame_meta = static_cast<const FrameMeta *>(l_frame->data);
+            size_t begin = k;
+            uint16_t count = 0;
+            while (k < ob.objs.size() && ob.frames[k] == frame_meta) {
+                count += ob.valid[k];
+                ++k;
+            }
+            if (frame_meta->source_id >= camera_count)
+                continue;
+
+            DetectionRecord rec = {};
+            rec.timestamp_ns = frame_meta->buf_pts;
+            rec.publish_ns = now_ns;
+            rec.frame_number = static_cast<uint64_t>(frame_meta->frame_num);
+            rec.source_id = frame_meta->source_id;
+            rec.count = count;
+            if (count == 0) {
+                rec.class_id = -1;
+                out(rec);
+                continue;
+            }
+
+            const CameraView *cam = cameras.forSource(frame_meta->source_id);
+            uint16_t index = 0;
+            for (size_t i = begin; i < k; ++i) {
+                if (!ob.valid[i])
+                    continue;
+                const ObjectMeta *obj_meta = ob.objs[i];
+                rec.index = index++;
+                rec.class_id = obj_meta->class_id;
+                rec.confidence = obj_meta->confidence;
+                rec.world_x = ob.wx[i];
+                rec.world_y = ob.wy[i];
+                rec.left = obj_meta->rect_params.left;
+                rec.top = obj_meta->rect_params.top;
+                rec.width = obj_meta->rect_params.width;
+                rec.height = obj_meta->rect_params.height;
+                if (cam)
+                    cam->boxToCamera(rec.left, rec.top, rec.width, rec.height);
+                out(rec);
+            }
+        }
+    }
+
+    // Labels the transformed batch: every labeled object gets a buffer of LabelCache::kLabelSize bytes from
+    // `acquire()`, filled with its X/Y label and handed over with `set_text(obj_meta, label)`. Objects left out by
+    // label_top_k / label_classes get `set_text(obj_meta, nullptr)`; objects without world coordinates are not touched
+    // otherwise. Does nothing when labels are off.
+    template <typename Acquire, typename SetText>
+    LabelStats label(Acquire &&acquire, SetText &&set_text) {
+        LabelStats stats;
+        if (!labels_)
+            return stats;
+        const Batch &ob = batch_;
+        size_t n = ob.objs.size();
+        bool selected_only = !selector_.selectsAll();
+        if (selected_only)
+            select();
+
+        for (size_t i = 0; i < n; ++i) {
+            if (selected_only && !selected_[i]) {
+                set_text(ob.objs[i], static_cast<char *>(nullptr));
+                continue;
+            }
+            if (!ob.valid[i])
+                continue;  // above the horizon, or a source without a camera
+            char *label = acquire();
+            if (!cache_.label(ob.objs[i]->object_id, static_cast<uint64_t>(ob.frames[i]->frame_num), ob.wx[i],
+                              ob.wy[i], label))
+                ++stats.reused;
+            ++stats.drawn;
+            set_text(ob.objs[i], label);
+        }
+        cache_.nextBatch();
+        return stats;
+    }
+
+private:
+    // selected_[i] for the objects of the batch that get a label, frame by frame
+    void select() {
+        const Batch &ob = batch_;
+        size_t n = ob.objs.size();
+        selected_.resize(n);
+        for (size_t begin = 0, end; begin < n; begin = end) {
+            end = begin + 1;
+            while (end < n && ob.frames[end] == ob.frames[begin])
+                ++end;
+            selector_.select(&ob.objs[begin], &ob.valid[begin], end - begin, &selected_[begin]);
+        }
+    }
+
+    Batch batch_;
+    bool labels_ = false;
+    LabelSelector selector_;
+    LabelCache cache_;
+    std::vector<uint8_t> selected_;
+};
@@ -1,6 +1,19 @@
 // apps/real_world_overlay/image_to_world.hpp
 #pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define IMAGE_TO_WORLD_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define IMAGE_TO_WORLD_NEON 1
+#endif
 
 inline std::pair<float, float> imageToWorld(float px, float py,
                                             int img_width, int img_height,
@@ -17,3 +30,331 @@ inline std::pair<float, float> imageToWorld(float px, float py,
 
     return {world_x, world_y};
 }
+
+// Per-camera constants of imageToWorld, computed once: world = pixel * scale + offset
+struct LinearWorldParams {
+    float sx = 1.0f, sy = 1.0f;
+    float ox = 0.0f, oy = 0.0f;
+};
+
+inline LinearWorldParams makeLinearWorldParams(int img_width, int img_height, float fov_x_m, float fov_y_m,
+                                               float cam_x_m, float cam_y_m) {
+    LinearWorldParams p;
+    p.sx = fov_x_m / img_width;
+    p.sy = fov_y_m / img_height;
+    p.ox = cam_x_m - 0.5f * fov_x_m;
+    p.oy = cam_y_m - 0.5f * fov_y_m;
+    return p;
+}
+
+namespace image_to_world_detail {
+
+inline void linearBatchScalar(const LinearWorldParams &p, const float *px, const float *py, float *wx, float *wy,
+                              size_t begin, size_t n) {
+    for (size_t i = begin; i < n; ++i) {
+        wx[i] = px[i] * p.sx + p.ox;
+        wy[i] = py[i] * p.sy + p.oy;
+    }
+}
+
+#if IMAGE_TO_WORLD_X86
+__attribute__((target("avx2,fma"))) inline size_t linearBatchAvx2(const LinearWorldParams &p, const float *px,
+                                                                  const float *py, float *wx, float *wy, size_t n) {
+    const __m256 sx = _mm256_set1_ps(p.sx), sy = _mm256_set1_ps(p.sy);
+    const __m256 ox = _mm256_set1_ps(p.ox), oy = _mm256_set1_ps(p.oy);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(wx + i, _mm256_fmadd_ps(_mm256_loadu_ps(px + i), sx, ox));
+        _mm256_storeu_ps(wy + i, _mm256_fmadd_ps(_mm256_loadu_ps(py + i), sy, oy));
+    }
+    return i;
+}
+
+inline bool cpuHasAvx2() {
+    static const bool has = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return has;
+}
+#elif IMAGE_TO_WORLD_NEON
+inline size_t linearBatchNeon(const LinearWorldParams &p, const float *px, const float *py, float *wx, float *wy,
+                              size_t n) {
+    const float32x4_t sx = vdupq_n_f32(p.sx), sy = vdupq_n_f32(p.sy);
+    const float32x4_t ox = vdupq_n_f32(p.ox), oy = vdupq_n_f32(p.oy);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(wx + i, vmlaq_f32(ox, vld1q_f32(px + i), sx));
+        vst1q_f32(wy + i, vmlaq_f32(oy, vld1q_f32(py + i), sy));
+    }
+    return i;
+}
+#endif
+
+} // namespace image_to_world_detail
+
+// imageToWorld over structure-of-arrays pixel coordinates (one frame or batch of objects)
+inline void imageToWorldBatch(const LinearWorldParams &p, const float *px, const float *py, float *wx, float *wy,
+                              size_t n) {
+    size_t done = 0;
+#if IMAGE_TO_WORLD_X86
+    if (image_to_world_detail::cpuHasAvx2())
+        done = image_to_world_detail::linearBatchAvx2(p, px, py, wx, wy, n);
+#elif IMAGE_TO_WORLD_NEON
+    done = image_to_world_detail::linearBatchNeon(p, px, py, wx, wy, n);
+#endif
+    image_to_world_detail::linearBatchScalar(p, px, py, wx, wy, done, n);
+}
+
+inline const char *imageToWorldSimdName() {
+#if IMAGE_TO_WORLD_X86
+    return image_to_world_detail::cpuHasAvx2() ? "avx2" : "scalar";
+#elif IMAGE_TO_WORLD_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+// Pinhole camera with Brown-Conrady distortion (k1, k2, p1, p2, k3). The camera frame is the OpenCV one (x right,
+// y down, z forward). The rotation is camera-to-world, built from extrinsic X, Y, Z Euler angles in degrees with the
+// world Z axis up, and the translation is the camera position in the world (position.z = height above the ground).
+struct CameraModel {
+    int width = 0, height = 0;
+    double fx = 1.0, fy = 1.0, cx = 0.0, cy = 0.0;
+    double k1 = 0.0, k2 = 0.0, p1 = 0.0, p2 = 0.0, k3 = 0.0;
+    double r[9] = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
+    double tx = 0.0, ty = 0.0, tz = 0.0;
+};
+
+inline void rotationFromEuler(double rx_deg, double ry_deg, double rz_deg, double r[9]) {
+    const double d2r = M_PI / 180.0;
+    double cx = std::cos(rx_deg * d2r), sx = std::sin(rx_deg * d2r);
+    double cy = std::cos(ry_deg * d2r), sy = std::sin(ry_deg * d2r);
+    double cz = std::cos(rz_deg * d2r), sz = std::sin(rz_deg * d2r);
+
+    // R = Rz * Ry * Rx
+    r[0] = cz * cy; r[1] = cz * sy * sx - sz * cx; r[2] = cz * sy * cx + sz * sx;
+    r[3] = sz * cy; r[4] = sz * sy * sx + cz * cx; r[5] = sz * sy * cx - cz * sx;
+    r[6] = -sy;     r[7] = cy * sx;                r[8] = cy * cx;
+}
+
+inline void undistortPoint(const CameraModel &cam, double u, double v, double &xn, double &yn) {
+    double x0 = (u - cam.cx) / cam.fx;
+    double y0 = (v - cam.cy) / cam.fy;
+    double x = x0, y = y0;
+
+    if (cam.k1 != 0.0 || cam.k2 != 0.0 || cam.p1 != 0.0 || cam.p2 != 0.0 || cam.k3 != 0.0) {
+        for (int i = 0; i < 10; ++i) {
+            double r2 = x * x + y * y;
+            double icdist = 1.0 / (1.0 + ((cam.k3 * r2 + cam.k2) * r2 + cam.k1) * r2);
+            double dx = 2.0 * cam.p1 * x * y + cam.p2 * (r2 + 2.0 * x * x);
+            double dy = cam.p1 * (r2 + 2.0 * y * y) + 2.0 * cam.p2 * x * y;
+            x = (x0 - dx) * icdist;
+            y = (y0 - dy) * icdist;
+        }
+    }
+
+    xn = x;
+    yn = y;
+}
+
+// Intersects the pixel ray with the ground plane (world z = ground_z). Returns false above the horizon.
+inline bool pixelToGround(const CameraModel &cam, double u, double v, double ground_z, double &wx, double &wy) {
+    double xn, yn;
+    undistortPoint(cam, u, v, xn, yn);
+
+    double dx = cam.r[0] * xn + cam.r[1] * yn + cam.r[2];
+    double dy = cam.r[3] * xn + cam.r[4] * yn + cam.r[5];
+    double dz = cam.r[6] * xn + cam.r[7] * yn + cam.r[8];
+
+    if (dz > -1e-9) {
+        return false;
+    }
+
+    double t = (ground_z - cam.tz) / dz;
+    if (t <= 0.0) {
+        return false;
+    }
+
+    wx = cam.tx + t * dx;
+    wy = cam.ty + t * dy;
+    return true;
+}
+
+// Undistorted normalized image coordinates to the distorted pixel, the inverse of undistortPoint
+inline void normalizedToPixel(const CameraModel &cam, double x, double y, double &u, double &v) {
+    double r2 = x * x + y * y;
+    double radial = 1.0 + ((cam.k3 * r2 + cam.k2) * r2 + cam.k1) * r2;
+    double xd = x * radial + 2.0 * cam.p1 * x * y + cam.p2 * (r2 + 2.0 * x * x);
+    double yd = y * radial + cam.p1 * (r2 + 2.0 * y * y) + 2.0 * cam.p2 * x * y;
+
+    u = cam.fx * xd + cam.cx;
+    v = cam.fy * yd + cam.cy;
+}
+
+// Projects a world point to the (distorted) pixel. Returns false behind the camera.
+inline bool worldToPixel(const CameraModel &cam, double wx, double wy, double wz, double &u, double &v) {
+    double px = wx - cam.tx, py = wy - cam.ty, pz = wz - cam.tz;
+
+    // camera = R^T * (world - t)
+    double xc = cam.r[0] * px + cam.r[3] * py + cam.r[6] * pz;
+    double yc = cam.r[1] * px + cam.r[4] * py + cam.r[7] * pz;
+    double zc = cam.r[2] * px + cam.r[5] * py + cam.r[8] * pz;
+
+    if (zc <= 1e-9) {
+        return false;
+    }
+
+    normalizedToPixel(cam, xc / zc, yc / zc, u, v);
+    return true;
+}
+
+// Pixel-to-ground table built once at startup. Nodes every `step` pixels hold the interleaved ground (x, y), lookups
+// interpolate bilinearly between the 4 surrounding nodes. Nodes above the horizon are NaN.
+class GroundLut {
+public:
+    bool build(const CameraModel &cam, int step, double ground_z = 0.0) {
+        if (step < 1 || cam.width <= 0 || cam.height <= 0) {
+            return false;
+        }
+
+        step_ = step;
+        inv_step_ = 1.0f / step;
+        cols_ = (cam.width + step - 1) / step + 1;
+        rows_ = (cam.height + step - 1) / step + 1;
+        xy_.assign(static_cast<size_t>(cols_) * rows_ * 2, std::numeric_limits<float>::quiet_NaN());
+
+        size_t valid = 0;
+        for (int j = 0; j < rows_; ++j) {
+            for (int i = 0; i < cols_; ++i) {
+                double wx, wy;
+                if (pixelToGround(cam, static_cast<double>(i) * step, static_cast<double>(j) * step, ground_z, wx, wy)) {
+                    float *node = &xy_[(static_cast<size_t>(j) * cols_ + i) * 2];
+                    node[0] = static_cast<float>(wx);
+                    node[1] = static_cast<float>(wy);
+                    ++valid;
+                }
+            }
+        }
+
+        return valid > 0;
+    }
+
+    bool lookup(float px, float py, float &wx, float &wy) const {
+        float gx = px * inv_step_;
+        float gy = py * inv_step_;
+        int i = static_cast<int>(gx);
+        int j = static_cast<int>(gy);
+        i = i < 0 ? 0 : (i > cols_ - 2 ? cols_ - 2 : i);
+        j = j < 0 ? 0 : (j > rows_ - 2 ? rows_ - 2 : j);
+        float fx = gx - i;
+        float fy = gy - j;
+
+        const float *n00 = &xy_[(static_cast<size_t>(j) * cols_ + i) * 2];
+        const float *n10 = n00 + 2;
+        const float *n01 = n00 + static_cast<size_t>(cols_) * 2;
+        const float *n11 = n01 + 2;
+
+        float w00 = (1.0f - fx) * (1.0f - fy), w10 = fx * (1.0f - fy);
+        float w01 = (1.0f - fx) * fy, w11 = fx * fy;
+
+        wx = w00 * n00[0] + w10 * n10[0] + w01 * n01[0] + w11 * n11[0];
+        wy = w00 * n00[1] + w10 * n10[1] + w01 * n01[1] + w11 * n11[1];
+        return !std::isnan(wx) && !std::isnan(wy);
+    }
+
+    // Derivative of the interpolated mapping, j = d(x, y) / d(u, v) row-major, in metres per pixel
+    bool jacobian(float px, float py, float j[4]) const {
+        float gx = px * inv_step_;
+        float gy = py * inv_step_;
+        int i = static_cast<int>(gx);
+        int jj = static_cast<int>(gy);
+        i = i < 0 ? 0 : (i > cols_ - 2 ? cols_ - 2 : i);
+        jj = jj < 0 ? 0 : (jj > rows_ - 2 ? rows_ - 2 : jj);
+        float fx = gx - i;
+        float fy = gy - jj;
+
+        const float *n00 = &xy_[(static_cast<size_t>(jj) * cols_ + i) * 2];
+        const float *n10 = n00 + 2;
+        const float *n01 = n00 + static_cast<size_t>(cols_) * 2;
+        const float *n11 = n01 + 2;
+
+        for (int c = 0; c < 2; ++c) {
+            j[c * 2 + 0] = ((1.0f - fy) * (n10[c] - n00[c]) + fy * (n11[c] - n01[c])) * inv_step_;
+            j[c * 2 + 1] = ((1.0f - fx) * (n01[c] - n00[c]) + fx * (n11[c] - n10[c])) * inv_step_;
+        }
+        return !std::isnan(j[0]) && !std::isnan(j[1]) && !std::isnan(j[2]) && !std::isnan(j[3]);
+    }
+
+    // lookup() over structure-of-arrays pixel coordinates, valid[i] = 0 above the horizon. Results are bit-identical to
+    // lookup(): the AVX2 path gathers the 4 nodes and keeps the scalar operation order (no FMA contraction).
+    void lookupBatch(const float *px, const float *py, float *wx, float *wy, uint8_t *valid, size_t n) const {
+        size_t done = 0;
+#if IMAGE_TO_WORLD_X86
+        if (image_to_world_detail::cpuHasAvx2())
+            done = lookupBatchAvx2(px, py, wx, wy, valid, n);
+#endif
+        for (size_t i = done; i < n; ++i)
+            valid[i] = lookup(px[i], py[i], wx[i], wy[i]);
+    }
+
+    bool empty() const { return xy_.empty(); }
+    int step() const { return step_; }
+    size_t bytes() const { return xy_.size() * sizeof(float); }
+
+private:
+#if IMAGE_TO_WORLD_X86
+    __attribute__((target("avx2"))) size_t lookupBatchAvx2(const float *px, const float *py, float *wx, float *wy,
+                                                           uint8_t *valid, size_t n) const {
+        const float *base = xy_.data();
+        const __m256 inv = _mm256_set1_ps(inv_step_);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i max_i = _mm256_set1_epi32(cols_ - 2), max_j = _mm256_set1_epi32(rows_ - 2);
+        const __m256i cols = _mm256_set1_epi32(cols_);
+        const __m256i row = _mm256_set1_epi32(cols_ * 2);
+        const __m256i two = _mm256_set1_epi32(2), y_off = _mm256_set1_epi32(1);
+
+        size_t k = 0;
+        for (; k + 8 <= n; k += 8) {
+            __m256 gx = _mm256_mul_ps(_mm256_loadu_ps(px + k), inv);
+            __m256 gy = _mm256_mul_ps(_mm256_loadu_ps(py + k), inv);
+            __m256i i = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvttps_epi32(gx), zero), max_i);
+            __m256i j = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvttps_epi32(gy), zero), max_j);
+            __m256 fx = _mm256_sub_ps(gx, _mm256_cvtepi32_ps(i));
+            __m256 fy = _mm256_sub_ps(gy, _mm256_cvtepi32_ps(j));
+
+            __m256i i00 = _mm256_slli_epi32(_mm256_add_epi32(_mm256_mullo_epi32(j, cols), i), 1);
+            __m256i i10 = _mm256_add_epi32(i00, two);
+            __m256i i01 = _mm256_add_epi32(i00, row);
+            __m256i i11 = _mm256_add_epi32(i01, two);
+
+            __m256 gfx = _mm256_sub_ps(one, fx), gfy = _mm256_sub_ps(one, fy);
+            __m256 w00 = _mm256_mul_ps(gfx, gfy), w10 = _mm256_mul_ps(fx, gfy);
+            __m256 w01 = _mm256_mul_ps(gfx, fy), w11 = _mm256_mul_ps(fx, fy);
+
+            __m256 rx = _mm256_mul_ps(w00, _mm256_i32gather_ps(base, i00, 4));
+            rx = _mm256_add_ps(rx, _mm256_mul_ps(w10, _mm256_i32gather_ps(base, i10, 4)));
+            rx = _mm256_add_ps(rx, _mm256_mul_ps(w01, _mm256_i32gather_ps(base, i01, 4)));
+            rx = _mm256_add_ps(rx, _mm256_mul_ps(w11, _mm256_i32gather_ps(base, i11, 4)));
+
+            __m256 ry = _mm256_mul_ps(w00, _mm256_i32gather_ps(base, _mm256_add_epi32(i00, y_off), 4));
+            ry = _mm256_add_ps(ry, _mm256_mul_ps(w10, _mm256_i32gather_ps(base, _mm256_add_epi32(i10, y_off), 4)));
+            ry = _mm256_add_ps(ry, _mm256_mul_ps(w01, _mm256_i32gather_ps(base, _mm256_add_epi32(i01, y_off), 4)));
+            ry = _mm256_add_ps(ry, _mm256_mul_ps(w11, _mm256_i32gather_ps(base, _mm256_add_epi32(i11, y_off), 4)));
+
+            _mm256_storeu_ps(wx + k, rx);
+            _mm256_storeu_ps(wy + k, ry);
+
+            int ordered = _mm256_movemask_ps(_mm256_and_ps(_mm256_cmp_ps(rx, rx, _CMP_ORD_Q),
+                                                           _mm256_cmp_ps(ry, ry, _CMP_ORD_Q)));
+            for (int b = 0; b < 8; ++b)
+                valid[k + b] = (ordered >> b) & 1;
+        }
+        return k;
+    }
+#endif
+
+    int step_ = 0;
+    float inv_step_ = 0.0f;
+    int cols_ = 0, rows_ = 0;
+    std::vector<float> xy_;
+};
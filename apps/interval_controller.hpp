@@ -0,0 +1,198 @@
+// apps/real_world_overlay/interval_controller.hpp
+// Chooses the nvinfer `interval` (frames skipped between inferences) once per control window from what the window
+// measured: frame latency against an SLO, the offload queue depth and the objects per frame. No GStreamer here, the app
+// feeds samples and applies decisions, tools/interval_controller_sim drives it with a simulated pipeline.
+//
+// load = max(p95 latency / SLO, queue depth / queue_high). The PID policy is the incremental (velocity) form on
+// e = load - setpoint, integrating into a continuous interval clamped to [min, max], so saturation cannot wind up.
+// The hysteresis policy steps the interval up above the SLO and down below low_water * SLO. Both raise the interval
+// faster than they lower it (dwell_up / dwell_down windows), and hold it at empty_interval or more while the scene is
+// empty. At max_interval and still over the SLO, drop_frames decimates the sources (keep one frame in N).
+// A decrease that is undone within probe_windows found a level the pipeline cannot sustain; the level it came from is
+// then held for hold_windows, doubling on every repeat up to max_hold_windows, instead of probing it every few seconds.
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+enum class IntervalPolicy { Pid, Hysteresis };
+
+inline bool parseIntervalPolicy(const std::string &name, IntervalPolicy &out) {
+    if (name == "pid") {
+        out = IntervalPolicy::Pid;
+    } else if (name == "hysteresis") {
+        out = IntervalPolicy::Hysteresis;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline const char *intervalPolicyName(IntervalPolicy p) { return p == IntervalPolicy::Pid ? "pid" : "hysteresis"; }
+
+struct IntervalControllerConfig {
+    IntervalPolicy policy = IntervalPolicy::Pid;
+    double latency_slo_ms = 100.0;  // p95 frame latency target
+    int min_interval = 0, max_interval = 4;
+    double setpoint = 0.7;          // PID: load it steers to, headroom under the SLO
+    double kp = 1.5, ki = 0.6, kd = 0.0;  // PID gains, interval steps per unit of load error
+    double low_water = 0.5;         // hysteresis: step down below this load
+    int dwell_up = 1;               // windows after a change before the next increase
+    int dwell_down = 3;             //   and before the next decrease
+    double queue_high = 0.0;        // offload queue depth counted as load 1, 0 = ignore the queue
+    double empty_objects = 0.2;     // mean objects per frame below which the scene is empty
+    int empty_interval = 4;         // lowest interval while the scene is empty
+    bool drop_frames = false;       // decimate the sources when max_interval is not enough
+    int max_keep_one_in = 4;
+    int probe_windows = 3;          // a decrease reversed this soon failed
+    int hold_windows = 15;          // then its starting level is held this long
+    int max_hold_windows = 240;
+};
+
+// One control window
+struct IntervalSample {
+    double latency_p95_ms = 0.0;
+    double queue_depth = 0.0;
+    double objects_per_frame = 0.0;
+    uint64_t frames = 0;  // frames measured, 0 = no data (the decision is held)
+};
+
+struct IntervalDecision {
+    int interval;
+    int keep_one_in;  // 1 = every frame
+    double load;
+    bool changed;
+};
+
+class IntervalController {
+public:
+    explicit IntervalController(const IntervalControllerConfig &cfg = IntervalControllerConfig()) : cfg_(cfg) {
+        cfg_.max_interval = std::max(cfg_.max_interval, cfg_.min_interval);
+        cfg_.empty_interval = std::min(std::max(cfg_.empty_interval, cfg_.min_interval), cfg_.max_interval);
+        cfg_.max_keep_one_in = std::max(cfg_.max_keep_one_in, 1);
+        reset(cfg_.min_interval);
+    }
+
+    void reset(int interval) {
+        interval_ = clampInterval(interval);
+        target_ = interval_;
+        keep_ = 1;
+        e1_ = e2_ = 0.0;
+        since_change_ = 1 << 20;
+        since_down_ = 1 << 20;
+        load_ = 0.0;
+        hold_left_ = 0;
+        hold_for_ = cfg_.hold_windows;
+        floor_interval_ = cfg_.min_interval;
+        floor_keep_ = 1;
+    }
+
+    IntervalDecision update(const IntervalSample &s) {
+        if (s.frames == 0)
+            return IntervalDecision{interval_, keep_, load_, false};
+
+        double load = s.latency_p95_ms / cfg_.latency_slo_ms;
+        if (cfg_.queue_high > 0.0)
+            load = std::max(load, s.queue_depth / cfg_.queue_high);
+        load_ = load;
+        ++since_change_;
+        ++since_down_;
+        if (hold_left_ > 0)
+            --hold_left_;
+        bool held = hold_left_ > 0;
+        if (since_down_ == cfg_.probe_windows + 1 && (down_interval_ < floor_interval_ || down_keep_ < floor_keep_))
+            hold_for_ = cfg_.hold_windows;  // got below the last failed level: back off from scratch next time
+
+        // Continuous target for the busy scene
+        if (cfg_.policy == IntervalPolicy::Pid) {
+            double e = load - cfg_.setpoint;
+            target_ += cfg_.kp * (e - e1_) + cfg_.ki * e + cfg_.kd * (e - 2.0 * e1_ + e2_);
+            int lowest = held ? floor_interval_ : cfg_.min_interval;
+            target_ = std::min(std::max(target_, static_cast<double>(lowest)), static_cast<double>(cfg_.max_interval));
+            e2_ = e1_;
+            e1_ = e;
+        } else if (load > 1.0) {
+            target_ = std::min(std::floor(target_) + 1.0, static_cast<double>(cfg_.max_interval));
+        } else if (load < cfg_.low_water) {
+            target_ = std::max(std::ceil(target_) - 1.0, static_cast<double>(cfg_.min_interval));
+        }
+
+        // Round with a deadband so a target hovering around .5 does not flap
+        int wanted = interval_;
+        if (target_ > interval_ + 0.6) {
+            wanted = static_cast<int>(std::floor(target_ + 0.4));
+        } else if (target_ < interval_ - 0.6) {
+            wanted = static_cast<int>(std::ceil(target_ - 0.4));
+        }
+        bool empty = s.objects_per_frame < cfg_.empty_objects;
+        if (empty && load <= 1.0)
+            wanted = std::max(wanted, cfg_.empty_interval);
+        if (held)
+            wanted = std::max(wanted, floor_interval_);
+        wanted = clampInterval(wanted);
+
+        // Decimation only once inference cannot be thinned further
+        int keep = keep_;
+        if (cfg_.drop_frames && interval_ == cfg_.max_interval && wanted == cfg_.max_interval && load > 1.0) {
+            keep = std::min(keep_ + 1, cfg_.max_keep_one_in);
+        } else if (keep_ > 1 && load < cfg_.low_water && !(held && keep_ <= floor_keep_)) {
+            keep = keep_ - 1;
+        }
+
+        const int before_interval = interval_, before_keep = keep_;
+        bool changed = false;
+        if (wanted > interval_ && since_change_ >= cfg_.dwell_up) {
+            interval_ = empty ? wanted : std::min(wanted, interval_ + 2);
+            changed = true;
+        } else if (wanted < interval_ && (since_change_ >= cfg_.dwell_down || (!empty && wasEmpty()))) {
+            // Objects showing up in an empty scene get inference back at once
+            interval_ = wanted;
+            changed = true;
+        }
+        if (keep != keep_ && (changed || since_change_ >= (keep > keep_ ? cfg_.dwell_up : cfg_.dwell_down))) {
+            keep_ = keep;
+            changed = true;
+        }
+        if (changed) {
+            since_change_ = 0;
+            if (interval_ < before_interval || keep_ < before_keep) {
+                since_down_ = 0;
+                up_interval_ = before_interval;
+                up_keep_ = before_keep;
+                down_interval_ = interval_;
+                down_keep_ = keep_;
+            } else if (since_down_ <= cfg_.probe_windows && !empty) {
+                // The last decrease did not hold
+                floor_interval_ = up_interval_;
+                floor_keep_ = up_keep_;
+                hold_left_ = hold_for_;
+                hold_for_ = std::min(hold_for_ * 2, cfg_.max_hold_windows);
+                since_down_ = 1 << 20;
+            }
+        }
+        was_empty_ = empty;
+        return IntervalDecision{interval_, keep_, load, changed};
+    }
+
+    int interval() const { return interval_; }
+    int keepOneIn() const { return keep_; }
+    const IntervalControllerConfig &config() const { return cfg_; }
+
+private:
+    int clampInterval(int i) const { return std::min(std::max(i, cfg_.min_interval), cfg_.max_interval); }
+    bool wasEmpty() const { return was_empty_; }
+
+    IntervalControllerConfig cfg_;
+    int interval_ = 0;
+    int keep_ = 1;
+    double target_ = 0.0;
+    double e1_ = 0.0, e2_ = 0.0;  // previous errors, PID
+    int since_change_ = 0;
+    int since_down_ = 0;                    // windows since the last decrease
+    int up_interval_ = 0, up_keep_ = 1;     // levels before it
+    int down_interval_ = 0, down_keep_ = 1; //   and after it
+    int floor_interval_ = 0, floor_keep_ = 1, hold_left_ = 0, hold_for_ = 0;
+    double load_ = 0.0;
+    bool was_empty_ = false;
+};
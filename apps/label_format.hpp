@@ -0,0 +1,98 @@
+// apps/real_world_overlay/label_format.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Longest output of formatFixed2 including the NUL: "-" + 39 integer digits (FLT_MAX) + ".00"
+constexpr size_t FIXED2_MAX_CHARS = 44;
+
+namespace label_format_detail {
+
+template <typename U>
+inline char *writeUnsigned(char *out, U value) {
+    char digits[40];
+    int n = 0;
+    do {
+        digits[n++] = static_cast<char>('0' + static_cast<int>(value % 10));
+        value /= 10;
+    } while (value != 0);
+    while (n > 0)
+        *out++ = digits[--n];
+    return out;
+}
+
+} // namespace label_format_detail
+
+// Same output as snprintf("%.2f", v) in the C locale, without printf or allocations. The float is decomposed into
+// mantissa * 2^e and v * 100 is rounded exactly (ties to even) with integer arithmetic. Writes the NUL, returns the
+// length. `out` must hold FIXED2_MAX_CHARS bytes.
+inline size_t formatFixed2(char *out, float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    bool negative = bits >> 31;
+    int exponent = static_cast<int>((bits >> 23) & 0xff);
+    uint32_t fraction = bits & 0x7fffff;
+
+    char *p = out;
+    if (negative)
+        *p++ = '-';
+
+    if (exponent == 0xff) {
+        const char *text = fraction ? "nan" : "inf";
+        std::memcpy(p, text, 4);
+        return static_cast<size_t>(p - out) + 3;
+    }
+
+    // v = m * 2^e2
+    uint64_t m = exponent ? (fraction | 0x800000u) : fraction;
+    int e2 = (exponent ? exponent : 1) - 150;
+
+    if (e2 >= 0) {
+        // Integral, up to FLT_MAX < 2^128
+        p = label_format_detail::writeUnsigned(p, static_cast<unsigned __int128>(m) << e2);
+        std::memcpy(p, ".00", 4);
+        return static_cast<size_t>(p - out) + 3;
+    }
+
+    // Hundredths: round(m * 100 / 2^s), m * 100 < 2^31
+    int s = -e2;
+    uint64_t scaled = m * 100;
+    uint64_t q = 0;
+    if (s < 64) {
+        q = scaled >> s;
+        uint64_t rem = scaled & ((uint64_t(1) << s) - 1);
+        uint64_t half = uint64_t(1) << (s - 1);
+        if (rem > half || (rem == half && (q & 1)))
+            ++q;
+    }
+
+    p = label_format_detail::writeUnsigned(p, q / 100);
+    unsigned cents = static_cast<unsigned>(q % 100);
+    p[0] = '.';
+    p[1] = static_cast<char>('0' + cents / 10);
+    p[2] = static_cast<char>('0' + cents % 10);
+    p[3] = '\0';
+    return static_cast<size_t>(p - out) + 3;
+}
+
+// "X:<x> Y:<y>" with two decimals, truncated to cap - 1 characters like snprintf. Returns the untruncated length.
+inline size_t formatWorldLabel(char *out, size_t cap, float x, float y) {
+    char text[2 * FIXED2_MAX_CHARS + 8];
+    char *p = text;
+    *p++ = 'X';
+    *p++ = ':';
+    p += formatFixed2(p, x);
+    *p++ = ' ';
+    *p++ = 'Y';
+    *p++ = ':';
+    p += formatFixed2(p, y);
+
+    size_t len = static_cast<size_t>(p - text);
+    if (cap > 0) {
+        size_t n = len < cap - 1 ? len : cap - 1;
+        std::memcpy(out, text, n);
+        out[n] = '\0';
+    }
+    return len;
+}
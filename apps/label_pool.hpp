@@ -0,0 +1,47 @@
+// apps/real_world_overlay/label_pool.hpp
+#pragma once
+#include <glib.h>
+#include <cstddef>
+#include <vector>
+
+// Recycles the display_text buffers of the OSD labels. Every buffer is a separate g_malloc block, so DeepStream can
+// still g_free one when its batch never comes back to the pool; acquire() then allocates a replacement. In steady
+// state no label is allocated or freed.
+class LabelPool {
+public:
+    static constexpr size_t kLabelSize = 64;
+
+    explicit LabelPool(size_t max_free = 4096) : max_free_(max_free) {}
+    LabelPool(const LabelPool &) = delete;
+    LabelPool &operator=(const LabelPool &) = delete;
+
+    ~LabelPool() {
+        for (char *label : free_)
+            g_free(label);
+    }
+
+    char *acquire() {
+        if (free_.empty()) {
+            ++allocations_;
+            return static_cast<char *>(g_malloc(kLabelSize));
+        }
+        char *label = free_.back();
+        free_.pop_back();
+        return label;
+    }
+
+    void release(char *label) {
+        if (free_.size() < max_free_) {
+            free_.push_back(label);
+        } else {
+            g_free(label);
+        }
+    }
+
+    size_t allocations() const { return allocations_; }
+
+private:
+    std::vector<char *> free_;
+    size_t max_free_;
+    size_t allocations_ = 0;
+};
@@ -0,0 +1,102 @@
+// apps/real_world_overlay/latency_histogram.hpp
+// HDR-style log-linear latency histogram over the full uint64 range of nanoseconds. Values below 64 ns are exact,
+// above that every power of two is split into 32 linear sub-buckets (3% relative precision). record() is a handful of
+// relaxed atomic operations, so any number of threads can record while another one takes a snapshot.
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 5;
+    static constexpr uint64_t kSub = uint64_t(1) << kSubBits;
+    static constexpr size_t kBuckets = (65 - kSubBits) * kSub;  // 2 * kSub exact, then 58 octaves
+
+    static size_t bucketOf(uint64_t v) {
+        if (v < 2 * kSub)
+            return static_cast<size_t>(v);
+        int e = 63 - __builtin_clzll(v);
+        int shift = e - kSubBits;
+        return static_cast<size_t>((shift + 1) * kSub + ((v >> shift) - kSub));
+    }
+
+    // Smallest and largest value of a bucket
+    static uint64_t bucketLow(size_t b) {
+        if (b < 2 * kSub)
+            return b;
+        int shift = static_cast<int>(b / kSub) - 1;
+        return (b % kSub + kSub) << shift;
+    }
+
+    static uint64_t bucketHigh(size_t b) {
+        if (b < 2 * kSub)
+            return b;
+        int shift = static_cast<int>(b / kSub) - 1;
+        return bucketLow(b) + ((uint64_t(1) << shift) - 1);
+    }
+
+    void record(uint64_t v) {
+        counts_[bucketOf(v)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(v, std::memory_order_relaxed);
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        while (v > max && !max_.compare_exchange_weak(max, v, std::memory_order_relaxed)) {
+        }
+    }
+
+    struct Snapshot {
+        std::vector<uint64_t> counts;
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+
+        double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+
+        // Midpoint of the bucket holding the q-quantile (q in [0, 1]), clamped to the recorded max
+        uint64_t quantile(double q) const {
+            if (count == 0)
+                return 0;
+            uint64_t rank = static_cast<uint64_t>(q * (count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t b = 0; b < counts.size(); ++b) {
+                seen += counts[b];
+                if (seen >= rank) {
+                    uint64_t mid = bucketLow(b) + (bucketHigh(b) - bucketLow(b)) / 2;
+                    return mid < max ? mid : max;
+                }
+            }
+            return max;
+        }
+
+        // What was recorded after `earlier` (a previous snapshot of the same histogram). max stays the all-time max.
+        Snapshot since(const Snapshot &earlier) const {
+            Snapshot d = *this;
+            for (size_t b = 0; b < d.counts.size() && b < earlier.counts.size(); ++b)
+                d.counts[b] -= earlier.counts[b] < d.counts[b] ? earlier.counts[b] : d.counts[b];
+            d.count = 0;
+            for (uint64_t c : d.counts)
+                d.count += c;
+            d.sum = sum > earlier.sum ? sum - earlier.sum : 0;
+            return d;
+        }
+    };
+
+    // Counts are read one by one while writers keep going, so a snapshot can be off by the in-flight records
+    Snapshot snapshot() const {
+        Snapshot s;
+        s.counts.resize(kBuckets);
+        for (size_t b = 0; b < kBuckets; ++b) {
+            s.counts[b] = counts_[b].load(std::memory_order_relaxed);
+            s.count += s.counts[b];
+        }
+        s.sum = sum_.load(std::memory_order_relaxed);
+        s.max = max_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    std::atomic<uint64_t> counts_[kBuckets] = {};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
@@ -0,0 +1,205 @@
+// apps/real_world_overlay/latency_tracer.hpp
+// Per-stage latency aggregation keyed by buffer timestamp, independent of GStreamer. Source stages claim a slot in a
+// fixed power-of-2 table for every new key; every later stage that sees the same key records the time since the
+// previous stage that saw it and the time since the source. A stage records a key once, so buffers split into several
+// downstream buffers (RTP packets) count at their first appearance. onBuffer() takes no locks and does not allocate.
+// Parallel branches carry buffers with equal timestamps (cameras started together, the tiles of one frame), so every
+// stage belongs to a lane and keys are only matched within it. A stage that starts a lane from others (a tee branch,
+// the output of a muxer) picks up a key it has not seen yet from the first of its `from` lanes that has it.
+#pragma once
+#include <time.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "latency_histogram.hpp"
+
+inline uint64_t latencyNowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+class LatencyTracer {
+public:
+    static constexpr int kMaxStages = 64;
+
+    // Slot count is rounded up to a power of 2; it only needs to cover the buffers in flight at once
+    explicit LatencyTracer(size_t slots = 1024) {
+        size_t cap = 1;
+        while (cap < slots)
+            cap <<= 1;
+        slots_.reset(new Slot[cap]);
+        mask_ = cap - 1;
+    }
+
+    static constexpr uint32_t kMaxLanes = 256;
+
+    // Registers a stage before buffers flow. Returns its id, or -1 when kMaxStages are already taken or a lane is not
+    // below kMaxLanes.
+    int addStage(const std::string &name, bool source, uint32_t lane = 0,
+                 const std::vector<uint32_t> &from = std::vector<uint32_t>()) {
+        if (stages_.size() >= kMaxStages || lane >= kMaxLanes)
+            return -1;
+        for (uint32_t l : from) {
+            if (l >= kMaxLanes)
+                return -1;
+        }
+        stages_.emplace_back(new Stage);
+        stages_.back()->name = name;
+        stages_.back()->source = source;
+        stages_.back()->lane = lane;
+        stages_.back()->from = from;
+        return static_cast<int>(stages_.size() - 1);
+    }
+
+    size_t stageCount() const { return stages_.size(); }
+    const std::string &stageName(int stage) const { return stages_[stage]->name; }
+
+    // The lane is added to `key` from bit 56 up, past two years of nanoseconds
+    void onBuffer(int stage, uint64_t key, uint64_t now_ns) {
+        Stage &s = *stages_[stage];
+        uint64_t lane_key = laneKey(key, s.lane);
+        Slot &slot = slots_[hashKey(lane_key) & mask_];
+        uint64_t tag = lane_key + 1;  // 0 marks an unused slot
+        uint64_t bit = uint64_t(1) << stage;
+        s.buffers.fetch_add(1, std::memory_order_relaxed);
+
+        if (s.source) {
+            if (slot.tag.load(std::memory_order_relaxed) == tag)
+                return;  // the same buffer leaving a source twice (several src pads)
+            slot.tag.store(0, std::memory_order_relaxed);
+            slot.source_ns.store(now_ns, std::memory_order_relaxed);
+            slot.last_ns.store(now_ns, std::memory_order_relaxed);
+            slot.seen.store(bit, std::memory_order_relaxed);
+            slot.tag.store(tag, std::memory_order_release);
+            return;
+        }
+
+        if (slot.tag.load(std::memory_order_acquire) != tag && !startFromLanes(s, key, slot, tag)) {
+            s.misses.fetch_add(1, std::memory_order_relaxed);  // no source saw it, or its slot was reused
+            return;
+        }
+        if (slot.seen.fetch_or(bit, std::memory_order_relaxed) & bit)
+            return;
+        uint64_t prev = slot.last_ns.exchange(now_ns, std::memory_order_relaxed);
+        uint64_t source = slot.source_ns.load(std::memory_order_relaxed);
+        if (now_ns >= prev)
+            s.since_previous.record(now_ns - prev);
+        if (now_ns >= source)
+            s.since_source.record(now_ns - source);
+    }
+
+    // {"timestamp_ns": .., "stages": [{"name", "source", "buffers", "misses", "since_previous_us", "since_source_us"}]}
+    // with count, mean, p50, p90, p99, p99.9 and max per histogram; source stages only report buffers
+    std::string toJson(uint64_t timestamp_ns) const {
+        std::string out = "{\"timestamp_ns\":" + std::to_string(timestamp_ns) + ",\"stages\":[";
+        for (size_t i = 0; i < stages_.size(); ++i) {
+            const Stage &s = *stages_[i];
+            if (i)
+                out += ',';
+            out += "{\"name\":\"";
+            appendEscaped(out, s.name);
+            out += "\",\"source\":";
+            out += s.source ? "true" : "false";
+            out += ",\"buffers\":" + std::to_string(s.buffers.load(std::memory_order_relaxed));
+            out += ",\"misses\":" + std::to_string(s.misses.load(std::memory_order_relaxed));
+            if (!s.source) {
+                out += ",\"since_previous_us\":";
+                appendSummary(out, s.since_previous.snapshot());
+                out += ",\"since_source_us\":";
+                appendSummary(out, s.since_source.snapshot());
+            }
+            out += '}';
+        }
+        out += "]}";
+        return out;
+    }
+
+    LatencyHistogram::Snapshot sincePrevious(int stage) const { return stages_[stage]->since_previous.snapshot(); }
+    LatencyHistogram::Snapshot sinceSource(int stage) const { return stages_[stage]->since_source.snapshot(); }
+    uint64_t misses(int stage) const { return stages_[stage]->misses.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> tag{0};
+        std::atomic<uint64_t> source_ns{0};
+        std::atomic<uint64_t> last_ns{0};
+        std::atomic<uint64_t> seen{0};
+    };
+
+    struct Stage {
+        std::string name;
+        bool source = false;
+        uint32_t lane = 0;
+        std::vector<uint32_t> from;  // lanes this stage continues, tried in order
+        std::atomic<uint64_t> buffers{0};
+        std::atomic<uint64_t> misses{0};
+        LatencyHistogram since_previous;
+        LatencyHistogram since_source;
+    };
+
+    static uint64_t laneKey(uint64_t key, uint32_t lane) { return key + (static_cast<uint64_t>(lane) << 56); }
+
+    // A key first seen on the lane of `s`: claims `slot` with the source and last times of the key on one of the
+    // lanes `s` continues. Returns false when none of them has it.
+    bool startFromLanes(const Stage &s, uint64_t key, Slot &slot, uint64_t tag) {
+        for (uint32_t lane : s.from) {
+            uint64_t from_key = laneKey(key, lane);
+            const Slot &from = slots_[hashKey(from_key) & mask_];
+            if (&from == &slot || from.tag.load(std::memory_order_acquire) != from_key + 1)
+                continue;
+            uint64_t source_ns = from.source_ns.load(std::memory_order_relaxed);
+            uint64_t last_ns = from.last_ns.load(std::memory_order_relaxed);
+            slot.tag.store(0, std::memory_order_relaxed);
+            slot.source_ns.store(source_ns, std::memory_order_relaxed);
+            slot.last_ns.store(last_ns, std::memory_order_relaxed);
+            slot.seen.store(0, std::memory_order_relaxed);
+            slot.tag.store(tag, std::memory_order_release);
+            return true;
+        }
+        return false;
+    }
+
+    // PTS values are multiples of the frame duration; mix them so consecutive frames spread over the table
+    static uint64_t hashKey(uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return key;
+    }
+
+    static void appendEscaped(std::string &out, const std::string &s) {
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+    }
+
+    static void appendSummary(std::string &out, const LatencyHistogram::Snapshot &h) {
+        char buf[256];
+        std::snprintf(buf, sizeof(buf),
+                      "{\"count\":%llu,\"mean\":%.3f,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"p999\":%.3f,\"max\":%.3f}",
+                      static_cast<unsigned long long>(h.count), h.mean() / 1000.0, h.quantile(0.5) / 1000.0,
+                      h.quantile(0.9) / 1000.0, h.quantile(0.99) / 1000.0, h.quantile(0.999) / 1000.0,
+                      h.max / 1000.0);
+        out += buf;
+    }
+
+    std::unique_ptr<Slot[]> slots_;
+    uint64_t mask_ = 0;
+    std::vector<std::unique_ptr<Stage>> stages_;
+};
@@ -1,8 +1,21 @@
 // main.cpp
 #include <gst/gst.h>
+#include <gst/video/video.h>
 #include <glib.h>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <dlfcn.h>
 #include "nvdsmeta.h"
 #include "gstnvdsmeta.h"
 #include "nvdsinfer.h"
@@ -10,19 +23,779 @@
 #include "nvdsinfer_custom_impl.h"
 #include "nvds_version.h"
 #include "image_to_world.hpp"
+#include "camera_set.hpp"
+#include "roi_crop.hpp"
+#include "label_format.hpp"
+#include "label_pool.hpp"
+#include "world_meta.hpp"
+#include "shm_ring.hpp"
+#include "detection_log.hpp"
+#include "spsc_queue.hpp"
+#include "tracker.hpp"
+#include "interval_controller.hpp"
+#include "motion_detector.hpp"
+#include "tile_merge.hpp"
+#include "zone_engine.hpp"
+#include "latency_tracer.hpp"
+#include "pipeline_tracer.hpp"
+#include "metrics.hpp"
+#include "metrics_server.hpp"
+#include "pipeline_config.hpp"
+#include "config_reload.hpp"
+#include "overlay_policy.hpp"
+#include "frame_processor.hpp"
+#include "../nvdsinfer_custom_impl_Yolo/parse_stats.h"
 
 #include <toml.hpp>
 
 struct CameraConfig {
-    std::string device;
-    int width, height;
-    float pos_x, pos_y, pos_z;
-    float rot_x, rot_y, rot_z;
-    float fov_x, fov_y;
+    std::vector<CameraGeometry> cameras;  // one per nvstreammux source, top-level keys or [[camera]]
+    std::string label_mode;          // "pooled" or "malloc"
+    bool text_overlay;               // X/Y label drawn by nvdsosd
+    OverlayConfig overlay;           // what nvdsosd draws: overlay mode, label_every, label_top_k, label_classes
+    bool world_meta;                 // WorldCoordMeta user meta on every object
+    float pixel_sigma;               // pixels, box centre noise for the world covariance
+    std::string shm_export;          // POSIX shared memory name of the detection ring, empty = disabled
+    int shm_capacity;                // records
+    std::string detection_log;       // directory of the on-disk detection log, empty = disabled
+    DetectionLogConfig log_cfg;
+    std::vector<ZoneConfig> zones;   // [[zone]] polygons for the zone analytics, empty = disabled
+    ZoneEngineConfig zone_cfg;
+    std::string probe_mode;          // "inline" or "offload" (worker thread)
+    int queue_capacity;              // objects, offload mode
+    std::string queue_policy;        // "drop_oldest", "drop_newest" or "block", offload mode
+    bool tracker;                    // IoU tracker per source, predicted boxes on frames nvinfer skipped
+    TrackerConfig tracker_cfg;
+    bool adaptive_interval;          // nvinfer interval steered toward latency_slo_ms at runtime
+    IntervalControllerConfig interval_cfg;
+    int control_period_ms;           // control window
+    std::string interval_log;        // CSV of every control window, empty = disabled
+    bool motion_gate;                // skip inference on batches where no raw source moves
+    MotionDetectorConfig motion_cfg;
+    MotionGateConfig motion_gate_cfg;
+    bool tiled;                      // sliced inference: every camera also cut into overlapping tiles
+    TilePlanConfig tile_plan;
+    TileMergeConfig tile_merge_cfg;
+    bool trace;                      // per-element latency probes
+    int trace_interval;              // seconds between latency dumps, 0 = only on SIGUSR1
+    std::string trace_output;        // latency JSON file, empty = stdout
+    int metrics_port;                // Prometheus /metrics port, 0 = disabled
+    std::string metrics_address;     // address the metrics server binds to
+    std::string parser_lib;          // custom bbox parser lib loaded by nvinfer, for its parse stats, empty = off
+    bool config_reload;              // calibration and thresholds reloaded when config.toml changes
 };
 
-static GstPadProbeReturn osd_sink_pad_buffer_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
-    CameraConfig *cfg = static_cast<CameraConfig *>(user_data);
+// Per-object copy of the meta the worker needs, taken on the streaming thread in offload mode. A frame without
+// objects is sent as one item with count = 0.
+struct ObjectWork {
+    uint64_t timestamp_ns;
+    uint64_t frame_number;
+    uint32_t source_id;
+    uint16_t index, count;
+    int32_t class_id;
+    float confidence;
+    float left, top, width, height;
+    uint64_t object_id;
+};
+
+using ObjectBatch = CentrePointBatch<NvDsFrameMeta, NvDsObjectMeta>;
+using ProbeProcessor = FrameProcessor<NvDsFrameMeta, NvDsObjectMeta>;
+
+// What the probes read per batch, rebuilt and swapped in when config.toml changes (see reloadConfig). Snapshots only
+// differ in the hot-reloadable keys: camera calibration, pixel_sigma, world_meta and the tile merge thresholds.
+struct RuntimeConfig {
+    CameraConfig cfg;
+    CameraSet cameras;  // by frame source_id
+};
+
+struct ProbeContext;
+
+// nvstreammux sink pad of one source: stamps frames for the adaptive interval, and decimates them
+struct MuxSinkProbe {
+    ProbeContext *ctx;
+    uint32_t source;
+    uint64_t frames = 0;
+};
+
+// Raw source pad of one camera: motion on its luma, read per batch on the nvinfer sink pad. Sources without raw 8-bit
+// luma (MJPEG, uri) keep motion = true and are always inferred.
+struct SourceMotion {
+    MotionDetector detector;
+    GstVideoInfo info;
+    bool supported = false;  // caps with 8-bit luma seen
+    int crop_x = 0, crop_y = 0, crop_width = 0, crop_height = 0;  // only motion inside counts, width 0 = whole frame
+    std::atomic<bool> motion{true};
+
+    explicit SourceMotion(const MotionDetectorConfig &cfg) : detector(cfg) {}
+};
+
+struct ProbeContext {
+    CameraConfig cfg;           // as started, the calibration and thresholds in use are in `runtime`
+    size_t camera_count = 0;    // nvstreammux pads that are cameras, tiles come after
+    ProbeProcessor processor;   // transform, export records and labels of the inline probe (frame_processor.hpp)
+
+    // Hot reload: the osd probe pins the current snapshot for a batch, the worker for a frame; the reload thread
+    // publishes new ones and frees the old once neither can still hold them
+    SnapshotPublisher<RuntimeConfig> runtime;
+    int osd_reader = -1, worker_reader = -1;
+    ConfigWatcher config_watcher;
+    std::thread reload_thread;
+    toml::table started_toml;  // config.toml as the pipeline was built from it, reload thread only
+
+    // One tracker per source (empty = disabled) and their per-frame buffers, sized at startup
+    std::vector<Tracker> trackers;
+    std::vector<TrackerDetection> track_dets;
+    std::vector<NvDsObjectMeta *> track_objs;
+    std::vector<TrackOutput> track_out;
+    NvDsMetaType world_meta_type = NVDS_START_USER_META;
+
+    // Pooled labels handed out on the osd sink pad, taken back on the osd src pad of the same buffer
+    bool pooled_labels = true;
+    LabelPool labels;
+    std::vector<std::pair<NvDsObjectMeta *, char *>> labels_in_flight;
+    GstBuffer *labels_buffer = nullptr;
+
+    ShmRingWriter detections;
+    DetectionLogWriter detection_log;
+    ZoneEngine zones;  // fed by the osd probe, or by the worker in offload mode
+
+    // Offload mode: the probe only queues ObjectWork items, the worker thread transforms and exports them
+    std::unique_ptr<SpscQueue<ObjectWork>> queue;
+    std::thread worker;
+    std::atomic<bool> stop_worker{false};
+    QueueCounters last_counters;
+
+    // Adaptive interval: frame latency from the nvstreammux sink pads to the osd sink pad, keyed by (PTS, source)
+    IntervalController interval_controller;
+    LatencyTracer frame_latency{512};
+    int latency_mux_stage = -1, latency_osd_stage = -1;
+    LatencyHistogram::Snapshot latency_seen;
+    std::deque<MuxSinkProbe> mux_probes;
+    std::atomic<int> keep_one_in{1};
+    GstElement *infer = nullptr;
+    std::atomic<int> infer_interval{0};  // static or adaptive, what the motion gate restores
+    uint64_t control_frames = 0, control_objects = 0;  // counter values at the last control window
+    FILE *interval_log = nullptr;
+
+    // Motion gate: one detector per source (empty = disabled), the gate runs on the nvinfer sink pad
+    std::deque<SourceMotion> motion;
+    MotionGate motion_gate;
+    int applied_interval = 0;  // nvinfer streaming thread only
+
+    // Tiled inference: nvstreammux pads after the cameras' own are tiles, merged back onto the camera's own frame
+    int mux_width = 0, mux_height = 0;
+    std::vector<std::vector<TileRect>> tiles;               // per camera, empty = not tiled
+    std::vector<TileRect> tile_regions;                     // per camera, the part of the frame the tiles cover
+    std::vector<std::pair<uint32_t, uint32_t>> tile_pads;   // (camera, tile) of pad cameras.size() + i
+    TileMerger tile_merger;
+    std::vector<NvDsFrameMeta *> tile_frames;
+    std::vector<MergeBox> merge_boxes;
+    std::vector<std::pair<NvDsObjectMeta *, NvDsFrameMeta *>> merge_objs;
+    std::vector<uint32_t> merge_keep;
+    std::vector<uint8_t> merge_kept;
+
+    // Prometheus metrics, always updated (relaxed atomics), rendered only when /metrics is scraped
+    MetricsRegistry metrics{"real_world_overlay_"};
+    MetricCounter *frames_total = nullptr;
+    MetricCounter *objects_total = nullptr;
+    MetricCounter *qos_dropped_total = nullptr;
+    MetricHistogram *objects_per_frame = nullptr;
+    MetricHistogram *probe_seconds = nullptr;
+    MetricGauge *tracks_active = nullptr;
+    MetricCounter *tracks_created_total = nullptr;
+    MetricCounter *predicted_objects_total = nullptr;
+    MetricGauge *inference_interval = nullptr;
+    MetricGauge *source_keep_one_in = nullptr;
+    MetricCounter *gated_batches_total = nullptr;
+    MetricGauge *sources_in_motion = nullptr;
+    MetricCounter *tile_merged_total = nullptr;
+    MetricCounter *config_reloads_total = nullptr;
+    MetricCounter *config_reload_failures_total = nullptr;
+    MetricCounter *osd_labels_total = nullptr;
+    MetricCounter *osd_labels_reused_total = nullptr;
+    std::unordered_map<std::string, guint64> qos_dropped_seen;  // per element, main loop only
+};
+
+static void attachWorldCoordMeta(ProbeContext *ctx, const RuntimeConfig &rt, NvDsBatchMeta *batch_meta, size_t i) {
+    const ObjectBatch &ob = ctx->processor.batch();
+
+    WorldCoordMeta payload = {};
+    payload.version = WORLD_COORD_META_VERSION;
+    payload.camera_id = ob.frames[i]->source_id;
+    payload.x = ob.wx[i];
+    payload.y = ob.wy[i];
+    payload.z = 0.0f;
+
+    float j[4];
+    if (!rt.cameras[ob.frames[i]->source_id].jacobian(ob.px[i], ob.py[i], j)) {
+        for (float &c : payload.cov) c = NAN;  // next to the horizon
+    } else {
+        worldCovariance(j, rt.cfg.pixel_sigma, payload.cov);
+    }
+
+    NvDsUserMeta *user_meta = nvds_acquire_user_meta_from_pool(batch_meta);
+    if (!user_meta) {
+        return;
+    }
+    setWorldCoordUserMeta(user_meta, ctx->world_meta_type, payload);
+    nvds_add_user_meta_to_obj(ob.objs[i], user_meta);
+}
+
+static void reportZoneEvents(ProbeContext *ctx) {
+    for (const ZoneEvent &e : ctx->zones.events()) {
+        if (e.kind == ZoneEventKind::Intrusion) {
+            std::cout << "Zone alert: intrusion in '" << ctx->zones.zone(e.zone).name << "' by object " << e.object_id
+                      << " (source " << e.source << ")\n";
+        } else if (e.kind == ZoneEventKind::Loiter) {
+            std::cout << "Zone alert: object " << e.object_id << " (source " << e.source << ") in '"
+                      << ctx->zones.zone(e.zone).name << "' for " << e.dwell_s << " s\n";
+        }
+    }
+}
+
+// Zone analytics on the world points of the batch, one engine frame per camera frame (tiles carry no objects of
+// their own once merged)
+static void updateZones(ProbeContext *ctx, const ObjectBatch &ob, NvDsBatchMeta *batch_meta) {
+    uint64_t now = shmRingNowNs();
+    size_t k = 0;
+    for (NvDsMetaList *l_frame = batch_meta->frame_meta_list; l_frame != nullptr; l_frame = l_frame->next) {
+        NvDsFrameMeta *frame_meta = (NvDsFrameMeta *)(l_frame->data);
+        size_t begin = k;
+        while (k < ob.objs.size() && ob.frames[k] == frame_meta) {
+            ++k;
+        }
+        if (frame_meta->source_id >= ctx->camera_count) {
+            continue;
+        }
+        ctx->zones.beginFrame(frame_meta->source_id, now);
+        for (size_t i = begin; i < k; ++i) {
+            if (ob.valid[i]) {
+                ctx->zones.add(ob.objs[i]->object_id, ob.wx[i], ob.wy[i]);
+            }
+        }
+        ctx->zones.endFrame();
+        reportZoneEvents(ctx);
+    }
+}
+
+// To the shared memory ring and the on-disk log; the log only queues the record for its writer thread
+static bool exportsDetections(const ProbeContext *ctx) {
+    return ctx->detections.isOpen() || ctx->detection_log.isOpen();
+}
+
+static void exportDetection(ProbeContext *ctx, const DetectionRecord &rec) {
+    if (ctx->detections.isOpen()) {
+        ctx->detections.publish(rec);
+    }
+    if (ctx->detection_log.isOpen()) {
+        ctx->detection_log.append(rec);
+    }
+}
+
+static ObjectWork makeObjectWork(const NvDsFrameMeta *frame_meta, const NvDsObjectMeta *obj_meta, uint16_t index,
+                                 uint16_t count) {
+    ObjectWork w = {};
+    w.timestamp_ns = frame_meta->buf_pts;
+    w.frame_number = static_cast<uint64_t>(frame_meta->frame_num);
+    w.source_id = frame_meta->source_id;
+    w.index = index;
+    w.count = count;
+    w.class_id = obj_meta ? obj_meta->class_id : -1;
+    w.object_id = ZONE_NO_ID;
+    if (obj_meta) {
+        w.object_id = obj_meta->object_id;
+        w.confidence = obj_meta->confidence;
+        w.left = obj_meta->rect_params.left;
+        w.top = obj_meta->rect_params.top;
+        w.width = obj_meta->rect_params.width;
+        w.height = obj_meta->rect_params.height;
+    }
+    return w;
+}
+
+// Streaming thread side of the offload mode: copy and return
+static void queueBatch(ProbeContext *ctx, NvDsBatchMeta *batch_meta) {
+    for (NvDsMetaList *l_frame = batch_meta->frame_meta_list; l_frame != nullptr; l_frame = l_frame->next) {
+        NvDsFrameMeta *frame_meta = (NvDsFrameMeta *)(l_frame->data);
+        if (frame_meta->source_id >= ctx->camera_count) {
+            continue;  // a tile, merged onto its camera's frame
+        }
+        uint16_t count = static_cast<uint16_t>(frame_meta->num_obj_meta);
+        ctx->frames_total->add();
+        ctx->objects_total->add(count);
+        ctx->objects_per_frame->observe(count);
+        if (count == 0 || frame_meta->obj_meta_list == nullptr) {
+            ctx->queue->push(makeObjectWork(frame_meta, nullptr, 0, 0));
+            continue;
+        }
+
+        uint16_t index = 0;
+        for (NvDsMetaList *l_obj = frame_meta->obj_meta_list; l_obj != nullptr; l_obj = l_obj->next) {
+            ctx->queue->push(makeObjectWork(frame_meta, (NvDsObjectMeta *)(l_obj->data), index++, count));
+        }
+    }
+}
+
+// Worker side: transform one frame with the camera of its source and publish it like the inline path (above-horizon
+// objects dropped, index and count renumbered). Objects lost to the queue policy are simply missing from the frame.
+static void processQueuedFrame(ProbeContext *ctx, const RuntimeConfig &rt, const std::vector<ObjectWork> &frame,
+                               ObjectBatch &buf) {
+    size_t n = frame[0].count == 0 ? 0 : frame.size();
+    buf.px.resize(n);
+    buf.py.resize(n);
+    buf.wx.resize(n);
+    buf.wy.resize(n);
+    buf.valid.assign(n, 1);
+    for (size_t i = 0; i < n; ++i) {
+        buf.px[i] = frame[i].left + frame[i].width / 2.0f;
+        buf.py[i] = frame[i].top + frame[i].height / 2.0f;
+    }
+
+    const CameraView *cam = rt.cameras.forSource(frame[0].source_id);
+    if (cam) {
+        cam->transform(buf.px.data(), buf.py.data(), buf.wx.data(), buf.wy.data(), buf.valid.data(), n);
+    } else {
+        buf.valid.assign(n, 0);
+    }
+
+    if (!ctx->zones.empty()) {
+        ctx->zones.beginFrame(frame[0].source_id, shmRingNowNs());
+        for (size_t i = 0; i < n; ++i) {
+            if (buf.valid[i]) {
+                ctx->zones.add(frame[i].object_id, buf.wx[i], buf.wy[i]);
+            }
+        }
+        ctx->zones.endFrame();
+        reportZoneEvents(ctx);
+    }
+
+    if (!exportsDetections(ctx)) {
+        return;
+    }
+
+    DetectionRecord rec = {};
+    rec.timestamp_ns = frame[0].timestamp_ns;
+    rec.publish_ns = shmRingNowNs();
+    rec.frame_number = frame[0].frame_number;
+    rec.source_id = frame[0].source_id;
+    for (size_t i = 0; i < n; ++i) {
+        rec.count += buf.valid[i];
+    }
+
+    if (rec.count == 0) {
+        rec.class_id = -1;
+        exportDetection(ctx, rec);
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        if (!buf.valid[i]) {
+            continue;
+        }
+        const ObjectWork &w = frame[i];
+        rec.class_id = w.class_id;
+        rec.confidence = w.confidence;
+        rec.world_x = buf.wx[i];
+        rec.world_y = buf.wy[i];
+        rec.left = w.left;
+        rec.top = w.top;
+        rec.width = w.width;
+        rec.height = w.height;
+        if (cam) {
+            cam->boxToCamera(rec.left, rec.top, rec.width, rec.height);
+        }
+        exportDetection(ctx, rec);
+        ++rec.index;
+    }
+}
+
+static void offloadWorker(ProbeContext *ctx) {
+    std::vector<ObjectWork> items(256);
+    std::vector<ObjectWork> frame;
+    ObjectBatch buf;
+    unsigned idle = 0;
+    // Each frame is transformed with the snapshot current when it is processed, pinned only for that frame
+    auto flush = [ctx, &frame, &buf]() {
+        PinnedSnapshot<RuntimeConfig> rt(ctx->runtime, ctx->worker_reader);
+        processQueuedFrame(ctx, *rt, frame, buf);
+        frame.clear();
+    };
+
+    while (!ctx->stop_worker.load(std::memory_order_relaxed)) {
+        size_t n = ctx->queue->pop(items.data(), items.size());
+        if (n == 0) {
+            // A frame whose last objects were dropped is flushed once the queue stays empty
+            if (!frame.empty() && idle == 1024) {
+                flush();
+            }
+            spscBackoff(idle++);
+            continue;
+        }
+        idle = 0;
+
+        for (size_t i = 0; i < n; ++i) {
+            const ObjectWork &w = items[i];
+            if (!frame.empty() && (w.frame_number != frame[0].frame_number || w.source_id != frame[0].source_id)) {
+                flush();
+            }
+            frame.push_back(w);
+            if (w.count == 0 || w.index + 1 == w.count) {
+                flush();
+            }
+        }
+    }
+}
+
+static gboolean printQueueStats(gpointer user_data) {
+    ProbeContext *ctx = static_cast<ProbeContext *>(user_data);
+    QueueCounters c = ctx->queue->counters();
+    const QueueCounters &l = ctx->last_counters;
+    std::cout << "Offload queue: " << c.pushed - l.pushed << " queued, " << c.popped - l.popped << " processed, "
+              << c.dropped_newest - l.dropped_newest << " dropped newest, " << c.dropped_oldest - l.dropped_oldest
+              << " dropped oldest, " << c.blocked - l.blocked << " blocked pushes, " << ctx->queue->size()
+              << " waiting\n";
+    ctx->last_counters = c;
+    return TRUE;
+}
+
+// Object meta for a track predicted on a frame nvinfer skipped, drawn like a detection
+static void addTrackedObject(NvDsBatchMeta *batch_meta, NvDsFrameMeta *frame_meta, const TrackOutput &t) {
+    NvDsObjectMeta *obj_meta = nvds_acquire_obj_meta_from_pool(batch_meta);
+    if (!obj_meta) {
+        return;
+    }
+    obj_meta->unique_component_id = -1;
+    obj_meta->class_id = t.class_id;
+    obj_meta->object_id = t.track_id;
+    obj_meta->confidence = t.confidence;
+    obj_meta->tracker_confidence = t.confidence;
+
+    NvOSD_RectParams &rect = obj_meta->rect_params;
+    rect.left = t.box.left;
+    rect.top = t.box.top;
+    rect.width = t.box.width;
+    rect.height = t.box.height;
+    rect.border_width = 3;
+    rect.border_color = NvOSD_ColorParams{1.0, 0.0, 0.0, 1.0};
+    rect.has_bg_color = 0;
+    obj_meta->tracker_bbox_info.org_bbox_coords = rect;
+
+    NvOSD_TextParams &text = obj_meta->text_params;
+    text.display_text = nullptr;
+    text.x_offset = static_cast<unsigned int>(std::max(t.box.left, 0.0f));
+    text.y_offset = static_cast<unsigned int>(std::max(t.box.top - 10.0f, 0.0f));
+    text.font_params.font_name = (char *)"Serif";
+    text.font_params.font_size = 10;
+    text.font_params.font_color = NvOSD_ColorParams{1.0, 1.0, 1.0, 1.0};
+    text.set_bg_clr = 1;
+    text.text_bg_clr = NvOSD_ColorParams{0.0, 0.0, 0.0, 1.0};
+
+    nvds_add_obj_meta_to_frame(frame_meta, obj_meta, nullptr);
+}
+
+// Runs before the transform: frames with inference get track ids on their objects, frames nvinfer skipped get the
+// predicted confirmed tracks as objects, so the rest of the probe sees every frame populated
+static void trackBatch(ProbeContext *ctx, NvDsBatchMeta *batch_meta) {
+    size_t active = 0;
+    uint64_t created = 0;
+    for (NvDsMetaList *l_frame = batch_meta->frame_meta_list; l_frame != nullptr; l_frame = l_frame->next) {
+        NvDsFrameMeta *frame_meta = (NvDsFrameMeta *)(l_frame->data);
+        if (frame_meta->source_id >= ctx->trackers.size()) {
+            continue;
+        }
+        Tracker &tracker = ctx->trackers[frame_meta->source_id];
+        uint64_t created_before = tracker.created();
+
+        if (frame_meta->bInferDone) {
+            size_t n = 0;
+            for (NvDsMetaList *l_obj = frame_meta->obj_meta_list; l_obj != nullptr && n < ctx->track_dets.size();
+                 l_obj = l_obj->next) {
+                NvDsObjectMeta *obj_meta = (NvDsObjectMeta *)(l_obj->data);
+                TrackerDetection &d = ctx->track_dets[n];
+                d.box = TrackBox{obj_meta->rect_params.left, obj_meta->rect_params.top, obj_meta->rect_params.width,
+                                 obj_meta->rect_params.height};
+                d.class_id = obj_meta->class_id;
+                d.confidence = obj_meta->confidence;
+                ctx->track_objs[n++] = obj_meta;
+            }
+            tracker.update(ctx->track_dets.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                ctx->track_objs[i]->object_id = ctx->track_dets[i].track_id;
+            }
+        } else {
+            tracker.predict();
+            size_t n = tracker.output(ctx->track_out.data(), ctx->track_out.size());
+            for (size_t i = 0; i < n; ++i) {
+                addTrackedObject(batch_meta, frame_meta, ctx->track_out[i]);
+            }
+            ctx->predicted_objects_total->add(n);
+        }
+        created += tracker.created() - created_before;
+    }
+    for (const Tracker &tracker : ctx->trackers) {
+        active += tracker.active();
+    }
+    ctx->tracks_active->set(static_cast<int64_t>(active));
+    ctx->tracks_created_total->add(created);
+}
+
+// Copy of a tile object on its camera's own frame, with its own copy of nvinfer's label
+static NvDsObjectMeta *copyObjectToFrame(NvDsBatchMeta *batch_meta, NvDsFrameMeta *frame_meta,
+                                         const NvDsObjectMeta *src) {
+    NvDsObjectMeta *obj_meta = nvds_acquire_obj_meta_from_pool(batch_meta);
+    if (!obj_meta) {
+        return nullptr;
+    }
+    obj_meta->unique_component_id = src->unique_component_id;
+    obj_meta->class_id = src->class_id;
+    obj_meta->object_id = src->object_id;
+    obj_meta->confidence = src->confidence;
+    obj_meta->detector_bbox_info = src->detector_bbox_info;
+    obj_meta->rect_params = src->rect_params;
+    obj_meta->text_params = src->text_params;
+    obj_meta->text_params.display_text =
+        src->text_params.display_text ? g_strdup(src->text_params.display_text) : nullptr;
+    std::memcpy(obj_meta->obj_label, src->obj_label, sizeof(obj_meta->obj_label));
+    nvds_add_obj_meta_to_frame(frame_meta, obj_meta, nullptr);
+    return obj_meta;
+}
+
+// Runs first on the osd sink pad: the detections of each tiled camera frame (its own, downscaled frame and its tiles,
+// same PTS) are merged in camera pixels and left on the camera's own frame in its nvstreammux pixels, so everything
+// after sees one frame per camera. Tile frames end up without objects. Tiles whose camera frame is not in the batch
+// (an nvstreammux timeout split the teed frame) keep their objects, which nothing reads.
+static void mergeTiles(ProbeContext *ctx, const RuntimeConfig &rt, NvDsBatchMeta *batch_meta) {
+    const size_t cameras = ctx->camera_count;
+    ctx->tile_merger.setConfig(rt.cfg.tile_merge_cfg);
+    ctx->tile_frames.clear();
+    for (NvDsMetaList *l_frame = batch_meta->frame_meta_list; l_frame != nullptr; l_frame = l_frame->next) {
+        NvDsFrameMeta *frame_meta = (NvDsFrameMeta *)(l_frame->data);
+        if (frame_meta->source_id < cameras && !ctx->tiles[frame_meta->source_id].empty()) {
+            ctx->tile_frames.push_back(frame_meta);
+        }
+    }
+
+    uint64_t merged = 0;
+    for (NvDsFrameMeta *own : ctx->tile_frames) {
+        const uint32_t camera = own->source_id;
+        const CameraView &cam = rt.cameras[camera];
+        std::vector<MergeBox> &boxes = ctx->merge_boxes;
+        boxes.clear();
+        ctx->merge_objs.clear();
+        auto add = [ctx, &boxes](NvDsFrameMeta *frame_meta, int32_t tile) {
+            for (NvDsMetaList *l_obj = frame_meta->obj_meta_list; l_obj != nullptr; l_obj = l_obj->next) {
+                NvDsObjectMeta *obj_meta = (NvDsObjectMeta *)(l_obj->data);
+                const NvOSD_RectParams &r = obj_meta->rect_params;
+                boxes.push_back(MergeBox{r.left, r.top, r.width, r.height, obj_meta->confidence, obj_meta->class_id,
+                                         tile});
+                ctx->merge_objs.emplace_back(obj_meta, frame_meta);
+            }
+        };
+        add(own, -1);
+        for (MergeBox &b : boxes) {
+            cam.boxToCamera(b.left, b.top, b.width, b.height);
+        }
+        for (NvDsMetaList *l_frame = batch_meta->frame_meta_list; l_frame != nullptr; l_frame = l_frame->next) {
+            NvDsFrameMeta *frame_meta = (NvDsFrameMeta *)(l_frame->data);
+            size_t pad = frame_meta->source_id;
+            if (pad < cameras || pad - cameras >= ctx->tile_pads.size() || frame_meta->buf_pts != own->buf_pts ||
+                ctx->tile_pads[pad - cameras].first != camera) {
+                continue;
+            }
+            uint32_t tile = ctx->tile_pads[pad - cameras].second;
+            size_t first = boxes.size();
+            add(frame_meta, static_cast<int32_t>(tile));
+            for (size_t i = first; i < boxes.size(); ++i) {
+                tileBoxToFrame(ctx->tiles[camera][tile], ctx->mux_width, ctx->mux_height, boxes[i].left, boxes[i].top,
+                               boxes[i].width, boxes[i].height);
+            }
+        }
+
+        size_t n = boxes.size();
+        ctx->merge_keep.resize(n);
+        size_t kept = ctx->tile_merger.merge(ctx->tiles[camera], ctx->tile_regions[camera], boxes.data(), n,
+                                             ctx->merge_keep.data());
+        ctx->merge_kept.assign(n, 0);
+        for (size_t k = 0; k < kept; ++k) {
+            ctx->merge_kept[ctx->merge_keep[k]] = 1;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            NvDsObjectMeta *obj_meta = ctx->merge_objs[i].first;
+            NvDsFrameMeta *frame_meta = ctx->merge_objs[i].second;
+            if (!ctx->merge_kept[i]) {
+                nvds_remove_obj_meta_from_frame(frame_meta, obj_meta);
+                continue;
+            }
+            if (frame_meta != own) {
+                NvDsObjectMeta *copy = copyObjectToFrame(batch_meta, own, obj_meta);
+                nvds_remove_obj_meta_from_frame(frame_meta, obj_meta);
+                if (!copy) {
+                    continue;
+                }
+                obj_meta = copy;
+            }
+            MergeBox b = boxes[i];
+            cam.boxToMux(b.left, b.top, b.width, b.height);
+            NvOSD_RectParams &rect = obj_meta->rect_params;
+            rect.left = b.left;
+            rect.top = b.top;
+            rect.width = b.width;
+            rect.height = b.height;
+            obj_meta->confidence = b.confidence;
+            obj_meta->text_params.x_offset = static_cast<unsigned int>(std::max(b.left, 0.0f));
+            obj_meta->text_params.y_offset = static_cast<unsigned int>(std::max(b.top - 10.0f, 0.0f));
+        }
+        merged += n - kept;
+    }
+    ctx->tile_merged_total->add(merged);
+}
+
+// Sources share PTS values, the top byte keeps their frames apart
+static uint64_t frameLatencyKey(uint64_t pts, uint32_t source) { return pts + (static_cast<uint64_t>(source) << 56); }
+
+static GstPadProbeReturn mux_sink_pad_buffer_probe(GstPad *, GstPadProbeInfo *info, gpointer user_data) {
+    MuxSinkProbe *probe = static_cast<MuxSinkProbe *>(user_data);
+    ProbeContext *ctx = probe->ctx;
+    GstBuffer *buf = GST_PAD_PROBE_INFO_BUFFER(info);
+    if (!buf) {
+        return GST_PAD_PROBE_OK;
+    }
+    int keep = ctx->keep_one_in.load(std::memory_order_relaxed);
+    if (keep > 1 && probe->frames++ % keep != 0) {
+        return GST_PAD_PROBE_DROP;
+    }
+    if (GST_BUFFER_PTS_IS_VALID(buf)) {
+        ctx->frame_latency.onBuffer(ctx->latency_mux_stage, frameLatencyKey(GST_BUFFER_PTS(buf), probe->source),
+                                    latencyNowNs());
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+static void stampFrameLatency(ProbeContext *ctx, NvDsBatchMeta *batch_meta) {
+    uint64_t now_ns = latencyNowNs();
+    for (NvDsMetaList *l_frame = batch_meta->frame_meta_list; l_frame != NULL; l_frame = l_frame->next) {
+        NvDsFrameMeta *frame_meta = (NvDsFrameMeta *)(l_frame->data);
+        ctx->frame_latency.onBuffer(ctx->latency_osd_stage, frameLatencyKey(frame_meta->buf_pts, frame_meta->source_id),
+                                    now_ns);
+    }
+}
+
+// One control window: p95 frame latency, offload queue depth and objects per frame in, nvinfer interval out
+static gboolean interval_control_cb(gpointer user_data) {
+    ProbeContext *ctx = static_cast<ProbeContext *>(user_data);
+    LatencyHistogram::Snapshot latency = ctx->frame_latency.sinceSource(ctx->latency_osd_stage);
+    LatencyHistogram::Snapshot window = latency.since(ctx->latency_seen);
+    ctx->latency_seen = latency;
+
+    uint64_t frames = ctx->frames_total->value(), objects = ctx->objects_total->value();
+    IntervalSample sample;
+    sample.frames = window.count;
+    sample.latency_p95_ms = window.quantile(0.95) / 1e6;
+    sample.queue_depth = ctx->queue ? static_cast<double>(ctx->queue->size()) : 0.0;
+    if (frames > ctx->control_frames) {
+        sample.objects_per_frame = double(objects - ctx->control_objects) / double(frames - ctx->control_frames);
+    }
+    ctx->control_frames = frames;
+    ctx->control_objects = objects;
+
+    IntervalDecision d = ctx->interval_controller.update(sample);
+    if (d.changed) {
+        ctx->infer_interval.store(d.interval, std::memory_order_relaxed);
+        if (ctx->motion.empty()) {
+            g_object_set(G_OBJECT(ctx->infer), "interval", d.interval, NULL);  // else the motion gate applies it
+        }
+        ctx->keep_one_in.store(d.keep_one_in, std::memory_order_relaxed);
+        ctx->inference_interval->set(d.interval);
+        ctx->source_keep_one_in->set(d.keep_one_in);
+        std::cout << "Inference interval " << d.interval << ", keep 1/" << d.keep_one_in << " frames (p95 "
+                  << sample.latency_p95_ms << " ms, load " << d.load << ", " << sample.objects_per_frame
+                  << " objects/frame)\n";
+    }
+    if (ctx->interval_log) {
+        std::fprintf(ctx->interval_log, "%.3f,%.3f,%.3f,%.0f,%llu,%.3f,%d,%d\n", g_get_monotonic_time() / 1e6,
+                     sample.objects_per_frame, sample.latency_p95_ms, sample.queue_depth,
+                     static_cast<unsigned long long>(sample.frames), d.load, d.interval, d.keep_one_in);
+        std::fflush(ctx->interval_log);
+    }
+    return TRUE;
+}
+
+static GstPadProbeReturn source_motion_probe(GstPad *, GstPadProbeInfo *info, gpointer user_data) {
+    SourceMotion *m = static_cast<SourceMotion *>(user_data);
+    if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
+        GstEvent *event = GST_PAD_PROBE_INFO_EVENT(info);
+        if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+            GstCaps *caps = nullptr;
+            gst_event_parse_caps(event, &caps);
+            m->supported = caps && gst_video_info_from_caps(&m->info, caps) &&
+                           (GST_VIDEO_INFO_IS_YUV(&m->info) || GST_VIDEO_INFO_IS_GRAY(&m->info)) &&
+                           GST_VIDEO_INFO_COMP_DEPTH(&m->info, 0) == 8;
+            m->motion.store(true, std::memory_order_relaxed);
+        }
+        return GST_PAD_PROBE_OK;
+    }
+
+    GstBuffer *buf = GST_PAD_PROBE_INFO_BUFFER(info);
+    GstVideoFrame frame;
+    if (!buf || !m->supported || !gst_video_frame_map(&frame, &m->info, buf, GST_MAP_READ)) {
+        return GST_PAD_PROBE_OK;
+    }
+    const uint8_t *luma = static_cast<const uint8_t *>(GST_VIDEO_FRAME_COMP_DATA(&frame, 0));
+    int stride = GST_VIDEO_FRAME_COMP_STRIDE(&frame, 0), pixel_step = GST_VIDEO_FRAME_COMP_PSTRIDE(&frame, 0);
+    MotionResult r = m->detector.update(luma, GST_VIDEO_FRAME_WIDTH(&frame), GST_VIDEO_FRAME_HEIGHT(&frame), stride,
+                                        pixel_step);
+    gst_video_frame_unmap(&frame);
+    bool inside = m->crop_width == 0 || (r.x1 > m->crop_x && r.x0 < m->crop_x + m->crop_width &&
+                                         r.y1 > m->crop_y && r.y0 < m->crop_y + m->crop_height);
+    m->motion.store(r.motion && inside, std::memory_order_relaxed);
+    return GST_PAD_PROBE_OK;
+}
+
+// Not in nvinfer's batch counter cycle for the next 2^31 batches, so nvinfer skips the batch
+static const int kGatedInterval = G_MAXINT - 1;
+
+// Runs on the streaming thread right before nvinfer takes the batch, so the interval set here decides this batch:
+// nvinfer infers a batch when its batch counter modulo (interval + 1) is 0. Skipped frames keep bInferDone = false,
+// the trackers predict them and their tracks age out.
+static GstPadProbeReturn infer_sink_pad_buffer_probe(GstPad *, GstPadProbeInfo *, gpointer user_data) {
+    ProbeContext *ctx = static_cast<ProbeContext *>(user_data);
+    int moving = 0;
+    for (const SourceMotion &m : ctx->motion) {
+        moving += m.motion.load(std::memory_order_relaxed);
+    }
+    ctx->sources_in_motion->set(moving);
+
+    bool run = ctx->motion_gate.infer(moving > 0);
+    int interval = run ? ctx->infer_interval.load(std::memory_order_relaxed) : kGatedInterval;
+    if (interval != ctx->applied_interval) {
+        g_object_set(G_OBJECT(ctx->infer), "interval", interval, NULL);
+        ctx->applied_interval = interval;
+    }
+    if (!run) {
+        ctx->gated_batches_total->add();
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+static void clearLabel(NvDsObjectMeta *obj_meta) {
+    NvOSD_TextParams &text = obj_meta->text_params;
+    g_free(text.display_text);  // label set by nvinfer
+    text.display_text = nullptr;
+}
+
+// overlay = "boxes": nvdsosd draws the boxes without any text
+static void clearLabels(NvDsBatchMeta *batch_meta) {
+    for (NvDsMetaList *l_frame = batch_meta->frame_meta_list; l_frame != NULL; l_frame = l_frame->next) {
+        NvDsFrameMeta *frame_meta = (NvDsFrameMeta *)(l_frame->data);
+        for (NvDsMetaList *l_obj = frame_meta->obj_meta_list; l_obj != NULL; l_obj = l_obj->next) {
+            clearLabel((NvDsObjectMeta *)(l_obj->data));
+        }
+    }
+}
+
+static GstPadProbeReturn osd_sink_pad_buffer_probe(GstPad *, GstPadProbeInfo *info, gpointer user_data) {
+    ProbeContext *ctx = static_cast<ProbeContext *>(user_data);
+    uint64_t start_ns = latencyNowNs();
 
     GstBuffer *buf = (GstBuffer *)info->data;
     NvDsBatchMeta *batch_meta = gst_buffer_get_nvds_batch_meta(buf);
@@ -30,98 +803,654 @@ static GstPadProbeReturn osd_sink_pad_buffer_probe(GstPad *pad, GstPadProbeInfo
         return GST_PAD_PROBE_OK;
     }
 
-    for (NvDsMetaList *l_frame = batch_meta->frame_meta_list; l_frame != nullptr; l_frame = l_frame->next) {
-        NvDsFrameMeta *frame_meta = (NvDsFrameMeta *)(l_frame->data);
+    if (ctx->latency_osd_stage >= 0) {
+        stampFrameLatency(ctx, batch_meta);
+    }
+    // Calibration and thresholds of this batch, however many reloads happen meanwhile
+    PinnedSnapshot<RuntimeConfig> rt(ctx->runtime, ctx->osd_reader);
+    const CameraConfig &cfg = rt->cfg;
+    if (!ctx->tile_pads.empty()) {
+        mergeTiles(ctx, *rt, batch_meta);
+    }
+    if (!ctx->trackers.empty()) {
+        trackBatch(ctx, batch_meta);
+    }
+    if (cfg.overlay.mode == OverlayMode::Boxes) {
+        clearLabels(batch_meta);
+    }
 
-        for (NvDsMetaList *l_obj = frame_meta->obj_meta_list; l_obj != nullptr; l_obj = l_obj->next) {
-            NvDsObjectMeta *obj_meta = (NvDsObjectMeta *)(l_obj->data);
+    if (ctx->queue) {
+        queueBatch(ctx, batch_meta);
+        ctx->probe_seconds->observe(latencyNowNs() - start_ns);
+        return GST_PAD_PROBE_OK;
+    }
 
-            float cx = obj_meta->rect_params.left + obj_meta->rect_params.width / 2.0f;
-            float cy = obj_meta->rect_params.top + obj_meta->rect_params.height / 2.0f;
+    // Transform every object of the batch with the camera of its source, export the records, then scatter the world
+    // meta and the labels
+    ProbeProcessor &proc = ctx->processor;
+    size_t n = proc.transform(batch_meta, rt->cameras, [ctx](NvDsFrameMeta *frame_meta) {
+        if (frame_meta->source_id < ctx->camera_count) {
+            ctx->frames_total->add();
+            ctx->objects_per_frame->observe(frame_meta->num_obj_meta);
+        }
+    });
+    ctx->objects_total->add(n);
+    const ObjectBatch &ob = proc.batch();
 
-            auto [wx, wy] = imageToWorld(cx, cy, cfg->width, cfg->height, cfg->fov_x, cfg->fov_y, cfg->pos_x, cfg->pos_y);
+    if (!ctx->zones.empty()) {
+        updateZones(ctx, ob, batch_meta);
+    }
+    if (exportsDetections(ctx)) {
+        proc.exportDetections(batch_meta, rt->cameras, ctx->camera_count, shmRingNowNs(),
+                              [ctx](const DetectionRecord &rec) { exportDetection(ctx, rec); });
+    }
+    if (cfg.world_meta) {
+        for (size_t i = 0; i < n; ++i) {
+            if (ob.valid[i]) {
+                attachWorldCoordMeta(ctx, *rt, batch_meta, i);
+            }
+        }
+    }
+
+    // Labels of a buffer that never reached the osd src pad were freed with the buffer meta
+    ctx->labels_in_flight.clear();
+    ctx->labels_buffer = buf;
+    if (proc.labels()) {
+        static_assert(LabelPool::kLabelSize >= LabelCache::kLabelSize, "labels are formatted into pool buffers");
+        ProbeProcessor::LabelStats stats = proc.label(
+            [ctx]() {
+                return ctx->pooled_labels ? ctx->labels.acquire() : (char *)g_malloc0(LabelCache::kLabelSize);
+            },
+            [ctx](NvDsObjectMeta *obj_meta, char *label) {
+                NvOSD_TextParams &text = obj_meta->text_params;
+                g_free(text.display_text);  // label set by nvinfer
+                text.display_text = label;
+                if (label && ctx->pooled_labels) {
+                    ctx->labels_in_flight.emplace_back(obj_meta, label);
+                }
+            });
+        ctx->osd_labels_total->add(stats.drawn);
+        ctx->osd_labels_reused_total->add(stats.reused);
+    }
+
+    ctx->probe_seconds->observe(latencyNowNs() - start_ns);
+    return GST_PAD_PROBE_OK;
+}
+
+// nvdsosd has drawn the labels: return them to the pool and clear display_text so the meta release does not free them
+static GstPadProbeReturn osd_src_pad_buffer_probe(GstPad *, GstPadProbeInfo *info, gpointer user_data) {
+    ProbeContext *ctx = static_cast<ProbeContext *>(user_data);
 
-            char *label = (char *)g_malloc0(64);
-            snprintf(label, 64, "X:%.2f Y:%.2f", wx, wy);
-            obj_meta->text_params.display_text = label;
+    GstBuffer *buf = (GstBuffer *)info->data;
+    if (buf != ctx->labels_buffer) {
+        return GST_PAD_PROBE_OK;
+    }
+
+    for (const auto &entry : ctx->labels_in_flight) {
+        NvOSD_TextParams &text = entry.first->text_params;
+        if (text.display_text == entry.second) {
+            text.display_text = nullptr;
+            ctx->labels.release(entry.second);
         }
     }
+    ctx->labels_in_flight.clear();
+    ctx->labels_buffer = nullptr;
 
     return GST_PAD_PROBE_OK;
 }
 
+// Parse stats of the custom bbox parser lib, looked up on the metrics thread once nvinfer has loaded the lib
+struct ParserStatsSource {
+    std::string path;
+    void *handle = nullptr;
+    NvDsInferYoloParseStatsFunc stats = nullptr;
+
+    bool read(NvDsInferYoloParseStatsData &data) {
+        if (!stats) {
+            if (path.empty()) {
+                return false;  // dlopen("") is the executable
+            }
+            handle = dlopen(path.c_str(), RTLD_LAZY | RTLD_NOLOAD);  // never loads a second copy
+            if (!handle) {
+                return false;
+            }
+            stats = reinterpret_cast<NvDsInferYoloParseStatsFunc>(dlsym(handle, "NvDsInferYoloParseStats"));
+            if (!stats) {
+                return false;  // lib built without parse stats
+            }
+        }
+        stats(&data);
+        return true;
+    }
+};
+
+static void registerMetrics(ProbeContext &ctx, ParserStatsSource &parser, const PipelineTracer *latency) {
+    MetricsRegistry &m = ctx.metrics;
+    ctx.frames_total = &m.counter("frames_total", "Frames seen by the overlay probe (rate() = FPS)");
+    ctx.objects_total = &m.counter("objects_total", "Objects seen by the overlay probe");
+    ctx.qos_dropped_total = &m.counter("qos_dropped_buffers_total", "Buffers dropped by pipeline elements (QoS)");
+    ctx.objects_per_frame = &m.histogram("objects_per_frame", "Objects per frame",
+                                         {0, 1, 2, 5, 10, 20, 50, 100, 200, 500});
+    ctx.probe_seconds = &m.histogram("probe_seconds", "Time spent in the overlay probe per batch",
+                                     {10000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000},
+                                     1e-9);
+    ctx.tracks_active = &m.gauge("tracks_active", "Tracks alive in the probe trackers");
+    ctx.tracks_created_total = &m.counter("tracks_created_total", "Tracks started by the probe trackers");
+    ctx.predicted_objects_total = &m.counter("predicted_objects_total",
+                                             "Objects drawn from track predictions on frames without inference");
+    ctx.inference_interval = &m.gauge("inference_interval", "nvinfer interval, frames skipped between inferences");
+    ctx.source_keep_one_in = &m.gauge("source_keep_one_in", "Frames kept per source, 1 in N (adaptive interval)");
+    ctx.gated_batches_total = &m.counter("gated_batches_total", "Batches not inferred because no source moved");
+    ctx.sources_in_motion = &m.gauge("sources_in_motion", "Sources whose last frame moved (motion gate)");
+    ctx.tile_merged_total = &m.counter("tile_merged_objects_total",
+                                       "Tile and full-frame detections merged into another one (tiled inference)");
+    ctx.config_reloads_total = &m.counter("config_reloads_total", "config.toml changes applied without a restart");
+    ctx.config_reload_failures_total =
+        &m.counter("config_reload_failures_total", "config.toml changes rejected, the running configuration kept");
+    ctx.osd_labels_total = &m.counter("osd_labels_total", "X/Y labels handed to nvdsosd");
+    ctx.osd_labels_reused_total =
+        &m.counter("osd_labels_reused_total", "X/Y labels copied from the cache between label_every refreshes");
+
+    const std::string prefix = m.prefix();
+    m.addCollector([&ctx, prefix](std::string &out) {
+        if (!ctx.queue) {
+            return;
+        }
+        QueueCounters c = ctx.queue->counters();
+        std::string name = prefix + "offload_dropped_objects_total";
+        appendMetricHeader(out, name, "counter", "Objects dropped by the offload queue policy");
+        appendMetricSample(out, name, metricLabel("end", "newest"), static_cast<double>(c.dropped_newest));
+        appendMetricSample(out, name, metricLabel("end", "oldest"), static_cast<double>(c.dropped_oldest));
+        name = prefix + "offload_queue_objects";
+        appendMetricHeader(out, name, "gauge", "Objects waiting for the offload worker");
+        appendMetricSample(out, name, "", static_cast<double>(ctx.queue->size()));
+    });
+
+    m.addCollector([&ctx, prefix](std::string &out) {
+        if (!ctx.detection_log.isOpen()) {
+            return;
+        }
+        DetectionLogCounters c = ctx.detection_log.counters();
+        std::string name = prefix + "detection_log_records_total";
+        appendMetricHeader(out, name, "counter", "Detection records handed to the on-disk log");
+        appendMetricSample(out, name, metricLabel("state", "written"), static_cast<double>(c.written));
+        appendMetricSample(out, name, metricLabel("state", "dropped"), static_cast<double>(c.dropped));
+        name = prefix + "detection_log_write_errors_total";
+        appendMetricHeader(out, name, "counter", "Failed detection log writes (the batch is lost)");
+        appendMetricSample(out, name, "", static_cast<double>(c.write_errors));
+    });
+
+    m.addCollector([&ctx, prefix](std::string &out) {
+        const ZoneEngine &zones = ctx.zones;
+        if (zones.empty()) {
+            return;
+        }
+        struct Column {
+            const char *name, *type, *help;
+            double (*value)(const ZoneCounters &);
+        };
+        static const Column columns[] = {
+            {"zone_objects", "gauge", "Objects in the zone on the last frame of every source",
+             [](const ZoneCounters &c) { return static_cast<double>(c.occupancy); }},
+            {"zone_entries_total", "counter", "Tracked objects that entered the zone",
+             [](const ZoneCounters &c) { return static_cast<double>(c.entries); }},
+            {"zone_intrusions_total", "counter", "Entries into an intrusion zone",
+             [](const ZoneCounters &c) { return static_cast<double>(c.intrusions); }},
+            {"zone_loiters_total", "counter", "Objects that stayed longer than the zone's max_dwell",
+             [](const ZoneCounters &c) { return static_cast<double>(c.loiters); }},
+        };
+        for (const Column &col : columns) {
+            std::string name = prefix + col.name;
+            appendMetricHeader(out, name, col.type, col.help);
+            for (size_t z = 0; z < zones.size(); ++z) {
+                appendMetricSample(out, name, metricLabel("zone", zones.zone(z).name), col.value(zones.counters(z)));
+            }
+        }
+        std::string name = prefix + "zone_dwell_seconds";
+        appendMetricHeader(out, name, "summary", "Time tracked objects spent in the zone, counted when they leave");
+        for (size_t z = 0; z < zones.size(); ++z) {
+            ZoneCounters c = zones.counters(z);
+            std::string label = metricLabel("zone", zones.zone(z).name);
+            appendMetricSample(out, name + "_sum", label, c.dwell_sum_s);
+            appendMetricSample(out, name + "_count", label, static_cast<double>(c.dwell_count));
+        }
+    });
+
+    m.addCollector([&parser, prefix](std::string &out) {
+        NvDsInferYoloParseStatsData p;
+        if (!parser.read(p)) {
+            return;
+        }
+        std::string name = prefix + "parser_calls_total";
+        appendMetricHeader(out, name, "counter", "Calls of the bbox parser");
+        appendMetricSample(out, name, "", static_cast<double>(p.calls));
+        name = prefix + "parser_failures_total";
+        appendMetricHeader(out, name, "counter", "Failed calls of the bbox parser");
+        appendMetricSample(out, name, "", static_cast<double>(p.failures));
+        name = prefix + "parser_objects_total";
+        appendMetricHeader(out, name, "counter", "Objects returned by the bbox parser");
+        appendMetricSample(out, name, "", static_cast<double>(p.objects));
+        name = prefix + "parser_seconds_total";
+        appendMetricHeader(out, name, "counter", "Time spent in the bbox parser");
+        appendMetricSample(out, name, "", p.totalNs * 1e-9);
+        name = prefix + "parser_max_seconds";
+        appendMetricHeader(out, name, "gauge", "Slowest bbox parser call");
+        appendMetricSample(out, name, "", p.maxNs * 1e-9);
+    });
+
+    if (!latency) {
+        return;
+    }
+    // Latency trace histograms as summaries, one series per element
+    m.addCollector([latency, prefix](std::string &out) {
+        const LatencyTracer &t = latency->tracer;
+        const char *names[2] = {"stage_latency_seconds", "since_source_seconds"};
+        const char *help[2] = {"Time from the previous element to this one", "Time from the source to this element"};
+        for (int kind = 0; kind < 2; ++kind) {
+            std::string name = prefix + names[kind];
+            appendMetricHeader(out, name, "summary", help[kind]);
+            for (size_t i = 0; i < t.stageCount(); ++i) {
+                int stage = static_cast<int>(i);
+                LatencyHistogram::Snapshot h = kind == 0 ? t.sincePrevious(stage) : t.sinceSource(stage);
+                if (h.count == 0) {
+                    continue;
+                }
+                std::string label = metricLabel("stage", t.stageName(stage));
+                for (double q : {0.5, 0.9, 0.99, 0.999}) {
+                    char quantile[32];
+                    snprintf(quantile, sizeof(quantile), ",quantile=\"%g\"", q);
+                    appendMetricSample(out, name, label + quantile, h.quantile(q) * 1e-9);
+                }
+                appendMetricSample(out, name + "_sum", label, h.sum * 1e-9);
+                appendMetricSample(out, name + "_count", label, static_cast<double>(h.count));
+            }
+        }
+    });
+}
+
+static gboolean bus_qos_cb(GstBus *, GstMessage *msg, gpointer user_data) {
+    if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_QOS) {
+        ProbeContext *ctx = static_cast<ProbeContext *>(user_data);
+        GstFormat format;
+        guint64 processed = 0, dropped = 0;
+        gst_message_parse_qos_stats(msg, &format, &processed, &dropped);
+        // Each QoS message carries the element's running total of dropped buffers; count the new ones
+        if (format == GST_FORMAT_BUFFERS && dropped != static_cast<guint64>(-1)) {
+            guint64 &seen = ctx->qos_dropped_seen[GST_OBJECT_NAME(GST_MESSAGE_SRC(msg))];
+            if (dropped > seen) {
+                ctx->qos_dropped_total->add(dropped - seen);
+                seen = dropped;
+            }
+        }
+    }
+    return TRUE;
+}
+
+// Keys a reload applies to the running pipeline, top level and in [[camera]] entries. text_overlay is not one of them:
+// the osd src pad probe that returns pooled labels is only installed when it is set at startup.
+static const char *const kReloadableKeys[] = {
+    "position", "rotation", "fov", "focal", "principal_point", "distortion", "lut_step",
+    "pixel_sigma", "world_meta", "tile_nms_iou", "tile_nms_ios", "tile_seam_overlap",
+};
+
+static toml::table withoutReloadableKeys(toml::table data) {
+    for (const char *key : kReloadableKeys) {
+        data.erase(key);
+    }
+    if (auto cameras = data["camera"].as_array()) {
+        for (toml::node &camera : *cameras) {
+            if (auto table = camera.as_table()) {
+                for (const char *key : kReloadableKeys) {
+                    table->erase(key);
+                }
+            }
+        }
+    }
+    return data;
+}
+
+// Parses config.toml again and publishes a snapshot with its calibration and thresholds. On a parse or validation
+// error the running snapshot stays and false is returned. Changes to any other key need a restart: they are reported
+// in `restart_keys` and ignored.
+static bool reloadConfig(ProbeContext &ctx, const std::string &path, std::string &error, bool &restart_keys) {
+    toml::table data;
+    try {
+        data = toml::parse_file(path);
+    }
+    catch (const toml::parse_error &err) {
+        error = std::string("parsing failed: ") + err.what();
+        return false;
+    }
+
+    std::vector<CameraGeometry> cameras;
+    if (!parseCameras(data, cameras, error)) {
+        return false;
+    }
+    const RuntimeConfig &current = *ctx.runtime.current();
+    if (cameras.size() != current.cfg.cameras.size()) {
+        error = "the number of cameras changed, restart to apply";
+        return false;
+    }
+
+    std::unique_ptr<RuntimeConfig> next(new RuntimeConfig{current.cfg, CameraSet()});
+    CameraConfig &cfg = next->cfg;
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        applyCalibration(cameras[i], cfg.cameras[i]);
+    }
+    cfg.pixel_sigma = static_cast<float>(data["pixel_sigma"].value_or(static_cast<double>(ctx.cfg.pixel_sigma)));
+    cfg.world_meta = !ctx.queue && data["world_meta"].value_or(ctx.cfg.world_meta);  // never in offload mode
+    TileMergeConfig &tm = cfg.tile_merge_cfg;
+    tm = ctx.cfg.tile_merge_cfg;
+    tm.nms_iou = data["tile_nms_iou"].value_or(tm.nms_iou);
+    tm.nms_ios = data["tile_nms_ios"].value_or(tm.nms_ios);
+    tm.seam_overlap = data["tile_seam_overlap"].value_or(tm.seam_overlap);
+    if (!(tm.nms_iou > 0.0f && tm.nms_ios > 0.0f && tm.seam_overlap > 0.0f)) {
+        error = "invalid tile merge thresholds";
+        return false;
+    }
+
+    // The ground LUTs are rebuilt here, off the streaming threads
+    next->cameras.build(cfg.cameras, ctx.mux_width, ctx.mux_height);
+    restart_keys = !(withoutReloadableKeys(data) == withoutReloadableKeys(ctx.started_toml));
+    ctx.runtime.publish(std::move(next));
+    return true;
+}
+
+// Reload thread: waits for config.toml to change and frees the snapshots the probes no longer hold
+static void reloadLoop(ProbeContext *ctx, std::string path) {
+    for (;;) {
+        ConfigWatcher::Result result = ctx->config_watcher.wait(1000);
+        if (result == ConfigWatcher::kStopped || result == ConfigWatcher::kError) {
+            break;
+        }
+        if (result == ConfigWatcher::kChanged) {
+            std::string error;
+            bool restart_keys = false;
+            if (reloadConfig(*ctx, path, error, restart_keys)) {
+                ctx->config_reloads_total->add();
+                std::cout << "Reloaded " << path << ": calibration and thresholds version "
+                          << ctx->runtime.version() << "\n";
+                if (restart_keys) {
+                    std::cout << "Reloaded " << path << ": other changed keys need a restart to apply\n";
+                }
+            } else {
+                ctx->config_reload_failures_total->add();
+                std::cerr << "Reload of " << path << " failed, keeping the running configuration: " << error
+                          << std::endl;
+            }
+        }
+        ctx->runtime.reclaim();
+    }
+}
+
 int main(int argc, char *argv[]) {
     gst_init(&argc, &argv);
 
-    CameraConfig cfg;
+    ProbeContext ctx;
+    CameraConfig &cfg = ctx.cfg;
+    PipelineConfig pipeline_cfg;
 
     // Set default values (optional)
-    cfg.device = "video0";
-    cfg.width = 1920;
-    cfg.height = 1080;
-    cfg.pos_x = cfg.pos_y = cfg.pos_z = 0.0f;
-    cfg.rot_x = cfg.rot_y = cfg.rot_z = 0.0f;
-    cfg.fov_x = cfg.fov_y = 1.0f;
+    cfg.label_mode = "pooled";
+    cfg.text_overlay = true;
+    cfg.world_meta = true;
+    cfg.pixel_sigma = 1.0f;
+    cfg.shm_capacity = 4096;
+    cfg.probe_mode = "inline";
+    cfg.queue_capacity = 8192;
+    cfg.queue_policy = "drop_oldest";
+    cfg.tracker = false;
+    cfg.adaptive_interval = false;
+    cfg.control_period_ms = 1000;
+    cfg.motion_gate = false;
+    cfg.tiled = false;
+    cfg.trace = false;
+    cfg.trace_interval = 10;
+    cfg.metrics_port = 0;
+    cfg.metrics_address = "127.0.0.1";
+    cfg.config_reload = true;
 
     // Load config.toml
     try {
         auto data = toml::parse_file("config.toml");
+        ctx.started_toml = data;
 
-        if (auto device_node = data["device"].as_string())
-            cfg.device = device_node->get();
+        // Camera geometry: the top-level keys, or one [[camera]] entry per source overriding them
+        std::string camera_error;
+        if (!parseCameras(data, cfg.cameras, camera_error)) {
+            std::cerr << camera_error << "\n";
+            return -1;
+        }
 
-        if (auto resolution_node = data["resolution"].as_array()) {
-            if (resolution_node->size() == 2) {
-                cfg.width = static_cast<int>(resolution_node->at(0).value_or(1920));
-                cfg.height = static_cast<int>(resolution_node->at(1).value_or(1080));
-            } else {
-                std::cerr << "Invalid resolution size in config.toml\n";
-                return -1;
-            }
-        } else {
-            std::cerr << "Missing or invalid 'resolution' in config.toml\n";
+        // Zone analytics: [[zone]] polygons in world metres
+        std::string zone_error;
+        if (!parseZones(data, cfg.zones, zone_error)) {
+            std::cerr << zone_error << "\n";
+            return -1;
+        }
+        cfg.zone_cfg.cell = static_cast<float>(data["zone_cell"].value_or(static_cast<double>(cfg.zone_cfg.cell)));
+        cfg.zone_cfg.lost_s = data["zone_lost_s"].value_or(cfg.zone_cfg.lost_s);
+        if (!(cfg.zone_cfg.cell > 0.0f) || cfg.zone_cfg.lost_s < 0.0) {
+            std::cerr << "Invalid zone_cell or zone_lost_s in config.toml\n";
             return -1;
         }
 
-        if (auto position_node = data["position"].as_array()) {
-            if (position_node->size() == 3) {
-                cfg.pos_x = static_cast<float>(position_node->at(0).value_or(0.0));
-                cfg.pos_y = static_cast<float>(position_node->at(1).value_or(0.0));
-                cfg.pos_z = static_cast<float>(position_node->at(2).value_or(0.0));
-            } else {
-                std::cerr << "Invalid position size in config.toml\n";
-                return -1;
-            }
-        } else {
-            std::cerr << "Missing or invalid 'position' in config.toml\n";
+        cfg.label_mode = data["label_mode"].value_or(cfg.label_mode);
+        if (cfg.label_mode != "pooled" && cfg.label_mode != "malloc") {
+            std::cerr << "Invalid label_mode in config.toml (pooled, malloc)\n";
             return -1;
         }
 
-        if (auto rotation_node = data["rotation"].as_array()) {
-            if (rotation_node->size() == 3) {
-                cfg.rot_x = static_cast<float>(rotation_node->at(0).value_or(0.0));
-                cfg.rot_y = static_cast<float>(rotation_node->at(1).value_or(0.0));
-                cfg.rot_z = static_cast<float>(rotation_node->at(2).value_or(0.0));
-            } else {
-                std::cerr << "Invalid rotation size in config.toml\n";
-                return -1;
+        cfg.text_overlay = data["text_overlay"].value_or(cfg.text_overlay);
+        OverlayConfig &oc = cfg.overlay;
+        if (!parseOverlayMode(data["overlay"].value_or(std::string("full")), oc.mode)) {
+            std::cerr << "Invalid overlay in config.toml (full, boxes, none)\n";
+            return -1;
+        }
+        oc.label_every = data["label_every"].value_or(oc.label_every);
+        oc.label_top_k = data["label_top_k"].value_or(oc.label_top_k);
+        if (auto classes = data["label_classes"].as_array()) {
+            for (size_t i = 0; i < classes->size(); ++i) {
+                oc.label_classes.push_back(static_cast<int>(classes->at(i).value_or(int64_t(-1))));
             }
-        } else {
-            std::cerr << "Missing or invalid 'rotation' in config.toml\n";
+        }
+        if (oc.label_every < 1 || oc.label_top_k < 0 ||
+            std::any_of(oc.label_classes.begin(), oc.label_classes.end(), [](int c) { return c < 0; })) {
+            std::cerr << "Invalid label_every, label_top_k or label_classes in config.toml\n";
             return -1;
         }
+        cfg.world_meta = data["world_meta"].value_or(cfg.world_meta);
+        cfg.pixel_sigma = static_cast<float>(data["pixel_sigma"].value_or(static_cast<double>(cfg.pixel_sigma)));
 
-        if (auto fov_node = data["fov"].as_array()) {
-            if (fov_node->size() == 2) {
-                cfg.fov_x = static_cast<float>(fov_node->at(0).value_or(1.0));
-                cfg.fov_y = static_cast<float>(fov_node->at(1).value_or(1.0));
-            } else {
-                std::cerr << "Invalid fov size in config.toml\n";
+        cfg.shm_export = data["shm_export"].value_or(cfg.shm_export);
+        cfg.shm_capacity = data["shm_capacity"].value_or(cfg.shm_capacity);
+        if (cfg.shm_capacity < 1) {
+            std::cerr << "Invalid shm_capacity in config.toml\n";
+            return -1;
+        }
+
+        cfg.detection_log = data["detection_log"].value_or(cfg.detection_log);
+        double segment_mb = data["detection_log_segment_mb"].value_or(64.0);
+        cfg.log_cfg.segment_seconds = data["detection_log_segment_seconds"].value_or(cfg.log_cfg.segment_seconds);
+        int64_t log_queue = data["detection_log_queue"].value_or(static_cast<int64_t>(cfg.log_cfg.queue_capacity));
+        if (segment_mb < 0.01 || cfg.log_cfg.segment_seconds < 0.0 || log_queue < 1) {
+            std::cerr << "Invalid detection_log_segment_mb, detection_log_segment_seconds or detection_log_queue in "
+                         "config.toml\n";
+            return -1;
+        }
+        cfg.log_cfg.segment_bytes = static_cast<uint64_t>(segment_mb * 1048576.0);
+        cfg.log_cfg.queue_capacity = static_cast<size_t>(log_queue);
+
+        cfg.probe_mode = data["probe_mode"].value_or(cfg.probe_mode);
+        if (cfg.probe_mode != "inline" && cfg.probe_mode != "offload") {
+            std::cerr << "Invalid probe_mode in config.toml (inline, offload)\n";
+            return -1;
+        }
+        cfg.queue_capacity = data["queue_capacity"].value_or(cfg.queue_capacity);
+        cfg.queue_policy = data["queue_policy"].value_or(cfg.queue_policy);
+        QueuePolicy policy;
+        if (cfg.queue_capacity < 1 || !parseQueuePolicy(cfg.queue_policy, policy)) {
+            std::cerr << "Invalid queue_capacity or queue_policy in config.toml (drop_oldest, drop_newest, block)\n";
+            return -1;
+        }
+
+        TrackerConfig &tc = cfg.tracker_cfg;
+        cfg.tracker = data["tracker"].value_or(cfg.tracker);
+        tc.capacity = data["tracker_capacity"].value_or(tc.capacity);
+        tc.max_detections = tc.capacity;
+        tc.high_threshold = static_cast<float>(data["tracker_high_threshold"].value_or(double(tc.high_threshold)));
+        tc.low_threshold = static_cast<float>(data["tracker_low_threshold"].value_or(double(tc.low_threshold)));
+        tc.iou_threshold = static_cast<float>(data["tracker_iou_threshold"].value_or(double(tc.iou_threshold)));
+        tc.min_hits = data["tracker_min_hits"].value_or(tc.min_hits);
+        tc.max_age = data["tracker_max_age"].value_or(tc.max_age);
+        tc.max_coast = data["tracker_max_coast"].value_or(tc.max_coast);
+        if (!parseTrackerAssociation(data["tracker_association"].value_or(std::string("greedy")), tc.association)) {
+            std::cerr << "Invalid tracker_association in config.toml (greedy, hungarian)\n";
+            return -1;
+        }
+        if (tc.capacity < 1 || tc.min_hits < 1 || tc.max_age < 0 || tc.max_coast < 0 ||
+            tc.low_threshold > tc.high_threshold || tc.iou_threshold <= 0.0f || tc.iou_threshold > 1.0f) {
+            std::cerr << "Invalid tracker settings in config.toml\n";
+            return -1;
+        }
+
+        IntervalControllerConfig &ic = cfg.interval_cfg;
+        cfg.adaptive_interval = data["adaptive_interval"].value_or(cfg.adaptive_interval);
+        ic.latency_slo_ms = data["latency_slo_ms"].value_or(ic.latency_slo_ms);
+        ic.max_interval = data["interval_max"].value_or(ic.max_interval);
+        ic.drop_frames = data["drop_frames"].value_or(ic.drop_frames);
+        cfg.control_period_ms = data["control_period_ms"].value_or(cfg.control_period_ms);
+        cfg.interval_log = data["interval_log"].value_or(cfg.interval_log);
+        if (!parseIntervalPolicy(data["interval_policy"].value_or(std::string("pid")), ic.policy)) {
+            std::cerr << "Invalid interval_policy in config.toml (pid, hysteresis)\n";
+            return -1;
+        }
+        if (ic.latency_slo_ms <= 0.0 || ic.max_interval < 0 || cfg.control_period_ms < 100) {
+            std::cerr << "Invalid latency_slo_ms, interval_max or control_period_ms in config.toml\n";
+            return -1;
+        }
+
+        MotionDetectorConfig &mc = cfg.motion_cfg;
+        MotionGateConfig &gc = cfg.motion_gate_cfg;
+        cfg.motion_gate = data["motion_gate"].value_or(cfg.motion_gate);
+        mc.downscale = data["motion_downscale"].value_or(mc.downscale);
+        mc.pixel_threshold = data["motion_threshold"].value_or(mc.pixel_threshold);
+        mc.min_blocks = data["motion_min_blocks"].value_or(mc.min_blocks);
+        mc.dilation = data["motion_dilation"].value_or(mc.dilation);
+        gc.hold_frames = data["motion_hold_frames"].value_or(gc.hold_frames);
+        gc.recheck_frames = data["motion_recheck_frames"].value_or(gc.recheck_frames);
+        if (mc.downscale < 1 || mc.pixel_threshold < 0 || mc.min_blocks < 1 || mc.dilation < 0 || gc.hold_frames < 0 ||
+            gc.recheck_frames < 0) {
+            std::cerr << "Invalid motion gate settings in config.toml\n";
+            return -1;
+        }
+
+        TilePlanConfig &tp = cfg.tile_plan;
+        TileMergeConfig &tm = cfg.tile_merge_cfg;
+        if (auto tiles = data["tiles"].as_array()) {
+            cfg.tiled = true;
+            tp.cols = tiles->size() == 2 ? static_cast<int>(tiles->at(0).value_or(0)) : 0;
+            tp.rows = tiles->size() == 2 ? static_cast<int>(tiles->at(1).value_or(0)) : 0;
+        }
+        tp.overlap = data["tile_overlap"].value_or(tp.overlap);
+        tm.nms_iou = data["tile_nms_iou"].value_or(tm.nms_iou);
+        tm.nms_ios = data["tile_nms_ios"].value_or(tm.nms_ios);
+        tm.seam_overlap = data["tile_seam_overlap"].value_or(tm.seam_overlap);
+        bool merge_ok = tm.nms_iou > 0.0f && tm.nms_ios > 0.0f && tm.seam_overlap > 0.0f;
+        if (cfg.tiled && (tp.cols < 1 || tp.rows < 1 || tp.cols * tp.rows < 2 || !(tp.overlap >= 0.0f) ||
+                          tp.overlap > 0.9f || !merge_ok)) {
+            std::cerr << "Invalid tiles, tile_overlap (0..0.9) or tile merge thresholds in config.toml\n";
+            return -1;
+        }
+
+        cfg.trace = data["trace"].value_or(cfg.trace);
+        cfg.trace_interval = data["trace_interval"].value_or(cfg.trace_interval);
+        cfg.trace_output = data["trace_output"].value_or(cfg.trace_output);
+        if (cfg.trace_interval < 0) {
+            std::cerr << "Invalid trace_interval in config.toml\n";
+            return -1;
+        }
+
+        cfg.metrics_port = data["metrics_port"].value_or(cfg.metrics_port);
+        cfg.metrics_address = data["metrics_address"].value_or(cfg.metrics_address);
+        cfg.config_reload = data["config_reload"].value_or(cfg.config_reload);
+        if (cfg.metrics_port < 0 || cfg.metrics_port > 65535) {
+            std::cerr << "Invalid metrics_port in config.toml\n";
+            return -1;
+        }
+
+        std::vector<SourceConfig> camera_sources(cfg.cameras.size());
+        for (size_t i = 0; i < cfg.cameras.size(); ++i) {
+            camera_sources[i].device = cfg.cameras[i].device;
+            camera_sources[i].width = cfg.cameras[i].width;
+            camera_sources[i].height = cfg.cameras[i].height;
+        }
+        std::string error;
+        if (!parsePipelineConfig(data, camera_sources, pipeline_cfg, error)) {
+            std::cerr << "Invalid pipeline in config.toml: " << error << "\n";
+            return -1;
+        }
+        pipeline_cfg.osd = cfg.overlay.mode != OverlayMode::None;
+        cfg.parser_lib = data["parser_lib"].value_or(inferConfigPath(pipeline_cfg.infer_config, "custom-lib-path"));
+
+        // roi crops, all at the nvstreammux aspect: mux_resolution, or the first camera's crop when it sets the size
+        double aspect = 0.0;
+        if (pipeline_cfg.mux_width > 0 && pipeline_cfg.mux_height > 0) {
+            aspect = static_cast<double>(pipeline_cfg.mux_width) / pipeline_cfg.mux_height;
+        } else if (cfg.cameras.size() > 1) {
+            CameraGeometry first = cfg.cameras[0];
+            if (!computeRoiCrop(first, 0.0, error)) {
+                std::cerr << "Invalid roi in config.toml: " << error << "\n";
                 return -1;
             }
-        } else {
-            std::cerr << "Missing or invalid 'fov' in config.toml\n";
-            return -1;
+            aspect = first.crop_width > 0 ? static_cast<double>(first.crop_width) / first.crop_height
+                                          : static_cast<double>(first.width) / first.height;
+        }
+        for (size_t i = 0; i < cfg.cameras.size(); ++i) {
+            CameraGeometry &g = cfg.cameras[i];
+            if (!computeRoiCrop(g, aspect, error)) {
+                std::cerr << "Invalid roi in config.toml: " << error << "\n";
+                return -1;
+            }
+            SourceConfig &src = pipeline_cfg.sources[i];
+            src.crop_x = g.crop_x;
+            src.crop_y = g.crop_y;
+            src.crop_width = g.crop_width;
+            src.crop_height = g.crop_height;
+        }
+
+        // Tiles over each camera's crop (or frame), all at the size of the first camera's tiles in nvstreammux
+        if (cfg.tiled) {
+            for (size_t i = 0; i < cfg.cameras.size(); ++i) {
+                const CameraGeometry &g = cfg.cameras[i];
+                TileRect region{0, 0, g.width, g.height};
+                if (g.crop_width > 0) {
+                    region = TileRect{g.crop_x, g.crop_y, g.crop_width, g.crop_height};
+                }
+                std::vector<TileRect> tiles;
+                if (!planTiles(region.x, region.y, region.width, region.height, cfg.tile_plan, tiles)) {
+                    std::cerr << "Invalid tiles in config.toml: camera " << i << " region " << region.width << " x "
+                              << region.height << " cannot be cut into " << cfg.tile_plan.cols << " x "
+                              << cfg.tile_plan.rows << " tiles\n";
+                    return -1;
+                }
+                for (size_t k = 0; k < tiles.size(); ++k) {
+                    const TileRect &t = tiles[k];
+                    pipeline_cfg.sources[i].tiles.push_back(SourceCrop{t.x, t.y, t.width, t.height});
+                }
+                ctx.tiles.push_back(tiles);
+                ctx.tile_regions.push_back(region);
+            }
+            for (size_t i = 0; i < cfg.cameras.size(); ++i) {
+                for (size_t k = 0; k < ctx.tiles[i].size(); ++k) {
+                    ctx.tile_pads.emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(k));
+                }
+            }
+            if (pipeline_cfg.mux_width <= 0 || pipeline_cfg.mux_height <= 0) {
+                pipeline_cfg.mux_width = ctx.tiles[0][0].width;
+                pipeline_cfg.mux_height = ctx.tiles[0][0].height;
+            }
+            ctx.tile_merger = TileMerger(cfg.tile_merge_cfg);
         }
     }
     catch (const toml::parse_error& err) {
@@ -133,40 +1462,312 @@ int main(int argc, char *argv[]) {
         return -1;
     }
 
+    // Build the pipeline from the [source] .. [sink] sections and check every element is installed, before any output
+    // is opened or thread started
+    PipelineDescription pipeline_desc;
+    std::string pipeline_error;
+    if (!buildPipelineDescription(pipeline_cfg, pipeline_desc, &pipeline_error)) {
+        std::cerr << "Invalid pipeline: " << pipeline_error << std::endl;
+        return -1;
+    }
+    std::string missing;
+    for (const std::string &factory : pipeline_desc.factories) {
+        GstElementFactory *f = gst_element_factory_find(factory.c_str());
+        if (f) {
+            gst_object_unref(f);
+        } else {
+            missing += " " + factory;
+        }
+    }
+    if (!missing.empty()) {
+        std::cerr << "GStreamer elements not installed:" << missing << std::endl;
+        return -1;
+    }
+
+    // Boxes are in nvstreammux pixels, each camera maps them back through its crop to its own resolution
+    int mux_width, mux_height;
+    sourceOutputSize(pipeline_cfg.sources[0], mux_width, mux_height);
+    mux_width = pipeline_cfg.mux_width > 0 ? pipeline_cfg.mux_width : mux_width;
+    mux_height = pipeline_cfg.mux_height > 0 ? pipeline_cfg.mux_height : mux_height;
+    ctx.mux_width = mux_width;
+    ctx.mux_height = mux_height;
+
+    // Labels and user meta belong to the buffer and cannot be produced later by the offload worker
+    if (cfg.probe_mode == "offload") {
+        if (cfg.text_overlay || cfg.world_meta) {
+            std::cout << "probe_mode = offload: text_overlay and world_meta are disabled\n";
+        }
+        cfg.text_overlay = false;
+        cfg.world_meta = false;
+    }
+
+    // First snapshot of the calibration and thresholds, published before any probe or the worker can read it
+    std::unique_ptr<RuntimeConfig> initial(new RuntimeConfig{cfg, CameraSet()});
+    initial->cameras.build(cfg.cameras, mux_width, mux_height);
+    ctx.runtime.publish(std::move(initial));
+    ctx.osd_reader = ctx.runtime.registerReader();
+    ctx.worker_reader = ctx.runtime.registerReader();
+    const CameraSet &cameras = ctx.runtime.current()->cameras;
+    ctx.camera_count = cameras.size();
+
+    // Track ids carry the source in their top 16 bits so they stay unique across cameras
+    if (cfg.tracker) {
+        ctx.trackers.reserve(cameras.size());
+        for (size_t i = 0; i < cameras.size(); ++i) {
+            ctx.trackers.emplace_back(cfg.tracker_cfg, (static_cast<uint64_t>(i) << 48) + 1);
+        }
+        ctx.track_dets.resize(cfg.tracker_cfg.max_detections);
+        ctx.track_objs.resize(cfg.tracker_cfg.max_detections);
+        ctx.track_out.resize(cfg.tracker_cfg.capacity);
+        std::cout << "Tracker: " << trackerAssociationName(cfg.tracker_cfg.association) << " IoU association, "
+                  << cfg.tracker_cfg.capacity << " tracks per source, inference interval " << pipeline_cfg.infer_interval
+                  << "\n";
+    } else if (pipeline_cfg.infer_interval > 0) {
+        std::cout << "Inference interval " << pipeline_cfg.infer_interval
+                  << " without tracker: skipped frames carry no objects (set tracker = true)\n";
+    }
+
     // Print loaded config to verify
-    std::cout << "Device: " << cfg.device << std::endl;
-    std::cout << "Resolution: " << cfg.width << " x " << cfg.height << std::endl;
-    std::cout << "Position: (" << cfg.pos_x << ", " << cfg.pos_y << ", " << cfg.pos_z << ")\n";
-    std::cout << "Rotation: (" << cfg.rot_x << ", " << cfg.rot_y << ", " << cfg.rot_z << ")\n";
-    std::cout << "FOV: (" << cfg.fov_x << ", " << cfg.fov_y << ")\n";
-
-    // Construct GStreamer pipeline description dynamically using device and resolution
-    gchar pipeline_desc[2048];
-    snprintf(pipeline_desc, sizeof(pipeline_desc),
-        "v4l2src device=/dev/%s ! "
-        "video/x-raw, width=%d, height=%d ! "
-        "nvvidconv ! video/x-raw(memory:NVMM), format=I420 ! "
-        "nvvidconv ! video/x-raw(memory:NVMM), format=NV12 ! "
-        "nvstreammux name=mux batch-size=1 width=%d height=%d ! "
-        "nvinfer config-file-path=/home/flux/DeepStream-Yolo/config_infer_primary_yoloV10.txt ! "
-        "nvdsosd name=osd ! "
-        "nvvidconv ! nvv4l2h264enc ! rtph264pay mtu=60000 ! "
-        "udpsink clients=100.72.147.81:5000 sync=false",
-        cfg.device.c_str(), cfg.width, cfg.height, cfg.width, cfg.height
-    );
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        const CameraView &cam = cameras[i];
+        const CameraGeometry &g = cam.geometry;
+        std::cout << "Camera " << i << " (source_id " << i << "):\n";
+        std::cout << "  Device: " << g.device << std::endl;
+        std::cout << "  Resolution: " << g.width << " x " << g.height << std::endl;
+        std::cout << "  Position: (" << g.pos_x << ", " << g.pos_y << ", " << g.pos_z << ")\n";
+        std::cout << "  Rotation: (" << g.rot_x << ", " << g.rot_y << ", " << g.rot_z << ")\n";
+        std::cout << "  FOV: (" << g.fov_x << ", " << g.fov_y << ")\n";
+        if (g.crop_width > 0) {
+            std::cout << "  roi crop: " << g.crop_width << " x " << g.crop_height << " at (" << g.crop_x << ", "
+                      << g.crop_y << "), " << g.roi.size() << "-point roi, margin " << g.roi_margin << " px\n";
+        } else if (!g.roi.empty()) {
+            std::cout << "  roi crop: none, the roi spans the frame\n";
+        }
+        if (cam.pinhole()) {
+            std::cout << "  Camera model: fx=" << cam.model.fx << " fy=" << cam.model.fy << " cx=" << cam.model.cx
+                      << " cy=" << cam.model.cy << ", ground LUT step " << cam.lut.step() << " ("
+                      << cam.lut.bytes() / 1024 << " KiB)\n";
+        } else {
+            std::cout << "  Camera model: linear fov (set position.z to the camera height to use the pinhole model)\n";
+        }
+    }
+    std::cout << "nvstreammux: batch-size " << muxPadCount(pipeline_cfg) << ", " << mux_width << " x "
+              << mux_height << "\n";
+    if (cfg.tiled) {
+        const TileRect &t = ctx.tiles[0][0];
+        std::cout << "Tiled inference: " << cfg.tile_plan.cols << " x " << cfg.tile_plan.rows << " tiles per camera ("
+                  << t.width << " x " << t.height << " on camera 0, overlap " << cfg.tile_plan.overlap
+                  << ") next to the full frame, merged with " << tileMergeSimdName() << " IoU NMS (IoU "
+                  << cfg.tile_merge_cfg.nms_iou << ", IoS " << cfg.tile_merge_cfg.nms_ios << ") and seam fusion\n";
+    }
+    std::cout << "imageToWorld batch path: " << imageToWorldSimdName() << "\n";
+    ctx.pooled_labels = cfg.label_mode == "pooled";
+    ctx.processor.configure(cfg.text_overlay, cfg.overlay, ctx.pooled_labels);
+    const OverlayConfig &oc = cfg.overlay;
+    if (oc.mode != OverlayMode::Full) {
+        std::cout << "Overlay: " << overlayModeName(oc.mode)
+                  << (oc.mode == OverlayMode::Boxes ? ", no labels\n" : ", no nvdsosd in the pipeline\n");
+    } else if (cfg.text_overlay && (oc.label_every > 1 || oc.label_top_k > 0 || !oc.label_classes.empty())) {
+        std::cout << "Overlay: X/Y labels";
+        if (oc.label_top_k > 0) {
+            std::cout << " on the " << oc.label_top_k << " most confident objects per frame";
+        }
+        if (!oc.label_classes.empty()) {
+            std::cout << " of " << oc.label_classes.size() << " classes";
+        }
+        if (ctx.processor.labelCache().interval() > 1) {
+            std::cout << ", refreshed every " << oc.label_every << " frames"
+                      << (cfg.tracker ? "" : " (tracked objects only, set tracker = true)");
+        }
+        std::cout << "\n";
+    }
+    ctx.world_meta_type = nvds_get_user_meta_type((gchar *)WORLD_COORD_META_NAME);
+
+    if (!cfg.zones.empty()) {
+        std::string error;
+        if (!ctx.zones.configure(cfg.zones, cfg.zone_cfg, error)) {
+            std::cerr << "Failed to set up zones: " << error << std::endl;
+            return -1;
+        }
+        const ZoneGrid &grid = ctx.zones.grid();
+        std::cout << "Zones: " << cfg.zones.size() << " on a " << grid.columns() << "x" << grid.rows() << " grid of "
+                  << grid.cellSize() << " m cells (" << 100.0 * grid.edgeCellFraction() << "% need an exact test)\n";
+    }
+    // Outputs are opened before the reload and worker threads start, so failing here is still a plain return
+    if (cfg.adaptive_interval && !cfg.interval_log.empty()) {
+        ctx.interval_log = std::fopen(cfg.interval_log.c_str(), "w");
+        if (!ctx.interval_log) {
+            std::cerr << "Failed to open interval_log " << cfg.interval_log << std::endl;
+            return -1;
+        }
+        std::fprintf(ctx.interval_log,
+                     "seconds,objects_per_frame,latency_p95_ms,queue_depth,frames,load,interval,keep_one_in\n");
+    }
+    if (!cfg.shm_export.empty()) {
+        if (!ctx.detections.open(cfg.shm_export, cfg.shm_capacity)) {
+            std::cerr << "Failed to create shared memory ring " << cfg.shm_export << std::endl;
+            return -1;
+        }
+        std::cout << "Publishing detections to shared memory " << cfg.shm_export << "\n";
+    }
+    if (!cfg.detection_log.empty()) {
+        std::string error;
+        if (!ctx.detection_log.open(cfg.detection_log, cfg.log_cfg, error)) {
+            std::cerr << "Failed to open detection log: " << error << std::endl;
+            return -1;
+        }
+        std::cout << "Logging detections to " << cfg.detection_log << " (segments of "
+                  << cfg.log_cfg.segment_bytes / 1048576.0 << " MB or " << cfg.log_cfg.segment_seconds << " s)\n";
+    }
+
+    if (cfg.probe_mode == "offload") {
+        QueuePolicy policy = QueuePolicy::DropOldest;
+        parseQueuePolicy(cfg.queue_policy, policy);
+        ctx.queue.reset(new SpscQueue<ObjectWork>(cfg.queue_capacity, policy));
+        g_timeout_add_seconds(10, printQueueStats, &ctx);
+        std::cout << "Probe offloaded to a worker thread, queue " << ctx.queue->capacity() << " objects, "
+                  << queuePolicyName(policy) << "\n";
+    }
+
+    std::cout << "Pipeline:\n" << pipeline_desc.graph;
 
     GError *error = nullptr;
-    GstElement *pipeline = gst_parse_launch(pipeline_desc, &error);
+    GstElement *pipeline = gst_parse_launch(pipeline_desc.launch.c_str(), &error);
     if (!pipeline) {
         std::cerr << "Failed to create pipeline: " << error->message << std::endl;
         g_error_free(error);
         return -1;
     }
 
-    GstElement *osd = gst_bin_get_by_name(GST_BIN(pipeline), "osd");
-    GstPad *osd_sink_pad = gst_element_get_static_pad(osd, "sink");
+    // Without nvdsosd (overlay = "none") the overlay probe runs on the nvinfer src pad
+    GstElement *osd = gst_bin_get_by_name(GST_BIN(pipeline), pipeline_cfg.osd ? "osd" : "infer");
+    GstPad *osd_sink_pad = gst_element_get_static_pad(osd, pipeline_cfg.osd ? "sink" : "src");
+
+    gst_pad_add_probe(osd_sink_pad, GST_PAD_PROBE_TYPE_BUFFER, osd_sink_pad_buffer_probe, &ctx, NULL);
+    if (cfg.text_overlay && ctx.pooled_labels && cfg.overlay.mode == OverlayMode::Full) {
+        GstPad *osd_src_pad = gst_element_get_static_pad(osd, "src");
+        gst_pad_add_probe(osd_src_pad, GST_PAD_PROBE_TYPE_BUFFER, osd_src_pad_buffer_probe, &ctx, NULL);
+        gst_object_unref(osd_src_pad);
+    }
+
+    // The probes point into it, so it lives until main returns, after the pipeline is stopped
+    PipelineTracer latency;
+    if (cfg.trace) {
+        latency.output = cfg.trace_output;
+        size_t pads = installLatencyProbes(latency, pipeline);
+        scheduleLatencyDumps(latency, static_cast<guint>(cfg.trace_interval));
+        std::cout << "Latency trace on " << pads << " pads, dumped to "
+                  << (cfg.trace_output.empty() ? "stdout" : cfg.trace_output) << " every " << cfg.trace_interval
+                  << " s and on SIGUSR1\n";
+    }
+
+    ParserStatsSource parser;
+    parser.path = cfg.parser_lib;
+    registerMetrics(ctx, parser, cfg.trace ? &latency : nullptr);
+    GstBus *bus = gst_element_get_bus(pipeline);
+    gst_bus_add_watch(bus, bus_qos_cb, &ctx);
+    gst_object_unref(bus);
+
+    // Hot reload: the watcher thread swaps in new snapshots, the probes never wait for it
+    if (cfg.config_reload) {
+        if (ctx.config_watcher.open("config.toml")) {
+            ctx.reload_thread = std::thread(reloadLoop, &ctx, std::string("config.toml"));
+            std::cout << "Watching config.toml: calibration, pixel_sigma, world_meta and tile merge thresholds "
+                         "reload without a restart\n";
+        } else {
+            std::cerr << "Failed to watch config.toml, hot reload disabled" << std::endl;
+        }
+    }
+
+    // Adaptive interval: frames stamped entering nvstreammux (and decimated there) and again at the osd sink pad
+    ctx.inference_interval->set(pipeline_cfg.infer_interval);
+    ctx.source_keep_one_in->set(1);
+    ctx.infer_interval = pipeline_cfg.infer_interval;
+    ctx.applied_interval = pipeline_cfg.infer_interval;
+    if (cfg.adaptive_interval || cfg.motion_gate) {
+        ctx.infer = gst_bin_get_by_name(GST_BIN(pipeline), "infer");
+    }
+    if (cfg.adaptive_interval) {
+        IntervalControllerConfig ic = cfg.interval_cfg;
+        ic.min_interval = pipeline_cfg.infer_interval;
+        ic.queue_high = ctx.queue ? ctx.queue->capacity() / 2.0 : 0.0;
+        ctx.interval_controller = IntervalController(ic);
+        ctx.latency_mux_stage = ctx.frame_latency.addStage("mux", true);
+        ctx.latency_osd_stage = ctx.frame_latency.addStage("osd", false);
+        GstElement *mux = gst_bin_get_by_name(GST_BIN(pipeline), "mux");
+        for (size_t i = 0; i < muxPadCount(pipeline_cfg); ++i) {
+            std::string name = "sink_" + std::to_string(i);
+            GstPad *pad = gst_element_get_static_pad(mux, name.c_str());
+            if (!pad) {
+                continue;
+            }
+            ctx.mux_probes.push_back(MuxSinkProbe{&ctx, static_cast<uint32_t>(i)});
+            gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, mux_sink_pad_buffer_probe, &ctx.mux_probes.back(), NULL);
+            gst_object_unref(pad);
+        }
+        gst_object_unref(mux);
+        g_timeout_add(static_cast<guint>(cfg.control_period_ms), interval_control_cb, &ctx);
+        const IntervalControllerConfig &applied = ctx.interval_controller.config();
+        std::cout << "Adaptive inference interval: " << intervalPolicyName(applied.policy) << ", p95 latency SLO "
+                  << applied.latency_slo_ms << " ms, interval " << applied.min_interval << ".." << applied.max_interval
+                  << (applied.drop_frames ? ", source decimation allowed" : "") << "\n";
+    }
 
-    gst_pad_add_probe(osd_sink_pad, GST_PAD_PROBE_TYPE_BUFFER, osd_sink_pad_buffer_probe, &cfg, NULL);
+    // Motion gate: detectors on the raw source pads, the per-batch decision on the nvinfer sink pad
+    if (cfg.motion_gate) {
+        ctx.motion_gate = MotionGate(cfg.motion_gate_cfg);
+        for (size_t i = 0; i < pipeline_cfg.sources.size(); ++i) {
+            ctx.motion.emplace_back(cfg.motion_cfg);
+            const SourceConfig &src = pipeline_cfg.sources[i];
+            ctx.motion.back().crop_x = src.crop_x;
+            ctx.motion.back().crop_y = src.crop_y;
+            ctx.motion.back().crop_width = src.crop_width;
+            ctx.motion.back().crop_height = src.crop_height;
+            std::string name = "src" + std::to_string(i);
+            GstElement *element = gst_bin_get_by_name(GST_BIN(pipeline), name.c_str());
+            GstPad *pad = element ? gst_element_get_static_pad(element, "src") : nullptr;
+            if (pad && !(src.type == "v4l2" && src.format == "mjpeg")) {
+                auto types = (GstPadProbeType)(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM);
+                gst_pad_add_probe(pad, types, source_motion_probe, &ctx.motion.back(), NULL);
+            } else {
+                std::cout << "Motion gate: source " << i << " has no raw frames, always inferred\n";
+            }
+            if (pad) {
+                gst_object_unref(pad);
+            }
+            if (element) {
+                gst_object_unref(element);
+            }
+        }
+        GstPad *infer_sink_pad = gst_element_get_static_pad(ctx.infer, "sink");
+        gst_pad_add_probe(infer_sink_pad, GST_PAD_PROBE_TYPE_BUFFER, infer_sink_pad_buffer_probe, &ctx, NULL);
+        gst_object_unref(infer_sink_pad);
+        const MotionDetectorConfig &mc = cfg.motion_cfg;
+        std::cout << "Motion gate: luma / " << mc.downscale << ", " << motionDetectorSimdName() << " SAD, threshold "
+                  << mc.pixel_threshold << ", " << mc.min_blocks << " blocks, inference held "
+                  << cfg.motion_gate_cfg.hold_frames << " frames after motion, re-checked every "
+                  << cfg.motion_gate_cfg.recheck_frames << " frames\n";
+        if (!cfg.tracker) {
+            std::cout << "Motion gate without tracker: gated frames carry no objects (set tracker = true)\n";
+        }
+    }
+
+    MetricsServer metrics_server;
+    if (cfg.metrics_port > 0) {
+        std::string error;
+        if (!metrics_server.start(cfg.metrics_address, cfg.metrics_port, [&ctx]() { return ctx.metrics.render(); },
+                                  &error)) {
+            std::cerr << "Failed to start the metrics server, metrics disabled: " << error << std::endl;
+        } else {
+            std::cout << "Serving metrics on http://" << cfg.metrics_address << ":" << metrics_server.port()
+                      << "/metrics\n";
+        }
+    }
+
+    // Started last: nothing below returns early, so the thread is always stopped and joined at shutdown
+    if (ctx.queue) {
+        ctx.worker = std::thread(offloadWorker, &ctx);
+    }
 
     gst_element_set_state(pipeline, GST_STATE_PLAYING);
 
@@ -174,6 +1775,31 @@ int main(int argc, char *argv[]) {
     g_main_loop_run(loop);
 
     gst_element_set_state(pipeline, GST_STATE_NULL);
+    metrics_server.stop();
+    if (cfg.trace) {
+        dumpLatency(latency);
+    }
+    if (ctx.interval_log) {
+        std::fclose(ctx.interval_log);
+    }
+    if (ctx.infer) {
+        gst_object_unref(ctx.infer);
+    }
+    if (ctx.reload_thread.joinable()) {
+        ctx.config_watcher.stop();
+        ctx.reload_thread.join();
+    }
+    if (ctx.worker.joinable()) {
+        ctx.stop_worker = true;
+        ctx.queue->close();
+        ctx.worker.join();
+    }
+    if (ctx.detection_log.isOpen()) {
+        DetectionLogCounters c = ctx.detection_log.counters();
+        ctx.detection_log.close();
+        std::cout << "Detection log: " << c.appended << " records queued, " << c.dropped << " dropped, "
+                  << c.write_errors << " write errors\n";
+    }
     gst_object_unref(pipeline);
     return 0;
 }
@@ -0,0 +1,184 @@
+// apps/real_world_overlay/metrics.hpp
+// Prometheus text format metrics. Counters, gauges and fixed-bucket histograms are relaxed atomics updated from the
+// hot path; the text is only built when the registry is rendered (on scrape). Metrics are registered at startup and
+// live as long as the registry. Values that already exist elsewhere (queue counters, tracer histograms, parser stats)
+// are rendered by collectors at scrape time instead of being copied on every update.
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class MetricCounter {
+public:
+    void add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+class MetricGauge {
+public:
+    void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+// Integer observations (objects, nanoseconds, ...) in buckets with inclusive upper bounds; `scale` converts them to
+// the exported unit, e.g. 1e-9 for nanoseconds exported as seconds
+class MetricHistogram {
+public:
+    MetricHistogram(std::vector<uint64_t> bounds, double scale)
+        : bounds_(std::move(bounds)), scale_(scale), counts_(new std::atomic<uint64_t>[bounds_.size() + 1]) {
+        for (size_t i = 0; i <= bounds_.size(); ++i)
+            counts_[i].store(0, std::memory_order_relaxed);
+    }
+
+    void observe(uint64_t v) {
+        size_t b = 0;
+        while (b < bounds_.size() && v > bounds_[b])
+            ++b;
+        counts_[b].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(v, std::memory_order_relaxed);
+    }
+
+    const std::vector<uint64_t> &bounds() const { return bounds_; }
+    double scale() const { return scale_; }
+    uint64_t bucketCount(size_t b) const { return counts_[b].load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<uint64_t> bounds_;
+    double scale_;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+    std::atomic<uint64_t> sum_{0};
+};
+
+// `labels` is the inside of the braces, already escaped (see metricLabel), or empty
+inline void appendMetricSample(std::string &out, const std::string &name, const std::string &labels, double value) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.17g", value);
+    out += name;
+    if (!labels.empty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += ' ';
+    out += buf;
+    out += '\n';
+}
+
+inline void appendMetricHeader(std::string &out, const std::string &name, const char *type, const std::string &help) {
+    out += "# HELP " + name + ' ';
+    for (char c : help) {
+        if (c == '\\')
+            out += "\\\\";
+        else if (c == '\n')
+            out += "\\n";
+        else
+            out += c;
+    }
+    out += "\n# TYPE " + name + ' ' + type + '\n';
+}
+
+// key="value" with the value escaped for the text format
+inline std::string metricLabel(const std::string &key, const std::string &value) {
+    std::string out = key + "=\"";
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out + '"';
+}
+
+class MetricsRegistry {
+public:
+    using Collector = std::function<void(std::string &)>;
+
+    explicit MetricsRegistry(const std::string &prefix = "") : prefix_(prefix) {}
+
+    MetricCounter &counter(const std::string &name, const std::string &help) {
+        counters_.emplace_back(prefix_ + name, help);
+        return counters_.back().metric;
+    }
+
+    MetricGauge &gauge(const std::string &name, const std::string &help) {
+        gauges_.emplace_back(prefix_ + name, help);
+        return gauges_.back().metric;
+    }
+
+    MetricHistogram &histogram(const std::string &name, const std::string &help, std::vector<uint64_t> bounds,
+                               double scale = 1.0) {
+        histograms_.emplace_back(prefix_ + name, help, std::move(bounds), scale);
+        return histograms_.back().metric;
+    }
+
+    // Called on every render after the registered metrics; gets the prefix to build its own names
+    void addCollector(Collector collector) { collectors_.push_back(std::move(collector)); }
+
+    const std::string &prefix() const { return prefix_; }
+
+    std::string render() const {
+        std::string out;
+        out.reserve(4096);
+        for (const auto &c : counters_) {
+            appendMetricHeader(out, c.name, "counter", c.help);
+            appendMetricSample(out, c.name, "", static_cast<double>(c.metric.value()));
+        }
+        for (const auto &g : gauges_) {
+            appendMetricHeader(out, g.name, "gauge", g.help);
+            appendMetricSample(out, g.name, "", static_cast<double>(g.metric.value()));
+        }
+        for (const auto &h : histograms_) {
+            appendMetricHeader(out, h.name, "histogram", h.help);
+            const MetricHistogram &m = h.metric;
+            uint64_t cumulative = 0;
+            char le[64];
+            for (size_t b = 0; b < m.bounds().size(); ++b) {
+                cumulative += m.bucketCount(b);
+                std::snprintf(le, sizeof(le), "le=\"%.17g\"", m.bounds()[b] * m.scale());
+                appendMetricSample(out, h.name + "_bucket", le, static_cast<double>(cumulative));
+            }
+            cumulative += m.bucketCount(m.bounds().size());
+            appendMetricSample(out, h.name + "_bucket", "le=\"+Inf\"", static_cast<double>(cumulative));
+            appendMetricSample(out, h.name + "_sum", "", m.sum() * m.scale());
+            appendMetricSample(out, h.name + "_count", "", static_cast<double>(cumulative));
+        }
+        for (const Collector &collect : collectors_)
+            collect(out);
+        return out;
+    }
+
+private:
+    template <typename Metric>
+    struct Named {
+        template <typename... Args>
+        Named(const std::string &n, const std::string &h, Args &&...args)
+            : name(n), help(h), metric(std::forward<Args>(args)...) {}
+        std::string name;
+        std::string help;
+        Metric metric;
+    };
+
+    std::string prefix_;
+    std::deque<Named<MetricCounter>> counters_;  // deque: references stay valid as metrics are added
+    std::deque<Named<MetricGauge>> gauges_;
+    std::deque<Named<MetricHistogram>> histograms_;
+    std::vector<Collector> collectors_;
+};
@@ -0,0 +1,304 @@
+// apps/real_world_overlay/metrics_server.hpp
+// Minimal HTTP/1.1 server for Prometheus scrapes: one thread running an epoll loop over non-blocking sockets, no
+// dependencies. GET (or HEAD) /metrics returns render() as text/plain; version=0.0.4, other paths 404, other methods
+// 405. One request per connection (Connection: close); requests over 8 KiB get 431, connections idle for 5 s are
+// closed. An eventfd wakes the loop for stop().
+#pragma once
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class MetricsServer {
+public:
+    using Render = std::function<std::string()>;
+
+    static constexpr size_t kMaxRequest = 8192;
+    static constexpr int kMaxConnections = 64;
+    static constexpr uint64_t kIdleTimeoutNs = 5000000000ULL;
+
+    ~MetricsServer() { stop(); }
+
+    // Binds `address`:`port` (port 0 = any free port, see port()) and starts the loop thread. On failure returns false
+    // with `error` set.
+    bool start(const std::string &address, int port, Render render, std::string *error = nullptr) {
+        render_ = std::move(render);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1)
+            return fail(error, "invalid address " + address);
+
+        listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0)
+            return fail(error, std::string("socket: ") + std::strerror(errno));
+        int one = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+            return fail(error, "bind " + address + ":" + std::to_string(port) + ": " + std::strerror(errno));
+        if (listen(listen_fd_, 16) < 0)
+            return fail(error, std::string("listen: ") + std::strerror(errno));
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epoll_fd_ < 0 || wake_fd_ < 0)
+            return fail(error, std::string("epoll/eventfd: ") + std::strerror(errno));
+        watch(listen_fd_, EPOLLIN);
+        watch(wake_fd_, EPOLLIN);
+
+        thread_ = std::thread(&MetricsServer::loop, this);
+        return true;
+    }
+
+    void stop() {
+        if (thread_.joinable()) {
+            uint64_t one = 1;
+            ssize_t r = write(wake_fd_, &one, sizeof(one));
+            (void)r;
+            thread_.join();
+        }
+        for (auto &c : conns_)
+            close(c.first);
+        conns_.clear();
+        closeFd(listen_fd_);
+        closeFd(wake_fd_);
+        closeFd(epoll_fd_);
+    }
+
+    int port() const { return port_; }
+    uint64_t requests() const { return requests_.load(std::memory_order_relaxed); }
+
+private:
+    struct Conn {
+        std::string in;
+        std::string out;
+        size_t sent = 0;
+        uint64_t last_ns = 0;
+        bool draining = false;  // response sent, discarding the rest of an oversized request
+    };
+
+    static uint64_t nowNs() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    bool fail(std::string *error, const std::string &msg) {
+        if (error)
+            *error = msg;
+        closeFd(listen_fd_);
+        closeFd(wake_fd_);
+        closeFd(epoll_fd_);
+        return false;
+    }
+
+    static void closeFd(int &fd) {
+        if (fd >= 0)
+            close(fd);
+        fd = -1;
+    }
+
+    void watch(int fd, uint32_t events) {
+        epoll_event ev = {};
+        ev.events = events;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    void drop(int fd) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        conns_.erase(fd);
+    }
+
+    void loop() {
+        epoll_event events[32];
+        for (;;) {
+            int n = epoll_wait(epoll_fd_, events, 32, 1000);
+            if (n < 0 && errno != EINTR)
+                return;
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == wake_fd_)
+                    return;
+                if (fd == listen_fd_) {
+                    accept_all();
+                    continue;
+                }
+                auto it = conns_.find(fd);
+                if (it == conns_.end())
+                    continue;
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    drop(fd);
+                } else if (it->second.draining) {
+                    drain(fd, it->second);
+                } else if (it->second.out.empty()) {
+                    onReadable(fd, it->second);
+                } else {
+                    onWritable(fd, it->second);
+                }
+            }
+            closeIdle();
+        }
+    }
+
+    void accept_all() {
+        for (;;) {
+            int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+                return;  // EAGAIN, or a transient error: the next poll retries
+            if (conns_.size() >= static_cast<size_t>(kMaxConnections)) {
+                close(fd);
+                continue;
+            }
+            conns_[fd].last_ns = nowNs();
+            watch(fd, EPOLLIN);
+        }
+    }
+
+    void onReadable(int fd, Conn &c) {
+        char buf[2048];
+        for (;;) {
+            ssize_t r = read(fd, buf, sizeof(buf));
+            if (r > 0) {
+                c.in.append(buf, static_cast<size_t>(r));
+                c.last_ns = nowNs();
+                if (c.in.size() > kMaxRequest)
+                    break;
+                continue;
+            }
+            if (r == 0 && c.in.find("\r\n\r\n") != std::string::npos)
+                break;  // the client shut down its side after a complete request
+            if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                drop(fd);
+                return;
+            }
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        size_t end = c.in.find("\r\n\r\n");
+        if (end == std::string::npos && c.in.size() <= kMaxRequest)
+            return;  // wait for the rest of the headers
+        respond(c, end == std::string::npos || end + 4 > kMaxRequest);
+
+        epoll_event ev = {};
+        ev.events = EPOLLOUT;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+        onWritable(fd, c);
+    }
+
+    void onWritable(int fd, Conn &c) {
+        while (c.sent < c.out.size()) {
+            ssize_t w = send(fd, c.out.data() + c.sent, c.out.size() - c.sent, MSG_NOSIGNAL);
+            if (w > 0) {
+                c.sent += static_cast<size_t>(w);
+                c.last_ns = nowNs();
+                continue;
+            }
+            if (w < 0 && errno == EINTR)
+                continue;
+            if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                return;  // EPOLLOUT brings us back
+            break;
+        }
+        if (c.sent == c.out.size() && c.in.size() > kMaxRequest) {
+            // Closing with unread input would reset the connection before the client reads the 431
+            shutdown(fd, SHUT_WR);
+            c.draining = true;
+            epoll_event ev = {};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+            return;
+        }
+        drop(fd);
+    }
+
+    void drain(int fd, Conn &c) {
+        char buf[2048];
+        ssize_t r;
+        while ((r = read(fd, buf, sizeof(buf))) > 0)
+            c.last_ns = nowNs();
+        if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+            drop(fd);
+    }
+
+    void respond(Conn &c, bool too_large) {
+        requests_.fetch_add(1, std::memory_order_relaxed);
+        if (too_large) {
+            c.out = reply(431, "Request Header Fields Too Large", "text/plain", "request too large\n", true);
+            return;
+        }
+
+        // Request line: METHOD SP target SP version
+        size_t line_end = c.in.find("\r\n");
+        std::string line = c.in.substr(0, line_end);
+        size_t sp1 = line.find(' ');
+        size_t sp2 = sp1 == std::string::npos ? std::string::npos : line.find(' ', sp1 + 1);
+        if (sp2 == std::string::npos) {
+            c.out = reply(400, "Bad Request", "text/plain", "bad request\n", true);
+            return;
+        }
+        std::string method = line.substr(0, sp1);
+        std::string path = line.substr(sp1 + 1, sp2 - sp1 - 1);
+        path = path.substr(0, path.find('?'));
+
+        if (method != "GET" && method != "HEAD") {
+            c.out = reply(405, "Method Not Allowed", "text/plain", "method not allowed\n", true);
+            c.out.insert(c.out.find("\r\n") + 2, "Allow: GET, HEAD\r\n");
+            return;
+        }
+        if (path != "/metrics") {
+            c.out = reply(404, "Not Found", "text/plain", "metrics are served on /metrics\n", method == "GET");
+            return;
+        }
+        c.out = reply(200, "OK", "text/plain; version=0.0.4; charset=utf-8", render_(), method == "GET");
+    }
+
+    static std::string reply(int status, const char *reason, const char *type, const std::string &body,
+                             bool with_body) {
+        std::string out = "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\nContent-Type: " + type +
+                          "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+        if (with_body)
+            out += body;
+        return out;
+    }
+
+    void closeIdle() {
+        uint64_t now = nowNs();
+        std::vector<int> idle;
+        for (const auto &c : conns_) {
+            if (now - c.second.last_ns > kIdleTimeoutNs)
+                idle.push_back(c.first);
+        }
+        for (int fd : idle)
+            drop(fd);
+    }
+
+    Render render_;
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    int port_ = 0;
+    std::thread thread_;
+    std::unordered_map<int, Conn> conns_;  // loop thread only
+    std::atomic<uint64_t> requests_{0};
+};
@@ -0,0 +1,263 @@
+// apps/real_world_overlay/motion_detector.hpp
+// Cheap motion test for gating inference. The luma plane is point-sampled every `downscale` pixels into a small plane
+// (4K / 8 = 480 x 270), compared with the previous sampled frame in 8 x 8 sample blocks by sum of absolute differences
+// (SSE2 psadbw / NEON vabd, two blocks per 16-byte row), and a block whose mean difference exceeds pixel_threshold is
+// changed. Motion needs min_blocks changed blocks; the changed mask is then dilated by `dilation` blocks to give the
+// moving region. MotionGate turns the per-frame answer into infer / skip with a hold after motion and a forced
+// re-check. No GStreamer here, tools/motion_detector_bench runs it on raw frames.
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define MOTION_DETECTOR_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MOTION_DETECTOR_NEON 1
+#endif
+
+struct MotionDetectorConfig {
+    int downscale = 8;        // source pixels between samples, in x and y
+    int pixel_threshold = 10; // mean absolute luma difference per sample that makes a block changed
+    int min_blocks = 2;       // changed blocks for motion
+    int dilation = 1;         // blocks the changed mask grows by, for the motion region
+};
+
+struct MotionResult {
+    bool motion = false;
+    int changed_blocks = 0;  // before dilation
+    int active_blocks = 0;   // after dilation
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;  // bounding box of the active blocks in source pixels, empty without motion
+};
+
+namespace motion_detector_detail {
+
+constexpr int kBlock = 8;  // samples per block side
+
+// SAD of each 8 x 8 block along one block row; planes are `stride` bytes wide, a multiple of 16
+inline void sadBlockRowScalar(const uint8_t *a, const uint8_t *b, int stride, int blocks, uint32_t *out) {
+    for (int k = 0; k < blocks; ++k) {
+        uint32_t sad = 0;
+        for (int r = 0; r < kBlock; ++r) {
+            const uint8_t *pa = a + r * stride + k * kBlock, *pb = b + r * stride + k * kBlock;
+            for (int c = 0; c < kBlock; ++c)
+                sad += static_cast<uint32_t>(std::abs(pa[c] - pb[c]));
+        }
+        out[k] = sad;
+    }
+}
+
+inline void sadBlockRow(const uint8_t *a, const uint8_t *b, int stride, int blocks, uint32_t *out) {
+#if MOTION_DETECTOR_SSE2
+    int k = 0;
+    for (; k + 2 <= blocks; k += 2) {
+        __m128i acc = _mm_setzero_si128();
+        for (int r = 0; r < kBlock; ++r) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + r * stride + k * kBlock));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + r * stride + k * kBlock));
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+        }
+        out[k] = static_cast<uint32_t>(_mm_cvtsi128_si32(acc));
+        out[k + 1] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+    }
+    if (k < blocks)
+        sadBlockRowScalar(a + k * kBlock, b + k * kBlock, stride, blocks - k, out + k);
+#elif MOTION_DETECTOR_NEON
+    int k = 0;
+    for (; k + 2 <= blocks; k += 2) {
+        uint16x8_t acc = vdupq_n_u16(0);
+        for (int r = 0; r < kBlock; ++r) {
+            uint8x16_t va = vld1q_u8(a + r * stride + k * kBlock);
+            uint8x16_t vb = vld1q_u8(b + r * stride + k * kBlock);
+            acc = vpadalq_u8(acc, vabdq_u8(va, vb));
+        }
+        uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(acc));
+        out[k] = static_cast<uint32_t>(vgetq_lane_u64(sums, 0));
+        out[k + 1] = static_cast<uint32_t>(vgetq_lane_u64(sums, 1));
+    }
+    if (k < blocks)
+        sadBlockRowScalar(a + k * kBlock, b + k * kBlock, stride, blocks - k, out + k);
+#else
+    sadBlockRowScalar(a, b, stride, blocks, out);
+#endif
+}
+
+}  // namespace motion_detector_detail
+
+inline const char *motionDetectorSimdName() {
+#if MOTION_DETECTOR_SSE2
+    return "sse2";
+#elif MOTION_DETECTOR_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+// One per source, called from that source's streaming thread
+class MotionDetector {
+public:
+    explicit MotionDetector(const MotionDetectorConfig &cfg = MotionDetectorConfig()) : cfg_(cfg) {
+        cfg_.downscale = std::max(cfg_.downscale, 1);
+        cfg_.min_blocks = std::max(cfg_.min_blocks, 1);
+        cfg_.dilation = std::max(cfg_.dilation, 0);
+    }
+
+    // `luma` points at the first luma sample, `pixel_step` is the byte distance between luma samples of a row (2 for
+    // YUY2 / UYVY, 1 for planar formats) and `stride` the bytes per row. The first frame, and the first after a size
+    // change, only becomes the reference and reports motion.
+    MotionResult update(const uint8_t *luma, int width, int height, int stride, int pixel_step) {
+        using namespace motion_detector_detail;
+        const int ds = cfg_.downscale;
+        int sw = width / ds, sh = height / ds;
+        int bx = sw / kBlock, by = sh / kBlock;
+        MotionResult result;
+        if (bx < 1 || by < 1) {
+            result.motion = true;  // too small to tell
+            return result;
+        }
+        bool first = width != width_ || height != height_;
+        if (first)
+            resize(width, height, bx, by);
+
+        // Sample the centre of every ds x ds cell of the block area
+        const int off = ds / 2;
+        for (int y = 0; y < by * kBlock; ++y) {
+            const uint8_t *row =
+                luma + static_cast<size_t>(y * ds + off) * stride + static_cast<size_t>(off) * pixel_step;
+            uint8_t *dst = cur_.data() + static_cast<size_t>(y) * plane_stride_;
+            const size_t step = static_cast<size_t>(ds) * pixel_step;
+            for (int x = 0; x < bx * kBlock; ++x)
+                dst[x] = row[x * step];
+        }
+        if (first) {
+            cur_.swap(prev_);
+            result.motion = true;
+            return result;
+        }
+
+        const uint32_t limit = static_cast<uint32_t>(cfg_.pixel_threshold) * kBlock * kBlock;
+        for (int r = 0; r < by; ++r) {
+            size_t at = static_cast<size_t>(r) * kBlock * plane_stride_;
+            sadBlockRow(cur_.data() + at, prev_.data() + at, plane_stride_, bx, sad_.data());
+            for (int k = 0; k < bx; ++k) {
+                uint8_t changed = sad_[k] > limit;
+                changed_[r * bx + k] = changed;
+                result.changed_blocks += changed;
+            }
+        }
+        cur_.swap(prev_);
+
+        result.motion = result.changed_blocks >= cfg_.min_blocks;
+        if (!result.motion) {
+            std::fill(mask_.begin(), mask_.end(), 0);
+            return result;
+        }
+        dilate();
+        int min_x = bx, min_y = by, max_x = -1, max_y = -1;
+        for (int r = 0; r < by; ++r) {
+            for (int k = 0; k < bx; ++k) {
+                if (!mask_[r * bx + k])
+                    continue;
+                ++result.active_blocks;
+                min_x = std::min(min_x, k);
+                max_x = std::max(max_x, k);
+                min_y = std::min(min_y, r);
+                max_y = std::max(max_y, r);
+            }
+        }
+        const int cell = kBlock * ds;
+        result.x0 = min_x * cell;
+        result.y0 = min_y * cell;
+        result.x1 = std::min(width, (max_x + 1) * cell);
+        result.y1 = std::min(height, (max_y + 1) * cell);
+        return result;
+    }
+
+    // Active blocks of the last update, blocksX() x blocksY(), row-major
+    const std::vector<uint8_t> &mask() const { return mask_; }
+    int blocksX() const { return bx_; }
+    int blocksY() const { return by_; }
+    const MotionDetectorConfig &config() const { return cfg_; }
+
+private:
+    void resize(int width, int height, int bx, int by) {
+        using motion_detector_detail::kBlock;
+        width_ = width;
+        height_ = height;
+        bx_ = bx;
+        by_ = by;
+        plane_stride_ = (bx * kBlock + 15) & ~15;  // whole 16-byte loads, the padding is 0 in both planes
+        cur_.assign(static_cast<size_t>(plane_stride_) * by * kBlock, 0);
+        prev_.assign(cur_.size(), 0);
+        sad_.assign(bx, 0);
+        changed_.assign(static_cast<size_t>(bx) * by, 0);
+        mask_.assign(changed_.size(), 0);
+        tmp_.assign(changed_.size(), 0);
+    }
+
+    // Square structuring element of radius `dilation`, as a horizontal then a vertical pass
+    void dilate() {
+        const int d = cfg_.dilation;
+        if (d == 0) {
+            mask_ = changed_;
+            return;
+        }
+        for (int r = 0; r < by_; ++r) {
+            for (int k = 0; k < bx_; ++k) {
+                uint8_t v = 0;
+                for (int j = std::max(0, k - d); j <= std::min(bx_ - 1, k + d) && !v; ++j)
+                    v = changed_[r * bx_ + j];
+                tmp_[r * bx_ + k] = v;
+            }
+        }
+        for (int r = 0; r < by_; ++r) {
+            for (int k = 0; k < bx_; ++k) {
+                uint8_t v = 0;
+                for (int j = std::max(0, r - d); j <= std::min(by_ - 1, r + d) && !v; ++j)
+                    v = tmp_[j * bx_ + k];
+                mask_[r * bx_ + k] = v;
+            }
+        }
+    }
+
+    MotionDetectorConfig cfg_;
+    int width_ = 0, height_ = 0, bx_ = 0, by_ = 0, plane_stride_ = 0;
+    std::vector<uint8_t> cur_, prev_;  // sampled luma, this frame and the reference
+    std::vector<uint32_t> sad_;
+    std::vector<uint8_t> changed_, mask_, tmp_;
+};
+
+struct MotionGateConfig {
+    int hold_frames = 15;      // frames still inferred after the last motion, so objects coming to rest are seen
+    int recheck_frames = 150;  // infer at least once every this many frames, 0 = never without motion
+};
+
+// Per batch: infer while any source moves, for hold_frames after, and every recheck_frames regardless
+class MotionGate {
+public:
+    explicit MotionGate(const MotionGateConfig &cfg = MotionGateConfig()) : cfg_(cfg) {}
+
+    bool infer(bool motion) {
+        since_motion_ = std::min(since_motion_ + 1, 1 << 30);
+        ++since_infer_;
+        if (motion)
+            since_motion_ = 0;
+        bool recheck = cfg_.recheck_frames > 0 && since_infer_ >= cfg_.recheck_frames;
+        bool run = since_motion_ <= cfg_.hold_frames || recheck;
+        if (run)
+            since_infer_ = 0;
+        return run;
+    }
+
+    const MotionGateConfig &config() const { return cfg_; }
+
+private:
+    MotionGateConfig cfg_;
+    int since_motion_ = 0;  // the first frames are inferred
+    int since_infer_ = 0;
+};
@@ -0,0 +1,325 @@
+// apps/real_world_overlay/pipeline_builder.hpp
+// Builds the gst-launch description of the overlay pipeline from PipelineConfig, without GStreamer:
+//   source -> [decode] -> one conversion to NV12 in NVMM -> nvstreammux -> nvinfer -> [nvdsosd] -> [encode] -> sink
+// nvinfer takes the batch of nvstreammux, one frame per mux pad, and the engine file named for that batch.
+// Raw cameras are converted once, straight to NV12 NVMM (no intermediate I420 pass). MJPEG cameras are decoded by
+// nvv4l2decoder. A source crop (roi_crop.hpp) is cut by that same conversion. A tiled source (tile_merge.hpp) is teed
+// after its caps / decoder into one more conversion per tile, each feeding its own nvstreammux pad: pads 0..N-1 are
+// the sources, the tiles follow in source order. The result lists the element factories it uses so the caller can
+// check they are installed, and a readable one-element-per-line rendering of the graph.
+#pragma once
+#include <string>
+#include <vector>
+
+struct SourceCrop {
+    int x = 0, y = 0, width = 0, height = 0;
+};
+
+struct SourceConfig {
+    std::string type = "v4l2";    // "v4l2", "videotest" or "uri"
+    std::string device = "video0";
+    std::string uri;              // "uri" sources
+    std::string format = "raw";   // v4l2: "raw" or "mjpeg"
+    std::string raw_format;       // v4l2 raw: pixel format to request (e.g. "YUY2"), empty = camera default
+    int width = 1920, height = 1080;
+    int fps_n = 0, fps_d = 1;     // 0 = camera default
+    int crop_x = 0, crop_y = 0, crop_width = 0, crop_height = 0;  // pixels kept by the conversion, width 0 = all
+    std::vector<SourceCrop> tiles;  // tiled inference: one more nvstreammux pad per tile, empty = not tiled
+};
+
+// Size of what a source sends to nvstreammux
+inline void sourceOutputSize(const SourceConfig &s, int &width, int &height) {
+    bool cropped = s.crop_width > 0 && s.crop_height > 0;
+    width = cropped ? s.crop_width : s.width;
+    height = cropped ? s.crop_height : s.height;
+}
+
+struct PipelineConfig {
+    std::vector<SourceConfig> sources;
+    std::string converter = "nvvidconv";   // "nvvidconv" (Jetson) or "nvvideoconvert" (dGPU)
+    int mux_width = 0, mux_height = 0;     // 0 = output size of the first source
+    int batched_push_timeout_us = -1;      // nvstreammux, -1 = element default
+    std::string infer_config = "/home/flux/DeepStream-Yolo/config_infer_primary_yoloV10.txt";
+    int infer_interval = 0;                // frames skipped between inferences
+    std::string infer_engine;              // model-engine-file of the inference config, "" = left to the config
+    bool osd = true;                       // nvdsosd after nvinfer, false = headless (overlay = "none")
+    std::string encoder = "h264";          // "h264", "h265" or "none"
+    int bitrate = 0;                       // bits/s, 0 = encoder default
+    std::string sink = "udp";              // "udp" (RTP), "file", "display" or "fake"
+    std::string host = "100.72.147.81";
+    int port = 5000;
+    int mtu = 60000;
+    std::string location;                  // "file" sink
+    bool sync = false;
+};
+
+// nvstreammux pads: one per source, then one per tile
+inline size_t muxPadCount(const PipelineConfig &cfg) {
+    size_t pads = cfg.sources.size();
+    for (const SourceConfig &s : cfg.sources)
+        pads += s.tiles.size();
+    return pads;
+}
+
+// nvstreammux pad of tile `tile` of source `source`
+inline size_t tilePad(const PipelineConfig &cfg, size_t source, size_t tile) {
+    size_t pad = cfg.sources.size();
+    for (size_t i = 0; i < source; ++i)
+        pad += cfg.sources[i].tiles.size();
+    return pad + tile;
+}
+
+// `engine` with the batch in its file name (model_b1_gpu0_fp32.engine) set to `batch`, the name nvinfer saves an
+// engine it builds for that batch under; "" when the file name carries no _b<N>_
+inline std::string batchEngineFile(const std::string &engine, size_t batch) {
+    size_t name = engine.rfind('/');
+    name = name == std::string::npos ? 0 : name + 1;
+    for (size_t b = engine.find("_b", name); b != std::string::npos; b = engine.find("_b", b + 1)) {
+        size_t end = engine.find_first_not_of("0123456789", b + 2);
+        if (end != std::string::npos && end > b + 2 && engine[end] == '_')
+            return engine.substr(0, b + 2) + std::to_string(batch) + engine.substr(end);
+    }
+    return "";
+}
+
+struct PipelineDescription {
+    std::string launch;                  // for gst_parse_launch
+    std::string graph;                   // one element per line, for logs
+    std::vector<std::string> factories;  // distinct element factories used
+};
+
+namespace pipeline_builder_detail {
+
+struct Chain {
+    std::vector<std::string> items;  // elements with properties, caps, or pad references
+    std::vector<std::string> *factories;
+
+    Chain &add(const std::string &factory, const std::string &props = "") {
+        items.push_back(props.empty() ? factory : factory + " " + props);
+        for (const std::string &f : *factories) {
+            if (f == factory)
+                return *this;
+        }
+        factories->push_back(factory);
+        return *this;
+    }
+
+    Chain &caps(const std::string &caps) {
+        items.push_back(caps);
+        return *this;
+    }
+
+    Chain &ref(const std::string &pad) {
+        items.push_back(pad);
+        return *this;
+    }
+
+    std::string launch() const {
+        std::string out;
+        for (size_t i = 0; i < items.size(); ++i)
+            out += (i ? " ! " : "") + items[i];
+        return out;
+    }
+
+    std::string graph() const {
+        std::string out;
+        for (size_t i = 0; i < items.size(); ++i)
+            out += (i ? "    ! " : "  ") + items[i] + "\n";
+        return out;
+    }
+};
+
+inline std::string quoted(const std::string &s) {
+    return s.find_first_of(" !\"") == std::string::npos ? s : "\"" + s + "\"";
+}
+
+inline std::string framerate(const SourceConfig &s) {
+    return s.fps_n > 0 ? ", framerate=" + std::to_string(s.fps_n) + "/" + std::to_string(s.fps_d) : "";
+}
+
+inline std::string size(int w, int h) { return "width=" + std::to_string(w) + ", height=" + std::to_string(h); }
+
+// The one conversion: whatever the source produced, to NV12 in NVMM, cut to (x, y, w, h) when that is not the frame
+inline bool addConversion(const PipelineConfig &cfg, const SourceConfig &s, int x, int y, int w, int h, size_t pad,
+                          const std::string &what, Chain &c, std::string *error) {
+    if (w != s.width || h != s.height) {
+        if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > s.width || y + h > s.height) {
+            *error = what + ": crop outside the frame";
+            return false;
+        }
+        if (cfg.converter == "nvvideoconvert") {
+            c.add(cfg.converter, "src-crop=" + std::to_string(x) + ":" + std::to_string(y) + ":" + std::to_string(w) +
+                                     ":" + std::to_string(h));
+        } else {
+            c.add(cfg.converter, "left=" + std::to_string(x) + " top=" + std::to_string(y) +
+                                     " right=" + std::to_string(x + w) + " bottom=" + std::to_string(y + h));
+        }
+    } else {
+        c.add(cfg.converter);
+    }
+    c.caps("video/x-raw(memory:NVMM), format=NV12, " + size(w, h));
+    c.ref("mux.sink_" + std::to_string(pad));
+    return true;
+}
+
+inline bool buildSource(const PipelineConfig &cfg, size_t index, Chain &c, std::string *error) {
+    const SourceConfig &s = cfg.sources[index];
+    std::string name = "name=src" + std::to_string(index);
+    if (s.width <= 0 || s.height <= 0 || s.fps_n < 0 || s.fps_d <= 0) {
+        *error = "source " + std::to_string(index) + ": invalid size or framerate";
+        return false;
+    }
+
+    if (s.type == "v4l2") {
+        c.add("v4l2src", "device=/dev/" + s.device + " " + name);
+        if (s.format == "mjpeg") {
+            c.caps("image/jpeg, " + size(s.width, s.height) + framerate(s));
+            c.add("jpegparse").add("nvv4l2decoder", "mjpeg=1");
+        } else if (s.format == "raw") {
+            std::string fmt = s.raw_format.empty() ? "" : ", format=" + s.raw_format;
+            c.caps("video/x-raw" + fmt + ", " + size(s.width, s.height) + framerate(s));
+        } else {
+            *error = "source " + std::to_string(index) + ": format must be raw or mjpeg";
+            return false;
+        }
+    } else if (s.type == "videotest") {
+        c.add("videotestsrc", "is-live=true " + name);
+        c.caps("video/x-raw, " + size(s.width, s.height) + framerate(s));
+    } else if (s.type == "uri") {
+        if (s.uri.empty()) {
+            *error = "source " + std::to_string(index) + ": uri source without uri";
+            return false;
+        }
+        c.add("uridecodebin", "uri=" + quoted(s.uri) + " " + name);
+    } else {
+        *error = "source " + std::to_string(index) + ": type must be v4l2, videotest or uri";
+        return false;
+    }
+
+    // At the source (or crop) size; the tiles branch off before it
+    if (!s.tiles.empty())
+        c.add("tee", "name=t" + std::to_string(index)).add("queue");
+    int out_w, out_h;
+    sourceOutputSize(s, out_w, out_h);
+    bool cropped = out_w != s.width || out_h != s.height;
+    return addConversion(cfg, s, cropped ? s.crop_x : 0, cropped ? s.crop_y : 0, out_w, out_h, index,
+                         "source " + std::to_string(index), c, error);
+}
+
+// Branch of tile `tile` of source `index`, from the source's tee to its nvstreammux pad
+inline bool buildTile(const PipelineConfig &cfg, size_t index, size_t tile, Chain &c, std::string *error) {
+    const SourceConfig &s = cfg.sources[index];
+    const SourceCrop &t = s.tiles[tile];
+    c.ref("t" + std::to_string(index) + ".");
+    c.add("queue");
+    return addConversion(cfg, s, t.x, t.y, t.width, t.height, tilePad(cfg, index, tile),
+                         "source " + std::to_string(index) + " tile " + std::to_string(tile), c, error);
+}
+
+}  // namespace pipeline_builder_detail
+
+// Returns false with `error` set for an invalid configuration
+inline bool buildPipelineDescription(const PipelineConfig &cfg, PipelineDescription &out, std::string *error) {
+    using namespace pipeline_builder_detail;
+    std::string unused;
+    if (!error)
+        error = &unused;
+    out = PipelineDescription();
+
+    if (cfg.sources.empty()) {
+        *error = "no sources";
+        return false;
+    }
+    if (cfg.converter != "nvvidconv" && cfg.converter != "nvvideoconvert") {
+        *error = "converter must be nvvidconv or nvvideoconvert";
+        return false;
+    }
+    if (cfg.infer_config.empty()) {
+        *error = "inference config file not set";
+        return false;
+    }
+
+    // Main branch: mux, inference, overlay, output
+    Chain main{{}, &out.factories};
+    int mux_w, mux_h;
+    sourceOutputSize(cfg.sources[0], mux_w, mux_h);
+    mux_w = cfg.mux_width > 0 ? cfg.mux_width : mux_w;
+    mux_h = cfg.mux_height > 0 ? cfg.mux_height : mux_h;
+    std::string mux = "name=mux batch-size=" + std::to_string(muxPadCount(cfg)) + " width=" + std::to_string(mux_w) +
+                      " height=" + std::to_string(mux_h);
+    if (cfg.batched_push_timeout_us >= 0)
+        mux += " batched-push-timeout=" + std::to_string(cfg.batched_push_timeout_us);
+    main.add("nvstreammux", mux);
+
+    // nvinfer batches as many frames as the mux, with the engine built for that batch: a batch-1 engine would be
+    // rebuilt at every start, or run one frame of the batch at a time
+    size_t batch = muxPadCount(cfg);
+    std::string infer =
+        "name=infer config-file-path=" + quoted(cfg.infer_config) + " batch-size=" + std::to_string(batch);
+    std::string engine = batchEngineFile(cfg.infer_engine, batch);
+    if (!engine.empty())
+        infer += " model-engine-file=" + quoted(engine);
+    if (cfg.infer_interval > 0)
+        infer += " interval=" + std::to_string(cfg.infer_interval);
+    main.add("nvinfer", infer);
+    if (cfg.osd)
+        main.add("nvdsosd", "name=osd");
+
+    if (cfg.sink == "display") {
+        // Both take the RGBA NVMM output of nvdsosd, or the NV12 of nvinfer, directly
+        main.add(cfg.converter == "nvvidconv" ? "nv3dsink" : "nveglglessink",
+                 std::string("sync=") + (cfg.sync ? "true" : "false"));
+    } else if (cfg.sink == "fake" && cfg.encoder == "none") {
+        main.add("fakesink", std::string("sync=") + (cfg.sync ? "true" : "false"));
+    } else {
+        if (cfg.encoder != "h264" && cfg.encoder != "h265") {
+            *error = cfg.sink + " sink needs encoder h264 or h265";
+            return false;
+        }
+        // nvdsosd outputs RGBA, the encoders take NV12 (a passthrough without nvdsosd)
+        main.add(cfg.converter);
+        main.caps("video/x-raw(memory:NVMM), format=NV12");
+        std::string enc = cfg.bitrate > 0 ? "bitrate=" + std::to_string(cfg.bitrate) : "";
+        main.add(cfg.encoder == "h264" ? "nvv4l2h264enc" : "nvv4l2h265enc", enc);
+        std::string sync = std::string("sync=") + (cfg.sync ? "true" : "false");
+
+        if (cfg.sink == "udp") {
+            if (cfg.host.empty() || cfg.port <= 0 || cfg.port > 65535) {
+                *error = "udp sink needs host and port";
+                return false;
+            }
+            main.add(cfg.encoder == "h264" ? "rtph264pay" : "rtph265pay", "mtu=" + std::to_string(cfg.mtu));
+            main.add("udpsink", "clients=" + cfg.host + ":" + std::to_string(cfg.port) + " " + sync);
+        } else if (cfg.sink == "file") {
+            if (cfg.location.empty()) {
+                *error = "file sink needs a location";
+                return false;
+            }
+            main.add(cfg.encoder == "h264" ? "h264parse" : "h265parse").add("qtmux");
+            main.add("filesink", "location=" + quoted(cfg.location) + " " + sync);
+        } else if (cfg.sink == "fake") {
+            main.add("fakesink", sync);
+        } else {
+            *error = "sink must be udp, file, display or fake";
+            return false;
+        }
+    }
+
+    out.launch = main.launch();
+    out.graph = main.graph();
+    for (size_t i = 0; i < cfg.sources.size(); ++i) {
+        Chain src{{}, &out.factories};
+        if (!buildSource(cfg, i, src, error))
+            return false;
+        out.launch += "  " + src.launch();
+        out.graph += src.graph();
+        for (size_t k = 0; k < cfg.sources[i].tiles.size(); ++k) {
+            Chain tile{{}, &out.factories};
+            if (!buildTile(cfg, i, k, tile, error))
+                return false;
+            out.launch += "  " + tile.launch();
+            out.graph += tile.graph();
+        }
+    }
+    return true;
+}
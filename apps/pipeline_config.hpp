@@ -0,0 +1,143 @@
+// apps/real_world_overlay/pipeline_config.hpp
+// Reads the pipeline sections of config.toml into PipelineConfig. Every section and key is optional; the defaults
+// reproduce the original hardcoded pipeline minus its redundant I420 conversion.
+//   [source]      type = "v4l2" | "videotest" | "uri", device (default: top-level device), uri
+//   [caps]        format = "raw" | "mjpeg", raw_format, framerate = [num, den]   (size: top-level resolution)
+//   [[camera]]    one source per entry, the [source] and [caps] keys above override per camera
+//   [conversion]  converter = "nvvidconv" | "nvvideoconvert", mux_resolution = [w, h], batched_push_timeout (us)
+//   [inference]   config, interval, engine (default: model-engine-file of the config, renamed for the batch)
+//   [encoder]     codec = "h264" | "h265" | "none", bitrate (bits/s)
+//   [sink]        type = "udp" | "file" | "display" | "fake", host, port, mtu, location, sync
+#pragma once
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <toml.hpp>
+
+#include "pipeline_builder.hpp"
+
+// Reads the [source] keys of `source` and the [caps] keys of `caps` over the values already in `src`
+inline bool parseSourceKeys(toml::node_view<const toml::node> source, toml::node_view<const toml::node> caps,
+                            SourceConfig &src, std::string &error) {
+    src.type = source["type"].value_or(src.type);
+    src.device = source["device"].value_or(src.device);
+    src.uri = source["uri"].value_or(src.uri);
+    src.format = caps["format"].value_or(src.format);
+    src.raw_format = caps["raw_format"].value_or(src.raw_format);
+    if (auto fps = caps["framerate"].as_array()) {
+        if (fps->size() != 2) {
+            error = "Invalid framerate in config.toml (num, den)";
+            return false;
+        }
+        src.fps_n = static_cast<int>(fps->at(0).value_or(0));
+        src.fps_d = static_cast<int>(fps->at(1).value_or(1));
+    }
+    return true;
+}
+
+// `key` of the [property] group of an nvinfer config, a path taken relative to the config's directory; "" when the
+// file or the key is missing
+inline std::string inferConfigPath(const std::string &path, const std::string &key) {
+    std::ifstream file(path);
+    std::string line, group;
+    while (std::getline(file, line)) {
+        size_t begin = line.find_first_not_of(" \t\r"), end = line.find_last_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#')
+            continue;
+        line = line.substr(begin, end - begin + 1);
+        if (line[0] == '[') {
+            group = line;
+            continue;
+        }
+        size_t eq = line.find('=');
+        if (group != "[property]" || eq == std::string::npos || eq == 0)
+            continue;
+        if (line.substr(0, line.find_last_not_of(" \t", eq - 1) + 1) != key)
+            continue;
+        std::string value = line.substr(eq + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+        size_t dir = path.rfind('/');
+        if (value.empty() || value[0] == '/' || dir == std::string::npos)
+            return value;
+        return path.substr(0, dir + 1) + value;
+    }
+    return "";
+}
+
+// model-engine-file of an nvinfer config
+inline std::string inferConfigEngine(const std::string &path) { return inferConfigPath(path, "model-engine-file"); }
+
+// `cameras` holds the device and resolution of every camera, in [[camera]] order (one entry without the array)
+inline bool parsePipelineConfig(const toml::table &data, const std::vector<SourceConfig> &cameras, PipelineConfig &pc,
+                                std::string &error) {
+    auto list = data["camera"].as_array();
+    pc.sources.clear();
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        SourceConfig src = cameras[i];
+        if (!parseSourceKeys(data["source"], data["caps"], src, error))
+            return false;
+        src.device = cameras[i].device;
+        if (list && i < list->size()) {
+            toml::node_view<const toml::node> cam(list->at(i));
+            if (!parseSourceKeys(cam, cam, src, error)) {
+                error = "camera " + std::to_string(i) + ": " + error;
+                return false;
+            }
+        } else {
+            src.device = data["source"]["device"].value_or(src.device);
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (src.type == "v4l2" && pc.sources[j].type == "v4l2" && src.device == pc.sources[j].device) {
+                error = "cameras " + std::to_string(j) + " and " + std::to_string(i) + " share /dev/" + src.device;
+                return false;
+            }
+        }
+        pc.sources.push_back(src);
+    }
+
+    auto conversion = data["conversion"];
+    pc.converter = conversion["converter"].value_or(pc.converter);
+    if (auto res = conversion["mux_resolution"].as_array()) {
+        if (res->size() != 2) {
+            error = "Invalid mux_resolution in config.toml (width, height)";
+            return false;
+        }
+        pc.mux_width = static_cast<int>(res->at(0).value_or(0));
+        pc.mux_height = static_cast<int>(res->at(1).value_or(0));
+    }
+    pc.batched_push_timeout_us = conversion["batched_push_timeout"].value_or(pc.batched_push_timeout_us);
+    if (pc.sources.size() > 1 && pc.batched_push_timeout_us < 0)
+        pc.batched_push_timeout_us = 40000;  // do not hold the batch forever for a stalled camera
+
+    auto inference = data["inference"];
+    pc.infer_config = inference["config"].value_or(pc.infer_config);
+    pc.infer_interval = inference["interval"].value_or(pc.infer_interval);
+    pc.infer_engine = inference["engine"].value_or(inferConfigEngine(pc.infer_config));
+
+    auto encoder = data["encoder"];
+    pc.encoder = encoder["codec"].value_or(pc.encoder);
+    pc.bitrate = encoder["bitrate"].value_or(pc.bitrate);
+
+    auto sink = data["sink"];
+    pc.sink = sink["type"].value_or(pc.sink);
+    pc.host = sink["host"].value_or(pc.host);
+    pc.port = sink["port"].value_or(pc.port);
+    pc.mtu = sink["mtu"].value_or(pc.mtu);
+    pc.location = sink["location"].value_or(pc.location);
+    pc.sync = sink["sync"].value_or(pc.sync);
+
+    // Catch configuration mistakes here rather than at gst_parse_launch
+    PipelineDescription desc;
+    return buildPipelineDescription(pc, desc, &error);
+}
+
+// Single camera described by the top-level `device`, `width` and `height`
+inline bool parsePipelineConfig(const toml::table &data, const std::string &device, int width, int height,
+                                PipelineConfig &pc, std::string &error) {
+    SourceConfig camera;
+    camera.device = device;
+    camera.width = width;
+    camera.height = height;
+    return parsePipelineConfig(data, std::vector<SourceConfig>(1, camera), pc, error);
+}
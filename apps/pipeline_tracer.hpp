@@ -0,0 +1,268 @@
+// apps/real_world_overlay/pipeline_tracer.hpp
+// GStreamer side of the latency tracer: a buffer probe on every element of a pipeline feeding LatencyTracer, and the
+// periodic / SIGUSR1 JSON dump. Sources (no sink pads) are probed on their src pads and start a buffer's trace, sinks
+// (no src pads) on their sink pads, every other element on its src pads. Buffers are keyed by PTS, or by the offset
+// (the frame number for video sources) when a buffer has no PTS, within the lane of the pad: cameras started together
+// and the tiles of one frame carry equal PTS, so each source, each tee branch and each muxer output traces on its own
+// lane (latency_tracer.hpp). Needs GStreamer only, no DeepStream.
+#pragma once
+#include <glib-unix.h>
+#include <gst/gst.h>
+#include <signal.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "latency_tracer.hpp"
+
+struct PipelineTracer {
+    struct Probe {
+        LatencyTracer *tracer;
+        int stage;
+    };
+
+    LatencyTracer tracer;
+    std::vector<std::unique_ptr<Probe>> probes;
+    std::string output;  // JSON file, replaced on every dump; stdout when empty
+};
+
+static GstPadProbeReturn latency_pad_probe(GstPad *, GstPadProbeInfo *info, gpointer user_data) {
+    PipelineTracer::Probe *probe = static_cast<PipelineTracer::Probe *>(user_data);
+    GstBuffer *buf = nullptr;
+    if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+        GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+        if (list && gst_buffer_list_length(list) > 0)
+            buf = gst_buffer_list_get(list, 0);
+    } else {
+        buf = GST_PAD_PROBE_INFO_BUFFER(info);
+    }
+    if (!buf)
+        return GST_PAD_PROBE_OK;
+
+    uint64_t key = GST_BUFFER_PTS(buf);
+    if (!GST_CLOCK_TIME_IS_VALID(key)) {
+        key = GST_BUFFER_OFFSET(buf);
+        if (key == GST_BUFFER_OFFSET_NONE)
+            return GST_PAD_PROBE_OK;
+    }
+    probe->tracer->onBuffer(probe->stage, key, latencyNowNs());
+    return GST_PAD_PROBE_OK;
+}
+
+// Lanes of the pads, set up before any probe: every source, and every element whose input is not linked yet (behind
+// the dynamic pads of uridecodebin), starts a lane; an element with several src pads (tee) starts one per pad from the
+// lane it receives, and an element with several sink pads (nvstreammux) one from all the lanes it receives. Others
+// stay on the lane they receive. Lane 0 is left to pads no lane reaches.
+struct LatencyLanes {
+    std::map<GstPad *, uint32_t> pads;        // src pads, and the sink pads of sinks
+    std::vector<std::vector<uint32_t>> from;  // lanes each lane continues, by lane
+    std::set<GstElement *> starts;            // elements traced as sources
+};
+
+static std::vector<GstPad *> latencyElementPads(GstElement *element, bool sink_pads) {
+    std::vector<GstPad *> pads;
+    GST_OBJECT_LOCK(element);
+    for (GList *l = sink_pads ? element->sinkpads : element->srcpads; l; l = l->next)
+        pads.push_back(GST_PAD(l->data));
+    GST_OBJECT_UNLOCK(element);
+    return pads;
+}
+
+// The src pad of the element feeding `sink_pad`, through the ghost pads of bins; null when it is not linked
+static GstPad *latencyUpstreamPad(GstPad *sink_pad) {
+    GstPad *pad = gst_pad_get_peer(sink_pad);
+    for (int depth = 0; pad && depth < 16; ++depth) {
+        GstPad *next = nullptr;
+        if (GST_IS_GHOST_PAD(pad)) {
+            next = gst_ghost_pad_get_target(GST_GHOST_PAD(pad));  // src ghost pad of a bin: continue inside
+        } else if (GST_IS_PROXY_PAD(pad)) {
+            GstProxyPad *ghost = gst_proxy_pad_get_internal(GST_PROXY_PAD(pad));  // inside a bin: continue outside
+            if (ghost) {
+                next = gst_pad_get_peer(GST_PAD(ghost));
+                gst_object_unref(ghost);
+            }
+        } else {
+            gst_object_unref(pad);  // still held by its element
+            return pad;
+        }
+        gst_object_unref(pad);
+        pad = next;
+    }
+    if (pad)
+        gst_object_unref(pad);
+    return nullptr;
+}
+
+static LatencyLanes assignLatencyLanes(const std::vector<GstElement *> &elements) {
+    LatencyLanes lanes;
+    lanes.from.emplace_back();
+    auto newLane = [&lanes](const std::vector<uint32_t> &from) {
+        lanes.from.push_back(from);
+        return static_cast<uint32_t>(lanes.from.size() - 1);
+    };
+
+    // Elements wait for the lanes of their linked inputs; a pass without progress lets the rest go with those known
+    std::set<GstElement *> done;
+    bool force = false;
+    while (done.size() < elements.size()) {
+        bool progress = false;
+        for (GstElement *element : elements) {
+            if (done.count(element))
+                continue;
+            std::vector<GstPad *> sinks = latencyElementPads(element, true), srcs = latencyElementPads(element, false);
+            std::vector<uint32_t> inputs, sink_lanes;
+            bool linked = false, waiting = false;
+            for (GstPad *pad : sinks) {
+                GstPad *up = latencyUpstreamPad(pad);
+                std::map<GstPad *, uint32_t>::const_iterator it = up ? lanes.pads.find(up) : lanes.pads.end();
+                linked = linked || up;
+                waiting = waiting || (up && it == lanes.pads.end());
+                uint32_t lane = it != lanes.pads.end() ? it->second : 0;
+                sink_lanes.push_back(lane);
+                if (it != lanes.pads.end() && std::find(inputs.begin(), inputs.end(), lane) == inputs.end())
+                    inputs.push_back(lane);
+            }
+            if (waiting && !force)
+                continue;
+
+            uint32_t lane = 0;
+            if (!linked) {
+                lane = newLane({});
+                lanes.starts.insert(element);
+            } else if (sinks.size() > 1) {
+                lane = newLane(inputs);
+            } else if (!inputs.empty()) {
+                lane = inputs[0];
+            }
+            if (srcs.empty()) {
+                for (size_t i = 0; i < sinks.size(); ++i)
+                    lanes.pads[sinks[i]] = sink_lanes[i];
+            }
+            for (GstPad *pad : srcs)
+                lanes.pads[pad] = srcs.size() > 1 ? newLane({lane}) : lane;
+            done.insert(element);
+            progress = true;
+        }
+        force = !progress;
+    }
+    return lanes;
+}
+
+static void addLatencyProbes(PipelineTracer &t, const LatencyLanes &lanes, GstElement *element, bool sink_pads,
+                             bool source) {
+    GstIterator *it = sink_pads ? gst_element_iterate_sink_pads(element) : gst_element_iterate_src_pads(element);
+    bool several = (sink_pads ? element->numsinkpads : element->numsrcpads) > 1;
+    GValue item = G_VALUE_INIT;
+    bool done = false;
+    while (!done) {
+        switch (gst_iterator_next(it, &item)) {
+        case GST_ITERATOR_OK: {
+            GstPad *pad = GST_PAD(g_value_get_object(&item));
+            std::string name = GST_ELEMENT_NAME(element);
+            if (several)
+                name = name + "." + GST_PAD_NAME(pad);
+            std::map<GstPad *, uint32_t>::const_iterator lane = lanes.pads.find(pad);
+            int stage = lane != lanes.pads.end()
+                            ? t.tracer.addStage(name, source, lane->second, lanes.from[lane->second])
+                            : t.tracer.addStage(name, source);
+            if (stage >= 0) {
+                t.probes.emplace_back(new PipelineTracer::Probe{&t.tracer, stage});
+                gst_pad_add_probe(pad,
+                                  static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER |
+                                                               GST_PAD_PROBE_TYPE_BUFFER_LIST),
+                                  latency_pad_probe, t.probes.back().get(), NULL);
+            } else {
+                std::cerr << "Latency trace: more than " << LatencyTracer::kMaxStages << " pads or "
+                          << LatencyTracer::kMaxLanes << " lanes, " << name << " is not traced\n";
+            }
+            g_value_reset(&item);
+            break;
+        }
+        case GST_ITERATOR_RESYNC:
+            gst_iterator_resync(it);
+            break;
+        default:
+            done = true;
+            break;
+        }
+    }
+    g_value_unset(&item);
+    gst_iterator_free(it);
+}
+
+// Call once, before the pipeline goes to PAUSED. Returns the number of traced pads.
+static size_t installLatencyProbes(PipelineTracer &t, GstElement *pipeline) {
+    std::vector<GstElement *> elements;
+    GstIterator *it = gst_bin_iterate_recurse(GST_BIN(pipeline));
+    GValue item = G_VALUE_INIT;
+    bool done = false;
+    while (!done) {
+        switch (gst_iterator_next(it, &item)) {
+        case GST_ITERATOR_OK: {
+            GstElement *element = GST_ELEMENT(g_value_get_object(&item));
+            if (!GST_IS_BIN(element))  // the children of nested bins are visited themselves
+                elements.push_back(element);  // still held by the pipeline
+            g_value_reset(&item);
+            break;
+        }
+        case GST_ITERATOR_RESYNC:
+            elements.clear();
+            gst_iterator_resync(it);
+            break;
+        default:
+            done = true;
+            break;
+        }
+    }
+    g_value_unset(&item);
+    gst_iterator_free(it);
+
+    LatencyLanes lanes = assignLatencyLanes(elements);
+    for (GstElement *element : elements) {
+        if (lanes.starts.count(element))
+            addLatencyProbes(t, lanes, element, false, true);
+        else if (element->numsrcpads == 0)
+            addLatencyProbes(t, lanes, element, true, false);
+        else
+            addLatencyProbes(t, lanes, element, false, false);
+    }
+    return t.probes.size();
+}
+
+// Writes the JSON to a temporary file and renames it, so readers never see a partial dump
+static bool dumpLatency(const PipelineTracer &t) {
+    std::string json = t.tracer.toJson(latencyNowNs());
+    if (t.output.empty()) {
+        std::printf("%s\n", json.c_str());
+        std::fflush(stdout);
+        return true;
+    }
+    std::string tmp = t.output + ".tmp";
+    FILE *f = std::fopen(tmp.c_str(), "w");
+    if (!f)
+        return false;
+    bool ok = std::fwrite(json.data(), 1, json.size(), f) == json.size();
+    ok = std::fputc('\n', f) != EOF && ok;
+    ok = std::fclose(f) == 0 && ok;
+    return ok && std::rename(tmp.c_str(), t.output.c_str()) == 0;
+}
+
+static gboolean dump_latency_cb(gpointer user_data) {
+    PipelineTracer *t = static_cast<PipelineTracer *>(user_data);
+    if (!dumpLatency(*t))
+        std::cerr << "Failed to write latency trace to " << t->output << std::endl;
+    return G_SOURCE_CONTINUE;
+}
+
+// Dumps every `interval_s` seconds (0 = only on demand) and on SIGUSR1, both from the main loop
+static void scheduleLatencyDumps(PipelineTracer &t, guint interval_s) {
+    if (interval_s > 0)
+        g_timeout_add_seconds(interval_s, dump_latency_cb, &t);
+    g_unix_signal_add(SIGUSR1, dump_latency_cb, &t);
+}
@@ -0,0 +1,173 @@
+// apps/real_world_overlay/roi_crop.hpp
+// Limits inference to the part of a camera frame that sees a world region of interest, so the network input is spent
+// on it instead of on the whole frame. The roi ground polygon (z = 0) is clipped to the half-space in front of the
+// camera, its edges are sampled and projected with the pinhole model (the inverse of pixelToGround / the ground LUT),
+// or with the inverse of the linear fov model, and the pixel bounds grown by roi_margin become the crop the
+// conversion element cuts out before nvstreammux. The crop is widened to the nvstreammux aspect ratio so nvstreammux
+// does not stretch it, and aligned to even pixels for NV12. CameraView maps the boxes back to full-frame pixels.
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "camera_set.hpp"
+
+struct PixelBounds {
+    double u0 = 0.0, v0 = 0.0, u1 = 0.0, v1 = 0.0;
+
+    bool empty() const { return !(u1 > u0 && v1 > v0); }
+};
+
+namespace roi_crop_detail {
+
+using Point = std::pair<double, double>;
+
+constexpr int kEdgeSamples = 64;  // per polygon edge, world edges are curves once distorted
+constexpr double kNear = 1e-3;    // metres in front of the camera
+
+// Distance of a ground point along the optical axis
+inline double depth(const CameraModel &cam, double wx, double wy) {
+    return cam.r[2] * (wx - cam.tx) + cam.r[5] * (wy - cam.ty) + cam.r[8] * (0.0 - cam.tz);
+}
+
+// Sutherland-Hodgman against depth >= kNear; empty when the polygon is entirely behind the camera
+inline std::vector<Point> clipToFront(const CameraModel &cam, const std::vector<Point> &poly) {
+    std::vector<Point> out;
+    for (size_t i = 0; i < poly.size(); ++i) {
+        const Point &a = poly[i], &b = poly[(i + 1) % poly.size()];
+        double da = depth(cam, a.first, a.second) - kNear, db = depth(cam, b.first, b.second) - kNear;
+        if (da >= 0.0)
+            out.push_back(a);
+        if ((da >= 0.0) != (db >= 0.0)) {
+            double t = da / (da - db);
+            out.emplace_back(a.first + t * (b.first - a.first), a.second + t * (b.second - a.second));
+        }
+    }
+    return out;
+}
+
+// Normalized coordinates seen by the image border. The distortion polynomial folds back far outside the image, so
+// points are clamped to this box before they are distorted.
+inline void normalizedBox(const CameraModel &cam, double &x0, double &y0, double &x1, double &y1) {
+    x0 = y0 = 1e300;
+    x1 = y1 = -1e300;
+    const int n = 32;
+    for (int i = 0; i <= n; ++i) {
+        double s = static_cast<double>(i) / n;
+        const double border[4][2] = {{s * cam.width, 0.0}, {s * cam.width, double(cam.height)},
+                                     {0.0, s * cam.height}, {double(cam.width), s * cam.height}};
+        for (const auto &p : border) {
+            double x, y;
+            undistortPoint(cam, p[0], p[1], x, y);
+            x0 = std::min(x0, x);
+            y0 = std::min(y0, y);
+            x1 = std::max(x1, x);
+            y1 = std::max(y1, y);
+        }
+    }
+}
+
+inline void grow(PixelBounds &b, double u, double v, bool &first) {
+    if (first) {
+        b.u0 = b.u1 = u;
+        b.v0 = b.v1 = v;
+        first = false;
+        return;
+    }
+    b.u0 = std::min(b.u0, u);
+    b.u1 = std::max(b.u1, u);
+    b.v0 = std::min(b.v0, v);
+    b.v1 = std::max(b.v1, v);
+}
+
+}  // namespace roi_crop_detail
+
+// Pixel bounds of the ground polygon in the camera image, clipped to the image. False when the camera does not see it.
+inline bool roiPixelBounds(const CameraGeometry &g, const std::vector<std::pair<float, float>> &roi, PixelBounds &b) {
+    using namespace roi_crop_detail;
+    b = PixelBounds();
+    bool first = true;
+    if (g.pos_z <= 0.0f) {
+        // Linear fov model: straight edges stay straight, the vertices are enough
+        LinearWorldParams p = makeLinearWorldParams(g.width, g.height, g.fov_x, g.fov_y, g.pos_x, g.pos_y);
+        for (const auto &w : roi)
+            grow(b, (w.first - p.ox) / p.sx, (w.second - p.oy) / p.sy, first);
+    } else {
+        CameraModel cam = makeCameraModel(g);
+        std::vector<Point> poly;
+        for (const auto &w : roi)
+            poly.emplace_back(w.first, w.second);
+        poly = clipToFront(cam, poly);
+        double nx0, ny0, nx1, ny1;
+        normalizedBox(cam, nx0, ny0, nx1, ny1);
+        for (size_t i = 0; i < poly.size(); ++i) {
+            const Point &a = poly[i], &c = poly[(i + 1) % poly.size()];
+            for (int k = 0; k < kEdgeSamples; ++k) {
+                double t = static_cast<double>(k) / kEdgeSamples;
+                double wx = a.first + t * (c.first - a.first) - cam.tx;
+                double wy = a.second + t * (c.second - a.second) - cam.ty;
+                double wz = -cam.tz;
+                double xc = cam.r[0] * wx + cam.r[3] * wy + cam.r[6] * wz;
+                double yc = cam.r[1] * wx + cam.r[4] * wy + cam.r[7] * wz;
+                double zc = std::max(cam.r[2] * wx + cam.r[5] * wy + cam.r[8] * wz, kNear);
+                double u, v;
+                normalizedToPixel(cam, std::min(std::max(xc / zc, nx0), nx1), std::min(std::max(yc / zc, ny0), ny1),
+                                  u, v);
+                grow(b, u, v, first);
+            }
+        }
+    }
+    if (first)
+        return false;
+    b.u0 = std::max(b.u0, 0.0);
+    b.v0 = std::max(b.v0, 0.0);
+    b.u1 = std::min(b.u1, static_cast<double>(g.width));
+    b.v1 = std::min(b.v1, static_cast<double>(g.height));
+    return !b.empty();
+}
+
+// Crop around `b` grown by `margin`, widened to `aspect` (width / height, 0 = keep) as far as the image allows, with
+// even position and size. Sets the crop fields of `g`; a crop covering the whole frame is stored as no crop.
+inline void fitCrop(CameraGeometry &g, const PixelBounds &b, int margin, double aspect) {
+    double u0 = std::max(0.0, b.u0 - margin), v0 = std::max(0.0, b.v0 - margin);
+    double u1 = std::min(double(g.width), b.u1 + margin), v1 = std::min(double(g.height), b.v1 + margin);
+    double w = u1 - u0, h = v1 - v0;
+    if (aspect > 0.0) {
+        double need_w = std::min(double(g.width), std::max(w, h * aspect));
+        double need_h = std::min(double(g.height), std::max(h, need_w / aspect));
+        need_w = std::min(double(g.width), std::max(need_w, need_h * aspect));
+        // Grow around the centre, sliding back inside the image
+        double cu = (u0 + u1) / 2.0, cv = (v0 + v1) / 2.0;
+        u0 = std::min(std::max(cu - need_w / 2.0, 0.0), g.width - need_w);
+        v0 = std::min(std::max(cv - need_h / 2.0, 0.0), g.height - need_h);
+        u1 = u0 + need_w;
+        v1 = v0 + need_h;
+    }
+    int x0 = static_cast<int>(std::floor(u0 / 2.0)) * 2, y0 = static_cast<int>(std::floor(v0 / 2.0)) * 2;
+    int x1 = std::min(static_cast<int>(std::ceil(u1 / 2.0)) * 2, g.width & ~1);
+    int y1 = std::min(static_cast<int>(std::ceil(v1 / 2.0)) * 2, g.height & ~1);
+    if (x0 == 0 && y0 == 0 && x1 >= (g.width & ~1) && y1 >= (g.height & ~1)) {
+        g.crop_x = g.crop_y = g.crop_width = g.crop_height = 0;
+        return;
+    }
+    g.crop_x = x0;
+    g.crop_y = y0;
+    g.crop_width = x1 - x0;
+    g.crop_height = y1 - y0;
+}
+
+// Crop of a camera with a roi, `aspect` as in fitCrop. False with `error` when the camera does not see its roi.
+inline bool computeRoiCrop(CameraGeometry &g, double aspect, std::string &error) {
+    g.crop_x = g.crop_y = g.crop_width = g.crop_height = 0;
+    if (g.roi.empty())
+        return true;
+    PixelBounds b;
+    if (!roiPixelBounds(g, g.roi, b)) {
+        error = "roi not visible from camera " + g.device;
+        return false;
+    }
+    fitCrop(g, b, g.roi_margin, aspect);
+    return true;
+}
@@ -0,0 +1,247 @@
+// apps/real_world_overlay/shm_ring.hpp
+// Per-frame world detections published into POSIX shared memory: a single writer (the overlay app) and any number of
+// readers in other processes, no locks on either side. Readers include this header and use ShmRingReader.
+//
+// Layout: ShmRingHeader, then `capacity` ShmRingSlot. Sequence n goes to slot n & (capacity - 1). Each slot is a
+// seqlock: seq = 2n + 1 while sequence n is written, 2n + 2 once it is complete. Readers copy the record and check seq
+// again; a reader that falls more than `capacity` records behind is told how many it lost and skips ahead.
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+constexpr uint64_t SHM_RING_MAGIC = 0x474e495244574f52ULL;  // "ROWDRING"
+constexpr uint32_t SHM_RING_VERSION = 1;                    // bump on any header or DetectionRecord layout change
+
+// One detection, or one record with count = 0 and class_id = -1 for a frame without detections
+struct DetectionRecord {
+    uint64_t timestamp_ns;  // buffer PTS
+    uint64_t publish_ns;    // CLOCK_MONOTONIC when published
+    uint64_t frame_number;
+    uint32_t source_id;
+    uint16_t index;         // detection index in the frame
+    uint16_t count;         // detections in the frame
+    int32_t class_id;
+    float confidence;
+    float world_x, world_y;  // metres
+    float left, top, width, height;  // full-frame camera pixels
+};
+
+static_assert(sizeof(DetectionRecord) == 64, "DetectionRecord layout changed, bump SHM_RING_VERSION");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the ring needs address-free 64-bit atomics");
+
+struct ShmRingHeader {
+    std::atomic<uint64_t> magic;  // set last by the writer
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t capacity;
+    std::atomic<uint64_t> epoch;  // set when the writer creates the ring, 0 once it is closed
+    alignas(64) std::atomic<uint64_t> head;  // records published
+};
+
+struct ShmRingSlot {
+    std::atomic<uint64_t> seq;
+    DetectionRecord record;
+};
+
+inline uint64_t shmRingNowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+inline size_t shmRingBytes(uint64_t capacity) {
+    return sizeof(ShmRingHeader) + static_cast<size_t>(capacity) * sizeof(ShmRingSlot);
+}
+
+class ShmRingWriter {
+public:
+    ShmRingWriter() = default;
+    ShmRingWriter(const ShmRingWriter &) = delete;
+    ShmRingWriter &operator=(const ShmRingWriter &) = delete;
+    ~ShmRingWriter() { close(); }
+
+    // Creates (or recreates) the segment, capacity is rounded up to a power of 2
+    bool open(const std::string &name, uint64_t capacity) {
+        close();
+        uint64_t cap = 1;
+        while (cap < capacity)
+            cap <<= 1;
+
+        int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0)
+            return false;
+        size_t bytes = shmRingBytes(cap);
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void *map = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED)
+            return false;
+
+        name_ = name;
+        bytes_ = bytes;
+        header_ = static_cast<ShmRingHeader *>(map);
+        slots_ = reinterpret_cast<ShmRingSlot *>(header_ + 1);
+        mask_ = cap - 1;
+
+        // Readers check magic first, so it is cleared while the rest is reset
+        header_->magic.store(0, std::memory_order_relaxed);
+        header_->version = SHM_RING_VERSION;
+        header_->record_size = sizeof(DetectionRecord);
+        header_->capacity = cap;
+        for (uint64_t i = 0; i < cap; ++i)
+            slots_[i].seq.store(0, std::memory_order_relaxed);
+        header_->head.store(0, std::memory_order_relaxed);
+        header_->epoch.store(shmRingNowNs(), std::memory_order_release);
+        header_->magic.store(SHM_RING_MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    void close() {
+        if (header_) {
+            header_->epoch.store(0, std::memory_order_release);
+            munmap(header_, bytes_);
+            shm_unlink(name_.c_str());
+            header_ = nullptr;
+        }
+    }
+
+    bool isOpen() const { return header_ != nullptr; }
+
+    void publish(const DetectionRecord &record) {
+        uint64_t n = header_->head.load(std::memory_order_relaxed);
+        ShmRingSlot &slot = slots_[n & mask_];
+        slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&slot.record, &record, sizeof(DetectionRecord));
+        slot.seq.store(2 * n + 2, std::memory_order_release);
+        header_->head.store(n + 1, std::memory_order_release);
+    }
+
+    uint64_t published() const { return header_ ? header_->head.load(std::memory_order_relaxed) : 0; }
+
+private:
+    std::string name_;
+    size_t bytes_ = 0;
+    ShmRingHeader *header_ = nullptr;
+    ShmRingSlot *slots_ = nullptr;
+    uint64_t mask_ = 0;
+};
+
+class ShmRingReader {
+public:
+    enum Result { kRecord, kEmpty, kOverrun };
+
+    ShmRingReader() = default;
+    ShmRingReader(const ShmRingReader &) = delete;
+    ShmRingReader &operator=(const ShmRingReader &) = delete;
+    ~ShmRingReader() { close(); }
+
+    // Fails until the writer has created the segment. `from_latest` skips what is already in the ring.
+    bool open(const std::string &name, bool from_latest = true) {
+        close();
+        name_ = name;
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmRingHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void *map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED)
+            return false;
+
+        bytes_ = static_cast<size_t>(st.st_size);
+        header_ = static_cast<const ShmRingHeader *>(map);
+        if (header_->magic.load(std::memory_order_acquire) != SHM_RING_MAGIC || header_->version != SHM_RING_VERSION ||
+            header_->record_size != sizeof(DetectionRecord) || shmRingBytes(header_->capacity) > bytes_) {
+            close();
+            return false;
+        }
+        slots_ = reinterpret_cast<const ShmRingSlot *>(header_ + 1);
+        capacity_ = header_->capacity;
+        epoch_ = header_->epoch.load(std::memory_order_acquire);
+        pos_ = from_latest ? header_->head.load(std::memory_order_acquire) : 0;
+        return true;
+    }
+
+    void close() {
+        if (header_) {
+            munmap(const_cast<ShmRingHeader *>(header_), bytes_);
+            header_ = nullptr;
+        }
+    }
+
+    bool isOpen() const { return header_ != nullptr; }
+
+    // kRecord: `out` holds the next record. kOverrun: the writer lapped this reader, `lost` records were skipped and
+    // the next call continues with the oldest record still in the ring. When the writer closes or recreates the ring
+    // the reader reopens it and starts from its first record.
+    Result next(DetectionRecord &out, uint64_t *lost = nullptr) {
+        if (!header_) {
+            if (name_.empty() || !open(name_, false))
+                return kEmpty;
+        }
+
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        if (pos_ >= head) {
+            if (header_->epoch.load(std::memory_order_acquire) != epoch_)
+                close();
+            return kEmpty;
+        }
+        if (head - pos_ >= capacity_)
+            return skipTo(oldestSafe(), lost);
+
+        const ShmRingSlot &slot = slots_[pos_ & (capacity_ - 1)];
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        if (seq != 2 * pos_ + 2)
+            return skipTo(oldestSafe(), lost);
+
+        std::memcpy(&out, &slot.record, sizeof(DetectionRecord));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != seq)
+            return skipTo(oldestSafe(), lost);
+
+        ++pos_;
+        return kRecord;
+    }
+
+    uint64_t position() const { return pos_; }
+
+private:
+    // Oldest sequence the writer cannot be overwriting right now
+    uint64_t oldestSafe() const {
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        return head >= capacity_ ? head - capacity_ + 1 : 0;
+    }
+
+    Result skipTo(uint64_t pos, uint64_t *lost) {
+        if (lost)
+            *lost = pos > pos_ ? pos - pos_ : 0;
+        if (pos > pos_)
+            pos_ = pos;
+        return kOverrun;
+    }
+
+    std::string name_;
+    size_t bytes_ = 0;
+    const ShmRingHeader *header_ = nullptr;
+    const ShmRingSlot *slots_ = nullptr;
+    uint64_t capacity_ = 0;
+    uint64_t epoch_ = 0;
+    uint64_t pos_ = 0;
+};
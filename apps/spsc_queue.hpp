@@ -0,0 +1,176 @@
+// apps/real_world_overlay/spsc_queue.hpp
+// Bounded single-producer single-consumer queue of trivially copyable items, preallocated, no locks. What happens
+// when the queue is full is a per-queue policy:
+//   DropNewest  push() fails and the item is counted as dropped
+//   DropOldest  the producer advances the tail with a CAS and overwrites the oldest item. The consumer copies items
+//               out first and commits with a CAS, so a copy the producer raced with is discarded, never returned.
+//   Block       push() waits (spin, yield, then short sleeps) until the consumer makes room or the queue is closed
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SPSC_CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__)
+#define SPSC_CPU_RELAX() asm volatile("yield")
+#else
+#define SPSC_CPU_RELAX() ((void)0)
+#endif
+
+enum class QueuePolicy { DropNewest, DropOldest, Block };
+
+inline const char *queuePolicyName(QueuePolicy policy) {
+    switch (policy) {
+    case QueuePolicy::DropNewest:
+        return "drop_newest";
+    case QueuePolicy::DropOldest:
+        return "drop_oldest";
+    case QueuePolicy::Block:
+        return "block";
+    }
+    return "?";
+}
+
+inline bool parseQueuePolicy(const std::string &name, QueuePolicy &policy) {
+    for (QueuePolicy p : {QueuePolicy::DropNewest, QueuePolicy::DropOldest, QueuePolicy::Block}) {
+        if (name == queuePolicyName(p)) {
+            policy = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+struct QueueCounters {
+    uint64_t pushed = 0;
+    uint64_t popped = 0;
+    uint64_t dropped_newest = 0;
+    uint64_t dropped_oldest = 0;
+    uint64_t blocked = 0;  // pushes that had to wait
+};
+
+// Spin, then yield, then sleep; `round` counts the waits of one operation
+inline void spscBackoff(unsigned round) {
+    if (round < 64) {
+        SPSC_CPU_RELAX();
+    } else if (round < 1024) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+template <typename T>
+class SpscQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscQueue items are copied without constructors");
+
+public:
+    // Capacity is rounded up to a power of 2
+    SpscQueue(size_t capacity, QueuePolicy policy) : policy_(policy) {
+        size_t cap = 1;
+        while (cap < capacity)
+            cap <<= 1;
+        slots_.resize(cap);
+        mask_ = cap - 1;
+    }
+
+    QueuePolicy policy() const { return policy_; }
+    size_t capacity() const { return slots_.size(); }
+    size_t size() const {
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+        return static_cast<size_t>(head_.load(std::memory_order_acquire) - tail);
+    }
+
+    // Producer side. Returns false when the item was dropped (DropNewest) or the queue is closed.
+    bool push(const T &item) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        bool waited = false;
+
+        for (unsigned round = 0;; ++round) {
+            uint64_t tail = tail_.load(std::memory_order_acquire);
+            if (head - tail < slots_.size())
+                break;
+
+            if (policy_ == QueuePolicy::DropNewest) {
+                dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (policy_ == QueuePolicy::DropOldest) {
+                if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_acq_rel))
+                    dropped_oldest_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (closed_.load(std::memory_order_relaxed))
+                return false;
+            if (!waited) {
+                waited = true;
+                blocked_.fetch_add(1, std::memory_order_relaxed);
+            }
+            spscBackoff(round);
+        }
+
+        slots_[head & mask_] = item;
+        head_.store(head + 1, std::memory_order_release);
+        pushed_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consumer side. Copies up to `max` items in FIFO order, returns how many.
+    size_t pop(T *out, size_t max) {
+        for (;;) {
+            uint64_t tail = tail_.load(std::memory_order_acquire);
+            uint64_t head = head_.load(std::memory_order_acquire);
+            size_t n = static_cast<size_t>(head - tail);
+            if (n > max)
+                n = max;
+            if (n == 0)
+                return 0;
+
+            for (size_t i = 0; i < n; ++i)
+                out[i] = slots_[(tail + i) & mask_];
+
+            if (policy_ != QueuePolicy::DropOldest) {
+                tail_.store(tail + n, std::memory_order_release);
+            } else if (!tail_.compare_exchange_strong(tail, tail + n, std::memory_order_acq_rel)) {
+                continue;  // the producer dropped some of these, copy again from the new tail
+            }
+
+            popped_.fetch_add(n, std::memory_order_relaxed);
+            return n;
+        }
+    }
+
+    // Wakes a producer blocked in push(); later pushes fail under the Block policy
+    void close() { closed_.store(true, std::memory_order_relaxed); }
+
+    QueueCounters counters() const {
+        QueueCounters c;
+        c.pushed = pushed_.load(std::memory_order_relaxed);
+        c.popped = popped_.load(std::memory_order_relaxed);
+        c.dropped_newest = dropped_newest_.load(std::memory_order_relaxed);
+        c.dropped_oldest = dropped_oldest_.load(std::memory_order_relaxed);
+        c.blocked = blocked_.load(std::memory_order_relaxed);
+        return c;
+    }
+
+private:
+    const QueuePolicy policy_;
+    std::vector<T> slots_;
+    uint64_t mask_ = 0;
+
+    alignas(64) std::atomic<uint64_t> head_{0};  // written by the producer
+    alignas(64) std::atomic<uint64_t> tail_{0};  // written by the consumer, and by the producer in DropOldest
+    alignas(64) std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> dropped_newest_{0};
+    std::atomic<uint64_t> dropped_oldest_{0};
+    std::atomic<uint64_t> blocked_{0};
+    std::atomic<bool> closed_{false};
+    alignas(64) std::atomic<uint64_t> popped_{0};
+};
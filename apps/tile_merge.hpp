@@ -0,0 +1,300 @@
+// apps/real_world_overlay/tile_merge.hpp
+// Sliced inference for frames much larger than the network input. planTiles splits a camera region into cols x rows
+// equal, overlapping tiles; each tile is its own nvstreammux pad (pipeline_builder.hpp), so nvinfer runs the tiles of
+// every camera as one batch next to the camera's full (downscaled) frame, which still catches objects larger than a
+// tile. TileMerger then merges the detections of one camera frame in full-frame pixels:
+//   1. seam fusion: same-class boxes from different tiles, at least one cut by an inner tile edge, whose extents
+//      across the seam agree (1-D IoU >= seam_overlap) are parts of one object and become their union;
+//   2. class-aware greedy NMS by confidence, a box suppressed by a kept one above nms_iou IoU or nms_ios
+//      intersection over the smaller box (a tile part inside the full-frame box of the same object).
+// IoU / IoS of one box against the rest are computed four at a time (SSE2 / NEON). No GStreamer here,
+// tools/tile_merge_check runs it on synthetic box sets.
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define TILE_MERGE_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TILE_MERGE_NEON 1
+#endif
+
+struct TileRect {
+    int x = 0, y = 0, width = 0, height = 0;  // pixels of the camera frame
+};
+
+struct TilePlanConfig {
+    int cols = 2, rows = 2;
+    float overlap = 0.2f;  // fraction of the tile size shared with the neighbour tile
+};
+
+// Tiles of the region (x, y, width, height), row-major, even position and size for NV12. Every tile has the same size,
+// neighbours share at least `overlap` of it and the last column / row ends at the region edge. False for an invalid
+// plan (fewer than 1 x 1 tiles, overlap outside [0, 0.9], or tiles smaller than 32 pixels).
+inline bool planTiles(int x, int y, int width, int height, const TilePlanConfig &cfg, std::vector<TileRect> &tiles) {
+    tiles.clear();
+    if (cfg.cols < 1 || cfg.rows < 1 || !(cfg.overlap >= 0.0f && cfg.overlap <= 0.9f) || width <= 0 || height <= 0)
+        return false;
+    auto span = [&cfg](int length, int count) {
+        double size = length / (count - (count - 1) * static_cast<double>(cfg.overlap));
+        return std::min(length & ~1, (static_cast<int>(std::ceil(size)) + 1) & ~1);
+    };
+    auto start = [](int origin, int length, int size, int count, int k) {
+        if (count == 1)
+            return origin;
+        double step = static_cast<double>(length - size) / (count - 1);
+        return (origin + static_cast<int>(std::lround(k * step))) & ~1;
+    };
+    int tw = span(width, cfg.cols), th = span(height, cfg.rows);
+    if (tw < 32 || th < 32)
+        return false;
+    for (int r = 0; r < cfg.rows; ++r) {
+        for (int c = 0; c < cfg.cols; ++c) {
+            TileRect t;
+            t.x = start(x, width, tw, cfg.cols, c);
+            t.y = start(y, height, th, cfg.rows, r);
+            t.width = tw;
+            t.height = th;
+            tiles.push_back(t);
+        }
+    }
+    return true;
+}
+
+// A box in the pixels of a tile's nvstreammux frame (mux_width x mux_height) to camera frame pixels
+inline void tileBoxToFrame(const TileRect &tile, int mux_width, int mux_height, float &left, float &top, float &width,
+                           float &height) {
+    float sx = static_cast<float>(tile.width) / mux_width, sy = static_cast<float>(tile.height) / mux_height;
+    left = left * sx + tile.x;
+    top = top * sy + tile.y;
+    width *= sx;
+    height *= sy;
+}
+
+struct MergeBox {
+    float left = 0.0f, top = 0.0f, width = 0.0f, height = 0.0f;  // camera frame pixels
+    float confidence = 0.0f;
+    int32_t class_id = 0;
+    int32_t tile = -1;  // index in the tile list, -1 = the full frame
+};
+
+struct TileMergeConfig {
+    float nms_iou = 0.5f;       // same-class boxes above this IoU are one object
+    float nms_ios = 0.8f;       //   as are boxes with this much of the smaller one inside the other
+    float seam_overlap = 0.5f;  // 1-D IoU across a seam for two cut tile boxes to be fused
+    float seam_margin = 4.0f;   // pixels from an inner tile edge within which a box counts as cut by it
+};
+
+namespace tile_merge_detail {
+
+constexpr float kEps = 1e-6f;
+
+// IoU and intersection over the smaller box of (l, t, r, b) against boxes [0, n) of the arrays
+inline void overlapRowScalar(float l, float t, float r, float b, const float *L, const float *T, const float *R,
+                             const float *B, size_t begin, size_t n, float *iou, float *ios) {
+    float area = (r - l) * (b - t);
+    for (size_t i = begin; i < n; ++i) {
+        float iw = std::max(0.0f, std::min(r, R[i]) - std::max(l, L[i]));
+        float ih = std::max(0.0f, std::min(b, B[i]) - std::max(t, T[i]));
+        float inter = iw * ih, other = (R[i] - L[i]) * (B[i] - T[i]);
+        iou[i] = inter / std::max(area + other - inter, kEps);
+        ios[i] = inter / std::max(std::min(area, other), kEps);
+    }
+}
+
+inline void overlapRow(float l, float t, float r, float b, const float *L, const float *T, const float *R,
+                       const float *B, size_t n, float *iou, float *ios) {
+    size_t i = 0;
+#if TILE_MERGE_SSE2
+    const __m128 vl = _mm_set1_ps(l), vt = _mm_set1_ps(t), vr = _mm_set1_ps(r), vb = _mm_set1_ps(b);
+    const __m128 area = _mm_set1_ps((r - l) * (b - t)), zero = _mm_setzero_ps(), eps = _mm_set1_ps(kEps);
+    for (; i + 4 <= n; i += 4) {
+        __m128 L4 = _mm_loadu_ps(L + i), T4 = _mm_loadu_ps(T + i), R4 = _mm_loadu_ps(R + i), B4 = _mm_loadu_ps(B + i);
+        __m128 iw = _mm_max_ps(zero, _mm_sub_ps(_mm_min_ps(vr, R4), _mm_max_ps(vl, L4)));
+        __m128 ih = _mm_max_ps(zero, _mm_sub_ps(_mm_min_ps(vb, B4), _mm_max_ps(vt, T4)));
+        __m128 inter = _mm_mul_ps(iw, ih);
+        __m128 other = _mm_mul_ps(_mm_sub_ps(R4, L4), _mm_sub_ps(B4, T4));
+        __m128 uni = _mm_max_ps(_mm_sub_ps(_mm_add_ps(area, other), inter), eps);
+        _mm_storeu_ps(iou + i, _mm_div_ps(inter, uni));
+        _mm_storeu_ps(ios + i, _mm_div_ps(inter, _mm_max_ps(_mm_min_ps(area, other), eps)));
+    }
+#elif TILE_MERGE_NEON
+    const float32x4_t vl = vdupq_n_f32(l), vt = vdupq_n_f32(t), vr = vdupq_n_f32(r), vb = vdupq_n_f32(b);
+    const float32x4_t area = vdupq_n_f32((r - l) * (b - t)), zero = vdupq_n_f32(0.0f), eps = vdupq_n_f32(kEps);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t L4 = vld1q_f32(L + i), T4 = vld1q_f32(T + i), R4 = vld1q_f32(R + i), B4 = vld1q_f32(B + i);
+        float32x4_t iw = vmaxq_f32(zero, vsubq_f32(vminq_f32(vr, R4), vmaxq_f32(vl, L4)));
+        float32x4_t ih = vmaxq_f32(zero, vsubq_f32(vminq_f32(vb, B4), vmaxq_f32(vt, T4)));
+        float32x4_t inter = vmulq_f32(iw, ih);
+        float32x4_t other = vmulq_f32(vsubq_f32(R4, L4), vsubq_f32(B4, T4));
+        float32x4_t uni = vmaxq_f32(vsubq_f32(vaddq_f32(area, other), inter), eps);
+        vst1q_f32(iou + i, vdivq_f32(inter, uni));
+        vst1q_f32(ios + i, vdivq_f32(inter, vmaxq_f32(vminq_f32(area, other), eps)));
+    }
+#endif
+    overlapRowScalar(l, t, r, b, L, T, R, B, i, n, iou, ios);
+}
+
+inline float overlap1d(float a0, float a1, float b0, float b1) {
+    float inter = std::max(0.0f, std::min(a1, b1) - std::max(a0, b0));
+    return inter / std::max(std::max(a1, b1) - std::min(a0, b0), kEps);
+}
+
+}  // namespace tile_merge_detail
+
+inline const char *tileMergeSimdName() {
+#if TILE_MERGE_SSE2
+    return "sse2";
+#elif TILE_MERGE_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+// One per probe; work buffers grow to the largest frame seen and are reused
+class TileMerger {
+public:
+    explicit TileMerger(const TileMergeConfig &cfg = TileMergeConfig()) : cfg_(cfg) {}
+
+    // Merges the boxes of one camera frame cut into `tiles` over `region` (the tiled part of the frame). Fused boxes
+    // are written over the box of their most confident part. Returns the number of boxes left, their indices in
+    // keep[0, n), most confident first; `keep` holds at least `n` entries.
+    size_t merge(const std::vector<TileRect> &tiles, const TileRect &region, MergeBox *boxes, size_t n,
+                 uint32_t *keep) {
+        using namespace tile_merge_detail;
+        parent_.resize(n);
+        std::iota(parent_.begin(), parent_.end(), 0u);
+        fuseSeams(tiles, region, boxes, n);
+
+        // One candidate per fused group: the union box on its most confident part
+        order_.clear();
+        for (uint32_t i = 0; i < n; ++i) {
+            uint32_t root = find(i);
+            if (root != i) {
+                MergeBox &r = boxes[root], &b = boxes[i];
+                float right = std::max(r.left + r.width, b.left + b.width);
+                float bottom = std::max(r.top + r.height, b.top + b.height);
+                r.left = std::min(r.left, b.left);
+                r.top = std::min(r.top, b.top);
+                r.width = right - r.left;
+                r.height = bottom - r.top;
+                r.confidence = std::max(r.confidence, b.confidence);
+            }
+        }
+        for (uint32_t i = 0; i < n; ++i) {
+            if (find(i) == i)
+                order_.push_back(i);
+        }
+        std::stable_sort(order_.begin(), order_.end(),
+                         [boxes](uint32_t a, uint32_t b) { return boxes[a].confidence > boxes[b].confidence; });
+
+        // Greedy NMS over the candidates in confidence order, as structure-of-arrays for overlapRow
+        size_t m = order_.size();
+        l_.resize(m);
+        t_.resize(m);
+        r_.resize(m);
+        b_.resize(m);
+        iou_.resize(m);
+        ios_.resize(m);
+        suppressed_.assign(m, 0);
+        for (size_t k = 0; k < m; ++k) {
+            const MergeBox &bx = boxes[order_[k]];
+            l_[k] = bx.left;
+            t_[k] = bx.top;
+            r_[k] = bx.left + bx.width;
+            b_[k] = bx.top + bx.height;
+        }
+        size_t kept = 0;
+        for (size_t k = 0; k < m; ++k) {
+            if (suppressed_[k])
+                continue;
+            keep[kept++] = order_[k];
+            size_t rest = m - k - 1;
+            overlapRow(l_[k], t_[k], r_[k], b_[k], &l_[k + 1], &t_[k + 1], &r_[k + 1], &b_[k + 1], rest,
+                       &iou_[k + 1], &ios_[k + 1]);
+            const int32_t cls = boxes[order_[k]].class_id;
+            for (size_t j = k + 1; j < m; ++j) {
+                if (boxes[order_[j]].class_id == cls && (iou_[j] >= cfg_.nms_iou || ios_[j] >= cfg_.nms_ios))
+                    suppressed_[j] = 1;
+            }
+        }
+        return kept;
+    }
+
+    const TileMergeConfig &config() const { return cfg_; }
+    void setConfig(const TileMergeConfig &cfg) { cfg_ = cfg; }
+
+private:
+    enum : uint8_t { kCutLeft = 1, kCutRight = 2, kCutTop = 4, kCutBottom = 8 };
+
+    uint32_t find(uint32_t i) {
+        while (parent_[i] != i) {
+            parent_[i] = parent_[parent_[i]];
+            i = parent_[i];
+        }
+        return i;
+    }
+
+    void unite(uint32_t a, uint32_t b, const MergeBox *boxes) {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return;
+        // The most confident part represents the group
+        if (boxes[b].confidence > boxes[a].confidence || (boxes[b].confidence == boxes[a].confidence && b < a))
+            std::swap(a, b);
+        parent_[b] = a;
+    }
+
+    // Sides of each tile box that lie on an inner tile edge
+    void fuseSeams(const std::vector<TileRect> &tiles, const TileRect &region, const MergeBox *boxes, size_t n) {
+        using tile_merge_detail::overlap1d;
+        cuts_.assign(n, 0);
+        const float m = cfg_.seam_margin;
+        for (size_t i = 0; i < n; ++i) {
+            const MergeBox &b = boxes[i];
+            if (b.tile < 0 || static_cast<size_t>(b.tile) >= tiles.size())
+                continue;
+            const TileRect &t = tiles[b.tile];
+            uint8_t cut = 0;
+            if (t.x > region.x && b.left <= t.x + m)
+                cut |= kCutLeft;
+            if (t.x + t.width < region.x + region.width && b.left + b.width >= t.x + t.width - m)
+                cut |= kCutRight;
+            if (t.y > region.y && b.top <= t.y + m)
+                cut |= kCutTop;
+            if (t.y + t.height < region.y + region.height && b.top + b.height >= t.y + t.height - m)
+                cut |= kCutBottom;
+            cuts_[i] = cut;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (!cuts_[i])
+                continue;
+            const MergeBox &a = boxes[i];
+            for (size_t j = 0; j < n; ++j) {
+                const MergeBox &b = boxes[j];
+                if (j == i || b.tile < 0 || b.tile == a.tile || b.class_id != a.class_id || (cuts_[j] && j < i))
+                    continue;  // pairs of two cut boxes are seen once
+                float ax1 = a.left + a.width, ay1 = a.top + a.height, bx1 = b.left + b.width, by1 = b.top + b.height;
+                bool vertical = (cuts_[i] & (kCutLeft | kCutRight)) || (cuts_[j] & (kCutLeft | kCutRight));
+                bool horizontal = (cuts_[i] & (kCutTop | kCutBottom)) || (cuts_[j] & (kCutTop | kCutBottom));
+                bool touch_x = ax1 >= b.left && bx1 >= a.left, touch_y = ay1 >= b.top && by1 >= a.top;
+                if ((vertical && touch_x && overlap1d(a.top, ay1, b.top, by1) >= cfg_.seam_overlap) ||
+                    (horizontal && touch_y && overlap1d(a.left, ax1, b.left, bx1) >= cfg_.seam_overlap))
+                    unite(static_cast<uint32_t>(i), static_cast<uint32_t>(j), boxes);
+            }
+        }
+    }
+
+    TileMergeConfig cfg_;
+    std::vector<uint32_t> parent_, order_;
+    std::vector<uint8_t> cuts_, suppressed_;
+    std::vector<float> l_, t_, r_, b_, iou_, ios_;
+};
@@ -0,0 +1,39 @@
+// apps/real_world_overlay/tools/alloc_counter.hpp
+// Replacement global operator new / delete for the tools that count heap allocations: the hot paths that must not
+// allocate (probe_harness, tracker_eval) and the meta that must be freed (world_meta_check). Defines the operators, so
+// include it from the one translation unit of a tool. Counters are process-wide; read them around the measured calls.
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> g_heap_allocations(0);  // operator new calls
+static std::atomic<int64_t> g_live_allocations(0);   // allocations not deleted yet
+
+inline uint64_t heapAllocations() { return g_heap_allocations.load(std::memory_order_relaxed); }
+inline int64_t liveAllocations() { return g_live_allocations.load(std::memory_order_relaxed); }
+
+// Kept out of line: inlined, GCC pairs their malloc() / free() with the callers' operator new / delete and reports
+// -Wmismatched-new-delete. The array and sized forms forward to these two.
+__attribute__((noinline)) void *operator new(size_t size) {
+    if (void *p = std::malloc(size ? size : 1)) {
+        g_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_live_allocations.fetch_add(1, std::memory_order_relaxed);
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept {
+    if (p) {
+        g_live_allocations.fetch_sub(1, std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete[](void *p) noexcept { operator delete(p); }
+void operator delete(void *p, size_t) noexcept { operator delete(p); }
+void operator delete[](void *p, size_t) noexcept { operator delete(p); }
@@ -0,0 +1,21 @@
+// apps/real_world_overlay/tools/check.hpp
+// CHECK and the summary line shared by the *_check tools, which CMakeLists.txt registers with CTest: a failed
+// condition is printed with its location and counted, checkResult() prints the count and returns the exit status.
+#pragma once
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                \
+    do {                                                                           \
+        if (!(cond)) {                                                             \
+            std::fprintf(stderr, "FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                            \
+        }                                                                          \
+    } while (0)
+
+// "OK (0 failures)" and 0, or "FAILED (n failures)" and 1
+static inline int checkResult() {
+    std::printf("%s (%d failures)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}
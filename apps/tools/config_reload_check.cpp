@@ -0,0 +1,219 @@
+// apps/real_world_overlay/tools/config_reload_check.cpp
+// Checks of the hot reload pieces: snapshots read by several threads while another publishes and reclaims them as fast
+// as it can (every snapshot a reader sees must be intact and no older than the one current when it entered), nothing
+// freed while pinned, everything freed once the readers are gone; the config.toml watcher on in-place writes,
+// rename-over saves, unrelated files and stop(); calibration copied without the pipeline keys. Exits non-zero on
+// failure, best run under -fsanitize=address or thread as well.
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera_set.hpp"
+#include "config_reload.hpp"
+#include "tools/check.hpp"
+
+// Every value derived from the version, so a snapshot freed or overwritten under a reader shows up as a mismatch
+struct Snapshot {
+    static std::atomic<int> alive;
+    uint64_t version;
+    std::vector<uint64_t> values;
+
+    explicit Snapshot(uint64_t v) : version(v), values(64) {
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = v * 2654435761ULL + i;
+        alive.fetch_add(1);
+    }
+    ~Snapshot() {
+        for (uint64_t &x : values)
+            x = 0;
+        version = UINT64_MAX;
+        alive.fetch_sub(1);
+    }
+
+    bool intact() const {
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i] != version * 2654435761ULL + i)
+                return false;
+        }
+        return true;
+    }
+};
+
+std::atomic<int> Snapshot::alive{0};
+
+static void checkConcurrentSwaps() {
+    const int kReaders = 3;
+    const uint64_t kVersions = 200000;
+    {
+        SnapshotPublisher<Snapshot> publisher;
+        publisher.publish(std::unique_ptr<const Snapshot>(new Snapshot(0)));
+        std::atomic<uint64_t> published{0};
+        std::atomic<bool> done{false};
+        std::atomic<int> corrupt{0}, stale{0};
+        std::vector<uint64_t> reads(kReaders, 0);
+
+        std::vector<std::thread> readers;
+        for (int r = 0; r < kReaders; ++r) {
+            int slot = publisher.registerReader();
+            CHECK(slot >= 0);
+            readers.emplace_back([&, r, slot]() {
+                uint64_t last = 0;
+                while (!done.load(std::memory_order_relaxed)) {
+                    uint64_t floor = published.load(std::memory_order_acquire);
+                    PinnedSnapshot<Snapshot> s(publisher, slot);
+                    if (!s.get() || !s->intact())
+                        corrupt.fetch_add(1);
+                    else if (s->version < floor || s->version < last)
+                        stale.fetch_add(1);
+                    else
+                        last = s->version;
+                    ++reads[r];
+                }
+            });
+        }
+
+        size_t most_retired = 0;
+        for (uint64_t v = 1; v <= kVersions; ++v) {
+            publisher.publish(std::unique_ptr<const Snapshot>(new Snapshot(v)));
+            published.store(v, std::memory_order_release);
+            size_t retired = publisher.reclaim();
+            most_retired = retired > most_retired ? retired : most_retired;
+        }
+        done = true;
+        for (std::thread &t : readers)
+            t.join();
+
+        uint64_t total = 0;
+        for (uint64_t n : reads)
+            total += n;
+        CHECK(corrupt == 0);
+        CHECK(stale == 0);
+        CHECK(total > 0);
+        CHECK(publisher.reclaim() == 0);
+        CHECK(publisher.reclaimed() == kVersions);
+        CHECK(Snapshot::alive == 1);
+        CHECK(publisher.current()->version == kVersions && publisher.version() == kVersions + 1);  // counts publishes
+        std::printf("swaps: %llu versions under %d readers, %llu reads, at most %zu waiting to be freed\n",
+                    static_cast<unsigned long long>(kVersions), kReaders, static_cast<unsigned long long>(total),
+                    most_retired);
+    }
+    CHECK(Snapshot::alive == 0);
+}
+
+static void checkPinned() {
+    SnapshotPublisher<Snapshot> publisher;
+    int a = publisher.registerReader(), b = publisher.registerReader();
+    CHECK(publisher.enter(a) == nullptr);  // nothing published yet
+    publisher.leave(a);
+
+    publisher.publish(std::unique_ptr<const Snapshot>(new Snapshot(1)));
+    const Snapshot *held = publisher.enter(a);
+    CHECK(held && held->version == 1);
+
+    // Two swaps while `a` holds version 1: neither 1 nor 2 may be freed, `b` keeps seeing the newest
+    publisher.publish(std::unique_ptr<const Snapshot>(new Snapshot(2)));
+    {
+        PinnedSnapshot<Snapshot> s(publisher, b);
+        CHECK(s->version == 2);
+    }
+    publisher.publish(std::unique_ptr<const Snapshot>(new Snapshot(3)));
+    CHECK(publisher.reclaim() == 2);
+    CHECK(held->intact() && held->version == 1);
+    CHECK(Snapshot::alive == 3);
+    {
+        PinnedSnapshot<Snapshot> s(publisher, b);
+        CHECK(s->version == 3);
+        CHECK(publisher.reclaim() == 2);  // `b` entered after both were retired, it holds neither
+    }
+
+    publisher.leave(a);
+    CHECK(publisher.reclaim() == 0);
+    CHECK(publisher.reclaimed() == 2);
+    CHECK(Snapshot::alive == 1);
+
+    // Slots run out instead of being shared
+    for (int i = 2; i < SnapshotPublisher<Snapshot>::kMaxReaders; ++i)
+        CHECK(publisher.registerReader() == i);
+    CHECK(publisher.registerReader() == -1);
+}
+
+static void writeFile(const std::string &path, const std::string &text) {
+    std::ofstream out(path, std::ios::trunc);
+    out << text;
+}
+
+static void checkWatcher() {
+    std::string dir = "/tmp/config_reload_check_" + std::to_string(getpid());
+    CHECK(::mkdir(dir.c_str(), 0755) == 0);
+    std::string path = dir + "/config.toml";
+    writeFile(path, "pixel_sigma = 1.0\n");
+
+    ConfigWatcher watcher;
+    CHECK(!ConfigWatcher().open(dir + "/missing/config.toml"));
+    CHECK(watcher.open(path));
+    CHECK(watcher.wait(50) == ConfigWatcher::kTimeout);
+
+    // Written in place, several times in a row: one change
+    writeFile(path, "pixel_sigma = 2.0\n");
+    writeFile(path, "pixel_sigma = 3.0\n");
+    CHECK(watcher.wait(1000, 50) == ConfigWatcher::kChanged);
+    CHECK(watcher.wait(100, 50) == ConfigWatcher::kTimeout);
+
+    // Another file in the directory is not a change
+    writeFile(dir + "/other.toml", "x = 1\n");
+    CHECK(watcher.wait(100, 50) == ConfigWatcher::kTimeout);
+
+    // Saved the way editors do: a temporary file renamed over the original
+    writeFile(dir + "/config.toml.tmp", "pixel_sigma = 4.0\n");
+    CHECK(::rename((dir + "/config.toml.tmp").c_str(), path.c_str()) == 0);
+    CHECK(watcher.wait(1000, 50) == ConfigWatcher::kChanged);
+
+    // stop() wakes a waiting thread
+    auto start = std::chrono::steady_clock::now();
+    std::thread stopper([&watcher]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        watcher.stop();
+    });
+    CHECK(watcher.wait(10000) == ConfigWatcher::kStopped);
+    stopper.join();
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+
+    ::unlink(path.c_str());
+    ::unlink((dir + "/other.toml").c_str());
+    ::rmdir(dir.c_str());
+}
+
+static void checkCalibration() {
+    CameraGeometry running, loaded;
+    running.device = "video2";
+    running.crop_width = 640;
+    running.roi = {{0, 0}, {1, 0}, {1, 1}};
+    loaded.pos_z = 4.0f;
+    loaded.rot_x = 0.3f;
+    loaded.focal_x = 900.0f;
+    loaded.distortion[4] = 0.01f;
+    loaded.lut_step = 8;
+    loaded.device = "video7";
+    applyCalibration(loaded, running);
+    CHECK(running.pos_z == 4.0f && running.rot_x == 0.3f && running.focal_x == 900.0f);
+    CHECK(running.distortion[4] == 0.01f && running.lut_step == 8);
+    CHECK(running.device == "video2" && running.crop_width == 640 && running.roi.size() == 3);
+}
+
+int main() {
+    checkConcurrentSwaps();
+    checkPinned();
+    checkWatcher();
+    checkCalibration();
+
+    return checkResult();
+}
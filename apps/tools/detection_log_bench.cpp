@@ -0,0 +1,107 @@
+// apps/real_world_overlay/tools/detection_log_bench.cpp
+// Write throughput and time-range query latency of the append-only detection log.
+//   detection_log_bench [dir] [records] [segment MB] [queries]     defaults: /tmp 4000000 16 2000
+// Writes `records` through DetectionLogWriter as fast as append() accepts them (publish times 100 us apart), then
+// times reader open and random queries of 1 s, 60 s and 1 h spans that touch every matching record. Write numbers
+// depend on the file system: on tmpfs they measure the writer thread, on disk the page cache and fdatasync at rotation.
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "detection_log.hpp"
+
+int main(int argc, char *argv[]) {
+    std::string parent = argc > 1 ? argv[1] : "/tmp";
+    long long records = argc > 2 ? std::atoll(argv[2]) : 4000000;
+    int segment_mb = argc > 3 ? std::atoi(argv[3]) : 16;
+    int queries = argc > 4 ? std::atoi(argv[4]) : 2000;
+    if (records < 1 || segment_mb < 1 || queries < 1) {
+        std::fprintf(stderr, "usage: %s [dir] [records] [segment MB] [queries]\n", argv[0]);
+        return 2;
+    }
+    std::string dir = parent + "/detection_log_bench_" + std::to_string(getpid());
+
+    DetectionLogConfig cfg;
+    cfg.segment_bytes = static_cast<uint64_t>(segment_mb) << 20;
+    cfg.segment_seconds = 0.0;
+    DetectionLogWriter writer;
+    std::string error;
+    if (!writer.open(dir, cfg, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    DetectionRecord rec = {};
+    rec.count = 1;
+    rec.confidence = 0.5f;
+    uint64_t base = shmRingNowNs();
+    uint64_t full = 0;
+    uint64_t start = shmRingNowNs();
+    for (long long i = 0; i < records; ++i) {
+        rec.frame_number = static_cast<uint64_t>(i);
+        rec.publish_ns = base + static_cast<uint64_t>(i) * 100000ULL;
+        rec.class_id = static_cast<int32_t>(i % 80);
+        while (!writer.append(rec)) {
+            ++full;
+            std::this_thread::yield();
+        }
+    }
+    writer.close();
+    double write_s = (shmRingNowNs() - start) / 1e9;
+    DetectionLogCounters c = writer.counters();
+    double mb = records * sizeof(DetectionRecord) / 1048576.0;
+    std::printf("write: %lld records (%.0f MB) in %.3f s, %.2f M records/s, %.0f MB/s, %llu segments, "
+                "%llu full-queue retries\n",
+                records, mb, write_s, records / write_s / 1e6, mb / write_s,
+                static_cast<unsigned long long>(c.segments), static_cast<unsigned long long>(full));
+
+    DetectionLogReader reader;
+    start = shmRingNowNs();
+    if (!reader.open(dir, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    std::printf("open: %zu segments in %.3f ms\n", reader.segments().size(), (shmRingNowNs() - start) / 1e6);
+
+    const DetectionLogSegment &first = reader.segments().front();
+    const DetectionLogSegment &last = reader.segments().back();
+    uint64_t lo = first.toWallNs(first.records()[0].publish_ns);
+    uint64_t hi = last.toWallNs(last.records()[last.size() - 1].publish_ns);
+    std::mt19937_64 rng(1);
+
+    for (double span_s : {1.0, 60.0, 3600.0}) {
+        uint64_t span = static_cast<uint64_t>(span_s * 1e9);
+        std::vector<uint32_t> latency_ns;
+        uint64_t matched = 0, checksum = 0;
+        for (int q = 0; q < queries; ++q) {
+            uint64_t from = lo + rng() % (hi - lo + 1);
+            uint64_t t0 = shmRingNowNs();
+            matched += reader.query(from, from + span, [&](const DetectionLogSegment &, const DetectionRecord *r,
+                                                           size_t n) {
+                for (size_t i = 0; i < n; ++i)
+                    checksum += static_cast<uint64_t>(r[i].class_id);
+            });
+            latency_ns.push_back(static_cast<uint32_t>(std::min<uint64_t>(shmRingNowNs() - t0, UINT32_MAX)));
+        }
+        std::sort(latency_ns.begin(), latency_ns.end());
+        auto pct = [&](double p) {
+            return latency_ns[std::min(latency_ns.size() - 1, size_t(p * latency_ns.size()))] / 1000.0;
+        };
+        std::printf("query %6.0f s: %8.0f records avg, latency us p50 %.1f p99 %.1f max %.1f (checksum %llu)\n",
+                    span_s, static_cast<double>(matched) / queries, pct(0.5), pct(0.99), latency_ns.back() / 1000.0,
+                    static_cast<unsigned long long>(checksum % 1000));
+    }
+
+    for (const std::string &name : detectionLogSegments(dir)) {
+        ::unlink((dir + "/" + name + ".dlog").c_str());
+        ::unlink((dir + "/" + name + ".didx").c_str());
+    }
+    ::rmdir(dir.c_str());
+    return 0;
+}
@@ -0,0 +1,95 @@
+// apps/real_world_overlay/tools/detection_log_query.cpp
+// Prints the detections of a time range from a detection log directory (detection_log in config.toml) as CSV.
+//   detection_log_query <dir> <from> <to> [--source N] [--class N] [--min-confidence X] [--count]
+// Times are Unix seconds (fractions allowed), "now", or a negative number of seconds before now. Frames without
+// detections (class_id -1) are skipped. --count prints only the number of matching records.
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "detection_log.hpp"
+
+static bool parseTime(const char *text, uint64_t now_ns, uint64_t &out) {
+    if (std::strcmp(text, "now") == 0) {
+        out = now_ns;
+        return true;
+    }
+    char *end = nullptr;
+    double s = std::strtod(text, &end);
+    if (end == text || *end != '\0' || !std::isfinite(s))
+        return false;
+    if (s < 0.0) {
+        double back = -s * 1e9;
+        out = back >= static_cast<double>(now_ns) ? 0 : now_ns - static_cast<uint64_t>(back);
+    } else {
+        out = static_cast<uint64_t>(s * 1e9);
+    }
+    return true;
+}
+
+static int usage(const char *argv0) {
+    std::fprintf(stderr, "usage: %s <dir> <from> <to> [--source N] [--class N] [--min-confidence X] [--count]\n",
+                 argv0);
+    return 2;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4)
+        return usage(argv[0]);
+    uint64_t now = detectionLogRealtimeNs();
+    uint64_t from = 0, to = 0;
+    if (!parseTime(argv[2], now, from) || !parseTime(argv[3], now, to))
+        return usage(argv[0]);
+
+    long source = -1, cls = -2;
+    double min_confidence = -1.0;
+    bool count_only = false;
+    for (int i = 4; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--count") {
+            count_only = true;
+        } else if (i + 1 < argc && arg == "--source") {
+            source = std::atol(argv[++i]);
+        } else if (i + 1 < argc && arg == "--class") {
+            cls = std::atol(argv[++i]);
+        } else if (i + 1 < argc && arg == "--min-confidence") {
+            min_confidence = std::atof(argv[++i]);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    DetectionLogReader reader;
+    std::string error;
+    if (!reader.open(argv[1], error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    if (!count_only)
+        std::printf("time,source_id,frame_number,index,count,class_id,confidence,world_x,world_y,left,top,width,"
+                    "height\n");
+    uint64_t matched = 0;
+    reader.query(from, to, [&](const DetectionLogSegment &seg, const DetectionRecord *r, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const DetectionRecord &d = r[i];
+            if (d.class_id < 0 || (source >= 0 && d.source_id != static_cast<uint32_t>(source)) ||
+                (cls >= -1 && d.class_id != cls) || d.confidence < min_confidence)
+                continue;
+            ++matched;
+            if (count_only)
+                continue;
+            uint64_t wall = seg.toWallNs(d.publish_ns);
+            std::printf("%llu.%09llu,%u,%llu,%u,%u,%d,%.3f,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f\n",
+                        static_cast<unsigned long long>(wall / 1000000000ULL),
+                        static_cast<unsigned long long>(wall % 1000000000ULL), d.source_id,
+                        static_cast<unsigned long long>(d.frame_number), d.index, d.count, d.class_id, d.confidence,
+                        d.world_x, d.world_y, d.left, d.top, d.width, d.height);
+        }
+    });
+    if (count_only)
+        std::printf("%llu\n", static_cast<unsigned long long>(matched));
+    return 0;
+}
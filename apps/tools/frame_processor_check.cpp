@@ -0,0 +1,246 @@
+// apps/real_world_overlay/tools/frame_processor_check.cpp
+// Checks of the osd probe's per-batch work on stand-in meta structs: the exported records (one per object on the
+// ground, a count = 0 record for an empty frame, tiles skipped, boxes back in camera pixels) and the labels (text of
+// the transformed world point, objects left out by label_top_k cleared, objects off the ground or without a camera
+// untouched, labels off outside full mode). Exits non-zero on failure.
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "frame_processor.hpp"
+#include "tools/check.hpp"
+
+// Stand-ins with the field names the templates use (NvDsMetaList, NvDsBatchMeta, NvDsFrameMeta, NvDsObjectMeta)
+struct MockList {
+    void *data;
+    MockList *next;
+};
+struct MockRect {
+    float left, top, width, height;
+};
+struct MockText {
+    char *display_text;
+};
+struct MockObject {
+    MockRect rect_params;
+    int class_id;
+    float confidence;
+    uint64_t object_id;
+    MockText text_params;
+};
+struct MockFrame {
+    uint32_t source_id;
+    int frame_num;
+    uint64_t buf_pts;
+    MockList *obj_meta_list;
+};
+struct MockBatch {
+    MockList *frame_meta_list;
+};
+
+// Owns the nodes of one synthetic batch
+struct MockBatchBuilder {
+    std::deque<MockList> nodes;
+    std::deque<MockFrame> frames;
+    std::deque<MockObject> objects;
+    MockBatch batch = {nullptr};
+    MockList **frame_tail = &batch.frame_meta_list;
+
+    MockFrame &addFrame(uint32_t source_id, int frame_num) {
+        frames.push_back(MockFrame{source_id, frame_num, 1000u * static_cast<uint64_t>(frame_num), nullptr});
+        nodes.push_back(MockList{&frames.back(), nullptr});
+        *frame_tail = &nodes.back();
+        frame_tail = &nodes.back().next;
+        return frames.back();
+    }
+
+    MockObject &addObject(MockFrame &frame, MockRect box, int class_id, float confidence) {
+        objects.push_back(MockObject{box, class_id, confidence, objects.size() + 1, {nullptr}});
+        nodes.push_back(MockList{&objects.back(), nullptr});
+        MockList **tail = &frame.obj_meta_list;
+        while (*tail)
+            tail = &(*tail)->next;
+        *tail = &nodes.back();
+        return objects.back();
+    }
+};
+
+// A 1920x1080 camera looking down and a 1280x720 one tilted towards the horizon
+static const char *kCameras =
+    "resolution = [1920, 1080]\n"
+    "rotation = [0.0, 180.0, -90.0]\n"
+    "fov = [2.0, 1.125]\n"
+    "[[camera]]\n"
+    "position = [0.0, 0.0, 3.0]\n"
+    "[[camera]]\n"
+    "resolution = [1280, 720]\n"
+    "position = [10.0, 0.0, 4.5]\n"
+    "rotation = [85.0, 180.0, -90.0]\n";
+
+// Frame 0 of source 0 with 3 objects, frame 0 of source 1 with one object above its horizon and one on the ground,
+// an empty frame of source 0 and a tile frame (source 2 of 2 cameras)
+struct Fixture {
+    MockBatchBuilder b;
+    MockObject *low = nullptr, *mid = nullptr, *high = nullptr, *sky = nullptr, *ground = nullptr;
+
+    Fixture() {
+        MockFrame &f0 = b.addFrame(0, 7);
+        low = &b.addObject(f0, {100.0f, 200.0f, 40.0f, 80.0f}, 1, 0.3f);
+        mid = &b.addObject(f0, {900.0f, 500.0f, 40.0f, 80.0f}, 2, 0.6f);
+        high = &b.addObject(f0, {1500.0f, 800.0f, 40.0f, 80.0f}, 1, 0.9f);
+        MockFrame &f1 = b.addFrame(1, 3);
+        sky = &b.addObject(f1, {900.0f, 0.0f, 40.0f, 20.0f}, 0, 0.8f);
+        ground = &b.addObject(f1, {900.0f, 900.0f, 60.0f, 120.0f}, 0, 0.7f);
+        b.addFrame(0, 8);
+        MockFrame &tile = b.addFrame(2, 7);
+        b.addObject(tile, {10.0f, 10.0f, 40.0f, 80.0f}, 1, 0.5f);
+    }
+};
+
+static bool buildCameras(CameraSet &cameras) {
+    std::vector<CameraGeometry> geometry;
+    std::string error;
+    toml::table data = toml::parse(kCameras);
+    if (!parseCameras(data, geometry, error))
+        return false;
+    cameras.build(geometry, 1920, 1080);
+    return cameras.size() == 2;
+}
+
+static void checkExport(const CameraSet &cameras) {
+    Fixture fx;
+    FrameProcessor<MockFrame, MockObject> proc;
+    size_t frames = 0;
+    CHECK(proc.transform(&fx.b.batch, cameras, [&](MockFrame *) { ++frames; }) == 6);
+    CHECK(frames == 4);
+    const auto &ob = proc.batch();
+    CHECK(ob.valid[0] && ob.valid[1] && ob.valid[2]);
+    CHECK(!ob.valid[3] && ob.valid[4]);  // the box at the top of the tilted camera is above its horizon
+
+    std::vector<DetectionRecord> recs;
+    proc.exportDetections(&fx.b.batch, cameras, 2, 42, [&](const DetectionRecord &r) { recs.push_back(r); });
+    CHECK(recs.size() == 5);
+    if (recs.size() != 5)
+        return;
+    for (size_t i = 0; i < 3; ++i) {
+        CHECK(recs[i].source_id == 0 && recs[i].frame_number == 7 && recs[i].timestamp_ns == 7000);
+        CHECK(recs[i].publish_ns == 42 && recs[i].count == 3 && recs[i].index == i);
+        CHECK(recs[i].world_x == ob.wx[i] && recs[i].world_y == ob.wy[i]);
+    }
+    CHECK(recs[0].class_id == 1 && recs[0].confidence == 0.3f && recs[0].left == 100.0f && recs[0].width == 40.0f);
+
+    // Only the object on the ground, its box scaled from nvstreammux to 1280x720 camera pixels
+    const DetectionRecord &g = recs[3];
+    CHECK(g.source_id == 1 && g.count == 1 && g.index == 0 && g.world_x == ob.wx[4]);
+    CHECK(g.left == 600.0f && g.top == 600.0f && g.width == 40.0f && g.height == 80.0f);
+
+    // The empty frame is one record without a detection, the tile frame none
+    CHECK(recs[4].source_id == 0 && recs[4].frame_number == 8 && recs[4].count == 0 && recs[4].class_id == -1);
+}
+
+struct Labels {
+    std::vector<char *> buffers;
+
+    char *acquire() {
+        buffers.push_back(new char[LabelCache::kLabelSize]);
+        return buffers.back();
+    }
+    ~Labels() {
+        for (char *b : buffers)
+            delete[] b;
+    }
+};
+
+static void checkLabels(const CameraSet &cameras) {
+    char expected[LabelCache::kLabelSize];
+    static char nvinfer_text[] = "person";
+
+    // Every object on the ground is labeled with its world point
+    {
+        Fixture fx;
+        for (MockObject &o : fx.b.objects)
+            o.text_params.display_text = nvinfer_text;
+        FrameProcessor<MockFrame, MockObject> proc;
+        proc.configure(true, OverlayConfig(), true);
+        CHECK(proc.labels());
+        proc.transform(&fx.b.batch, cameras, [](MockFrame *) {});
+        Labels labels;
+        auto stats = proc.label([&] { return labels.acquire(); },
+                                [](MockObject *obj, char *label) { obj->text_params.display_text = label; });
+        CHECK(stats.drawn == 4 && stats.reused == 0 && labels.buffers.size() == 4);
+        const auto &ob = proc.batch();
+        formatWorldLabel(expected, sizeof(expected), ob.wx[1], ob.wy[1]);
+        CHECK(std::strcmp(fx.mid->text_params.display_text, expected) == 0);
+        formatWorldLabel(expected, sizeof(expected), ob.wx[4], ob.wy[4]);
+        CHECK(std::strcmp(fx.ground->text_params.display_text, expected) == 0);
+        CHECK(fx.sky->text_params.display_text == nvinfer_text);
+        CHECK(fx.b.objects.back().text_params.display_text == nvinfer_text);  // no camera for the tile source
+    }
+
+    // label_top_k = 1: the most confident object of each frame, the others lose their text
+    {
+        Fixture fx;
+        for (MockObject &o : fx.b.objects)
+            o.text_params.display_text = nvinfer_text;
+        OverlayConfig overlay;
+        overlay.label_top_k = 1;
+        FrameProcessor<MockFrame, MockObject> proc;
+        proc.configure(true, overlay, true);
+        proc.transform(&fx.b.batch, cameras, [](MockFrame *) {});
+        Labels labels;
+        auto stats = proc.label([&] { return labels.acquire(); },
+                                [](MockObject *obj, char *label) { obj->text_params.display_text = label; });
+        CHECK(stats.drawn == 2);
+        CHECK(fx.low->text_params.display_text == nullptr && fx.mid->text_params.display_text == nullptr);
+        CHECK(fx.high->text_params.display_text != nullptr && fx.high->text_params.display_text != nvinfer_text);
+        CHECK(fx.sky->text_params.display_text == nullptr);
+        CHECK(fx.ground->text_params.display_text != nullptr && fx.ground->text_params.display_text != nvinfer_text);
+    }
+
+    // label_every = 3 with cached labels: the second batch of the same frames copies them
+    {
+        Fixture fx;
+        OverlayConfig overlay;
+        overlay.label_every = 3;
+        FrameProcessor<MockFrame, MockObject> proc;
+        proc.configure(true, overlay, true);
+        Labels labels;
+        auto set_text = [](MockObject *obj, char *label) { obj->text_params.display_text = label; };
+        for (int pass = 0; pass < 2; ++pass) {
+            proc.transform(&fx.b.batch, cameras, [](MockFrame *) {});
+            auto stats = proc.label([&] { return labels.acquire(); }, set_text);
+            CHECK(stats.drawn == 4 && stats.reused == (pass ? 4u : 0u));
+        }
+        proc.configure(true, overlay, false);
+        CHECK(proc.labelCache().interval() == 1);
+    }
+
+    // No labels without text_overlay or outside full mode
+    {
+        Fixture fx;
+        OverlayConfig overlay;
+        FrameProcessor<MockFrame, MockObject> proc;
+        proc.configure(false, overlay, true);
+        CHECK(!proc.labels());
+        overlay.mode = OverlayMode::Boxes;
+        proc.configure(true, overlay, true);
+        CHECK(!proc.labels());
+        proc.transform(&fx.b.batch, cameras, [](MockFrame *) {});
+        size_t calls = 0;
+        auto stats = proc.label([&] { return static_cast<char *>(nullptr); }, [&](MockObject *, char *) { ++calls; });
+        CHECK(stats.drawn == 0 && calls == 0);
+    }
+}
+
+int main() {
+    CameraSet cameras;
+    CHECK(buildCameras(cameras));
+    if (failures == 0) {
+        checkExport(cameras);
+        checkLabels(cameras);
+    }
+
+    return checkResult();
+}
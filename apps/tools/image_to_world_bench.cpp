@@ -0,0 +1,185 @@
+// apps/real_world_overlay/tools/image_to_world_bench.cpp
+// Accuracy and per-call cost of the ground LUT against the exact pinhole ray intersection on synthetic cameras, and of
+// the batched SoA paths (imageToWorldBatch, GroundLut::lookupBatch) against the per-object scalar calls.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "image_to_world.hpp"
+
+struct SyntheticCamera {
+    const char *name;
+    double height_m;
+    double rot_deg[3];
+    double dist[5];
+};
+
+static CameraModel makeCamera(const SyntheticCamera &sc, int width, int height) {
+    CameraModel cam;
+    cam.width = width;
+    cam.height = height;
+    cam.fx = cam.fy = 0.9 * width;
+    cam.cx = width / 2.0;
+    cam.cy = height / 2.0;
+    cam.k1 = sc.dist[0];
+    cam.k2 = sc.dist[1];
+    cam.p1 = sc.dist[2];
+    cam.p2 = sc.dist[3];
+    cam.k3 = sc.dist[4];
+    rotationFromEuler(sc.rot_deg[0], sc.rot_deg[1], sc.rot_deg[2], cam.r);
+    cam.tz = sc.height_m;
+    return cam;
+}
+
+// Best of 5 runs
+template <typename F>
+static double nsPerCall(size_t n, F &&f) {
+    double best = 0.0;
+    for (int rep = 0; rep < 5; ++rep) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+        best = rep == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+// Per-object cost of the probe paths for typical object counts per batch. Every batch size runs over the same number
+// of objects in total.
+static void benchBatch(const SyntheticCamera &sc, int width, int height, const std::vector<float> &px,
+                       const std::vector<float> &py) {
+    const size_t batch_sizes[] = {8, 64, 256, 1024};
+    const size_t total = px.size();
+    const LinearWorldParams lp = makeLinearWorldParams(width, height, 2.0f, 1.2f, 0.5f, -0.25f);
+
+    CameraModel cam = makeCamera(sc, width, height);
+    GroundLut lut;
+    lut.build(cam, 4);
+
+    std::vector<float> wx(total), wy(total), bx(total), by(total);
+    std::vector<uint8_t> valid(total), bvalid(total);
+
+    std::printf("\nBatched paths (%s, batch path %s)\n", sc.name, imageToWorldSimdName());
+    std::printf("%-8s %-14s %-14s %-14s %-14s %-14s %-14s\n", "objects", "linear ns/obj", "batch ns/obj",
+                "max diff m", "lut ns/obj", "lut batch ns", "mismatches");
+
+    for (size_t bs : batch_sizes) {
+        size_t count = total / bs * bs;
+
+        double linear_ns = nsPerCall(count, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                std::tie(wx[i], wy[i]) = imageToWorld(px[i], py[i], width, height, 2.0f, 1.2f, 0.5f, -0.25f);
+        });
+        double batch_ns = nsPerCall(count, [&]() {
+            for (size_t b = 0; b < count; b += bs)
+                imageToWorldBatch(lp, &px[b], &py[b], &bx[b], &by[b], bs);
+        });
+        double max_diff = 0.0;
+        for (size_t i = 0; i < count; ++i)
+            max_diff = std::max(max_diff, static_cast<double>(std::max(std::fabs(wx[i] - bx[i]), std::fabs(wy[i] - by[i]))));
+
+        double lut_ns = nsPerCall(count, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                valid[i] = lut.lookup(px[i], py[i], wx[i], wy[i]);
+        });
+        double lut_batch_ns = nsPerCall(count, [&]() {
+            for (size_t b = 0; b < count; b += bs)
+                lut.lookupBatch(&px[b], &py[b], &bx[b], &by[b], &bvalid[b], bs);
+        });
+        size_t mismatches = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (valid[i] != bvalid[i] || (valid[i] && (wx[i] != bx[i] || wy[i] != by[i])))
+                ++mismatches;
+        }
+
+        std::printf("%-8zu %-14.2f %-14.2f %-14.2e %-14.2f %-14.2f %-14zu\n", bs, linear_ns, batch_ns, max_diff, lut_ns,
+                    lut_batch_ns, mismatches);
+    }
+}
+
+int main() {
+    const int width = 3848, height = 2168;
+    const size_t samples = 200000;
+
+    const SyntheticCamera cameras[] = {
+        {"nadir 3 m", 3.0, {0.0, 180.0, -90.0}, {0.0, 0.0, 0.0, 0.0, 0.0}},
+        {"tilted 25 deg 3 m + distortion", 3.0, {-25.0, 180.0, -90.0}, {-0.25, 0.08, 0.001, -0.0005, 0.0}},
+        {"tilted 45 deg 6 m + distortion", 6.0, {-45.0, 180.0, -90.0}, {-0.30, 0.10, 0.0, 0.0, -0.02}},
+    };
+    const int steps[] = {1, 2, 4, 8, 16};
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> ux(0.0f, width - 1.0f), uy(0.0f, height - 1.0f);
+    std::vector<float> px(samples), py(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        px[i] = ux(gen);
+        py[i] = uy(gen);
+    }
+
+    for (const SyntheticCamera &sc : cameras) {
+        CameraModel cam = makeCamera(sc, width, height);
+
+        std::vector<double> ex(samples), ey(samples);
+        std::vector<char> valid(samples);
+        volatile double sink = 0.0;
+
+        double exact_ns = nsPerCall(samples, [&]() {
+            for (size_t i = 0; i < samples; ++i)
+                valid[i] = pixelToGround(cam, px[i], py[i], 0.0, ex[i], ey[i]);
+        });
+
+        double linear_ns = nsPerCall(samples, [&]() {
+            double acc = 0.0;
+            for (size_t i = 0; i < samples; ++i) {
+                auto w = imageToWorld(px[i], py[i], width, height, 2.0f, 1.2f, 0.0f, 0.0f);
+                acc += w.first + w.second;
+            }
+            sink = acc;
+        });
+
+        std::printf("\n%s (%dx%d): exact %.1f ns/call, linear fov %.1f ns/call\n", sc.name, width, height, exact_ns,
+                    linear_ns);
+        std::printf("%-6s %-10s %-10s %-14s %-14s %-10s\n", "step", "build ms", "KiB", "mean err mm", "max err mm",
+                    "ns/call");
+
+        for (int step : steps) {
+            GroundLut lut;
+            auto t0 = std::chrono::steady_clock::now();
+            lut.build(cam, step);
+            double build_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+            double err_sum = 0.0, err_max = 0.0;
+            size_t n = 0;
+            for (size_t i = 0; i < samples; ++i) {
+                float wx, wy;
+                if (!valid[i] || !lut.lookup(px[i], py[i], wx, wy))
+                    continue;
+                double err = std::hypot(wx - ex[i], wy - ey[i]) * 1000.0;
+                err_sum += err;
+                err_max = std::max(err_max, err);
+                ++n;
+            }
+
+            double lut_ns = nsPerCall(samples, [&]() {
+                float acc = 0.0f;
+                for (size_t i = 0; i < samples; ++i) {
+                    float wx, wy;
+                    lut.lookup(px[i], py[i], wx, wy);
+                    acc += wx + wy;
+                }
+                sink = acc;
+            });
+
+            std::printf("%-6d %-10.1f %-10zu %-14.3f %-14.3f %-10.1f\n", step, build_ms, lut.bytes() / 1024,
+                        n ? err_sum / n : 0.0, err_max, lut_ns);
+        }
+        (void)sink;
+    }
+
+    benchBatch(cameras[1], width, height, px, py);
+
+    return 0;
+}
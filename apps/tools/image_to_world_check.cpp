@@ -0,0 +1,239 @@
+// apps/real_world_overlay/tools/image_to_world_check.cpp
+// Checks of the pinhole camera model of image_to_world.hpp, no GStreamer or DeepStream needed: the worldToPixel /
+// pixelToGround round trip on straight-down, tilted and distorted synthetic cameras, the convergence of undistortPoint,
+// the horizon and behind-the-camera cases, the GroundLut::lookup error against pixelToGround, and the batched SoA paths
+// (imageToWorldBatch, GroundLut::lookupBatch) against the per-object scalar calls. Exits non-zero on failure.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "image_to_world.hpp"
+#include "tools/check.hpp"
+
+struct SyntheticCamera {
+    const char *name;
+    double height_m;
+    double rot_deg[3];
+    double dist[5];
+};
+
+static const int kWidth = 1920, kHeight = 1080;
+
+static const SyntheticCamera kCameras[] = {
+    {"straight down 3 m", 3.0, {0.0, 180.0, -90.0}, {0.0, 0.0, 0.0, 0.0, 0.0}},
+    {"tilted 25 deg 3 m", 3.0, {-25.0, 180.0, -90.0}, {0.0, 0.0, 0.0, 0.0, 0.0}},
+    {"tilted 25 deg 3 m + distortion", 3.0, {-25.0, 180.0, -90.0}, {-0.25, 0.08, 0.001, -0.0005, 0.0}},
+    {"tilted 45 deg 6 m + distortion", 6.0, {-45.0, 180.0, -90.0}, {-0.30, 0.10, 0.0, 0.0, -0.02}},
+};
+
+static CameraModel makeCamera(const SyntheticCamera &sc) {
+    CameraModel cam;
+    cam.width = kWidth;
+    cam.height = kHeight;
+    cam.fx = cam.fy = 0.9 * kWidth;
+    cam.cx = kWidth / 2.0;
+    cam.cy = kHeight / 2.0;
+    cam.k1 = sc.dist[0];
+    cam.k2 = sc.dist[1];
+    cam.p1 = sc.dist[2];
+    cam.p2 = sc.dist[3];
+    cam.k3 = sc.dist[4];
+    rotationFromEuler(sc.rot_deg[0], sc.rot_deg[1], sc.rot_deg[2], cam.r);
+    cam.tz = sc.height_m;
+    return cam;
+}
+
+static void checkStraightDown() {
+    CameraModel cam = makeCamera(kCameras[0]);
+
+    // The principal point is below the camera, fx pixels off it are one camera height away on the ground
+    double wx, wy;
+    CHECK(pixelToGround(cam, cam.cx, cam.cy, 0.0, wx, wy));
+    CHECK(std::fabs(wx) < 1e-9 && std::fabs(wy) < 1e-9);
+    CHECK(pixelToGround(cam, cam.cx + cam.fx, cam.cy, 0.0, wx, wy));
+    CHECK(std::fabs(std::hypot(wx, wy) - 3.0) < 1e-9);
+
+    // A raised ground plane is closer
+    double rx, ry;
+    CHECK(pixelToGround(cam, cam.cx + cam.fx, cam.cy, 1.0, rx, ry));
+    CHECK(std::fabs(std::hypot(rx, ry) - 2.0) < 1e-9);
+
+    // Above the camera and behind it
+    double u, v;
+    CHECK(!pixelToGround(cam, cam.cx, cam.cy, 4.0, wx, wy));
+    CHECK(!worldToPixel(cam, 0.0, 0.0, 5.0, u, v));
+}
+
+static void checkRoundTrip(const SyntheticCamera &sc) {
+    CameraModel cam = makeCamera(sc);
+
+    // pixel -> ground -> pixel over the whole frame
+    double max_px = 0.0;
+    int grounded = 0;
+    for (int v = 0; v <= kHeight; v += 40) {
+        for (int u = 0; u <= kWidth; u += 40) {
+            double wx, wy, pu = 0.0, pv = 0.0;
+            if (!pixelToGround(cam, u, v, 0.0, wx, wy))
+                continue;
+            ++grounded;
+            CHECK(worldToPixel(cam, wx, wy, 0.0, pu, pv));
+            max_px = std::max(max_px, std::max(std::fabs(pu - u), std::fabs(pv - v)));
+        }
+    }
+    if (max_px >= 1e-3)
+        std::fprintf(stderr, "%s: pixel round trip error %.2e px\n", sc.name, max_px);
+    CHECK(grounded == (kWidth / 40 + 1) * (kHeight / 40 + 1));
+    CHECK(max_px < 1e-3);
+
+    // ground -> pixel -> ground for the points in the field of view. The distortion polynomial folds back far outside
+    // it, so the field of view is the one of the camera without distortion.
+    CameraModel pinhole = cam;
+    pinhole.k1 = pinhole.k2 = pinhole.p1 = pinhole.p2 = pinhole.k3 = 0.0;
+    double max_m = 0.0;
+    int seen = 0;
+    for (double y = -10.0; y <= 10.0; y += 0.5) {
+        for (double x = -10.0; x <= 10.0; x += 0.5) {
+            double u = 0.0, v = 0.0, wx = 0.0, wy = 0.0;
+            if (!worldToPixel(pinhole, x, y, 0.0, u, v) || u < 0.0 || v < 0.0 || u > kWidth || v > kHeight)
+                continue;
+            CHECK(worldToPixel(cam, x, y, 0.0, u, v));
+            ++seen;
+            CHECK(pixelToGround(cam, u, v, 0.0, wx, wy));
+            max_m = std::max(max_m, std::hypot(wx - x, wy - y));
+        }
+    }
+    if (max_m >= 1e-5)
+        std::fprintf(stderr, "%s: ground round trip error %.2e m\n", sc.name, max_m);
+    CHECK(seen > 20);
+    CHECK(max_m < 1e-5);
+}
+
+// undistortPoint inverts normalizedToPixel to well under a pixel out to the frame corners
+static void checkUndistort(const SyntheticCamera &sc) {
+    CameraModel cam = makeCamera(sc);
+    const double corner_x = kWidth / 2.0 / cam.fx, corner_y = kHeight / 2.0 / cam.fy;
+
+    double max_err = 0.0;
+    for (double y = -corner_y; y <= corner_y + 1e-9; y += corner_y / 8) {
+        for (double x = -corner_x; x <= corner_x + 1e-9; x += corner_x / 8) {
+            double u, v, xn, yn;
+            normalizedToPixel(cam, x, y, u, v);
+            undistortPoint(cam, u, v, xn, yn);
+            max_err = std::max(max_err, std::max(std::fabs(xn - x), std::fabs(yn - y)) * cam.fx);
+        }
+    }
+    if (max_err >= 1e-3)
+        std::fprintf(stderr, "%s: undistort error %.2e px\n", sc.name, max_err);
+    CHECK(max_err < 1e-3);
+}
+
+// A camera looking at the horizon sees the ground only in the lower half of the frame
+static void checkHorizon() {
+    SyntheticCamera sc = {"horizontal 3 m", 3.0, {90.0, 180.0, -90.0}, {0.0, 0.0, 0.0, 0.0, 0.0}};
+    CameraModel cam = makeCamera(sc);
+
+    double wx, wy;
+    CHECK(!pixelToGround(cam, cam.cx, 0.0, 0.0, wx, wy));
+    CHECK(!pixelToGround(cam, cam.cx, cam.cy - 1.0, 0.0, wx, wy));
+    CHECK(pixelToGround(cam, cam.cx, kHeight - 1.0, 0.0, wx, wy));
+    CHECK(std::fabs(std::hypot(wx, wy) - 3.0 * cam.fy / (kHeight - 1.0 - cam.cy)) < 1e-6);
+
+    GroundLut lut;
+    CHECK(lut.build(cam, 8));
+    float lx, ly;
+    CHECK(!lut.lookup(cam.cx, 10.0f, lx, ly));
+    CHECK(lut.lookup(cam.cx, kHeight - 1.0f, lx, ly));
+}
+
+// Bilinear LUT against the exact ray intersection: exact at the nodes, within a few millimetres between them
+static void checkLut(const SyntheticCamera &sc) {
+    CameraModel cam = makeCamera(sc);
+
+    GroundLut empty;
+    CHECK(!empty.build(cam, 0) && empty.empty());
+
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> ux(0.0, kWidth - 1.0), uy(0.0, kHeight - 1.0);
+
+    const int steps[] = {1, 4, 16};
+    const double bounds_mm[] = {0.05, 0.5, 5.0};
+    for (int s = 0; s < 3; ++s) {
+        GroundLut lut;
+        CHECK(lut.build(cam, steps[s]) && lut.step() == steps[s]);
+
+        double wx = 0.0, wy = 0.0;
+        float lx, ly;
+        CHECK(pixelToGround(cam, 4.0 * steps[s], 2.0 * steps[s], 0.0, wx, wy));
+        CHECK(lut.lookup(4.0f * steps[s], 2.0f * steps[s], lx, ly));
+        CHECK(std::fabs(lx - wx) < 1e-5 && std::fabs(ly - wy) < 1e-5);
+
+        double max_mm = 0.0;
+        for (int i = 0; i < 20000; ++i) {
+            double u = ux(gen), v = uy(gen);
+            CHECK(pixelToGround(cam, u, v, 0.0, wx, wy));
+            CHECK(lut.lookup(static_cast<float>(u), static_cast<float>(v), lx, ly));
+            max_mm = std::max(max_mm, std::hypot(lx - wx, ly - wy) * 1000.0);
+        }
+        if (max_mm >= bounds_mm[s])
+            std::fprintf(stderr, "%s: lut step %d error %.3f mm\n", sc.name, steps[s], max_mm);
+        CHECK(max_mm < bounds_mm[s]);
+    }
+}
+
+// Every batch size, so the SIMD body and the scalar tail both run. lookupBatch is bit-identical to lookup(), including
+// pixels above the horizon and off the frame; imageToWorldBatch may contract to FMA, so it is within float rounding.
+static void checkBatch() {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> ux(-50.0f, kWidth + 50.0f), uy(-50.0f, kHeight + 50.0f);
+    const size_t total = 67;
+    std::vector<float> px(total), py(total);
+    for (size_t i = 0; i < total; ++i) {
+        px[i] = ux(gen);
+        py[i] = uy(gen);
+    }
+
+    const LinearWorldParams lp = makeLinearWorldParams(kWidth, kHeight, 2.0f, 1.2f, 0.5f, -0.25f);
+    SyntheticCamera horizontal = {"horizontal 3 m", 3.0, {90.0, 180.0, -90.0}, {0.0, 0.0, 0.0, 0.0, 0.0}};
+    GroundLut luts[2];
+    CHECK(luts[0].build(makeCamera(kCameras[3]), 4));
+    CHECK(luts[1].build(makeCamera(horizontal), 8));
+
+    for (size_t n = 0; n <= total; ++n) {
+        std::vector<float> wx(n + 1, -1.0f), wy(n + 1, -1.0f);
+        imageToWorldBatch(lp, px.data(), py.data(), wx.data(), wy.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            std::pair<float, float> w = imageToWorld(px[i], py[i], kWidth, kHeight, 2.0f, 1.2f, 0.5f, -0.25f);
+            CHECK(std::fabs(wx[i] - w.first) < 1e-5f && std::fabs(wy[i] - w.second) < 1e-5f);
+        }
+        CHECK(wx[n] == -1.0f && wy[n] == -1.0f);
+
+        for (const GroundLut &lut : luts) {
+            std::vector<uint8_t> valid(n + 1, 2);
+            lut.lookupBatch(px.data(), py.data(), wx.data(), wy.data(), valid.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                float lx, ly;
+                bool ok = lut.lookup(px[i], py[i], lx, ly);
+                CHECK(valid[i] == ok);
+                CHECK(!ok || (wx[i] == lx && wy[i] == ly));
+            }
+            CHECK(valid[n] == 2);
+        }
+    }
+}
+
+int main() {
+    checkStraightDown();
+    for (const SyntheticCamera &sc : kCameras) {
+        checkRoundTrip(sc);
+        checkUndistort(sc);
+        checkLut(sc);
+    }
+    checkHorizon();
+    checkBatch();
+
+    return checkResult();
+}
@@ -0,0 +1,161 @@
+// apps/real_world_overlay/tools/label_format_bench.cpp
+// Checks formatFixed2 / formatWorldLabel against snprintf("%.2f") and compares their cost.
+//   label_format_bench               every hundredth in [-100000, 100000] and its float neighbours, 10M random bit
+//                                    patterns, then the timings
+//   label_format_bench --exhaustive  all 2^32 float bit patterns (multi-threaded)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "label_format.hpp"
+
+static bool checkValue(float v) {
+    char expected[64], got[FIXED2_MAX_CHARS];
+    int n = std::snprintf(expected, sizeof(expected), "%.2f", v);
+    size_t len = formatFixed2(got, v);
+    if (static_cast<size_t>(n) != len || std::strcmp(expected, got) != 0) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        std::fprintf(stderr, "MISMATCH 0x%08x: snprintf \"%s\", formatFixed2 \"%s\"\n", bits, expected, got);
+        return false;
+    }
+    return true;
+}
+
+static bool checkLabel(float x, float y) {
+    char expected[64], got[64];
+    int n = std::snprintf(expected, sizeof(expected), "X:%.2f Y:%.2f", x, y);
+    size_t len = formatWorldLabel(got, sizeof(got), x, y);
+    if (static_cast<size_t>(n) != len || std::strcmp(expected, got) != 0) {
+        std::fprintf(stderr, "MISMATCH label: snprintf \"%s\", formatWorldLabel \"%s\"\n", expected, got);
+        return false;
+    }
+    return true;
+}
+
+static size_t checkExhaustive() {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<size_t> mismatches(0);
+    std::vector<std::thread> workers;
+    const uint64_t total = uint64_t(1) << 32;
+
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            size_t local = 0;
+            for (uint64_t b = t; b < total; b += threads) {
+                uint32_t bits = static_cast<uint32_t>(b);
+                float v;
+                std::memcpy(&v, &bits, sizeof(v));
+                if (!checkValue(v) && ++local > 10)
+                    break;
+            }
+            mismatches += local;
+        });
+    }
+    for (std::thread &w : workers)
+        w.join();
+    return mismatches;
+}
+
+static size_t checkDefault() {
+    size_t mismatches = 0, checked = 0;
+
+    // Hundredths and their neighbours are where rounding decisions flip
+    for (int64_t c = -10000000; c <= 10000000 && mismatches < 10; ++c) {
+        float v = static_cast<float>(c / 100.0);
+        mismatches += !checkValue(v);
+        mismatches += !checkValue(std::nextafter(v, -INFINITY));
+        mismatches += !checkValue(std::nextafter(v, INFINITY));
+        checked += 3;
+    }
+
+    // Exact ties (odd multiples of 1/8), special values and extremes
+    const float specials[] = {0.0f, -0.0f, 0.125f, -0.125f, 0.375f, 2.625f, 1e-45f, -1e-45f, 0.005f, 0.015f,
+                              1e10f, 3.4028235e38f, -3.4028235e38f, INFINITY, -INFINITY, NAN, -NAN};
+    for (float v : specials) {
+        mismatches += !checkValue(v);
+        ++checked;
+    }
+
+    std::mt19937 gen(7);
+    for (int i = 0; i < 10000000 && mismatches < 10; ++i) {
+        uint32_t bits = gen();
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        mismatches += !checkValue(v);
+        ++checked;
+    }
+
+    std::uniform_real_distribution<float> coord(-50.0f, 50.0f);
+    for (int i = 0; i < 1000000 && mismatches < 10; ++i) {
+        mismatches += !checkLabel(coord(gen), coord(gen));
+        ++checked;
+    }
+
+    std::printf("checked %zu values\n", checked);
+    return mismatches;
+}
+
+template <typename F>
+static double nsPerCall(size_t n, F &&f) {
+    double best = 0.0;
+    for (int rep = 0; rep < 5; ++rep) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+        best = rep == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+static void bench() {
+    const size_t samples = 1000000;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> coord(-50.0f, 50.0f);
+    std::vector<float> xs(samples), ys(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        xs[i] = coord(gen);
+        ys[i] = coord(gen);
+    }
+
+    char label[64];
+    volatile size_t sink = 0;
+
+    double printf_ns = nsPerCall(samples, [&]() {
+        size_t acc = 0;
+        for (size_t i = 0; i < samples; ++i)
+            acc += std::snprintf(label, sizeof(label), "X:%.2f Y:%.2f", xs[i], ys[i]);
+        sink = acc;
+    });
+    double fixed_ns = nsPerCall(samples, [&]() {
+        size_t acc = 0;
+        for (size_t i = 0; i < samples; ++i)
+            acc += formatWorldLabel(label, sizeof(label), xs[i], ys[i]);
+        sink = acc;
+    });
+    (void)sink;
+
+    std::printf("\"X:%%.2f Y:%%.2f\" label, coordinates in [-50, 50] m\n");
+    std::printf("%-18s %.1f ns/label\n", "snprintf", printf_ns);
+    std::printf("%-18s %.1f ns/label (%.1fx)\n", "formatWorldLabel", fixed_ns, printf_ns / fixed_ns);
+}
+
+int main(int argc, char *argv[]) {
+    bool exhaustive = argc > 1 && std::strcmp(argv[1], "--exhaustive") == 0;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t mismatches = exhaustive ? checkExhaustive() : checkDefault();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%s check: %zu mismatches (%.1f s)\n", exhaustive ? "exhaustive" : "default", mismatches, seconds);
+    if (mismatches)
+        return 1;
+
+    bench();
+    return 0;
+}
@@ -0,0 +1,184 @@
+// apps/real_world_overlay/tools/latency_trace_check.cpp
+// Checks of the latency histogram and tracer without GStreamer: bucket bounds, percentile error against exact sorted
+// percentiles, concurrent recording, per-stage attribution of simulated pipelines, buffers with equal PTS on parallel
+// branches, the JSON dump, and the cost of one probe call (budget: 1 us). Exits non-zero on failure.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "latency_tracer.hpp"
+#include "tools/check.hpp"
+
+static void checkBuckets() {
+    size_t prev = 0;
+    for (uint64_t v : {0ULL, 1ULL, 63ULL, 64ULL, 65ULL, 127ULL, 128ULL, 1000ULL, 123456789ULL, 1ULL << 40,
+                       ~0ULL >> 1, ~0ULL}) {
+        size_t b = LatencyHistogram::bucketOf(v);
+        CHECK(b < LatencyHistogram::kBuckets);
+        CHECK(LatencyHistogram::bucketLow(b) <= v && v <= LatencyHistogram::bucketHigh(b));
+        CHECK(b >= prev);
+        prev = b;
+    }
+    // Buckets tile the range: each one starts right after the previous one ends
+    for (size_t b = 1; b < LatencyHistogram::kBuckets; ++b)
+        CHECK(LatencyHistogram::bucketLow(b) == LatencyHistogram::bucketHigh(b - 1) + 1);
+    CHECK(LatencyHistogram::bucketHigh(LatencyHistogram::kBuckets - 1) == ~0ULL);
+    std::printf("bucket bounds: done\n");
+}
+
+// Log-normal latencies around 2 ms with a long tail, compared against the exact sorted percentiles
+static void checkAccuracy() {
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> dist(std::log(2e6), 0.8);
+    std::vector<uint64_t> values(1000000);
+    LatencyHistogram h;
+    for (uint64_t &v : values) {
+        v = static_cast<uint64_t>(dist(rng));
+        h.record(v);
+    }
+    std::sort(values.begin(), values.end());
+    LatencyHistogram::Snapshot s = h.snapshot();
+    CHECK(s.count == values.size() && s.max == values.back());
+
+    double worst = 0.0;
+    for (double q : {0.5, 0.9, 0.99, 0.999, 0.9999}) {
+        double exact = static_cast<double>(values[static_cast<size_t>(q * (values.size() - 1))]);
+        double err = std::fabs(static_cast<double>(s.quantile(q)) - exact) / exact;
+        worst = std::max(worst, err);
+    }
+    CHECK(worst < 1.0 / LatencyHistogram::kSub);
+    std::printf("percentiles of %zu log-normal values: worst relative error %.3f%% (bound %.3f%%)\n", values.size(),
+                worst * 100.0, 100.0 / LatencyHistogram::kSub);
+}
+
+static void checkConcurrent() {
+    const int threads = 4;
+    const uint64_t per_thread = 500000;
+    LatencyHistogram h;
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&h, t]() {
+            for (uint64_t i = 0; i < per_thread; ++i)
+                h.record(1000 * (t + 1) + i % 7);
+        });
+    }
+    for (std::thread &th : pool)
+        th.join();
+    LatencyHistogram::Snapshot s = h.snapshot();
+    CHECK(s.count == threads * per_thread);
+    CHECK(s.max == 1000 * threads + 6);
+    uint64_t sum = 0;
+    for (int t = 0; t < threads; ++t) {
+        for (uint64_t i = 0; i < per_thread; ++i)
+            sum += 1000 * (t + 1) + i % 7;
+    }
+    CHECK(s.sum == sum);
+    std::printf("%d threads x %llu records: done\n", threads, static_cast<unsigned long long>(per_thread));
+}
+
+// Four stages with fixed delays, one buffer split into packets at the last stage, and a buffer no source saw
+static void checkTracer() {
+    LatencyTracer tracer(64);
+    int src = tracer.addStage("src", true);
+    int conv = tracer.addStage("conv", false);
+    int infer = tracer.addStage("infer", false);
+    int sink = tracer.addStage("sink", false);
+
+    const uint64_t frame_ns = 33333333;
+    for (uint64_t f = 0; f < 1000; ++f) {
+        uint64_t pts = f * frame_ns, t = 1000000000 + f * frame_ns;
+        tracer.onBuffer(src, pts, t);
+        tracer.onBuffer(conv, pts, t + 2000);
+        tracer.onBuffer(infer, pts, t + 2000 + 8000000);
+        for (int packet = 0; packet < 3; ++packet)
+            tracer.onBuffer(sink, pts, t + 2000 + 8000000 + 500000 + packet * 1000);
+    }
+    tracer.onBuffer(sink, 12345, 5000000000ULL);
+
+    LatencyHistogram::Snapshot c = tracer.sincePrevious(conv), i = tracer.sincePrevious(infer);
+    LatencyHistogram::Snapshot k = tracer.sincePrevious(sink), total = tracer.sinceSource(sink);
+    CHECK(c.count == 1000 && i.count == 1000 && k.count == 1000);
+    CHECK(c.max == 2000 && i.max == 8000000 && k.max == 500000 && total.max == 8502000);
+    CHECK(std::fabs(i.quantile(0.5) - 8e6) / 8e6 < 1.0 / LatencyHistogram::kSub);
+    CHECK(tracer.misses(sink) == 1);
+
+    std::string json = tracer.toJson(42);
+    CHECK(json.compare(0, 17, "{\"timestamp_ns\":4") == 0);
+    CHECK(json.find("\"name\":\"infer\"") != std::string::npos);
+    CHECK(json.find("\"since_source_us\":{\"count\":1000") != std::string::npos);
+    CHECK(std::count(json.begin(), json.end(), '{') == std::count(json.begin(), json.end(), '}'));
+    std::printf("simulated pipeline: done\n%s\n", json.c_str());
+}
+
+// Two cameras with equal PTS on lanes 1 and 2, one teed into two tiles, merged by a muxer: each branch keeps its own
+// source time, where PTS alone would mix them up
+static void checkLanes() {
+    LatencyTracer tracer(256);
+    int cam0 = tracer.addStage("cam0", true, 1), cam1 = tracer.addStage("cam1", true, 2);
+    int conv0 = tracer.addStage("conv0", false, 1), conv1 = tracer.addStage("conv1", false, 2);
+    int tile0 = tracer.addStage("tile0", false, 3, {2}), tile1 = tracer.addStage("tile1", false, 4, {2});
+    int mux = tracer.addStage("mux", false, 5, {1, 3, 4});
+    CHECK(tracer.addStage("bad", false, LatencyTracer::kMaxLanes) == -1);
+    CHECK(tracer.addStage("bad", false, 1, {LatencyTracer::kMaxLanes}) == -1);
+
+    const uint64_t frame_ns = 33333333;
+    for (uint64_t f = 0; f < 100; ++f) {
+        uint64_t pts = f * frame_ns, t = 1000000000 + f * frame_ns;
+        tracer.onBuffer(cam0, pts, t);
+        tracer.onBuffer(cam1, pts, t + 1000000);
+        tracer.onBuffer(conv1, pts, t + 1000000 + 3000);
+        tracer.onBuffer(tile0, pts, t + 1000000 + 5000);
+        tracer.onBuffer(tile1, pts, t + 1000000 + 7000);
+        tracer.onBuffer(conv0, pts, t + 2000000);  // camera 1 passed with the same PTS in between
+        tracer.onBuffer(mux, pts, t + 4000000);
+    }
+    tracer.onBuffer(tile0, 12345, 5000000000ULL);  // its lane and the one it continues never saw it
+
+    CHECK(tracer.sinceSource(conv0).max == 2000000 && tracer.sincePrevious(conv0).max == 2000000);
+    CHECK(tracer.sinceSource(conv1).max == 3000 && tracer.sincePrevious(conv1).max == 3000);
+    CHECK(tracer.sinceSource(tile0).max == 5000 && tracer.sincePrevious(tile0).max == 2000);
+    CHECK(tracer.sinceSource(tile1).max == 7000 && tracer.sincePrevious(tile1).max == 4000);
+    CHECK(tracer.sinceSource(tile0).count == 100 && tracer.sinceSource(tile1).count == 100);
+    CHECK(tracer.sinceSource(mux).count == 100 && tracer.sinceSource(mux).max == 4000000);  // the first lane, cam0
+    CHECK(tracer.misses(tile0) == 1 && tracer.misses(mux) == 0 && tracer.misses(conv0) == 0);
+    std::printf("equal PTS on two cameras and two tiles: done\n");
+}
+
+// Probe cost: one source and three downstream stages per buffer, clock read included
+static void benchProbe() {
+    LatencyTracer tracer(1024);
+    int stages[4];
+    stages[0] = tracer.addStage("src", true);
+    for (int s = 1; s < 4; ++s)
+        stages[s] = tracer.addStage("stage" + std::to_string(s), false);
+
+    const uint64_t buffers = 500000;
+    double best = 1e30;
+    for (int run = 0; run < 5; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t b = 0; b < buffers; ++b) {
+            uint64_t pts = (run * buffers + b) * 33333333ULL;
+            for (int s = 0; s < 4; ++s)
+                tracer.onBuffer(stages[s], pts, latencyNowNs());
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ns / (buffers * 4));
+    }
+    CHECK(best < 1000.0);
+    std::printf("onBuffer + clock read: %.1f ns per probe\n", best);
+}
+
+int main() {
+    checkBuckets();
+    checkAccuracy();
+    checkConcurrent();
+    checkTracer();
+    checkLanes();
+    benchProbe();
+
+    return checkResult();
+}
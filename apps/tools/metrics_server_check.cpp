@@ -0,0 +1,194 @@
+// apps/real_world_overlay/tools/metrics_server_check.cpp
+// Loopback checks of the metrics registry and the epoll /metrics server: text format of every metric type, status
+// codes, requests split over several writes, oversized requests, many concurrent clients, scrapes while another thread
+// updates counters, and the hot-path cost of an update. Exits non-zero on failure.
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics.hpp"
+#include "metrics_server.hpp"
+#include "tools/check.hpp"
+
+// Sends `request` in pieces of `chunk` bytes (pausing between them) and returns everything read until the server closes
+static std::string httpExchange(int port, const std::string &request, size_t chunk = 0) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return "";
+    }
+    if (chunk == 0)
+        chunk = request.size();
+    for (size_t off = 0; off < request.size(); off += chunk) {
+        if (send(fd, request.data() + off, std::min(chunk, request.size() - off), MSG_NOSIGNAL) < 0)
+            break;
+        if (off + chunk < request.size())
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::string response;
+    char buf[4096];
+    ssize_t r;
+    while ((r = read(fd, buf, sizeof(buf))) > 0)
+        response.append(buf, static_cast<size_t>(r));
+    close(fd);
+    return response;
+}
+
+static int statusOf(const std::string &response) {
+    return response.size() > 12 ? std::atoi(response.c_str() + 9) : 0;
+}
+
+static std::string bodyOf(const std::string &response) {
+    size_t end = response.find("\r\n\r\n");
+    return end == std::string::npos ? "" : response.substr(end + 4);
+}
+
+// Value of the first sample line starting with `series` + ' '
+static double sampleValue(const std::string &body, const std::string &series) {
+    size_t pos = body.find("\n" + series + " ");
+    return pos == std::string::npos ? -1.0 : std::atof(body.c_str() + pos + series.size() + 2);
+}
+
+static void checkFormat() {
+    MetricsRegistry registry("app_");
+    MetricCounter &frames = registry.counter("frames_total", "Frames processed");
+    MetricGauge &queued = registry.gauge("queued", "Items waiting");
+    MetricHistogram &objects = registry.histogram("objects_per_frame", "Objects per frame", {0, 1, 10});
+    MetricHistogram &latency = registry.histogram("latency_seconds", "Latency", {1000000, 10000000}, 1e-9);
+    registry.addCollector([](std::string &out) {
+        appendMetricHeader(out, "app_stage_seconds", "gauge", "Per stage \\ with\nnewline");
+        appendMetricSample(out, "app_stage_seconds", metricLabel("stage", "a\"b\\c"), 0.5);
+    });
+
+    frames.add(3);
+    queued.set(-2);
+    for (uint64_t v : {0, 1, 2, 50})
+        objects.observe(v);
+    latency.observe(500000);
+    latency.observe(20000000);
+
+    std::string text = "\n" + registry.render();
+    CHECK(text.find("\n# HELP app_frames_total Frames processed\n# TYPE app_frames_total counter\n"
+                    "app_frames_total 3\n") != std::string::npos);
+    CHECK(text.find("\n# TYPE app_queued gauge\napp_queued -2\n") != std::string::npos);
+    CHECK(text.find("\napp_objects_per_frame_bucket{le=\"0\"} 1\n") != std::string::npos);
+    CHECK(text.find("\napp_objects_per_frame_bucket{le=\"1\"} 2\n") != std::string::npos);
+    CHECK(text.find("\napp_objects_per_frame_bucket{le=\"10\"} 3\n") != std::string::npos);
+    CHECK(text.find("\napp_objects_per_frame_bucket{le=\"+Inf\"} 4\n") != std::string::npos);
+    CHECK(sampleValue(text, "app_objects_per_frame_sum") == 53.0);
+    CHECK(sampleValue(text, "app_objects_per_frame_count") == 4.0);
+    CHECK(text.find("\napp_latency_seconds_bucket{le=\"0.001\"} 1\n") != std::string::npos);
+    CHECK(std::fabs(sampleValue(text, "app_latency_seconds_sum") - 0.0205) < 1e-12);
+    CHECK(text.find("# HELP app_stage_seconds Per stage \\\\ with\\nnewline\n") != std::string::npos);
+    CHECK(text.find("\napp_stage_seconds{stage=\"a\\\"b\\\\c\"} 0.5\n") != std::string::npos);
+    std::printf("text format: done\n");
+}
+
+static void checkServer() {
+    MetricsRegistry registry("app_");
+    MetricCounter &frames = registry.counter("frames_total", "Frames processed");
+    MetricsServer server;
+    std::string error;
+    CHECK(server.start("127.0.0.1", 0, [&registry]() { return registry.render(); }, &error));
+    int port = server.port();
+    CHECK(port > 0);
+
+    frames.add(7);
+    std::string r = httpExchange(port, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    CHECK(statusOf(r) == 200);
+    CHECK(r.find("Content-Type: text/plain; version=0.0.4") != std::string::npos);
+    CHECK(sampleValue("\n" + bodyOf(r), "app_frames_total") == 7.0);
+    size_t length = std::strtoul(r.c_str() + r.find("Content-Length: ") + 16, nullptr, 10);
+    CHECK(length == bodyOf(r).size());
+
+    r = httpExchange(port, "HEAD /metrics HTTP/1.1\r\n\r\n");
+    CHECK(statusOf(r) == 200 && bodyOf(r).empty());
+    CHECK(statusOf(httpExchange(port, "GET /metrics?x=1 HTTP/1.0\r\n\r\n")) == 200);
+    CHECK(statusOf(httpExchange(port, "GET / HTTP/1.1\r\n\r\n")) == 404);
+    r = httpExchange(port, "POST /metrics HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+    CHECK(statusOf(r) == 405 && r.find("\r\nAllow: GET, HEAD\r\n") != std::string::npos);
+    CHECK(statusOf(httpExchange(port, "garbage\r\n\r\n")) == 400);
+    CHECK(statusOf(httpExchange(port, "GET /metrics HTTP/1.1\r\nX: " + std::string(10000, 'a') + "\r\n\r\n")) == 431);
+
+    // Headers trickling in over several reads
+    frames.add(1);
+    r = httpExchange(port, "GET /metrics HTTP/1.1\r\nHost: localhost\r\nAccept: */*\r\n\r\n", 7);
+    CHECK(statusOf(r) == 200 && sampleValue("\n" + bodyOf(r), "app_frames_total") == 8.0);
+    std::printf("status codes and split requests: done\n");
+
+    // Concurrent scrapers while the "pipeline" keeps counting
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        while (!done.load(std::memory_order_relaxed))
+            frames.add(1);
+    });
+    std::atomic<int> ok(0);
+    std::vector<std::thread> clients;
+    for (int c = 0; c < 16; ++c) {
+        clients.emplace_back([&]() {
+            double last = 0.0;
+            for (int i = 0; i < 50; ++i) {
+                std::string resp = httpExchange(port, "GET /metrics HTTP/1.1\r\n\r\n");
+                double v = sampleValue("\n" + bodyOf(resp), "app_frames_total");
+                if (statusOf(resp) == 200 && v >= last) {
+                    ++ok;
+                    last = v;
+                }
+            }
+        });
+    }
+    for (std::thread &t : clients)
+        t.join();
+    done.store(true);
+    writer.join();
+    CHECK(ok.load() == 16 * 50);
+    std::printf("16 concurrent clients x 50 scrapes: %d ok, %llu requests served\n", ok.load(),
+                static_cast<unsigned long long>(server.requests()));
+
+    server.stop();
+    CHECK(httpExchange(port, "GET /metrics HTTP/1.1\r\n\r\n").empty());
+
+    // The port is free again
+    MetricsServer again;
+    CHECK(again.start("127.0.0.1", port, [&registry]() { return registry.render(); }, &error));
+    CHECK(!MetricsServer().start("127.0.0.1", port, [] { return std::string(); }, &error) && !error.empty());
+    CHECK(!MetricsServer().start("not an address", 0, [] { return std::string(); }, &error));
+}
+
+static void benchUpdate() {
+    MetricsRegistry registry;
+    MetricCounter &counter = registry.counter("c", "c");
+    MetricHistogram &hist = registry.histogram("h", "h", {0, 1, 2, 5, 10, 20, 50, 100, 200, 500});
+    const uint64_t n = 10000000;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+        counter.add(1);
+        hist.observe(i & 63);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+    CHECK(counter.value() == n);
+    std::printf("counter add + histogram observe: %.1f ns\n", ns);
+}
+
+int main() {
+    checkFormat();
+    checkServer();
+    benchUpdate();
+
+    return checkResult();
+}
@@ -0,0 +1,162 @@
+// apps/real_world_overlay/tools/motion_detector_bench.cpp
+// MotionDetector on synthetic raw frames: a textured static background with per-frame sensor noise, and a block
+// walking across it. Checks the SIMD SAD against the scalar one, that noise alone is not motion, that the walker is
+// found with a region covering it, and the MotionGate schedule; then times update() for 4K and 1080p YUY2 / NV12
+// frames. Exits non-zero when a check fails.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "motion_detector.hpp"
+#include "tools/check.hpp"
+
+// Packed YUY2 (pixel_step 2) or the luma plane of NV12 (pixel_step 1)
+struct RawFrame {
+    int width, height, pixel_step, stride;
+    std::vector<uint8_t> data;
+
+    RawFrame(int w, int h, int step)
+        : width(w), height(h), pixel_step(step), stride(w * step), data(size_t(w) * step * h) {}
+
+    uint8_t &luma(int x, int y) { return data[size_t(y) * stride + size_t(x) * pixel_step]; }
+};
+
+struct Scene {
+    std::vector<uint8_t> background;  // luma
+    int width, height;
+    std::mt19937 rng{5};
+
+    Scene(int w, int h) : background(size_t(w) * h), width(w), height(h) {
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x)
+                background[size_t(y) * w + x] =
+                    static_cast<uint8_t>(60 + (x * 7 / 64 + y * 5 / 64) % 90 + ((x ^ y) & 15));
+    }
+
+    // Background with +-noise per pixel, and a bright w x h block at (bx, by) when w > 0
+    void render(RawFrame &f, int noise, int bx = 0, int by = 0, int w = 0, int h = 0) {
+        std::uniform_int_distribution<int> n(-noise, noise);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                int v = background[size_t(y) * width + x];
+                if (x >= bx && x < bx + w && y >= by && y < by + h)
+                    v = 230;
+                // Noise on every 8th diagonal, which holds every sample at downscale 8 (a per-pixel RNG is slow at 4K)
+                if (noise && ((x + y) & 7) == 0)
+                    v += n(rng);
+                f.luma(x, y) = static_cast<uint8_t>(std::min(255, std::max(0, v)));
+            }
+        }
+    }
+};
+
+static void checkSad() {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> byte(0, 255);
+    const int stride = 64, blocks = 7;  // odd count: SIMD pairs plus the scalar tail
+    std::vector<uint8_t> a(stride * 8), b(stride * 8);
+    int mismatches = 0;
+    for (int rep = 0; rep < 200; ++rep) {
+        for (size_t i = 0; i < a.size(); ++i) {
+            a[i] = static_cast<uint8_t>(byte(rng));
+            b[i] = static_cast<uint8_t>(rep % 2 ? byte(rng) : std::min(255, a[i] + byte(rng) % 4));
+        }
+        uint32_t s[blocks], v[blocks];
+        motion_detector_detail::sadBlockRowScalar(a.data(), b.data(), stride, blocks, s);
+        motion_detector_detail::sadBlockRow(a.data(), b.data(), stride, blocks, v);
+        for (int k = 0; k < blocks; ++k)
+            mismatches += s[k] != v[k];
+    }
+    CHECK(mismatches == 0);
+    std::printf("SAD %s vs scalar: %d mismatches over %d blocks\n", motionDetectorSimdName(), mismatches, 200 * blocks);
+}
+
+static void checkDetection(int width, int height, int pixel_step) {
+    Scene scene(width, height);
+    RawFrame frame(width, height, pixel_step);
+    MotionDetector detector;
+    const char *format = pixel_step == 2 ? "YUY2" : "NV12";
+
+    scene.render(frame, 0);
+    CHECK(detector.update(frame.data.data(), width, height, frame.stride, pixel_step).motion);  // reference only
+
+    int false_motion = 0;
+    for (int i = 0; i < 10; ++i) {
+        scene.render(frame, 6);
+        MotionResult r = detector.update(frame.data.data(), width, height, frame.stride, pixel_step);
+        false_motion += r.motion;
+    }
+    CHECK(false_motion == 0);
+
+    // A person-sized block (4% of the width) walking 1% of the width per frame
+    int bw = width / 25, bh = height / 6, missed = 0, uncovered = 0;
+    for (int i = 0; i < 10; ++i) {
+        int bx = width / 4 + i * width / 100, by = height / 2;
+        scene.render(frame, 6, bx, by, bw, bh);
+        MotionResult r = detector.update(frame.data.data(), width, height, frame.stride, pixel_step);
+        if (i == 0)
+            continue;  // still compared with the empty scene
+        missed += !r.motion;
+        uncovered += !(r.x0 <= bx && r.y0 <= by && r.x1 >= bx + bw && r.y1 >= by + bh);
+    }
+    CHECK(missed == 0 && uncovered == 0);
+    std::printf("%s %dx%d: %d false motion in 10 noisy static frames, %d missed and %d uncovered of 9 walker frames "
+                "(%dx%d blocks)\n",
+                format, width, height, false_motion, missed, uncovered, detector.blocksX(), detector.blocksY());
+}
+
+static void checkGate() {
+    MotionGateConfig cfg;
+    cfg.hold_frames = 3;
+    cfg.recheck_frames = 10;
+    MotionGate gate(cfg);
+    std::vector<int> inferred;
+    for (int i = 0; i < 40; ++i)
+        if (gate.infer(i == 5))
+            inferred.push_back(i);
+    // 0..2 start-up, the motion frame 5 and 3 after it, then every 10 frames
+    std::vector<int> expected = {0, 1, 2, 5, 6, 7, 8, 18, 28, 38};
+    CHECK(inferred == expected);
+    std::printf("gate: %zu of 40 frames inferred with one motion frame, hold 3, re-check 10\n", inferred.size());
+}
+
+static void bench(int width, int height, int pixel_step) {
+    Scene scene(width, height);
+    RawFrame a(width, height, pixel_step), b(width, height, pixel_step);
+    scene.render(a, 6);
+    scene.render(b, 6, width / 3, height / 3, width / 25, height / 6);
+    MotionDetector detector;
+    detector.update(a.data.data(), width, height, a.stride, pixel_step);
+
+    const int frames = 200;
+    double best = 0.0;
+    for (int rep = 0; rep < 5; ++rep) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i) {
+            const RawFrame &f = i & 1 ? b : a;
+            detector.update(f.data.data(), width, height, f.stride, pixel_step);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        double us = std::chrono::duration<double, std::micro>(elapsed).count() / frames;
+        best = rep == 0 ? us : std::min(best, us);
+    }
+    std::printf("  %-5s %4d x %-4d  %7.1f us/frame  (%.2f%% of a 30 fps frame period)\n",
+                pixel_step == 2 ? "YUY2" : "NV12", width, height, best, best / 333.33);
+}
+
+int main() {
+    checkSad();
+    checkDetection(1920, 1080, 2);
+    checkDetection(3840, 2160, 1);
+    checkGate();
+
+    std::printf("update(), downscale 8, %s SAD, best of 5 x 200 frames:\n", motionDetectorSimdName());
+    bench(3840, 2160, 2);
+    bench(3840, 2160, 1);
+    bench(1920, 1080, 2);
+    bench(1920, 1080, 1);
+
+    return checkResult();
+}
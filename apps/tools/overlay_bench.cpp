@@ -0,0 +1,143 @@
+// apps/real_world_overlay/tools/overlay_bench.cpp
+// Per-frame label cost of the osd probe in each overlay mode, on synthetic tracked objects: label selection, the
+// X/Y label (formatted or copied from the cache) into a recycled display_text buffer, and the buffer's return to the
+// pool as on the osd src pad. Also reports the labels handed to nvdsosd per frame, which its text rendering cost
+// follows.
+//   overlay_bench [objects] [frames] [label_every] [top_k]     defaults: 300 3000 5 90
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "overlay_policy.hpp"
+
+struct Obj {
+    int class_id;
+    float confidence;
+    uint64_t object_id;
+    float x, y;
+    char *display_text;
+};
+
+static double nowUs() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Result {
+    double us_per_frame;
+    double labels_per_frame;
+    double formatted_per_frame;
+};
+
+// One probe pass per frame over `objs`, with the settings of `cfg`
+static Result run(std::vector<Obj> &objs, int frames, const OverlayConfig &cfg, std::mt19937 &rng) {
+    LabelSelector selector;
+    selector.configure(cfg);
+    LabelCache cache(cfg.label_every);
+    std::vector<char *> pool;  // LabelPool in steady state: a free list of fixed-size buffers
+    std::vector<Obj *> ptrs;
+    for (Obj &o : objs)
+        ptrs.push_back(&o);
+    std::vector<uint8_t> valid(objs.size(), 1), labeled(objs.size());
+    std::vector<char *> in_flight;
+    std::normal_distribution<float> step(0.0f, 0.05f);
+
+    uint64_t labels = 0;
+    double total_us = 0.0;
+    for (int f = 0; f < frames; ++f) {
+        for (Obj &o : objs) {
+            o.x += step(rng);
+            o.y += step(rng);
+        }
+
+        double start = nowUs();
+        if (cfg.mode == OverlayMode::Full) {
+            bool filtered = !selector.selectsAll();
+            if (filtered)
+                selector.select(ptrs.data(), valid.data(), objs.size(), labeled.data());
+            for (size_t i = 0; i < objs.size(); ++i) {
+                Obj &o = objs[i];
+                if (filtered && !labeled[i])
+                    continue;
+                char *label;
+                if (pool.empty()) {
+                    label = static_cast<char *>(std::malloc(LabelCache::kLabelSize));
+                } else {
+                    label = pool.back();
+                    pool.pop_back();
+                }
+                cache.label(o.object_id, static_cast<uint64_t>(f), o.x, o.y, label);
+                o.display_text = label;
+                in_flight.push_back(label);
+            }
+            cache.nextBatch();
+        } else {
+            for (Obj &o : objs)
+                o.display_text = nullptr;  // boxes: nvinfer's labels cleared
+        }
+        labels += in_flight.size();
+        for (char *label : in_flight)
+            pool.push_back(label);
+        in_flight.clear();
+        total_us += nowUs() - start;
+    }
+    for (char *label : pool)
+        std::free(label);
+    return Result{total_us / frames, static_cast<double>(labels) / frames,
+                  static_cast<double>(cache.formatted()) / frames};
+}
+
+int main(int argc, char *argv[]) {
+    int objects = argc > 1 ? std::atoi(argv[1]) : 300;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 3000;
+    int every = argc > 3 ? std::atoi(argv[3]) : 5;
+    int top_k = argc > 4 ? std::atoi(argv[4]) : 90;
+    if (objects < 1 || frames < 1 || every < 1 || top_k < 1) {
+        std::fprintf(stderr, "usage: %s [objects] [frames] [label_every] [top_k]\n", argv[0]);
+        return 2;
+    }
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> pos(-50.0f, 50.0f), conf(0.25f, 1.0f);
+    std::vector<Obj> objs(static_cast<size_t>(objects));
+    for (size_t i = 0; i < objs.size(); ++i) {
+        objs[i].class_id = static_cast<int>(rng() % 10);
+        objs[i].confidence = conf(rng);
+        objs[i].object_id = (uint64_t(i % 4) << 48) + i + 1;  // 4 sources, ids as the tracker hands them out
+        objs[i].x = pos(rng);
+        objs[i].y = pos(rng);
+    }
+
+    struct Mode {
+        const char *name;
+        OverlayConfig cfg;
+    };
+    std::vector<Mode> modes(6);
+    modes[0].name = "full";
+    modes[1].name = "full, label_every";
+    modes[1].cfg.label_every = every;
+    modes[2].name = "full, label_top_k";
+    modes[2].cfg.label_top_k = top_k;
+    modes[3].name = "full, label_classes 0-2";
+    modes[3].cfg.label_classes = {0, 1, 2};
+    modes[4].name = "full, top_k + label_every";
+    modes[4].cfg.label_top_k = top_k;
+    modes[4].cfg.label_every = every;
+    modes[5].name = "boxes";
+    modes[5].cfg.mode = OverlayMode::Boxes;
+
+    std::printf("%d tracked objects per frame, %d frames, label_every %d, label_top_k %d\n", objects, frames, every,
+                top_k);
+    std::printf("%-26s %12s %16s %18s\n", "mode", "us/frame", "labels/frame", "formatted/frame");
+    double full_us = 0.0;
+    for (Mode &m : modes) {
+        run(objs, frames / 10 + 1, m.cfg, rng);  // warm-up
+        Result r = run(objs, frames, m.cfg, rng);
+        if (&m == &modes[0])
+            full_us = r.us_per_frame;
+        std::printf("%-26s %12.2f %16.1f %18.1f   (%.1fx)\n", m.name, r.us_per_frame, r.labels_per_frame,
+                    r.formatted_per_frame, full_us / r.us_per_frame);
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+// apps/real_world_overlay/tools/overlay_policy_check.cpp
+// Checks of the overlay modes: mode names, label selection by class and top-k confidence (ties, invalid objects,
+// k larger than the frame), and the label cache: refresh every N frames staggered by object id, reuse in between,
+// untracked objects always formatted, skipped frames, source frame counters going back, forgetting objects no longer
+// labeled. Exits non-zero on failure.
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "overlay_policy.hpp"
+#include "tools/check.hpp"
+
+struct Obj {
+    int class_id;
+    float confidence;
+};
+
+static void checkModes() {
+    OverlayMode mode = OverlayMode::Full;
+    CHECK(parseOverlayMode("boxes", mode) && mode == OverlayMode::Boxes);
+    CHECK(parseOverlayMode("none", mode) && mode == OverlayMode::None);
+    CHECK(parseOverlayMode("full", mode) && mode == OverlayMode::Full);
+    CHECK(!parseOverlayMode("labels", mode) && mode == OverlayMode::Full);
+    CHECK(std::strcmp(overlayModeName(OverlayMode::Boxes), "boxes") == 0);
+}
+
+static size_t selectFrame(LabelSelector &sel, const std::vector<Obj> &objs, const std::vector<uint8_t> &valid,
+                          std::vector<uint8_t> &labeled) {
+    std::vector<const Obj *> ptrs;
+    for (const Obj &o : objs)
+        ptrs.push_back(&o);
+    labeled.assign(objs.size(), 7);
+    return sel.select(ptrs.data(), valid.data(), objs.size(), labeled.data());
+}
+
+static void checkSelector() {
+    std::vector<Obj> objs = {{0, 0.9f}, {2, 0.5f}, {1, 0.7f}, {2, 0.95f}, {0, 0.7f}, {5, 0.99f}};
+    std::vector<uint8_t> valid = {1, 1, 1, 1, 1, 0};
+    std::vector<uint8_t> labeled;
+    LabelSelector sel;
+    OverlayConfig cfg;
+
+    sel.configure(cfg);
+    CHECK(sel.selectsAll());
+    CHECK(selectFrame(sel, objs, valid, labeled) == 5);
+    CHECK((labeled == std::vector<uint8_t>{1, 1, 1, 1, 1, 0}));  // the invalid one never gets a label
+
+    cfg.label_top_k = 3;
+    sel.configure(cfg);
+    CHECK(!sel.selectsAll());
+    CHECK(selectFrame(sel, objs, valid, labeled) == 3);
+    CHECK((labeled == std::vector<uint8_t>{1, 0, 1, 1, 0, 0}));  // 0.95, 0.9, then the earlier of the two 0.7
+
+    cfg.label_classes = {0, 2};
+    sel.configure(cfg);
+    CHECK(selectFrame(sel, objs, valid, labeled) == 3);
+    CHECK((labeled == std::vector<uint8_t>{1, 0, 0, 1, 1, 0}));
+
+    cfg.label_top_k = 10;
+    sel.configure(cfg);
+    CHECK(selectFrame(sel, objs, valid, labeled) == 4);
+    CHECK((labeled == std::vector<uint8_t>{1, 1, 0, 1, 1, 0}));
+
+    cfg.label_top_k = 0;
+    cfg.label_classes = {5, -1, 64};
+    sel.configure(cfg);
+    CHECK(selectFrame(sel, objs, valid, labeled) == 0);  // class 5 is the invalid object
+    objs[0].class_id = 64;
+    CHECK(selectFrame(sel, objs, valid, labeled) == 1 && labeled[0] == 1);
+    objs[0].class_id = -3;
+    CHECK(selectFrame(sel, objs, valid, labeled) == 0);
+
+    std::vector<Obj> none;
+    std::vector<uint8_t> no_valid;
+    CHECK(selectFrame(sel, none, no_valid, labeled) == 0);
+}
+
+static void checkCache() {
+    char out[LabelCache::kLabelSize];
+    char expected[LabelCache::kLabelSize];
+
+    // Every frame: nothing cached
+    LabelCache every(1);
+    CHECK(every.label(3, 0, 1.0f, 2.0f, out) && std::strcmp(out, "X:1.00 Y:2.00") == 0);
+    CHECK(every.label(3, 1, 1.5f, 2.0f, out) && std::strcmp(out, "X:1.50 Y:2.00") == 0);
+    CHECK(every.size() == 0 && every.formatted() == 2 && every.reused() == 0);
+
+    // Every 4 frames: formatted when first seen, then on the frames where (frame + id) % 4 == 0
+    LabelCache cache(4);
+    int formatted = 0;
+    for (uint64_t f = 10; f < 30; ++f) {
+        float x = static_cast<float>(f);
+        bool fresh = cache.label(5, f, x, 0.0f, out);
+        formatted += fresh;
+        bool expect = f == 10 || (f + 5) % 4 == 0;
+        CHECK(fresh == expect);
+        uint64_t shown = f;
+        while (shown != 10 && (shown + 5) % 4 != 0)
+            --shown;
+        formatWorldLabel(expected, sizeof(expected), static_cast<float>(shown), 0.0f);
+        CHECK(std::strcmp(out, expected) == 0);  // never older than 3 frames
+        cache.nextBatch();
+    }
+    CHECK(formatted == 6 && cache.formatted() == 6 && cache.reused() == 14);
+
+    // Objects are staggered: of 8 ids seen on the same frames, 2 refresh on each frame
+    LabelCache staggered(4);
+    for (uint64_t id = 100; id < 108; ++id)
+        staggered.label(id, 0, 0.0f, 0.0f, out);
+    for (uint64_t f = 1; f <= 8; ++f) {
+        int n = 0;
+        for (uint64_t id = 100; id < 108; ++id)
+            n += staggered.label(id, f, 0.0f, 0.0f, out);
+        CHECK(n == 2);
+    }
+
+    // The same frame twice (tile-merged duplicates of a track) formats once
+    CHECK(cache.label(5, 31, 1.0f, 1.0f, out) == true);  // (31 + 5) % 4 == 0
+    CHECK(cache.label(5, 31, 2.0f, 2.0f, out) == false && std::strcmp(out, "X:1.00 Y:1.00") == 0);
+
+    // A skipped refresh frame is caught up, a frame counter going back (source restarted) refreshes
+    CHECK(cache.label(5, 40, 3.0f, 3.0f, out) == true);
+    CHECK(cache.label(5, 2, 4.0f, 4.0f, out) == true && std::strcmp(out, "X:4.00 Y:4.00") == 0);
+
+    // Untracked objects are never cached
+    size_t before = cache.size();
+    CHECK(cache.label(LabelCache::kUntracked, 41, 7.0f, 7.0f, out) && std::strcmp(out, "X:7.00 Y:7.00") == 0);
+    CHECK(cache.label(LabelCache::kUntracked, 42, 8.0f, 8.0f, out) && std::strcmp(out, "X:8.00 Y:8.00") == 0);
+    CHECK(cache.size() == before);
+
+    // Objects not labeled any more are forgotten after a while, those still labeled stay
+    LabelCache sweep(2);
+    for (int b = 0; b < 1000; ++b) {
+        if (b < 10)
+            sweep.label(1, static_cast<uint64_t>(b), 0.0f, 0.0f, out);
+        sweep.label(2, static_cast<uint64_t>(b), 0.0f, 0.0f, out);
+        sweep.nextBatch();
+    }
+    CHECK(sweep.size() == 1);
+
+    cache.setInterval(0);
+    CHECK(cache.interval() == 1 && cache.size() == 0);
+}
+
+int main() {
+    checkModes();
+    checkSelector();
+    checkCache();
+
+    return checkResult();
+}
@@ -0,0 +1,386 @@
+// apps/real_world_overlay/tools/pipeline_builder_check.cpp
+// Checks of the config-driven pipeline description, no GStreamer or DeepStream needed: the default config, every
+// source x converter x encoder x sink permutation (one conversion per source, no I420 pass, consistent factory list,
+// unique element names), the source crop, tiled sources, the nvinfer batch and its engine file, the headless pipeline
+// and the configuration errors. Exits non-zero on failure.
+//   pipeline_builder_check [config.toml]    also prints the graph built from that file
+#include <algorithm>
+#include <cstdio>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "pipeline_config.hpp"
+#include "tools/check.hpp"
+
+static const char *kBase = "device = \"video0\"\nresolution = [3848, 2168]\n";
+
+static bool build(const std::string &toml_text, PipelineDescription &desc, std::string &error) {
+    toml::table data = toml::parse(toml_text);
+    PipelineConfig pc;
+    auto res = data["resolution"].as_array();
+    int w = res ? static_cast<int>(res->at(0).value_or(1920)) : 1920;
+    int h = res ? static_cast<int>(res->at(1).value_or(1080)) : 1080;
+    if (!parsePipelineConfig(data, data["device"].value_or(std::string("video0")), w, h, pc, error))
+        return false;
+    return buildPipelineDescription(pc, desc, &error);
+}
+
+static size_t count(const std::string &s, const std::string &what) {
+    size_t n = 0;
+    for (size_t pos = s.find(what); pos != std::string::npos; pos = s.find(what, pos + what.size()))
+        ++n;
+    return n;
+}
+
+// Splits the launch line into chains (separated by two spaces) of items (separated by " ! ")
+static std::vector<std::vector<std::string>> chains(const std::string &launch) {
+    std::vector<std::vector<std::string>> out;
+    size_t start = 0;
+    while (start <= launch.size()) {
+        size_t end = launch.find("  ", start);
+        std::string chain = launch.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        std::vector<std::string> items;
+        size_t a = 0;
+        for (;;) {
+            size_t b = chain.find(" ! ", a);
+            items.push_back(chain.substr(a, b == std::string::npos ? std::string::npos : b - a));
+            if (b == std::string::npos)
+                break;
+            a = b + 3;
+        }
+        out.push_back(items);
+        if (end == std::string::npos)
+            break;
+        start = end + 2;
+    }
+    return out;
+}
+
+// Structure every valid description shares
+static void checkInvariants(const PipelineDescription &desc, const std::string &converter, const std::string &what) {
+    std::vector<std::vector<std::string>> c = chains(desc.launch);
+    bool ok = c.size() == 2 && c[0][0].compare(0, 11, "nvstreammux") == 0 && c[1].back() == "mux.sink_0";
+
+    // Every element is in the factory list, every listed factory is used, element names are unique
+    std::set<std::string> used, names;
+    for (const auto &chain : c) {
+        for (const std::string &item : chain) {
+            ok = ok && !item.empty();
+            if (item.compare(0, 6, "video/") == 0 || item.compare(0, 6, "image/") == 0)
+                continue;  // caps
+            if (item.find(".sink_") != std::string::npos)
+                continue;  // pad reference
+            std::string factory = item.substr(0, item.find(' '));
+            used.insert(factory);
+            size_t name = item.find("name=");
+            if (name != std::string::npos)
+                ok = ok && names.insert(item.substr(name, item.find(' ', name) - name)).second;
+        }
+    }
+    ok = ok && used == std::set<std::string>(desc.factories.begin(), desc.factories.end());
+    ok = ok && used.size() == desc.factories.size();
+
+    // One conversion between source and mux, and no I420 round trip
+    size_t conversions = 0;
+    for (const std::string &item : c[1])
+        conversions += item == converter;
+    ok = ok && conversions == 1 && desc.launch.find("I420") == std::string::npos;
+    ok = ok && desc.launch.find("name=osd") != std::string::npos && desc.launch.find("name=infer") != std::string::npos;
+    ok = ok && count(desc.graph, "\n") == c[0].size() + c[1].size();
+    if (!ok)
+        std::fprintf(stderr, "  %s:\n  %s\n", what.c_str(), desc.launch.c_str());
+    CHECK(ok);
+}
+
+static void checkDefault() {
+    PipelineDescription desc;
+    std::string error;
+    CHECK(build(kBase, desc, error));
+    CHECK(desc.launch ==
+          "nvstreammux name=mux batch-size=1 width=3848 height=2168 ! "
+          "nvinfer name=infer config-file-path=/home/flux/DeepStream-Yolo/config_infer_primary_yoloV10.txt "
+          "batch-size=1 ! "
+          "nvdsosd name=osd ! nvvidconv ! video/x-raw(memory:NVMM), format=NV12 ! nvv4l2h264enc ! "
+          "rtph264pay mtu=60000 ! udpsink clients=100.72.147.81:5000 sync=false  "
+          "v4l2src device=/dev/video0 name=src0 ! video/x-raw, width=3848, height=2168 ! nvvidconv ! "
+          "video/x-raw(memory:NVMM), format=NV12, width=3848, height=2168 ! mux.sink_0");
+    checkInvariants(desc, "nvvidconv", "default");
+    std::printf("default config:\n%s", desc.graph.c_str());
+}
+
+static void checkPermutations() {
+    const char *sources[] = {
+        "[source]\ntype = \"v4l2\"\n[caps]\nformat = \"raw\"\nraw_format = \"YUY2\"\nframerate = [30, 1]\n",
+        "[source]\ntype = \"v4l2\"\ndevice = \"video2\"\n[caps]\nformat = \"mjpeg\"\nframerate = [60, 1]\n",
+        "[source]\ntype = \"videotest\"\n",
+        "[source]\ntype = \"uri\"\nuri = \"file:///data/clip 1.mp4\"\n",
+    };
+    const char *converters[] = {"nvvidconv", "nvvideoconvert"};
+    const char *encoders[] = {"h264", "h265", "none"};
+    const char *sinks[] = {"udp", "file", "display", "fake"};
+
+    int built = 0, rejected = 0;
+    for (size_t si = 0; si < sizeof(sources) / sizeof(sources[0]); ++si) {
+        const char *source = sources[si];
+        for (const char *converter : converters) {
+            for (const char *encoder : encoders) {
+                for (const char *sink : sinks) {
+                    std::ostringstream t;
+                    t << kBase << source << "[conversion]\nconverter = \"" << converter
+                      << "\"\nbatched_push_timeout = 40000\n[inference]\nconfig = \"/models/yolo.txt\"\ninterval = 2\n"
+                      << "[encoder]\ncodec = \"" << encoder << "\"\nbitrate = 4000000\n[sink]\ntype = \"" << sink
+                      << "\"\nhost = \"127.0.0.1\"\nport = 5600\nlocation = \"/tmp/out.mp4\"\n";
+                    std::string what = "source " + std::to_string(si) + " " + converter + " " + encoder + " " + sink;
+
+                    PipelineDescription desc;
+                    std::string error;
+                    bool ok = build(t.str(), desc, error);
+                    bool expected = std::string(encoder) != "none" || std::string(sink) == "display" ||
+                                    std::string(sink) == "fake";
+                    if (ok != expected)
+                        std::fprintf(stderr, "  %s: %s\n", what.c_str(), ok ? "built" : error.c_str());
+                    CHECK(ok == expected);
+                    if (!ok) {
+                        ++rejected;
+                        continue;
+                    }
+                    ++built;
+                    checkInvariants(desc, converter, what);
+
+                    const std::string &l = desc.launch;
+                    CHECK(l.find("batch-size=1 width=3848 height=2168 batched-push-timeout=40000") != std::string::npos);
+                    CHECK(l.find("config-file-path=/models/yolo.txt batch-size=1 interval=2") !=
+                          std::string::npos);
+                    if (std::string(source).find("mjpeg") != std::string::npos) {
+                        CHECK(l.find("v4l2src device=/dev/video2 name=src0 ! image/jpeg, width=3848, height=2168, "
+                                     "framerate=60/1 ! jpegparse ! nvv4l2decoder mjpeg=1 ! ") != std::string::npos);
+                    }
+                    if (std::string(source).find("YUY2") != std::string::npos)
+                        CHECK(l.find("video/x-raw, format=YUY2, width=3848") != std::string::npos);
+                    if (std::string(source).find("uri") != std::string::npos)
+                        CHECK(l.find("uridecodebin uri=\"file:///data/clip 1.mp4\" name=src0") != std::string::npos);
+                    if (std::string(sink) == "udp")
+                        CHECK(l.find("udpsink clients=127.0.0.1:5600 sync=false") != std::string::npos);
+                    if (std::string(sink) == "file")
+                        CHECK(l.find("parse ! qtmux ! filesink location=/tmp/out.mp4") != std::string::npos);
+                    if (std::string(sink) == "display")
+                        CHECK(l.find(std::string(converter) == "nvvidconv" ? "nv3dsink" : "nveglglessink") !=
+                              std::string::npos && l.find("enc") == std::string::npos);
+                    if (std::string(encoder) != "none" && std::string(sink) != "display")
+                        CHECK(l.find(std::string("nvv4l2") + encoder + "enc bitrate=4000000") != std::string::npos);
+                }
+            }
+        }
+    }
+    std::printf("%d permutations built, %d rejected as expected\n", built, rejected);
+}
+
+// A roi crop is cut by the conversion element and sizes the caps and, by default, the mux
+static void checkCrop() {
+    for (const char *converter : {"nvvidconv", "nvvideoconvert"}) {
+        toml::table data = toml::parse(std::string(kBase) + "[conversion]\nconverter = \"" + converter + "\"\n");
+        PipelineConfig pc;
+        PipelineDescription desc;
+        std::string error;
+        CHECK(parsePipelineConfig(data, "video0", 3848, 2168, pc, error));
+        pc.sources[0].crop_x = 1000;
+        pc.sources[0].crop_y = 600;
+        pc.sources[0].crop_width = 1600;
+        pc.sources[0].crop_height = 900;
+        CHECK(buildPipelineDescription(pc, desc, &error));
+        const std::string crop = std::string(converter) == "nvvideoconvert"
+                                     ? "nvvideoconvert src-crop=1000:600:1600:900 ! "
+                                     : "nvvidconv left=1000 top=600 right=2600 bottom=1500 ! ";
+        CHECK(desc.launch.find(crop + "video/x-raw(memory:NVMM), format=NV12, width=1600, height=900 ! mux.sink_0") !=
+              std::string::npos);
+        CHECK(desc.launch.find("nvstreammux name=mux batch-size=1 width=1600 height=900") == 0);
+        CHECK(desc.launch.find("v4l2src device=/dev/video0 name=src0 ! video/x-raw, width=3848, height=2168") !=
+              std::string::npos);
+        checkInvariants(desc, crop.substr(0, crop.size() - 3), std::string("crop ") + converter);
+
+        pc.sources[0].crop_x = 2400;  // 2400 + 1600 > 3848
+        CHECK(!buildPipelineDescription(pc, desc, &error) && error.find("crop") != std::string::npos);
+    }
+    std::printf("crop built for both converters, out-of-frame crop rejected\n");
+}
+
+// Tiles: the source is teed into its own pad and one cropped pad per tile, numbered after the sources
+static void checkTiles() {
+    toml::table data = toml::parse(kBase);
+    PipelineConfig pc;
+    PipelineDescription desc;
+    std::string error;
+    CHECK(parsePipelineConfig(data, "video0", 3848, 2168, pc, error));
+    pc.sources.push_back(pc.sources[0]);
+    pc.sources[1].device = "video1";
+    pc.sources[0].tiles = {{0, 0, 2000, 1126}, {1848, 0, 2000, 1126}, {0, 1042, 2000, 1126}, {1848, 1042, 2000, 1126}};
+    pc.mux_width = 2000;
+    pc.mux_height = 1126;
+    CHECK(muxPadCount(pc) == 6 && tilePad(pc, 0, 0) == 2 && tilePad(pc, 0, 3) == 5 && tilePad(pc, 1, 0) == 6);
+    CHECK(buildPipelineDescription(pc, desc, &error));
+    const std::string &l = desc.launch;
+    CHECK(l.find("nvstreammux name=mux batch-size=6 width=2000 height=1126") == 0);
+    CHECK(l.find("v4l2src device=/dev/video0 name=src0 ! video/x-raw, width=3848, height=2168 ! tee name=t0 ! queue ! "
+                 "nvvidconv ! video/x-raw(memory:NVMM), format=NV12, width=3848, height=2168 ! mux.sink_0") !=
+          std::string::npos);
+    CHECK(l.find("t0. ! queue ! nvvidconv left=1848 top=1042 right=3848 bottom=2168 ! "
+                 "video/x-raw(memory:NVMM), format=NV12, width=2000, height=1126 ! mux.sink_5") != std::string::npos);
+    CHECK(l.find("name=src1 ! video/x-raw, width=3848, height=2168 ! nvvidconv") != std::string::npos);
+    CHECK(count(l, "mux.sink_") == 6 && count(l, "t0. ! queue") == 4 && count(l, "tee name=") == 1);
+    CHECK(std::count(desc.factories.begin(), desc.factories.end(), "tee") == 1);
+    CHECK(count(desc.graph, "\n") == count(l, " ! ") + 6 + 1);
+    CHECK(l.find("nvinfer name=infer config-file-path=/home/flux/DeepStream-Yolo/config_infer_primary_yoloV10.txt "
+                 "batch-size=6 ! ") != std::string::npos);
+
+    // Both cameras tiled: nvinfer batches every frame and tile of every camera
+    pc.sources[1].tiles = pc.sources[0].tiles;
+    pc.infer_engine = "/models/model_b1_gpu0_fp16.engine";
+    CHECK(buildPipelineDescription(pc, desc, &error));
+    size_t batch = pc.sources.size() * (1 + pc.sources[0].tiles.size());
+    CHECK(batch == 10 && muxPadCount(pc) == batch && count(desc.launch, "mux.sink_") == batch);
+    CHECK(desc.launch.find("nvstreammux name=mux batch-size=10 ") == 0);
+    CHECK(desc.launch.find(" batch-size=10 model-engine-file=/models/model_b10_gpu0_fp16.engine ! ") !=
+          std::string::npos);
+
+    pc.sources[0].tiles[3].x = 1850;  // 1850 + 2000 > 3848
+    CHECK(!buildPipelineDescription(pc, desc, &error) && error.find("tile 3") != std::string::npos);
+    std::printf("4 tiles of one and of both of 2 sources built, out-of-frame tile rejected\n");
+}
+
+// nvinfer takes the batch of the mux, with the engine of the inference config renamed for that batch
+static void checkBatch() {
+    CHECK(batchEngineFile("model_b1_gpu0_fp32.engine", 3) == "model_b3_gpu0_fp32.engine");
+    CHECK(batchEngineFile("/m_b2/yolo.onnx_b16_gpu0_int8.engine", 4) == "/m_b2/yolo.onnx_b4_gpu0_int8.engine");
+    CHECK(batchEngineFile("/models/model_b_gpu0.engine", 2).empty() && batchEngineFile("model.engine", 2).empty());
+    CHECK(batchEngineFile("", 2).empty());
+
+    const std::string infer_config = "/tmp/pipeline_builder_check_infer.txt";
+    FILE *f = std::fopen(infer_config.c_str(), "w");
+    CHECK(f != nullptr);
+    if (!f)
+        return;
+    std::fputs("[property]\r\ngpu-id=0\r\n#model-engine-file=old.engine\r\n"
+               "model-engine-file = model_b1_gpu0_fp16.engine\r\nbatch-size=1\r\n"
+               "custom-lib-path=/opt/yolo/libnvdsinfer_custom_impl_Yolo.so\r\n"
+               "[class-attrs-all]\r\nmodel-engine-file=other.engine\r\n",
+               f);
+    std::fclose(f);
+    CHECK(inferConfigEngine(infer_config) == "/tmp/model_b1_gpu0_fp16.engine");
+    CHECK(inferConfigEngine("/tmp/pipeline_builder_check_missing.txt").empty());
+    CHECK(inferConfigPath(infer_config, "custom-lib-path") == "/opt/yolo/libnvdsinfer_custom_impl_Yolo.so");
+    CHECK(inferConfigPath(infer_config, "labelfile-path").empty());
+
+    toml::table data = toml::parse(std::string(kBase) + "[[camera]]\n[[camera]]\ndevice = \"video1\"\n[[camera]]\n"
+                                   "device = \"video2\"\n[inference]\nconfig = \"" + infer_config + "\"\n");
+    std::vector<SourceConfig> cameras(3);
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        cameras[i].device = "video" + std::to_string(i);
+        cameras[i].width = 1920;
+        cameras[i].height = 1080;
+    }
+    PipelineConfig pc;
+    PipelineDescription desc;
+    std::string error;
+    CHECK(parsePipelineConfig(data, cameras, pc, error));
+    CHECK(pc.infer_engine == "/tmp/model_b1_gpu0_fp16.engine");
+    CHECK(buildPipelineDescription(pc, desc, &error));
+    CHECK(desc.launch.find("nvstreammux name=mux batch-size=3 ") == 0);
+    CHECK(desc.launch.find("nvinfer name=infer config-file-path=" + infer_config +
+                           " batch-size=3 model-engine-file=/tmp/model_b3_gpu0_fp16.engine ! ") != std::string::npos);
+
+    // An engine set in config.toml wins, one without a batch in its name is left to the inference config
+    data = toml::parse(std::string(kBase) + "[inference]\nconfig = \"" + infer_config +
+                       "\"\nengine = \"/engines/yolo_b1_.engine\"\n");
+    CHECK(parsePipelineConfig(data, "video0", 3848, 2168, pc, error) && pc.infer_engine == "/engines/yolo_b1_.engine");
+    CHECK(buildPipelineDescription(pc, desc, &error));
+    CHECK(desc.launch.find(" batch-size=1 model-engine-file=/engines/yolo_b1_.engine ! ") != std::string::npos);
+    pc.infer_engine = "/engines/yolo.engine";
+    CHECK(buildPipelineDescription(pc, desc, &error));
+    CHECK(desc.launch.find("model-engine-file") == std::string::npos);
+    std::remove(infer_config.c_str());
+    std::printf("nvinfer batch of 3 cameras with the engine renamed for it\n");
+}
+
+// overlay = "none": no nvdsosd, nvinfer feeds the encoder conversion or the sink
+static void checkHeadless() {
+    toml::table data = toml::parse(kBase);
+    PipelineConfig pc;
+    PipelineDescription desc;
+    std::string error;
+    CHECK(parsePipelineConfig(data, "video0", 3848, 2168, pc, error));
+    pc.osd = false;
+    CHECK(buildPipelineDescription(pc, desc, &error));
+    CHECK(desc.launch.find("nvdsosd") == std::string::npos);
+    CHECK(desc.launch.find("config_infer_primary_yoloV10.txt batch-size=1 ! nvvidconv ! "
+                           "video/x-raw(memory:NVMM), format=NV12 ! nvv4l2h264enc") != std::string::npos);
+    CHECK(std::count(desc.factories.begin(), desc.factories.end(), "nvdsosd") == 0);
+
+    pc.sink = "fake";
+    pc.encoder = "none";
+    CHECK(buildPipelineDescription(pc, desc, &error));
+    CHECK(desc.launch.find("config_infer_primary_yoloV10.txt batch-size=1 ! fakesink sync=false") != std::string::npos);
+    std::printf("headless pipeline built without nvdsosd\n");
+}
+
+static void checkErrors() {
+    const char *bad[] = {
+        "[source]\ntype = \"rtsp\"\n",
+        "[caps]\nformat = \"h264\"\n",
+        "[caps]\nframerate = [30]\n",
+        "[source]\ntype = \"uri\"\n",
+        "[conversion]\nconverter = \"videoconvert\"\n",
+        "[conversion]\nmux_resolution = [1920]\n",
+        "[inference]\nconfig = \"\"\n",
+        "[encoder]\ncodec = \"vp8\"\n",
+        "[sink]\ntype = \"rtsp\"\n",
+        "[sink]\ntype = \"file\"\n",
+        "[sink]\nport = 70000\n",
+    };
+    for (const char *b : bad) {
+        PipelineDescription desc;
+        std::string error;
+        bool ok = build(std::string(kBase) + b, desc, error);
+        if (ok)
+            std::fprintf(stderr, "  accepted: %s\n", b);
+        CHECK(!ok && !error.empty());
+    }
+    PipelineDescription desc;
+    std::string error;
+    CHECK(!build("resolution = [0, 1080]\n", desc, error));
+    std::printf("%zu invalid configs rejected\n", sizeof(bad) / sizeof(bad[0]) + 1);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        try {
+            toml::table data = toml::parse_file(argv[1]);
+            auto res = data["resolution"].as_array();
+            PipelineConfig pc;
+            PipelineDescription desc;
+            std::string error;
+            if (!parsePipelineConfig(data, data["device"].value_or(std::string("video0")),
+                                     res ? static_cast<int>(res->at(0).value_or(1920)) : 1920,
+                                     res ? static_cast<int>(res->at(1).value_or(1080)) : 1080, pc, error) ||
+                !buildPipelineDescription(pc, desc, &error)) {
+                std::fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+                return 1;
+            }
+            std::printf("%s:\n%s\n%s\n", argv[1], desc.graph.c_str(), desc.launch.c_str());
+        } catch (const toml::parse_error &err) {
+            std::fprintf(stderr, "%s: %s\n", argv[1], err.what());
+            return 1;
+        }
+    }
+
+    checkDefault();
+    checkPermutations();
+    checkCrop();
+    checkTiles();
+    checkBatch();
+    checkHeadless();
+    checkErrors();
+
+    return checkResult();
+}
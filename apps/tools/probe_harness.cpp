@@ -0,0 +1,392 @@
+// apps/real_world_overlay/tools/probe_harness.cpp
+// Offline benchmark of the osd probe's per-batch work (frame_processor.hpp) on stand-in meta structs, no GStreamer or
+// DeepStream needed: world transform, detection records exported to a shared memory ring, and the X/Y labels in
+// recycled buffers returned after every batch as on the osd src pad. Frames are synthetic (tracked objects
+// random-walking over every camera) or replayed from a detection log directory (untracked objects). Reports us per
+// batch and per frame, the share of each step, and heap allocations per frame (operator new plus label buffers) after
+// a warm-up.
+//   probe_harness [--objects N] [--batches N] [--config config.toml] [--replay DIR] [--overlay full|boxes]
+//                 [--label-every N] [--top-k K] [--malloc-labels] [--no-export]
+// Defaults: 100 objects per frame, 2000 batches, the 3 cameras below, full overlay, labels formatted every frame.
+// World meta (nvds user meta) and the zone engine are not part of it: see zone_engine_bench for the latter.
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "detection_log.hpp"
+#include "frame_processor.hpp"
+#include "tools/alloc_counter.hpp"
+
+// Stand-ins with the field names the templates use (NvDsMetaList, NvDsBatchMeta, NvDsFrameMeta, NvDsObjectMeta)
+struct MockList {
+    void *data;
+    MockList *next;
+};
+struct MockRect {
+    float left, top, width, height;
+};
+struct MockText {
+    char *display_text;
+};
+struct MockObject {
+    MockRect rect_params;
+    int class_id;
+    float confidence;
+    uint64_t object_id;
+    MockText text_params;
+};
+struct MockFrame {
+    uint32_t source_id;
+    int frame_num;
+    uint64_t buf_pts;
+    uint32_t num_obj_meta;
+    MockList *obj_meta_list;
+};
+struct MockBatch {
+    MockList *frame_meta_list;
+};
+
+// One object of a frame to build
+struct ObjectSpec {
+    MockRect box;
+    int class_id;
+    float confidence;
+    uint64_t object_id;
+};
+
+struct FrameSpec {
+    uint32_t source_id;
+    uint64_t frame_number, pts;
+    std::vector<ObjectSpec> objects;
+};
+
+// Owns the nodes of one batch, rebuilt outside the measured region
+struct MockBatchBuilder {
+    std::deque<MockList> nodes;
+    std::deque<MockFrame> frames;
+    std::deque<MockObject> objects;
+    MockBatch batch = {nullptr};
+
+    void build(const std::vector<FrameSpec> &specs) {
+        nodes.clear();
+        frames.clear();
+        objects.clear();
+        batch.frame_meta_list = nullptr;
+        MockList **frame_tail = &batch.frame_meta_list;
+        for (const FrameSpec &f : specs) {
+            frames.push_back(MockFrame{f.source_id, static_cast<int>(f.frame_number), f.pts,
+                                       static_cast<uint32_t>(f.objects.size()), nullptr});
+            nodes.push_back(MockList{&frames.back(), nullptr});
+            *frame_tail = &nodes.back();
+            frame_tail = &nodes.back().next;
+            MockList **obj_tail = &frames.back().obj_meta_list;
+            for (const ObjectSpec &o : f.objects) {
+                objects.push_back(MockObject{o.box, o.class_id, o.confidence, o.object_id, {nullptr}});
+                nodes.push_back(MockList{&objects.back(), nullptr});
+                *obj_tail = &nodes.back();
+                obj_tail = &nodes.back().next;
+            }
+        }
+    }
+};
+
+static const char *kCameras =
+    "resolution = [1920, 1080]\n"
+    "rotation = [30.0, 180.0, -90.0]\n"
+    "fov = [2.0, 1.125]\n"
+    "[[camera]]\n"
+    "position = [0.0, 0.0, 4.5]\n"
+    "[[camera]]\n"
+    "position = [10.0, 0.0, 4.5]\n"
+    "distortion = [-0.1, 0.01, 0.0, 0.0, 0.0]\n"
+    "[[camera]]\n"
+    "position = [20.0, 0.0, 6.0]\n"
+    "rotation = [45.0, 180.0, -90.0]\n";
+
+// Tracked objects walking over the frame of each camera
+class SyntheticFrames {
+public:
+    SyntheticFrames(size_t cameras, int objects, int width, int height)
+        : cameras_(cameras), width_(width), height_(height), rng_(7) {
+        std::uniform_real_distribution<float> x(0.0f, static_cast<float>(width)), y(0.0f, static_cast<float>(height));
+        std::uniform_real_distribution<float> conf(0.25f, 1.0f);
+        for (size_t c = 0; c < cameras; ++c) {
+            for (int i = 0; i < objects; ++i) {
+                uint64_t id = (static_cast<uint64_t>(c) << 48) + static_cast<uint64_t>(i) + 1;
+                objects_.push_back(ObjectSpec{{x(rng_), y(rng_), 40.0f, 90.0f}, static_cast<int>(rng_() % 10),
+                                              conf(rng_), id});
+            }
+        }
+    }
+
+    bool next(std::vector<FrameSpec> &batch) {
+        std::normal_distribution<float> step(0.0f, 2.0f);
+        batch.resize(cameras_);
+        size_t per_camera = objects_.size() / cameras_;
+        for (size_t c = 0; c < cameras_; ++c) {
+            FrameSpec &f = batch[c];
+            f.source_id = static_cast<uint32_t>(c);
+            f.frame_number = frame_;
+            f.pts = frame_ * 33333333ULL;
+            f.objects.assign(objects_.begin() + c * per_camera, objects_.begin() + (c + 1) * per_camera);
+        }
+        for (ObjectSpec &o : objects_) {
+            o.box.left = std::min(std::max(o.box.left + step(rng_), 0.0f), static_cast<float>(width_) - 40.0f);
+            o.box.top = std::min(std::max(o.box.top + step(rng_), 0.0f), static_cast<float>(height_) - 90.0f);
+        }
+        ++frame_;
+        return true;
+    }
+
+private:
+    size_t cameras_;
+    int width_, height_;
+    std::mt19937 rng_;
+    std::vector<ObjectSpec> objects_;
+    uint64_t frame_ = 0;
+};
+
+// Frames of a detection log in publish order, one batch per round over the sources. Boxes go back to nvstreammux
+// pixels with the camera of their source.
+class ReplayFrames {
+public:
+    bool open(const std::string &dir, std::string &error) {
+        if (!reader_.open(dir, error))
+            return false;
+        if (reader_.segments().empty()) {
+            error = "no records in " + dir;
+            return false;
+        }
+        return true;
+    }
+
+    bool next(std::vector<FrameSpec> &batch, const CameraSet &cameras) {
+        batch.clear();
+        std::vector<uint32_t> sources;
+        while (const DetectionRecord *r = peek()) {
+            if (std::find(sources.begin(), sources.end(), r->source_id) != sources.end() && !batch.empty() &&
+                (batch.back().source_id != r->source_id || batch.back().frame_number != r->frame_number))
+                break;  // the source's next frame starts the next batch
+            if (batch.empty() || batch.back().source_id != r->source_id ||
+                batch.back().frame_number != r->frame_number) {
+                batch.push_back(FrameSpec{r->source_id, r->frame_number, r->timestamp_ns, {}});
+                sources.push_back(r->source_id);
+            }
+            if (r->class_id >= 0 && r->count > 0) {
+                ObjectSpec o = {{r->left, r->top, r->width, r->height}, r->class_id, r->confidence, UINT64_MAX};
+                if (const CameraView *cam = cameras.forSource(r->source_id))
+                    cam->boxToMux(o.box.left, o.box.top, o.box.width, o.box.height);
+                batch.back().objects.push_back(o);
+            }
+            advance();
+        }
+        return !batch.empty();
+    }
+
+private:
+    const DetectionRecord *peek() const {
+        const auto &segs = reader_.segments();
+        if (segment_ >= segs.size())
+            return nullptr;
+        return &segs[segment_].records()[record_];
+    }
+
+    void advance() {
+        if (++record_ >= reader_.segments()[segment_].size()) {
+            record_ = 0;
+            ++segment_;
+        }
+    }
+
+    DetectionLogReader reader_;
+    size_t segment_ = 0, record_ = 0;
+};
+
+static int usage(const char *argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [--objects N] [--batches N] [--config config.toml] [--replay DIR] [--overlay full|boxes]\n"
+                 "       [--label-every N] [--top-k K] [--malloc-labels] [--no-export]\n",
+                 argv0);
+    return 2;
+}
+
+static double nowUs() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char *argv[]) {
+    int objects = 100, batches = 2000;
+    std::string config, replay;
+    OverlayConfig overlay;
+    bool malloc_labels = false, export_records = true;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool value = i + 1 < argc;
+        if (arg == "--objects" && value)
+            objects = std::atoi(argv[++i]);
+        else if (arg == "--batches" && value)
+            batches = std::atoi(argv[++i]);
+        else if (arg == "--config" && value)
+            config = argv[++i];
+        else if (arg == "--replay" && value)
+            replay = argv[++i];
+        else if (arg == "--overlay" && value) {
+            if (!parseOverlayMode(argv[++i], overlay.mode) || overlay.mode == OverlayMode::None)
+                return usage(argv[0]);
+        } else if (arg == "--label-every" && value)
+            overlay.label_every = std::atoi(argv[++i]);
+        else if (arg == "--top-k" && value)
+            overlay.label_top_k = std::atoi(argv[++i]);
+        else if (arg == "--malloc-labels")
+            malloc_labels = true;
+        else if (arg == "--no-export")
+            export_records = false;
+        else
+            return usage(argv[0]);
+    }
+    if (objects < 0 || batches < 1 || overlay.label_every < 1 || overlay.label_top_k < 0)
+        return usage(argv[0]);
+
+    std::vector<CameraGeometry> geometry;
+    std::string error;
+    try {
+        toml::table data = config.empty() ? toml::parse(kCameras) : toml::parse_file(config);
+        if (!parseCameras(data, geometry, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    } catch (const toml::parse_error &err) {
+        std::fprintf(stderr, "%s\n", err.what());
+        return 1;
+    }
+    int mux_width = geometry[0].width, mux_height = geometry[0].height;
+    CameraSet cameras;
+    size_t pinhole = cameras.build(geometry, mux_width, mux_height);
+
+    SyntheticFrames synthetic(cameras.size(), objects, mux_width, mux_height);
+    ReplayFrames replayed;
+    if (!replay.empty() && !replayed.open(replay, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    ShmRingWriter ring;
+    std::string ring_name = "/probe_harness_" + std::to_string(getpid());
+    if (export_records && !ring.open(ring_name, 65536)) {
+        std::fprintf(stderr, "Failed to create shared memory ring %s\n", ring_name.c_str());
+        return 1;
+    }
+
+    // Label buffers: a LabelPool free list, or one malloc per label freed with the batch (label_mode = "malloc")
+    FrameProcessor<MockFrame, MockObject> proc;
+    proc.configure(true, overlay, !malloc_labels);
+    std::vector<char *> free_labels, in_flight;
+    size_t label_allocations = 0;
+    auto acquire = [&]() {
+        if (malloc_labels || free_labels.empty()) {
+            ++label_allocations;
+            return static_cast<char *>(std::malloc(LabelCache::kLabelSize));
+        }
+        char *label = free_labels.back();
+        free_labels.pop_back();
+        return label;
+    };
+    auto set_text = [&](MockObject *obj, char *label) {
+        obj->text_params.display_text = label;
+        if (label)
+            in_flight.push_back(label);
+    };
+    in_flight.reserve(4096);
+    free_labels.reserve(4096);
+
+    const int warmup = std::min(100, batches / 10);
+    std::vector<FrameSpec> specs;
+    MockBatchBuilder builder;
+    std::vector<double> batch_us;
+    double transform_us = 0.0, export_us = 0.0, label_us = 0.0;
+    size_t frames = 0, objs = 0, valid = 0, records = 0, drawn = 0, heap = 0, label_heap = 0;
+    int run = 0;
+    for (; run < warmup + batches; ++run) {
+        bool more = replay.empty() ? synthetic.next(specs) : replayed.next(specs, cameras);
+        if (!more)
+            break;
+        builder.build(specs);
+        bool measured = run >= warmup;
+        size_t heap_before = heapAllocations(), labels_before = label_allocations;
+
+        double t0 = nowUs();
+        if (overlay.mode == OverlayMode::Boxes) {
+            for (MockObject &o : builder.objects)
+                o.text_params.display_text = nullptr;
+        }
+        size_t n = proc.transform(&builder.batch, cameras, [](MockFrame *) {});
+        double t1 = nowUs();
+        size_t exported = 0;
+        if (export_records) {
+            proc.exportDetections(&builder.batch, cameras, cameras.size(), shmRingNowNs(),
+                                  [&](const DetectionRecord &rec) {
+                                      ring.publish(rec);
+                                      ++exported;
+                                  });
+        }
+        double t2 = nowUs();
+        size_t labeled = proc.label(acquire, set_text).drawn;
+        // The osd src pad: pooled labels back to the free list, malloc labels freed with the meta
+        for (char *label : in_flight) {
+            if (malloc_labels)
+                std::free(label);
+            else
+                free_labels.push_back(label);
+        }
+        in_flight.clear();
+        double t3 = nowUs();
+
+        if (!measured)
+            continue;
+        heap += heapAllocations() - heap_before;
+        label_heap += label_allocations - labels_before;
+        transform_us += t1 - t0;
+        export_us += t2 - t1;
+        label_us += t3 - t2;
+        batch_us.push_back(t3 - t0);
+        frames += specs.size();
+        objs += n;
+        for (size_t i = 0; i < n; ++i)
+            valid += proc.batch().valid[i];
+        records += exported;
+        drawn += labeled;
+    }
+    for (char *label : free_labels)
+        std::free(label);
+    if (batch_us.empty()) {
+        std::fprintf(stderr, "no batches after the %d warm-up batches\n", warmup);
+        return 1;
+    }
+
+    double total_us = transform_us + export_us + label_us;
+    std::sort(batch_us.begin(), batch_us.end());
+    double nb = static_cast<double>(batch_us.size()), nf = static_cast<double>(frames);
+    std::printf("%zu cameras (%zu pinhole), %s, %zu batches of %.1f frames, %.1f objects per frame\n", cameras.size(),
+                pinhole, replay.empty() ? "synthetic frames" : ("replay of " + replay).c_str(), batch_us.size(),
+                nf / nb, objs / nf);
+    std::printf("overlay %s, label_every %d, label_top_k %d, %s labels, export %s\n", overlayModeName(overlay.mode),
+                overlay.label_every, overlay.label_top_k, malloc_labels ? "malloc" : "pooled",
+                export_records ? "to a shared memory ring" : "off");
+    std::printf("per frame   %8.2f us  (transform %.2f, export %.2f, labels %.2f)\n", total_us / nf,
+                transform_us / nf, export_us / nf, label_us / nf);
+    std::printf("per batch   %8.2f us  p50 %.2f  p99 %.2f  max %.2f\n", total_us / nb, batch_us[batch_us.size() / 2],
+                batch_us[std::min(batch_us.size() - 1, static_cast<size_t>(nb * 0.99))], batch_us.back());
+    std::printf("per frame   %8.1f objects on the ground, %.1f records, %.1f labels\n", valid / nf, records / nf,
+                drawn / nf);
+    std::printf("allocations %8.3f per frame  (%.3f operator new, %.3f label buffers)\n", (heap + label_heap) / nf,
+                heap / nf, label_heap / nf);
+    return 0;
+}
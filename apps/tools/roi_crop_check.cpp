@@ -0,0 +1,274 @@
+// apps/real_world_overlay/tools/roi_crop_check.cpp
+// Checks of the roi crop, no GStreamer or DeepStream needed: normalizedToPixel / worldToPixel against undistortPoint
+// and pixelToGround, the roi bounds of ground polygons seen by straight-down, tilted and distorted pinhole cameras and
+// by the linear fov model (including polygons partly and fully behind the camera), the crop fit (margin, aspect, even
+// alignment, full frame = no crop), and CameraView mapping cropped nvstreammux boxes back to full-frame pixels and the
+// world. Exits non-zero on failure.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "roi_crop.hpp"
+#include "tools/check.hpp"
+
+static CameraGeometry straightDown() {
+    CameraGeometry g;
+    g.device = "video0";
+    g.width = 1920;
+    g.height = 1080;
+    g.pos_z = 3.0f;
+    g.rot_y = 180.0f;
+    g.rot_z = -90.0f;
+    g.fov_x = 2.0f;
+    g.fov_y = 1.125f;
+    return g;
+}
+
+static CameraGeometry tilted() {
+    CameraGeometry g = straightDown();
+    g.device = "video1";
+    g.width = 1280;
+    g.height = 720;
+    g.pos_x = 10.0f;
+    g.pos_z = 4.5f;
+    g.rot_x = 30.0f;
+    g.distortion[0] = -0.1f;
+    g.distortion[1] = 0.01f;
+    return g;
+}
+
+static CameraGeometry linear() {
+    CameraGeometry g = straightDown();
+    g.device = "video2";
+    g.width = 640;
+    g.height = 480;
+    g.pos_x = -5.0f;
+    g.pos_y = 2.0f;
+    g.pos_z = 0.0f;
+    g.fov_x = 4.0f;
+    g.fov_y = 3.0f;
+    return g;
+}
+
+// Ground points seen at the corners of the pixel rectangle, as a roi
+static std::vector<std::pair<float, float>> roiOfPixels(const CameraGeometry &g, double u0, double v0, double u1,
+                                                        double v1) {
+    std::vector<std::pair<float, float>> roi;
+    const double corners[4][2] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+    for (const auto &c : corners) {
+        double wx, wy;
+        if (g.pos_z > 0.0f) {
+            if (!pixelToGround(makeCameraModel(g), c[0], c[1], 0.0, wx, wy))
+                return {};
+        } else {
+            LinearWorldParams p = makeLinearWorldParams(g.width, g.height, g.fov_x, g.fov_y, g.pos_x, g.pos_y);
+            wx = c[0] * p.sx + p.ox;
+            wy = c[1] * p.sy + p.oy;
+        }
+        roi.emplace_back(static_cast<float>(wx), static_cast<float>(wy));
+    }
+    return roi;
+}
+
+static void checkInverse() {
+    const CameraGeometry geometries[] = {straightDown(), tilted()};
+    double worst = 0.0;
+    int misses = 0;
+    for (const CameraGeometry &g : geometries) {
+        CameraModel cam = makeCameraModel(g);
+        for (int j = 0; j <= 8; ++j) {
+            for (int i = 0; i <= 8; ++i) {
+                double u = g.width * (0.05 + 0.9 * i / 8.0), v = g.height * (0.05 + 0.9 * j / 8.0);
+                double x, y, u2, v2, wx, wy, u3, v3;
+                undistortPoint(cam, u, v, x, y);
+                normalizedToPixel(cam, x, y, u2, v2);
+                worst = std::max(worst, std::max(std::fabs(u2 - u), std::fabs(v2 - v)));
+                if (!pixelToGround(cam, u, v, 0.0, wx, wy) || !worldToPixel(cam, wx, wy, 0.0, u3, v3)) {
+                    ++misses;
+                    continue;
+                }
+                worst = std::max(worst, std::max(std::fabs(u3 - u), std::fabs(v3 - v)));
+            }
+        }
+    }
+    CHECK(worst < 0.01 && misses == 0);
+    std::printf("pixel -> ground -> pixel: worst %.5f px, %d misses\n", worst, misses);
+}
+
+// The bounds of a roi seen at a pixel rectangle hold that rectangle and little else
+static void checkBounds() {
+    struct Case {
+        CameraGeometry g;
+        double u0, v0, u1, v1;
+    };
+    const Case cases[] = {
+        {straightDown(), 600, 300, 1100, 700},
+        {tilted(), 200, 300, 700, 600},
+        {tilted(), 40, 30, 1240, 690},
+        {linear(), 100, 50, 300, 400},
+    };
+    for (const Case &c : cases) {
+        std::vector<std::pair<float, float>> roi = roiOfPixels(c.g, c.u0, c.v0, c.u1, c.v1);
+        PixelBounds b;
+        CHECK(roi.size() == 4 && roiPixelBounds(c.g, roi, b));
+        // Straight world edges bow under distortion, allow a few pixels of that around the corners
+        const double slack = c.g.distortion[0] != 0.0f ? 40.0 : 0.5;
+        bool holds = b.u0 <= c.u0 + 0.5 && b.v0 <= c.v0 + 0.5 && b.u1 >= c.u1 - 0.5 && b.v1 >= c.v1 - 0.5;
+        bool tight = b.u0 >= c.u0 - slack && b.v0 >= c.v0 - slack && b.u1 <= c.u1 + slack && b.v1 <= c.v1 + slack;
+        if (!holds || !tight)
+            std::fprintf(stderr, "  %s: pixels %.0f,%.0f %.0f,%.0f bounds %.1f,%.1f %.1f,%.1f\n", c.g.device.c_str(),
+                         c.u0, c.v0, c.u1, c.v1, b.u0, b.v0, b.u1, b.v1);
+        CHECK(holds && tight);
+    }
+
+    // Partly behind the tilted camera: clipped at the camera plane, bounded by the image
+    CameraGeometry g = tilted();
+    CameraModel cam = makeCameraModel(g);
+    double ax = 0.0, ay = 0.0;
+    bool hit = pixelToGround(cam, g.width / 2.0, g.height / 2.0, 0.0, ax, ay);
+    CHECK(hit);
+    if (!hit)
+        return;
+    double dx = ax - g.pos_x, dy = ay - g.pos_y;  // horizontal viewing direction
+    std::vector<std::pair<float, float>> roi = {
+        {float(g.pos_x - 3 * dx - dy), float(g.pos_y - 3 * dy + dx)},
+        {float(g.pos_x - 3 * dx + dy), float(g.pos_y - 3 * dy - dx)},
+        {float(ax + dy), float(ay - dx)},
+        {float(ax - dy), float(ay + dx)},
+    };
+    PixelBounds b;
+    CHECK(roiPixelBounds(g, roi, b));
+    CHECK(b.u0 >= 0.0 && b.v0 >= 0.0 && b.u1 <= g.width && b.v1 <= g.height && !b.empty());
+    std::string error;
+    g.roi = roi;
+    CHECK(computeRoiCrop(g, 0.0, error));
+
+    // Entirely behind it: not visible
+    g.roi = {{float(g.pos_x - 3 * dx - dy), float(g.pos_y - 3 * dy + dx)},
+             {float(g.pos_x - 3 * dx + dy), float(g.pos_y - 3 * dy - dx)},
+             {float(g.pos_x - 2 * dx), float(g.pos_y - 2 * dy)}};
+    CHECK(!roiPixelBounds(g, g.roi, b));
+    CHECK(!computeRoiCrop(g, 0.0, error) && error.find("video1") != std::string::npos);
+
+    // Off the image of the linear model
+    g = linear();
+    g.roi = {{100.0f, 100.0f}, {101.0f, 100.0f}, {101.0f, 101.0f}};
+    CHECK(!computeRoiCrop(g, 0.0, error));
+    std::printf("roi bounds of %zu pixel rectangles, clipped and invisible rois\n", sizeof(cases) / sizeof(cases[0]));
+}
+
+static void checkFit() {
+    CameraGeometry g = straightDown();
+    PixelBounds b;
+    b.u0 = 601.3;
+    b.v0 = 301.7;
+    b.u1 = 1100.2;
+    b.v1 = 700.9;
+
+    // Margin and even alignment
+    fitCrop(g, b, 32, 0.0);
+    CHECK(g.crop_x % 2 == 0 && g.crop_y % 2 == 0 && g.crop_width % 2 == 0 && g.crop_height % 2 == 0);
+    CHECK(g.crop_x <= 601.3 - 32 && g.crop_y <= 301.7 - 32);
+    CHECK(g.crop_x + g.crop_width >= 1100.2 + 32 && g.crop_y + g.crop_height >= 700.9 + 32);
+    CHECK(g.crop_x >= 601.3 - 34 && g.crop_x + g.crop_width <= 1100.2 + 34);
+
+    // Widened to 16:9 around the same centre
+    fitCrop(g, b, 32, 16.0 / 9.0);
+    double aspect = static_cast<double>(g.crop_width) / g.crop_height;
+    CHECK(std::fabs(aspect - 16.0 / 9.0) < 0.01);
+    CHECK(g.crop_x <= 601.3 - 32 && g.crop_x + g.crop_width >= 1100.2 + 32);
+    CHECK(g.crop_y <= 301.7 - 32 && g.crop_y + g.crop_height >= 700.9 + 32);
+    std::printf("16:9 crop of %.0fx%.0f bounds: %dx%d at %d,%d\n", b.u1 - b.u0, b.v1 - b.v0, g.crop_width,
+                g.crop_height, g.crop_x, g.crop_y);
+
+    // Near a corner the widened crop slides back inside the image
+    b.u0 = 10.0;
+    b.v0 = 900.0;
+    b.u1 = 110.0;
+    b.v1 = 1075.0;
+    fitCrop(g, b, 32, 16.0 / 9.0);
+    CHECK(g.crop_x == 0 && g.crop_y + g.crop_height <= 1080 && g.crop_y <= 900 - 32);
+    CHECK(std::fabs(static_cast<double>(g.crop_width) / g.crop_height - 16.0 / 9.0) < 0.01);
+
+    // Taller than the image allows at that aspect: full height, the aspect as close as the image allows
+    b.u0 = 900.0;
+    b.v0 = 0.0;
+    b.u1 = 1000.0;
+    b.v1 = 1080.0;
+    fitCrop(g, b, 0, 1.0);
+    CHECK(g.crop_height == 1080 && g.crop_width == 1080 && g.crop_x >= 0 && g.crop_x + g.crop_width <= 1920);
+
+    // Everything: no crop
+    b.u0 = 5.0;
+    b.v0 = 5.0;
+    b.u1 = 1915.0;
+    b.v1 = 1075.0;
+    fitCrop(g, b, 32, 0.0);
+    CHECK(g.crop_width == 0 && g.crop_height == 0 && g.crop_x == 0 && g.crop_y == 0);
+}
+
+// World point -> full-frame pixel -> pixel in the cropped nvstreammux frame -> CameraView -> the same world point
+static void checkView() {
+    CameraGeometry geometries[] = {straightDown(), tilted(), linear()};
+    const int mux_w = 1280, mux_h = 720;
+    for (CameraGeometry &g : geometries) {
+        g.roi = roiOfPixels(g, g.width * 0.3, g.height * 0.4, g.width * 0.6, g.height * 0.8);
+        std::string error;
+        CHECK(computeRoiCrop(g, static_cast<double>(mux_w) / mux_h, error));
+        CHECK(g.crop_width > 0 && g.crop_width < g.width && g.crop_height < g.height);
+        CameraView view;
+        CHECK(view.build(g, mux_w, mux_h) == (g.pos_z > 0.0f));
+
+        // The crop is at the mux aspect, so the scale is the same both ways
+        CHECK(std::fabs(view.to_camera_x - view.to_camera_y) < 0.01f * view.to_camera_x);
+        // Inference sees the roi at more pixels than the whole frame would give it
+        CHECK(view.to_camera_x < static_cast<float>(g.width) / mux_w);
+
+        double worst = 0.0;
+        int n = 0;
+        for (const auto &w : g.roi) {
+            double u = 0.0, v = 0.0;
+            if (g.pos_z > 0.0f) {
+                bool projected = worldToPixel(view.model, w.first, w.second, 0.0, u, v);
+                CHECK(projected);
+                if (!projected)
+                    continue;
+            } else {
+                u = (w.first - view.linear.ox) / view.linear.sx;
+                v = (w.second - view.linear.oy) / view.linear.sy;
+            }
+            float px = static_cast<float>((u - view.crop_x) / view.to_camera_x);
+            float py = static_cast<float>((v - view.crop_y) / view.to_camera_y);
+            CHECK(px >= 0.0f && py >= 0.0f && px <= mux_w && py <= mux_h);
+
+            float left = px - 10.0f, top = py - 20.0f, width = 20.0f, height = 20.0f;
+            view.boxToCamera(left, top, width, height);
+            CHECK(std::fabs(left + width / 2.0f - u) < 0.05 && std::fabs(top + height - v) < 0.05);
+            view.boxToMux(left, top, width, height);
+            CHECK(std::fabs(left - (px - 10.0f)) < 0.01f && std::fabs(top - (py - 20.0f)) < 0.01f &&
+                  std::fabs(width - 20.0f) < 0.01f && std::fabs(height - 20.0f) < 0.01f);
+
+            float wx, wy;
+            uint8_t valid;
+            view.transform(&px, &py, &wx, &wy, &valid, 1);
+            CHECK(valid && std::fabs(px - u) < 0.05 && std::fabs(py - v) < 0.05);
+            worst = std::max(worst, static_cast<double>(std::max(std::fabs(wx - w.first), std::fabs(wy - w.second))));
+            ++n;
+        }
+        CHECK(worst < 0.01);
+        std::printf("%s %dx%d: crop %dx%d at %d,%d, %.2fx the pixels on the roi, %d corners back within %.4f m\n",
+                    g.device.c_str(), g.width, g.height, g.crop_width, g.crop_height, g.crop_x, g.crop_y,
+                    static_cast<double>(g.width) / mux_w / view.to_camera_x, n, worst);
+    }
+}
+
+int main() {
+    checkInverse();
+    checkBounds();
+    checkFit();
+    checkView();
+
+    return checkResult();
+}
@@ -0,0 +1,111 @@
+// apps/real_world_overlay/tools/shm_ring_bench.cpp
+// Publish-to-read latency of the shared memory detection ring across processes.
+//   shm_ring_bench [fps] [detections per frame] [seconds] [readers]     defaults: 30 200 3 2
+// The writer publishes one frame of detections every 1/fps seconds, reader processes busy-poll and measure
+// CLOCK_MONOTONIC now - publish_ns for every record. On machines with fewer cores than processes the numbers include
+// scheduler wake-up time.
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shm_ring.hpp"
+
+static int readerProcess(const std::string &name, uint64_t total, int id) {
+    ShmRingReader reader;
+    while (!reader.open(name, false))
+        sched_yield();
+
+    std::vector<uint32_t> latency_ns;
+    latency_ns.reserve(total);
+    uint64_t seen = 0, lost_total = 0;
+    DetectionRecord rec;
+
+    while (seen < total) {
+        uint64_t lost = 0;
+        ShmRingReader::Result r = reader.next(rec, &lost);
+        if (r == ShmRingReader::kRecord) {
+            uint64_t now = shmRingNowNs();
+            latency_ns.push_back(static_cast<uint32_t>(std::min<uint64_t>(now - rec.publish_ns, UINT32_MAX)));
+            ++seen;
+        } else if (r == ShmRingReader::kOverrun) {
+            lost_total += lost;
+            seen += lost;
+        }
+    }
+
+    std::sort(latency_ns.begin(), latency_ns.end());
+    auto pct = [&](double p) {
+        return latency_ns.empty() ? 0.0 : latency_ns[std::min(latency_ns.size() - 1, size_t(p * latency_ns.size()))] / 1000.0;
+    };
+    std::printf("reader %d: %zu records, %llu lost, latency us p50 %.2f p99 %.2f p99.9 %.2f max %.2f\n", id,
+                latency_ns.size(), static_cast<unsigned long long>(lost_total), pct(0.5), pct(0.99), pct(0.999),
+                latency_ns.empty() ? 0.0 : latency_ns.back() / 1000.0);
+    std::fflush(stdout);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    double fps = argc > 1 ? std::atof(argv[1]) : 30.0;
+    int detections = argc > 2 ? std::atoi(argv[2]) : 200;
+    double seconds = argc > 3 ? std::atof(argv[3]) : 3.0;
+    int readers = argc > 4 ? std::atoi(argv[4]) : 2;
+    if (fps <= 0.0 || detections < 1 || seconds <= 0.0 || readers < 1) {
+        std::fprintf(stderr, "usage: %s [fps] [detections per frame] [seconds] [readers]\n", argv[0]);
+        return 1;
+    }
+
+    uint64_t frames = static_cast<uint64_t>(fps * seconds);
+    uint64_t total = frames * detections;
+    std::string name = "/shm_ring_bench_" + std::to_string(getpid());
+
+    ShmRingWriter writer;
+    if (!writer.open(name, 4096)) {
+        std::perror("shm_open");
+        return 1;
+    }
+
+    std::printf("%.0f fps x %d detections for %.1f s, %d readers, %u cores\n", fps, detections, seconds, readers,
+                std::thread::hardware_concurrency());
+    std::fflush(stdout);
+
+    std::vector<pid_t> pids;
+    for (int i = 0; i < readers; ++i) {
+        pid_t pid = fork();
+        if (pid == 0)
+            _exit(readerProcess(name, total, i));
+        pids.push_back(pid);
+    }
+    usleep(100000);  // readers attached
+
+    uint64_t period_ns = static_cast<uint64_t>(1e9 / fps);
+    uint64_t next = shmRingNowNs();
+    double publish_ns = 0.0;
+    for (uint64_t f = 0; f < frames; ++f) {
+        while (shmRingNowNs() < next)
+            usleep(100);
+        next += period_ns;
+
+        uint64_t start = shmRingNowNs();
+        DetectionRecord rec = {};
+        rec.frame_number = f;
+        rec.count = static_cast<uint16_t>(detections);
+        for (int d = 0; d < detections; ++d) {
+            rec.index = static_cast<uint16_t>(d);
+            rec.publish_ns = shmRingNowNs();
+            writer.publish(rec);
+        }
+        publish_ns += static_cast<double>(shmRingNowNs() - start);
+    }
+
+    for (pid_t pid : pids)
+        waitpid(pid, nullptr, 0);
+    std::printf("writer: %.1f ns per record published\n", publish_ns / total);
+    return 0;
+}
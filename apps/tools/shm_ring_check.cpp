@@ -0,0 +1,172 @@
+// apps/real_world_overlay/tools/shm_ring_check.cpp
+// Producer / consumer checks of the shared memory detection ring: in-order delivery, overrun accounting, writer
+// restarts, and torn-read detection with reader processes racing the writer. Exits non-zero on failure.
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "shm_ring.hpp"
+#include "tools/check.hpp"
+
+// Every field is derived from the sequence so a torn record is detectable
+static DetectionRecord makeRecord(uint64_t seq) {
+    DetectionRecord rec = {};
+    rec.timestamp_ns = seq * 33333333ULL;
+    rec.publish_ns = shmRingNowNs();
+    rec.frame_number = seq;
+    rec.source_id = static_cast<uint32_t>(seq % 7);
+    rec.index = static_cast<uint16_t>(seq % 100);
+    rec.count = 100;
+    rec.class_id = static_cast<int32_t>(seq % 80);
+    rec.confidence = static_cast<float>(seq % 1000) / 1000.0f;
+    rec.world_x = static_cast<float>(seq % 4096) * 0.5f;
+    rec.world_y = -static_cast<float>(seq % 4096) * 0.25f;
+    rec.left = static_cast<float>(seq % 3840);
+    rec.top = static_cast<float>(seq % 2160);
+    rec.width = rec.left + 1.0f;
+    rec.height = rec.top + 1.0f;
+    return rec;
+}
+
+static bool consistent(const DetectionRecord &rec) {
+    DetectionRecord ref = makeRecord(rec.frame_number);
+    return rec.timestamp_ns == ref.timestamp_ns && rec.source_id == ref.source_id && rec.index == ref.index &&
+           rec.count == ref.count && rec.class_id == ref.class_id && rec.confidence == ref.confidence &&
+           rec.world_x == ref.world_x && rec.world_y == ref.world_y && rec.left == ref.left && rec.top == ref.top &&
+           rec.width == ref.width && rec.height == ref.height;
+}
+
+static void checkInOrder(const std::string &name) {
+    ShmRingWriter writer;
+    CHECK(writer.open(name, 60));  // rounded up to 64
+    ShmRingReader reader;
+    CHECK(reader.open(name, false));
+
+    DetectionRecord rec;
+    CHECK(reader.next(rec) == ShmRingReader::kEmpty);
+    for (uint64_t i = 0; i < 10; ++i)
+        writer.publish(makeRecord(i));
+    for (uint64_t i = 0; i < 10; ++i) {
+        CHECK(reader.next(rec) == ShmRingReader::kRecord);
+        CHECK(rec.frame_number == i && consistent(rec));
+    }
+    CHECK(reader.next(rec) == ShmRingReader::kEmpty);
+
+    // Lapped reader: told how many records it lost, then continues in order
+    for (uint64_t i = 10; i < 210; ++i)
+        writer.publish(makeRecord(i));
+    uint64_t lost = 0, received = 0, expected = 0;
+    ShmRingReader::Result r;
+    CHECK(reader.next(rec, &lost) == ShmRingReader::kOverrun);
+    expected = 10 + lost;
+    while ((r = reader.next(rec)) == ShmRingReader::kRecord) {
+        CHECK(rec.frame_number == expected++ && consistent(rec));
+        ++received;
+    }
+    CHECK(r == ShmRingReader::kEmpty);
+    CHECK(lost + received == 200 && received == 63);
+
+    // A late reader starting from the latest record sees only new ones
+    ShmRingReader late;
+    CHECK(late.open(name, true));
+    CHECK(late.next(rec) == ShmRingReader::kEmpty);
+    writer.publish(makeRecord(210));
+    CHECK(late.next(rec) == ShmRingReader::kRecord && rec.frame_number == 210);
+
+    // Writer restart: readers drop the old segment and read the new ring from its start
+    writer.close();
+    CHECK(reader.next(rec) == ShmRingReader::kRecord && rec.frame_number == 210);
+    CHECK(reader.next(rec) == ShmRingReader::kEmpty);
+    CHECK(writer.open(name, 128));
+    for (uint64_t i = 0; i < 5; ++i)
+        writer.publish(makeRecord(1000 + i));
+    for (uint64_t i = 0; i < 5; ++i) {
+        CHECK(reader.next(rec) == ShmRingReader::kRecord);
+        CHECK(rec.frame_number == 1000 + i && consistent(rec));
+    }
+
+    std::printf("in-order, overrun and restart: done\n");
+}
+
+// Reader process: returns the number of torn or out-of-order records
+static int readerProcess(const std::string &name, uint64_t total, bool slow) {
+    ShmRingReader reader;
+    while (!reader.open(name, false))
+        sched_yield();
+
+    uint64_t expected = 0, received = 0, lost_total = 0, errors = 0, spins = 0;
+    DetectionRecord rec;
+    while (expected < total) {
+        uint64_t lost = 0;
+        switch (reader.next(rec, &lost)) {
+        case ShmRingReader::kRecord:
+            if (rec.frame_number != expected || !consistent(rec))
+                ++errors;
+            expected = rec.frame_number + 1;
+            ++received;
+            if (slow && received % 64 == 0)
+                usleep(200);
+            break;
+        case ShmRingReader::kOverrun:
+            lost_total += lost;
+            expected += lost;
+            break;
+        case ShmRingReader::kEmpty:
+            if (++spins % 64 == 0)
+                sched_yield();
+            break;
+        }
+    }
+
+    std::printf("  reader %d%s: %llu received, %llu lost, %llu errors\n", getpid(), slow ? " (slow)" : "",
+                static_cast<unsigned long long>(received), static_cast<unsigned long long>(lost_total),
+                static_cast<unsigned long long>(errors));
+    std::fflush(stdout);
+    if (received + lost_total != total)
+        ++errors;
+    return errors ? 1 : 0;
+}
+
+static void checkProcesses(const std::string &name) {
+    const uint64_t total = 2000000;
+    const int readers = 3;
+
+    ShmRingWriter writer;
+    CHECK(writer.open(name, 1024));
+
+    std::fflush(stdout);
+    std::vector<pid_t> pids;
+    for (int i = 0; i < readers; ++i) {
+        pid_t pid = fork();
+        if (pid == 0)
+            _exit(readerProcess(name, total, i == readers - 1));
+        pids.push_back(pid);
+    }
+
+    // Frames of 100 detections, yielding between frames so readers get the CPU on small machines
+    for (uint64_t i = 0; i < total; ++i) {
+        writer.publish(makeRecord(i));
+        if (i % 100 == 99)
+            sched_yield();
+    }
+
+    for (pid_t pid : pids) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    std::printf("%d reader processes, %llu records: done\n", readers, static_cast<unsigned long long>(total));
+}
+
+int main() {
+    std::string name = "/shm_ring_check_" + std::to_string(getpid());
+    checkInOrder(name);
+    checkProcesses(name);
+
+    return checkResult();
+}
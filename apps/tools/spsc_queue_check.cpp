@@ -0,0 +1,121 @@
+// apps/real_world_overlay/tools/spsc_queue_check.cpp
+// Stress checks of SpscQueue under each overflow policy: FIFO order, no duplicated or torn items, and counters that
+// add up (pushed + dropped = offered, popped = received). Exits non-zero on failure.
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "spsc_queue.hpp"
+#include "tools/check.hpp"
+
+// Same size as the probe's per-object work item; every field is derived from seq so torn copies are detectable
+struct Item {
+    uint64_t seq;
+    uint64_t check[5];
+};
+
+static Item makeItem(uint64_t seq) {
+    Item item;
+    item.seq = seq;
+    for (int i = 0; i < 5; ++i)
+        item.check[i] = seq * 0x9e3779b97f4a7c15ULL + i;
+    return item;
+}
+
+static bool intact(const Item &item) {
+    for (int i = 0; i < 5; ++i) {
+        if (item.check[i] != item.seq * 0x9e3779b97f4a7c15ULL + i)
+            return false;
+    }
+    return true;
+}
+
+static void checkSingleThreaded() {
+    Item out[8];
+
+    SpscQueue<Item> newest(4, QueuePolicy::DropNewest);
+    for (uint64_t i = 0; i < 6; ++i)
+        CHECK(newest.push(makeItem(i)) == (i < 4));
+    CHECK(newest.pop(out, 8) == 4 && out[0].seq == 0 && out[3].seq == 3);
+    CHECK(newest.counters().dropped_newest == 2);
+
+    SpscQueue<Item> oldest(4, QueuePolicy::DropOldest);
+    for (uint64_t i = 0; i < 6; ++i)
+        CHECK(oldest.push(makeItem(i)));
+    CHECK(oldest.pop(out, 8) == 4 && out[0].seq == 2 && out[3].seq == 5);
+    CHECK(oldest.counters().dropped_oldest == 2);
+
+    SpscQueue<Item> block(4, QueuePolicy::Block);
+    for (uint64_t i = 0; i < 4; ++i)
+        CHECK(block.push(makeItem(i)));
+    block.close();
+    CHECK(!block.push(makeItem(4)));  // full and closed: returns instead of waiting
+    CHECK(block.pop(out, 8) == 4 && block.counters().pushed == 4);
+
+    std::printf("single-threaded policies: done\n");
+}
+
+// The consumer optionally stalls to force the full-queue path of every policy
+static void stress(QueuePolicy policy, uint64_t total, bool slow_consumer) {
+    SpscQueue<Item> queue(1024, policy);
+    std::atomic<bool> done(false);
+    uint64_t received = 0, disorder = 0, torn = 0, last = 0;
+    bool first = true;
+
+    std::thread consumer([&]() {
+        Item items[64];
+        for (;;) {
+            size_t n = queue.pop(items, 64);
+            if (n == 0) {
+                if (done.load(std::memory_order_acquire) && queue.size() == 0)
+                    break;
+                std::this_thread::yield();
+                continue;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                torn += !intact(items[i]);
+                if (!first && items[i].seq <= last)
+                    ++disorder;
+                first = false;
+                last = items[i].seq;
+            }
+            received += n;
+            if (slow_consumer && received % 4096 < 64)
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    uint64_t accepted = 0;
+    for (uint64_t i = 0; i < total; ++i)
+        accepted += queue.push(makeItem(i));
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    QueueCounters c = queue.counters();
+    CHECK(torn == 0 && disorder == 0);
+    CHECK(c.pushed == accepted && c.popped == received);
+    CHECK(c.pushed + c.dropped_newest == total);
+    CHECK(c.popped + c.dropped_oldest == c.pushed);
+    if (policy == QueuePolicy::Block)
+        CHECK(received == total);
+    if (policy == QueuePolicy::DropOldest)
+        CHECK(last == total - 1);  // the newest item always survives
+
+    std::printf("%-12s %-13s %9llu offered %9llu received %9llu dropped newest %9llu dropped oldest %7llu blocked\n",
+                queuePolicyName(policy), slow_consumer ? "slow consumer" : "fast consumer",
+                static_cast<unsigned long long>(total), static_cast<unsigned long long>(received),
+                static_cast<unsigned long long>(c.dropped_newest), static_cast<unsigned long long>(c.dropped_oldest),
+                static_cast<unsigned long long>(c.blocked));
+}
+
+int main() {
+    checkSingleThreaded();
+    for (QueuePolicy policy : {QueuePolicy::DropNewest, QueuePolicy::DropOldest, QueuePolicy::Block}) {
+        stress(policy, 2000000, false);
+        stress(policy, 500000, true);
+    }
+
+    return checkResult();
+}
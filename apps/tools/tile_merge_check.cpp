@@ -0,0 +1,303 @@
+// apps/real_world_overlay/tools/tile_merge_check.cpp
+// Checks of sliced inference, no GStreamer or DeepStream needed: the tile plan (equal even tiles covering the region
+// with the requested overlap), tile -> frame box remapping, the SIMD IoU / IoS row against the scalar one, and the
+// merge on synthetic 4K scenes. The simulated detector sees, per tile, every object with enough of itself inside the
+// tile (cut at the tile border), and on the downscaled full frame only the large ones. The merged result is scored
+// against ground truth next to concatenation and plain NMS, then merge() is timed. Exits non-zero on failure.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "tile_merge.hpp"
+#include "tools/check.hpp"
+
+static const int kWidth = 3848, kHeight = 2168;
+
+static void checkPlan() {
+    struct Case {
+        int x, y, w, h, cols, rows;
+        float overlap;
+    };
+    const Case cases[] = {
+        {0, 0, kWidth, kHeight, 3, 3, 0.2f}, {0, 0, kWidth, kHeight, 2, 2, 0.1f}, {0, 0, kWidth, kHeight, 4, 2, 0.25f},
+        {422, 400, 884, 498, 2, 2, 0.2f},    {0, 0, 1920, 1080, 1, 1, 0.2f},      {0, 0, 1919, 1079, 3, 2, 0.0f},
+    };
+    for (const Case &c : cases) {
+        TilePlanConfig cfg;
+        cfg.cols = c.cols;
+        cfg.rows = c.rows;
+        cfg.overlap = c.overlap;
+        std::vector<TileRect> tiles;
+        CHECK(planTiles(c.x, c.y, c.w, c.h, cfg, tiles));
+        CHECK(tiles.size() == static_cast<size_t>(c.cols * c.rows));
+        if (tiles.empty())
+            continue;
+        bool ok = true;
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            const TileRect &t = tiles[i];
+            ok = ok && t.width == tiles[0].width && t.height == tiles[0].height;
+            ok = ok && t.x % 2 == 0 && t.y % 2 == 0 && t.width % 2 == 0 && t.height % 2 == 0;
+            ok = ok && t.x >= c.x && t.y >= c.y && t.x + t.width <= c.x + c.w && t.y + t.height <= c.y + c.h;
+            // Row-major, and each neighbour shares the overlap (less two pixels of even alignment)
+            int col = static_cast<int>(i) % c.cols, row = static_cast<int>(i) / c.cols;
+            if (col > 0) {
+                const TileRect &left = tiles[i - 1];
+                ok = ok && left.y == t.y && left.x + left.width - t.x >= c.overlap * t.width - 2.0f;
+            }
+            if (row > 0) {
+                const TileRect &up = tiles[i - c.cols];
+                ok = ok && up.x == t.x && up.y + up.height - t.y >= c.overlap * t.height - 2.0f;
+            }
+        }
+        // Covers the region up to its even-aligned end
+        ok = ok && tiles.front().x == (c.x & ~1) && tiles.front().y == (c.y & ~1);
+        ok = ok && tiles.back().x + tiles.back().width >= ((c.x + c.w) & ~1) - 1;
+        ok = ok && tiles.back().y + tiles.back().height >= ((c.y + c.h) & ~1) - 1;
+        if (!ok)
+            std::fprintf(stderr, "  plan %dx%d+%d+%d %dx%d overlap %.2f: tile %dx%d\n", c.w, c.h, c.x, c.y, c.cols,
+                         c.rows, c.overlap, tiles[0].width, tiles[0].height);
+        CHECK(ok);
+    }
+
+    TilePlanConfig bad;
+    std::vector<TileRect> tiles;
+    bad.cols = 0;
+    CHECK(!planTiles(0, 0, kWidth, kHeight, bad, tiles) && tiles.empty());
+    bad.cols = 2;
+    bad.overlap = 0.95f;
+    CHECK(!planTiles(0, 0, kWidth, kHeight, bad, tiles));
+    bad.overlap = 0.2f;
+    bad.rows = 100;
+    CHECK(!planTiles(0, 0, kWidth, kHeight, bad, tiles));
+
+    TilePlanConfig cfg;
+    cfg.cols = cfg.rows = 3;
+    planTiles(0, 0, kWidth, kHeight, cfg, tiles);
+    std::printf("plan %dx%d, 3 x 3 tiles, overlap 0.2: %d x %d each (%zu plans checked)\n", kWidth, kHeight,
+                tiles[0].width, tiles[0].height, sizeof(cases) / sizeof(cases[0]));
+
+    // Remap: the centre and the corners of the tile's mux frame land on the tile
+    float l = 0.0f, t = 0.0f, w = 1280.0f, h = 720.0f;
+    tileBoxToFrame(tiles[4], 1280, 720, l, t, w, h);
+    CHECK(l == tiles[4].x && t == tiles[4].y && std::fabs(w - tiles[4].width) < 1e-3f &&
+          std::fabs(h - tiles[4].height) < 1e-3f);
+}
+
+static void checkOverlapRow() {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> pos(0.0f, 1000.0f), size(1.0f, 300.0f);
+    const size_t n = 103;  // SIMD groups plus a scalar tail
+    std::vector<float> L(n), T(n), R(n), B(n), iou(n), ios(n), iou_s(n), ios_s(n);
+    double worst = 0.0;
+    for (int rep = 0; rep < 100; ++rep) {
+        for (size_t i = 0; i < n; ++i) {
+            L[i] = pos(rng);
+            T[i] = pos(rng);
+            R[i] = L[i] + (i % 17 == 0 ? 0.0f : size(rng));  // some empty boxes
+            B[i] = T[i] + size(rng);
+        }
+        float l = pos(rng), t = pos(rng), r = l + size(rng), b = t + size(rng);
+        tile_merge_detail::overlapRow(l, t, r, b, L.data(), T.data(), R.data(), B.data(), n, iou.data(), ios.data());
+        tile_merge_detail::overlapRowScalar(l, t, r, b, L.data(), T.data(), R.data(), B.data(), 0, n, iou_s.data(),
+                                            ios_s.data());
+        for (size_t i = 0; i < n; ++i) {
+            worst = std::max(worst, static_cast<double>(std::fabs(iou[i] - iou_s[i])));
+            worst = std::max(worst, static_cast<double>(std::fabs(ios[i] - ios_s[i])));
+        }
+    }
+    CHECK(worst < 1e-6);
+    std::printf("IoU / IoS row %s vs scalar: worst difference %.2g over %zu boxes\n", tileMergeSimdName(), worst,
+                100 * n);
+}
+
+struct Object {
+    float l, t, r, b;
+    int32_t class_id;
+};
+
+static float boxIou(float al, float at, float ar, float ab, float bl, float bt, float br, float bb) {
+    float iw = std::max(0.0f, std::min(ar, br) - std::max(al, bl));
+    float ih = std::max(0.0f, std::min(ab, bb) - std::max(at, bt));
+    float inter = iw * ih;
+    return inter / ((ar - al) * (ab - at) + (br - bl) * (bb - bt) - inter);
+}
+
+// Objects that do not overlap each other much: people (1:2.5) of 24..140 pixels and vehicles of 300..900
+static std::vector<Object> makeScene(std::mt19937 &rng, int count) {
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    std::vector<Object> objects;
+    for (int tries = 0; static_cast<int>(objects.size()) < count && tries < count * 50; ++tries) {
+        Object o;
+        bool vehicle = u(rng) < 0.1f;
+        float w = vehicle ? 300.0f + 600.0f * u(rng) : 24.0f + 116.0f * u(rng);
+        float h = vehicle ? w * (0.4f + 0.2f * u(rng)) : w * 2.5f;
+        o.l = u(rng) * (kWidth - w);
+        o.t = u(rng) * (kHeight - h);
+        o.r = o.l + w;
+        o.b = o.t + h;
+        o.class_id = vehicle ? 2 : 0;
+        bool clear = true;
+        for (const Object &p : objects)
+            clear = clear && boxIou(o.l, o.t, o.r, o.b, p.l, p.t, p.r, p.b) < 0.1f;
+        if (clear)
+            objects.push_back(o);
+    }
+    return objects;
+}
+
+// What nvinfer would report: per tile the visible part of each object with at least 25% of its area and 8 network
+// pixels of width inside; on the full frame (3x downscaled) only objects over 180 pixels wide. +-1 pixel of jitter.
+static std::vector<MergeBox> detect(const std::vector<Object> &objects, const std::vector<TileRect> &tiles,
+                                    std::mt19937 &rng) {
+    std::uniform_real_distribution<float> jitter(-1.0f, 1.0f), conf(0.5f, 0.95f);
+    std::vector<MergeBox> boxes;
+    for (const Object &o : objects) {
+        float area = (o.r - o.l) * (o.b - o.t);
+        for (size_t k = 0; k < tiles.size(); ++k) {
+            const TileRect &t = tiles[k];
+            float l = std::max(o.l + jitter(rng), float(t.x)), r = std::min(o.r + jitter(rng), float(t.x + t.width));
+            float top = std::max(o.t + jitter(rng), float(t.y));
+            float b = std::min(o.b + jitter(rng), float(t.y + t.height));
+            if (r - l < 8.0f * t.width / 1280.0f || b <= top || (r - l) * (b - top) < 0.25f * area)
+                continue;
+            boxes.push_back(MergeBox{l, top, r - l, b - top, conf(rng), o.class_id, static_cast<int32_t>(k)});
+        }
+        if (o.r - o.l > 180.0f) {
+            float l = o.l + 3.0f * jitter(rng), top = o.t + 3.0f * jitter(rng);
+            boxes.push_back(MergeBox{l, top, o.r - l, o.b - top, conf(rng), o.class_id, -1});
+        }
+    }
+    std::shuffle(boxes.begin(), boxes.end(), rng);
+    return boxes;
+}
+
+struct Score {
+    int objects = 0, boxes = 0, matched = 0, tight = 0;
+
+    void add(const std::vector<Object> &objects_, const MergeBox *b, const uint32_t *keep, size_t n) {
+        objects += static_cast<int>(objects_.size());
+        boxes += static_cast<int>(n);
+        std::vector<uint8_t> used(n, 0);
+        for (const Object &o : objects_) {
+            int best = -1;
+            float best_iou = 0.5f;
+            for (size_t i = 0; i < n; ++i) {
+                const MergeBox &x = b[keep[i]];
+                float iou = boxIou(o.l, o.t, o.r, o.b, x.left, x.top, x.left + x.width, x.top + x.height);
+                if (!used[i] && x.class_id == o.class_id && iou >= best_iou) {
+                    best = static_cast<int>(i);
+                    best_iou = iou;
+                }
+            }
+            if (best >= 0) {
+                used[best] = 1;
+                ++matched;
+                tight += best_iou >= 0.8f;
+            }
+        }
+    }
+
+    double recall() const { return objects ? double(matched) / objects : 0.0; }
+    double precision() const { return boxes ? double(matched) / boxes : 0.0; }
+    double tightShare() const { return matched ? double(tight) / matched : 0.0; }
+};
+
+static void checkMerge() {
+    TilePlanConfig plan;
+    plan.cols = plan.rows = 3;
+    std::vector<TileRect> tiles;
+    planTiles(0, 0, kWidth, kHeight, plan, tiles);
+    const TileRect region{0, 0, kWidth, kHeight};
+
+    TileMergeConfig nms_only;
+    nms_only.seam_overlap = 2.0f;  // never fuses
+    TileMerger merger, plain(nms_only);
+    Score concat, nms, full;
+    std::mt19937 rng(7);
+    std::vector<uint32_t> keep;
+    for (int scene = 0; scene < 200; ++scene) {
+        std::vector<Object> objects = makeScene(rng, 40);
+        std::vector<MergeBox> boxes = detect(objects, tiles, rng);
+        keep.resize(boxes.size());
+        std::vector<uint32_t> all(boxes.size());
+        for (size_t i = 0; i < all.size(); ++i)
+            all[i] = static_cast<uint32_t>(i);
+        concat.add(objects, boxes.data(), all.data(), all.size());
+
+        std::vector<MergeBox> copy = boxes;
+        size_t n = plain.merge(tiles, region, copy.data(), copy.size(), keep.data());
+        nms.add(objects, copy.data(), keep.data(), n);
+
+        n = merger.merge(tiles, region, boxes.data(), boxes.size(), keep.data());
+        full.add(objects, boxes.data(), keep.data(), n);
+        for (size_t i = 1; i < n; ++i)
+            CHECK(boxes[keep[i - 1]].confidence >= boxes[keep[i]].confidence);
+    }
+    std::printf("200 scenes, %d objects, 3 x 3 tiles + full frame:\n", full.objects);
+    const struct {
+        const char *name;
+        const Score &s;
+    } rows[] = {{"concatenated", concat}, {"NMS", nms}, {"NMS + seam fusion", full}};
+    for (const auto &r : rows)
+        std::printf("  %-18s %6d boxes  recall %.3f  precision %.3f  IoU >= 0.8 %.3f\n", r.name, r.s.boxes,
+                    r.s.recall(), r.s.precision(), r.s.tightShare());
+    CHECK(full.recall() > 0.98 && full.precision() > 0.97);
+    CHECK(full.precision() > nms.precision() && nms.precision() > concat.precision());
+    CHECK(full.tightShare() > nms.tightShare());
+
+    // A lone object on the seam of four tiles: four cut parts become one box
+    Object o{1200.0f, 640.0f, 1400.0f, 900.0f, 0};
+    std::vector<Object> one(1, o);
+    std::vector<MergeBox> parts;
+    for (size_t k = 0; k < tiles.size(); ++k) {
+        const TileRect &t = tiles[k];
+        float l = std::max(o.l, float(t.x)), r = std::min(o.r, float(t.x + t.width));
+        float top = std::max(o.t, float(t.y)), b = std::min(o.b, float(t.y + t.height));
+        if (r > l && b > top)
+            parts.push_back(MergeBox{l, top, r - l, b - top, 0.6f + 0.1f * k, 0, static_cast<int32_t>(k)});
+    }
+    keep.resize(parts.size());
+    size_t n = merger.merge(tiles, region, parts.data(), parts.size(), keep.data());
+    CHECK(parts.size() == 4 && n == 1);
+    if (n == 1) {
+        const MergeBox &m = parts[keep[0]];
+        CHECK(m.left == o.l && m.top == o.t && m.left + m.width == o.r && m.top + m.height == o.b);
+    }
+}
+
+static void bench() {
+    TilePlanConfig plan;
+    plan.cols = plan.rows = 3;
+    std::vector<TileRect> tiles;
+    planTiles(0, 0, kWidth, kHeight, plan, tiles);
+    const TileRect region{0, 0, kWidth, kHeight};
+    TileMerger merger;
+    std::mt19937 rng(9);
+    for (int count : {20, 100, 250}) {
+        std::vector<Object> objects = makeScene(rng, count);
+        std::vector<MergeBox> boxes = detect(objects, tiles, rng), work;
+        std::vector<uint32_t> keep(boxes.size());
+        const int reps = 200;
+        auto start = std::chrono::steady_clock::now();
+        size_t kept = 0;
+        for (int i = 0; i < reps; ++i) {
+            work = boxes;
+            kept = merger.merge(tiles, region, work.data(), work.size(), keep.data());
+        }
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / reps;
+        std::printf("  %3zu objects, %4zu boxes -> %3zu  %8.1f us/frame\n", objects.size(), boxes.size(), kept, us);
+    }
+}
+
+int main() {
+    checkPlan();
+    checkOverlapRow();
+    checkMerge();
+    std::printf("merge(), %s IoU rows:\n", tileMergeSimdName());
+    bench();
+
+    return checkResult();
+}
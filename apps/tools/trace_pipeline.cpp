@@ -0,0 +1,66 @@
+// apps/real_world_overlay/tools/trace_pipeline.cpp
+// Runs any gst-launch pipeline with the latency probes of pipeline_tracer.hpp, without DeepStream or a camera.
+//   trace_pipeline ["pipeline description"] [dump interval s] [output json]
+// The default is a software stand-in for the capture / convert / encode path of real_world_overlay. The JSON is dumped
+// every interval, on SIGUSR1 and at end of stream.
+#include <gst/gst.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "pipeline_tracer.hpp"
+
+static const char *kDefaultPipeline =
+    "videotestsrc is-live=true num-buffers=900 ! video/x-raw,width=1920,height=1080,framerate=30/1 ! "
+    "videoconvert ! video/x-raw,format=NV12 ! videoscale ! video/x-raw,width=1280,height=720 ! "
+    "queue ! videoconvert ! fakesink sync=false";
+
+static gboolean bus_call(GstBus *bus, GstMessage *msg, gpointer data) {
+    GMainLoop *loop = static_cast<GMainLoop *>(data);
+    if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_ERROR) {
+        GError *err = nullptr;
+        gst_message_parse_error(msg, &err, nullptr);
+        std::cerr << "Error: " << err->message << std::endl;
+        g_error_free(err);
+        g_main_loop_quit(loop);
+    } else if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS) {
+        g_main_loop_quit(loop);
+    }
+    return TRUE;
+}
+
+int main(int argc, char *argv[]) {
+    gst_init(&argc, &argv);
+    const char *desc = argc > 1 ? argv[1] : kDefaultPipeline;
+    int interval = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    GError *error = nullptr;
+    GstElement *pipeline = gst_parse_launch(desc, &error);
+    if (!pipeline) {
+        std::cerr << "Failed to create pipeline: " << error->message << std::endl;
+        g_error_free(error);
+        return 1;
+    }
+
+    PipelineTracer latency;
+    if (argc > 3)
+        latency.output = argv[3];
+    size_t pads = installLatencyProbes(latency, pipeline);
+    scheduleLatencyDumps(latency, interval > 0 ? static_cast<guint>(interval) : 0);
+    std::cerr << "Tracing " << pads << " pads of: " << desc << std::endl;
+
+    GMainLoop *loop = g_main_loop_new(NULL, FALSE);
+    GstBus *bus = gst_element_get_bus(pipeline);
+    gst_bus_add_watch(bus, bus_call, loop);
+    gst_object_unref(bus);
+
+    gst_element_set_state(pipeline, GST_STATE_PLAYING);
+    g_main_loop_run(loop);
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+
+    dumpLatency(latency);
+    gst_object_unref(pipeline);
+    g_main_loop_unref(loop);
+    return 0;
+}
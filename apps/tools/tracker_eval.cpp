@@ -0,0 +1,404 @@
+// apps/real_world_overlay/tools/tracker_eval.cpp
+// Offline evaluation of the probe tracker: replays detections frame by frame with nvinfer's interval emulated (the
+// tracker only predicts on skipped frames) and reports, per interval and association, how much of the scene is drawn,
+// ID switches, position error on inferred and skipped frames, and the tracker time per frame. Heap allocations are
+// counted during the replay, there must be none.
+//   tracker_eval                                   synthetic crossing pedestrians, with checks (exit code)
+//   tracker_eval --mot file.txt                    MOTChallenge lines: frame,id,left,top,width,height,conf[,class]
+//                                                  (ground truth ids give ID switches, id -1 = detections only)
+//   tracker_eval --record /real_world_overlay out.txt [seconds] [source]
+//                                                  records the app's shared-memory detections as MOT lines
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shm_ring.hpp"
+#include "tracker.hpp"
+#include "tools/alloc_counter.hpp"
+#include "tools/check.hpp"
+
+// One detection of a replayed frame, with its ground truth identity when known (-1 otherwise)
+struct EvalDetection {
+    TrackBox box;
+    int32_t class_id;
+    float confidence;
+    int64_t truth_id;
+};
+
+struct EvalFrame {
+    std::vector<EvalDetection> detections;
+    std::vector<EvalDetection> truth;  // objects really present, for coverage and ID switches
+};
+
+struct EvalResult {
+    uint64_t truth = 0, covered = 0, false_outputs = 0, id_switches = 0, tracks = 0, allocations = 0;
+    double error_inferred = 0.0, error_skipped = 0.0;
+    uint64_t matched_inferred = 0, matched_skipped = 0;
+    double mean_us = 0.0, p99_us = 0.0, max_us = 0.0;
+};
+
+static float centreDistance(const TrackBox &a, const TrackBox &b) {
+    return std::hypot(a.left + a.width / 2.0f - b.left - b.width / 2.0f,
+                      a.top + a.height / 2.0f - b.top - b.height / 2.0f);
+}
+
+// Frames of crossing pedestrians: constant velocity with random turns, bouncing off the image edges. Objects behind
+// another one (smaller bottom edge, overlapping) are detected with low confidence, some detections are missed and a
+// few false positives appear.
+static std::vector<EvalFrame> syntheticScene(int objects, int frames, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    const float W = 1920.0f, H = 1080.0f;
+
+    struct Walker {
+        float x, y, vx, vy, w, h;
+    };
+    std::vector<Walker> walkers(objects);
+    auto turn = [&](Walker &o) {
+        float speed = 1.0f + 5.0f * uni(rng), angle = 6.2831853f * uni(rng);
+        o.vx = speed * std::cos(angle);
+        o.vy = 0.4f * speed * std::sin(angle);
+    };
+    for (Walker &o : walkers) {
+        o.w = 40.0f + 40.0f * uni(rng);
+        o.h = 2.4f * o.w;
+        o.x = uni(rng) * (W - o.w);
+        o.y = uni(rng) * (H - o.h);
+        turn(o);
+    }
+
+    std::vector<EvalFrame> out(frames);
+    for (int f = 0; f < frames; ++f) {
+        EvalFrame &frame = out[f];
+        for (int i = 0; i < objects; ++i) {
+            Walker &o = walkers[i];
+            if (uni(rng) < 0.01f)
+                turn(o);
+            o.x += o.vx;
+            o.y += o.vy;
+            if (o.x < 0.0f || o.x + o.w > W)
+                o.vx = -o.vx;
+            if (o.y < 0.0f || o.y + o.h > H)
+                o.vy = -o.vy;
+            frame.truth.push_back(EvalDetection{TrackBox{o.x, o.y, o.w, o.h}, 0, 1.0f, i});
+        }
+        for (const EvalDetection &t : frame.truth) {
+            bool occluded = false;
+            for (const EvalDetection &other : frame.truth) {
+                occluded = occluded || (other.truth_id != t.truth_id && trackIou(t.box, other.box) > 0.2f &&
+                                        other.box.top + other.box.height > t.box.top + t.box.height);
+            }
+            if (uni(rng) < (occluded ? 0.2f : 0.05f))
+                continue;  // missed
+            EvalDetection d = t;
+            d.box.left += 2.0f * noise(rng);
+            d.box.top += 2.0f * noise(rng);
+            d.box.width *= 1.0f + 0.03f * noise(rng);
+            d.box.height *= 1.0f + 0.03f * noise(rng);
+            d.confidence = occluded ? 0.2f + 0.25f * uni(rng) : 0.6f + 0.35f * uni(rng);
+            frame.detections.push_back(d);
+        }
+        if (uni(rng) < 0.1f) {
+            float w = 40.0f + 40.0f * uni(rng);
+            frame.detections.push_back(
+                EvalDetection{TrackBox{uni(rng) * (W - w), uni(rng) * (H - 2.4f * w), w, 2.4f * w}, 0,
+                              0.3f + 0.3f * uni(rng), -1});
+        }
+        std::shuffle(frame.detections.begin(), frame.detections.end(), rng);
+    }
+    return out;
+}
+
+// MOTChallenge text: frame,id,left,top,width,height,conf[,class,...]. Lines with an id are also ground truth.
+static bool loadMot(const char *path, std::vector<EvalFrame> &frames) {
+    FILE *f = std::fopen(path, "r");
+    if (!f)
+        return false;
+    std::map<long, EvalFrame> by_frame;
+    char line[512];
+    while (std::fgets(line, sizeof(line), f)) {
+        double v[8] = {0, -1, 0, 0, 0, 0, 1, 0};
+        int n = 0;
+        for (char *s = line; n < 8 && *s;) {
+            char *end;
+            v[n] = std::strtod(s, &end);
+            if (end == s)
+                break;
+            ++n;
+            s = end;
+            while (*s == ',' || *s == ' ')
+                ++s;
+        }
+        if (n < 6)
+            continue;
+        EvalDetection d{TrackBox{float(v[2]), float(v[3]), float(v[4]), float(v[5])}, int32_t(v[7]),
+                        float(v[6] < 0 ? 1.0 : v[6]), int64_t(v[1])};
+        EvalFrame &frame = by_frame[long(v[0])];
+        frame.detections.push_back(d);
+        if (d.truth_id >= 0)
+            frame.truth.push_back(d);
+    }
+    std::fclose(f);
+    if (by_frame.empty())
+        return false;
+    long first = by_frame.begin()->first, last = by_frame.rbegin()->first;
+    frames.assign(static_cast<size_t>(last - first + 1), EvalFrame());
+    for (auto &kv : by_frame)
+        frames[kv.first - first] = std::move(kv.second);
+    return true;
+}
+
+static EvalResult replay(const std::vector<EvalFrame> &frames, const TrackerConfig &cfg, int interval) {
+    EvalResult r;
+    Tracker tracker(cfg);
+    std::vector<TrackerDetection> dets(cfg.max_detections);
+    std::vector<TrackOutput> out(cfg.capacity);
+    std::vector<TrackBox> shown(std::max(cfg.capacity, cfg.max_detections));
+    std::vector<uint64_t> shown_id(shown.size());
+    std::vector<uint8_t> shown_used(shown.size());
+    std::map<int64_t, uint64_t> last_id;  // truth id -> track id
+    for (const EvalFrame &frame : frames) {
+        for (const EvalDetection &t : frame.truth)
+            last_id[t.truth_id] = TRACKER_NO_ID;
+    }
+    std::vector<double> us(frames.size());
+
+    uint64_t allocations = heapAllocations();
+    for (size_t f = 0; f < frames.size(); ++f) {
+        const EvalFrame &frame = frames[f];
+        bool inferred = f % static_cast<size_t>(interval + 1) == 0;
+        size_t n_shown = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        if (inferred) {
+            size_t n = std::min(frame.detections.size(), dets.size());
+            for (size_t i = 0; i < n; ++i) {
+                const EvalDetection &e = frame.detections[i];
+                dets[i].box = e.box;
+                dets[i].class_id = e.class_id;
+                dets[i].confidence = e.confidence;
+            }
+            tracker.update(dets.data(), n);
+            us[f] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            for (size_t i = 0; i < n; ++i) {
+                if (dets[i].track_id == TRACKER_NO_ID)
+                    continue;
+                shown[n_shown] = dets[i].box;
+                shown_id[n_shown++] = dets[i].track_id;
+            }
+        } else {
+            tracker.predict();
+            size_t n = tracker.output(out.data(), out.size());
+            us[f] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            for (size_t i = 0; i < n; ++i) {
+                shown[n_shown] = out[i].box;
+                shown_id[n_shown++] = out[i].track_id;
+            }
+        }
+
+        // Greedy IoU >= 0.5 between what would be drawn and the objects present
+        std::fill(shown_used.begin(), shown_used.begin() + n_shown, 0);
+        for (const EvalDetection &t : frame.truth) {
+            ++r.truth;
+            size_t best = n_shown;
+            float best_iou = 0.5f;
+            for (size_t i = 0; i < n_shown; ++i) {
+                float iou = shown_used[i] ? 0.0f : trackIou(t.box, shown[i]);
+                if (iou >= best_iou) {
+                    best_iou = iou;
+                    best = i;
+                }
+            }
+            if (best == n_shown)
+                continue;
+            shown_used[best] = 1;
+            ++r.covered;
+            (inferred ? r.error_inferred : r.error_skipped) += centreDistance(t.box, shown[best]);
+            ++(inferred ? r.matched_inferred : r.matched_skipped);
+            uint64_t &last = last_id.find(t.truth_id)->second;
+            r.id_switches += last != TRACKER_NO_ID && last != shown_id[best];
+            last = shown_id[best];
+        }
+        for (size_t i = 0; i < n_shown; ++i)
+            r.false_outputs += !shown_used[i];
+    }
+    r.allocations = heapAllocations() - allocations;
+    r.tracks = tracker.created();
+
+    std::sort(us.begin(), us.end());
+    for (double u : us)
+        r.mean_us += u;
+    r.mean_us /= std::max<size_t>(us.size(), 1);
+    r.p99_us = us.empty() ? 0.0 : us[us.size() * 99 / 100];
+    r.max_us = us.empty() ? 0.0 : us.back();
+    r.error_inferred /= std::max<uint64_t>(r.matched_inferred, 1);
+    r.error_skipped /= std::max<uint64_t>(r.matched_skipped, 1);
+    return r;
+}
+
+static void printHeader() {
+    std::printf("%-9s %-9s %8s %8s %7s %7s %8s %8s %8s %8s %8s\n", "interval", "assoc", "covered", "false", "idsw",
+                "tracks", "err_inf", "err_skip", "mean_us", "p99_us", "max_us");
+}
+
+static void printRow(int interval, const char *assoc, const EvalResult &r) {
+    std::printf("%-9d %-9s %7.1f%% %8llu %7llu %7llu %7.1fpx %7.1fpx %8.2f %8.2f %8.2f\n", interval, assoc,
+                100.0 * r.covered / std::max<uint64_t>(r.truth, 1), static_cast<unsigned long long>(r.false_outputs),
+                static_cast<unsigned long long>(r.id_switches), static_cast<unsigned long long>(r.tracks),
+                r.error_inferred, r.error_skipped, r.mean_us, r.p99_us, r.max_us);
+}
+
+// Two tracks, two detections: greedy takes the single best pair, Hungarian the best total
+static void checkAssociation() {
+    for (TrackerAssociation a : {TrackerAssociation::Greedy, TrackerAssociation::Hungarian}) {
+        TrackerConfig cfg;
+        cfg.min_hits = 1;
+        cfg.association = a;
+        Tracker tracker(cfg);
+        TrackerDetection start[2];
+        start[0].box = TrackBox{0.0f, 0.0f, 100.0f, 100.0f};
+        start[1].box = TrackBox{54.0f, 0.0f, 100.0f, 100.0f};
+        start[0].confidence = start[1].confidence = 0.9f;
+        tracker.update(start, 2);
+        CHECK(start[0].track_id == 1 && start[1].track_id == 2);
+
+        // IoU(A, d0) = 0.6, IoU(A, d1) = 0.55, IoU(B, d0) = 0.55, IoU(B, d1) < 0.3
+        TrackerDetection next[2];
+        next[0].box = TrackBox{25.0f, 0.0f, 100.0f, 100.0f};
+        next[1].box = TrackBox{-29.0f, 0.0f, 100.0f, 100.0f};
+        next[0].confidence = next[1].confidence = 0.9f;
+        tracker.update(next, 2);
+        if (a == TrackerAssociation::Greedy) {
+            CHECK(next[0].track_id == 1 && next[1].track_id == 3);
+        } else {
+            CHECK(next[0].track_id == 2 && next[1].track_id == 1);
+        }
+    }
+
+    // Low-confidence detections keep a confirmed track alive but never start one
+    Tracker tracker;
+    TrackerDetection d;
+    d.box = TrackBox{100.0f, 100.0f, 50.0f, 120.0f};
+    d.confidence = 0.3f;
+    tracker.update(&d, 1);
+    CHECK(tracker.active() == 0);
+    d.confidence = 0.9f;
+    tracker.update(&d, 1);
+    tracker.update(&d, 1);
+    CHECK(d.track_id == 1);
+    d.confidence = 0.3f;
+    d.box.left += 3.0f;
+    tracker.update(&d, 1);
+    CHECK(d.track_id == 1);
+
+    // Capacity: the pool fills, nothing is allocated, the overflow is counted
+    TrackerConfig small;
+    small.capacity = 4;
+    Tracker full(small);
+    TrackerDetection many[8];
+    for (int i = 0; i < 8; ++i) {
+        many[i].box = TrackBox{i * 200.0f, 0.0f, 50.0f, 120.0f};
+        many[i].confidence = 0.9f;
+    }
+    full.update(many, 8);
+    CHECK(full.active() == 4 && full.poolFull() == 4);
+    std::printf("association, low-confidence stage and pool capacity: done\n");
+}
+
+static int record(const char *name, const char *path, double seconds, uint32_t source) {
+    ShmRingReader reader;
+    for (int i = 0; i < 50 && !reader.open(name, true); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    if (!reader.isOpen()) {
+        std::fprintf(stderr, "cannot open shared memory ring %s\n", name);
+        return 1;
+    }
+    FILE *f = std::fopen(path, "w");
+    if (!f) {
+        std::fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    uint64_t records = 0, lost_total = 0;
+    auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < end) {
+        DetectionRecord rec;
+        uint64_t lost = 0;
+        ShmRingReader::Result res = reader.next(rec, &lost);
+        if (res == ShmRingReader::kEmpty) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            continue;
+        }
+        if (res == ShmRingReader::kOverrun) {
+            lost_total += lost;
+            continue;
+        }
+        if (rec.source_id != source || rec.count == 0)
+            continue;
+        std::fprintf(f, "%llu,-1,%.2f,%.2f,%.2f,%.2f,%.4f,%d\n", static_cast<unsigned long long>(rec.frame_number),
+                     rec.left, rec.top, rec.width, rec.height, rec.confidence, rec.class_id);
+        ++records;
+    }
+    std::fclose(f);
+    std::printf("%llu detections of source %u written to %s, %llu records lost\n",
+                static_cast<unsigned long long>(records), source, path, static_cast<unsigned long long>(lost_total));
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--record") == 0) {
+        if (argc < 4) {
+            std::fprintf(stderr, "usage: %s --record <shm name> <out.txt> [seconds] [source]\n", argv[0]);
+            return 2;
+        }
+        return record(argv[2], argv[3], argc > 4 ? std::atof(argv[4]) : 60.0,
+                      argc > 5 ? static_cast<uint32_t>(std::atoi(argv[5])) : 0);
+    }
+
+    std::vector<EvalFrame> frames;
+    bool synthetic = !(argc > 2 && std::strcmp(argv[1], "--mot") == 0);
+    if (synthetic) {
+        checkAssociation();
+        frames = syntheticScene(24, 3000, 7);
+        std::printf("synthetic scene: 24 crossing pedestrians, 3000 frames at 1920x1080\n");
+    } else if (!loadMot(argv[2], frames)) {
+        std::fprintf(stderr, "cannot read %s\n", argv[2]);
+        return 1;
+    } else {
+        std::printf("%s: %zu frames\n", argv[2], frames.size());
+    }
+
+    printHeader();
+    std::map<int, EvalResult> greedy;
+    for (int interval : {0, 1, 2, 3, 4}) {
+        for (TrackerAssociation a : {TrackerAssociation::Greedy, TrackerAssociation::Hungarian}) {
+            TrackerConfig cfg;
+            cfg.association = a;
+            EvalResult r = replay(frames, cfg, interval);
+            printRow(interval, trackerAssociationName(a), r);
+            CHECK(r.allocations == 0);
+            if (a == TrackerAssociation::Greedy)
+                greedy[interval] = r;
+        }
+    }
+
+    if (synthetic) {
+        // Skipped frames stay drawn (no tracker: 1 / (interval + 1)), identities stay stable
+        const EvalResult &r0 = greedy[0], &r2 = greedy[2];
+        double cover0 = double(r0.covered) / r0.truth, cover2 = double(r2.covered) / r2.truth;
+        CHECK(cover0 > 0.85 && cover2 > 0.8);
+        CHECK(r0.id_switches < r0.covered / 200 && r2.id_switches < r2.covered / 100);
+        CHECK(r2.error_skipped < 8.0);
+        std::printf("interval 2: %.1f%% of the objects drawn (without tracker %.1f%%)\n", 100.0 * cover2, 100.0 / 3);
+    }
+
+    return checkResult();
+}
@@ -0,0 +1,137 @@
+// apps/real_world_overlay/tools/world_meta_check.cpp
+// Exercises the WorldCoordMeta user meta lifecycle (attach, copy, release) with stand-ins for the DeepStream meta
+// structs, and the LUT Jacobian used for the covariance. Exits non-zero on failure.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "image_to_world.hpp"
+#include "world_meta.hpp"
+#include "tools/alloc_counter.hpp"
+#include "tools/check.hpp"
+
+// Same member names and function pointer types as NvDsBaseMeta / NvDsUserMeta / GList
+typedef void *(*StubCopyFunc)(void *data, void *user_data);
+typedef void (*StubReleaseFunc)(void *data, void *user_data);
+
+struct StubBaseMeta {
+    void *batch_meta;
+    int meta_type;
+    void *uContext;
+    StubCopyFunc copy_func;
+    StubReleaseFunc release_func;
+};
+
+struct StubUserMeta {
+    StubBaseMeta base_meta;
+    void *user_meta_data;
+};
+
+struct StubList {
+    void *data;
+    StubList *next;
+};
+
+// What nvds_copy_batch_meta does for a user meta: copy the payload, keep the type and the functions
+static StubUserMeta copyUserMeta(const StubUserMeta &src) {
+    StubUserMeta dst = src;
+    dst.user_meta_data = src.base_meta.copy_func(const_cast<StubUserMeta *>(&src), nullptr);
+    return dst;
+}
+
+static void checkLifecycle() {
+    const int meta_type = 4097;
+    const int objects = 1000;
+    std::vector<StubUserMeta> metas(objects), copies;
+    std::vector<StubList> list(objects);
+    copies.reserve(objects);
+    int64_t baseline = liveAllocations();
+
+    for (int i = 0; i < objects; ++i) {
+        WorldCoordMeta payload = {WORLD_COORD_META_VERSION, 3, 0.5f * i, -0.25f * i, 0.0f, {0.01f, 0.0f, 0.0f, 0.02f}};
+        std::memset(&metas[i], 0, sizeof(StubUserMeta));
+        setWorldCoordUserMeta(&metas[i], meta_type, payload);
+        list[i].data = &metas[i];
+        list[i].next = i + 1 < objects ? &list[i + 1] : nullptr;
+    }
+    CHECK(liveAllocations() - baseline == objects);
+
+    // Lookup by type, payload memcpy'd out like a message converter does
+    const WorldCoordMeta *found = findWorldCoordMeta<StubUserMeta>(&list[0], meta_type);
+    CHECK(found != nullptr);
+    CHECK(findWorldCoordMeta<StubUserMeta>(&list[0], meta_type + 1) == nullptr);
+    WorldCoordMeta flat;
+    std::memcpy(&flat, found, sizeof(flat));
+    CHECK(flat.version == WORLD_COORD_META_VERSION && flat.camera_id == 3 && flat.x == 0.0f && flat.cov[3] == 0.02f);
+
+    // Copy (tee / batch meta copy) then release both sets
+    for (const StubUserMeta &meta : metas)
+        copies.push_back(copyUserMeta(meta));
+    CHECK(liveAllocations() - baseline == 2 * objects);
+
+    for (int i = 0; i < objects; ++i) {
+        const WorldCoordMeta *a = static_cast<const WorldCoordMeta *>(metas[i].user_meta_data);
+        const WorldCoordMeta *b = static_cast<const WorldCoordMeta *>(copies[i].user_meta_data);
+        CHECK(a != b && std::memcmp(a, b, sizeof(WorldCoordMeta)) == 0);
+    }
+
+    for (StubUserMeta &meta : metas) {
+        meta.base_meta.release_func(&meta, nullptr);
+        CHECK(meta.user_meta_data == nullptr);
+    }
+    for (StubUserMeta &meta : copies)
+        meta.base_meta.release_func(&meta, nullptr);
+
+    CHECK(liveAllocations() == baseline);
+    std::printf("lifecycle: %d objects attached, copied and released, %lld payloads leaked\n", objects,
+                static_cast<long long>(liveAllocations() - baseline));
+}
+
+static void checkCovariance() {
+    CameraModel cam;
+    cam.width = 1920;
+    cam.height = 1080;
+    cam.fx = cam.fy = 1400.0;
+    cam.cx = 960.0;
+    cam.cy = 540.0;
+    cam.k1 = -0.2;
+    rotationFromEuler(-30.0, 180.0, -90.0, cam.r);
+    cam.tz = 4.0;
+
+    GroundLut lut;
+    CHECK(lut.build(cam, 4));
+
+    // Jacobian of the interpolant against central differences of the exact mapping
+    double max_rel = 0.0;
+    const float h = 0.5f;
+    for (float v = 700.0f; v < 1080.0f; v += 37.0f) {
+        for (float u = 20.0f; u < 1900.0f; u += 53.0f) {
+            float j[4];
+            double xp, yp, xm, ym, xq, yq, xn, yn;
+            if (!lut.jacobian(u, v, j) || !pixelToGround(cam, u + h, v, 0.0, xp, yp) ||
+                !pixelToGround(cam, u - h, v, 0.0, xm, ym) || !pixelToGround(cam, u, v + h, 0.0, xq, yq) ||
+                !pixelToGround(cam, u, v - h, 0.0, xn, yn))
+                continue;
+            double ref[4] = {(xp - xm) / (2 * h), (xq - xn) / (2 * h), (yp - ym) / (2 * h), (yq - yn) / (2 * h)};
+            double norm = std::sqrt(ref[0] * ref[0] + ref[1] * ref[1] + ref[2] * ref[2] + ref[3] * ref[3]);
+            for (int k = 0; k < 4; ++k)
+                max_rel = std::max(max_rel, std::fabs(j[k] - ref[k]) / norm);
+
+            float cov[4];
+            worldCovariance(j, 1.0f, cov);
+            CHECK(cov[0] >= 0.0f && cov[3] >= 0.0f && cov[1] == cov[2]);
+            CHECK(cov[0] * cov[3] - cov[1] * cov[2] >= -1e-12f);
+        }
+    }
+    CHECK(max_rel < 0.05);
+    std::printf("covariance: LUT Jacobian max relative error %.4f against central differences\n", max_rel);
+}
+
+int main() {
+    checkLifecycle();
+    checkCovariance();
+
+    return checkResult();
+}
@@ -0,0 +1,116 @@
+// apps/real_world_overlay/tools/zone_engine_bench.cpp
+// Zone engine cost on synthetic crowds: objects random-walking in a 120 x 60 m scene around a few crowd centres,
+// star-shaped zones (half of them concave) scattered over it. Times one frame of zone lookups with the grid against a
+// naive point-in-polygon pass over every zone, and the full ZoneEngine update (lookups plus accumulators).
+//   zone_engine_bench [objects] [zones] [frames] [cell m]     defaults: 500 32 900 0.25
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "zone_engine.hpp"
+
+static double nowUs() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char *argv[]) {
+    int objects = argc > 1 ? std::atoi(argv[1]) : 500;
+    int zone_count = argc > 2 ? std::atoi(argv[2]) : 32;
+    int frames = argc > 3 ? std::atoi(argv[3]) : 900;
+    float cell = argc > 4 ? static_cast<float>(std::atof(argv[4])) : 0.25f;
+    if (objects < 1 || zone_count < 1 || zone_count > static_cast<int>(kMaxZones) || frames < 1 || !(cell > 0.0f)) {
+        std::fprintf(stderr, "usage: %s [objects] [zones 1-%zu] [frames] [cell m]\n", argv[0], kMaxZones);
+        return 2;
+    }
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> ux(0.0f, 120.0f), uy(0.0f, 60.0f), unit(0.0f, 1.0f);
+    std::vector<ZoneConfig> zones;
+    for (int i = 0; i < zone_count; ++i) {
+        ZoneConfig z;
+        z.name = "z" + std::to_string(i);
+        z.intrusion = i % 4 == 0;
+        z.max_dwell_s = 10.0;
+        float cx = ux(rng), cy = uy(rng), r = 2.0f + 6.0f * unit(rng);
+        int points = 6 + static_cast<int>(rng() % 10);
+        for (int k = 0; k < points; ++k) {
+            float a = 6.2831853f * static_cast<float>(k) / static_cast<float>(points);
+            float rk = i % 2 && k % 2 ? r * 0.5f : r;
+            z.polygon.emplace_back(cx + rk * std::cos(a), cy + rk * std::sin(a));
+        }
+        zones.push_back(z);
+    }
+
+    ZoneEngine engine;
+    ZoneEngineConfig cfg;
+    cfg.cell = cell;
+    std::string error;
+    double t0 = nowUs();
+    if (!engine.configure(zones, cfg, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    const ZoneGrid &grid = engine.grid();
+    std::printf("grid: %d zones, %zux%zu cells of %.2f m, %.1f%% edge cells, built in %.1f ms\n", zone_count,
+                grid.columns(), grid.rows(), grid.cellSize(), 100.0 * grid.edgeCellFraction(), (nowUs() - t0) / 1e3);
+
+    // Crowds: every object drifts around one of 6 centres
+    std::normal_distribution<float> spread(0.0f, 8.0f), step(0.0f, 0.15f);
+    std::vector<float> cx(6), cy(6);
+    for (int c = 0; c < 6; ++c) {
+        cx[c] = ux(rng);
+        cy[c] = uy(rng);
+    }
+    std::vector<float> x(objects), y(objects);
+    for (int i = 0; i < objects; ++i) {
+        x[i] = cx[i % 6] + spread(rng);
+        y[i] = cy[i % 6] + spread(rng);
+    }
+
+    double grid_us = 0.0, naive_us = 0.0, engine_us = 0.0;
+    uint64_t tests = 0, grid_hits = 0, naive_hits = 0, events = 0;
+    uint64_t mask[kZoneWords];
+    for (int f = 0; f < frames; ++f) {
+        for (int i = 0; i < objects; ++i) {
+            x[i] += step(rng);
+            y[i] += step(rng);
+        }
+
+        double a = nowUs();
+        for (int i = 0; i < objects; ++i) {
+            tests += grid.lookup(x[i], y[i], mask);
+            for (size_t w = 0; w < grid.words(); ++w)
+                grid_hits += static_cast<uint64_t>(__builtin_popcountll(mask[w]));
+        }
+        double b = nowUs();
+        for (int i = 0; i < objects; ++i) {
+            for (int z = 0; z < zone_count; ++z)
+                naive_hits += grid.contains(static_cast<size_t>(z), x[i], y[i]);
+        }
+        double c = nowUs();
+        engine.beginFrame(0, static_cast<uint64_t>(f) * 33333333ULL);
+        for (int i = 0; i < objects; ++i)
+            engine.add(static_cast<uint64_t>(i), x[i], y[i]);
+        engine.endFrame();
+        events += engine.events().size();
+        double d = nowUs();
+
+        grid_us += b - a;
+        naive_us += c - b;
+        engine_us += d - c;
+    }
+
+    double lookups = static_cast<double>(objects) * frames;
+    std::printf("%d objects x %d frames: %.3f exact tests per lookup, %.2f zones per object (naive %.2f)\n", objects,
+                frames, tests / lookups, grid_hits / lookups, naive_hits / lookups);
+    std::printf("grid lookups   %8.1f us/frame  %6.1f ns/object\n", grid_us / frames, grid_us * 1e3 / lookups);
+    std::printf("naive PIP      %8.1f us/frame  %6.1f ns/object  (%.1fx)\n", naive_us / frames,
+                naive_us * 1e3 / lookups, naive_us / grid_us);
+    std::printf("engine update  %8.1f us/frame  %6.1f ns/object  (%llu events)\n", engine_us / frames,
+                engine_us * 1e3 / lookups, static_cast<unsigned long long>(events));
+    return grid_hits == naive_hits ? 0 : 1;
+}
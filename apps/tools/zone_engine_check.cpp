@@ -0,0 +1,219 @@
+// apps/real_world_overlay/tools/zone_engine_check.cpp
+// Checks of the zone engine: grid lookups against the exact point-in-polygon test for convex, concave and sliver
+// zones at several cell sizes (more than 64 zones included), [[zone]] parsing, and the accumulators: occupancy across
+// sources, entries, exits with dwell, intrusion and loitering alerts, lost objects. Exits non-zero on failure.
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "zone_engine.hpp"
+#include "tools/check.hpp"
+
+// Star-shaped polygon: convex for spikes = 0, concave otherwise
+static ZoneConfig starZone(std::mt19937 &rng, float cx, float cy, float radius, int points, float spikes) {
+    std::uniform_real_distribution<float> jitter(0.0f, 0.3f);
+    ZoneConfig z;
+    for (int i = 0; i < points; ++i) {
+        float a = 6.2831853f * static_cast<float>(i) / static_cast<float>(points);
+        float r = radius * (1.0f - jitter(rng) * (spikes > 0.0f ? 1.0f : 0.0f)) * (i % 2 ? 1.0f - spikes : 1.0f);
+        z.polygon.emplace_back(cx + r * std::cos(a), cy + r * std::sin(a));
+    }
+    return z;
+}
+
+static std::vector<ZoneConfig> randomZones(std::mt19937 &rng, size_t count) {
+    std::uniform_real_distribution<float> pos(0.0f, 60.0f), radius(0.5f, 8.0f);
+    std::vector<ZoneConfig> zones;
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 7 == 6) {
+            // Thin sliver, narrower than a cell
+            float x = pos(rng), y = pos(rng);
+            zones.push_back(ZoneConfig{"", {{x, y}, {x + 9.0f, y + 3.0f}, {x + 9.05f, y + 3.1f}}});
+        } else {
+            zones.push_back(starZone(rng, pos(rng), pos(rng), radius(rng), 5 + static_cast<int>(rng() % 10),
+                                     i % 2 ? 0.5f : 0.0f));
+        }
+        zones.back().name = "z" + std::to_string(i);
+    }
+    return zones;
+}
+
+static void checkGrid(size_t zone_count, float cell) {
+    std::mt19937 rng(static_cast<unsigned>(zone_count * 1000 + cell * 100));
+    std::vector<ZoneConfig> zones = randomZones(rng, zone_count);
+    ZoneGrid grid;
+    std::string error;
+    CHECK(grid.build(zones, cell, error));
+
+    std::uniform_real_distribution<float> pos(-10.0f, 75.0f);
+    uint64_t mask[kZoneWords];
+    size_t tests = 0, mismatches = 0, points = 200000;
+    for (size_t p = 0; p < points; ++p) {
+        float x = pos(rng), y = pos(rng);
+        if (p % 4 == 0) {
+            // On or next to a vertex, where cell borders and edges meet
+            const ZoneConfig &z = zones[rng() % zones.size()];
+            const auto &v = z.polygon[rng() % z.polygon.size()];
+            x = v.first + (p % 8 == 0 ? 0.0f : 1e-3f);
+            y = v.second;
+        }
+        tests += grid.lookup(x, y, mask);
+        for (size_t z = 0; z < zones.size(); ++z)
+            mismatches += ((mask[z / 64] >> (z % 64)) & 1) != static_cast<uint64_t>(grid.contains(z, x, y));
+    }
+    CHECK(mismatches == 0);
+    std::printf("grid: %3zu zones, cell %.2f m, %zux%zu cells, %.1f%% edge cells, %.3f exact tests per lookup, "
+                "%zu mismatches\n",
+                zone_count, grid.cellSize(), grid.columns(), grid.rows(), 100.0 * grid.edgeCellFraction(),
+                static_cast<double>(tests) / points, mismatches);
+}
+
+static void checkOffGrid() {
+    ZoneGrid grid;
+    std::string error;
+    CHECK(grid.build({ZoneConfig{"a", {{0, 0}, {10, 0}, {10, 10}, {0, 10}}}}, 0.5f, error));
+    uint64_t mask[kZoneWords] = {~0ull};
+    grid.lookup(1e6f, 5.0f, mask);
+    CHECK(mask[0] == 0);
+    mask[0] = ~0ull;
+    grid.lookup(NAN, 5.0f, mask);
+    CHECK(mask[0] == 0);
+    grid.lookup(5.0f, 5.0f, mask);
+    CHECK(mask[0] == 1);
+
+    CHECK(!grid.build({}, 0.5f, error));
+    CHECK(!grid.build({ZoneConfig{"a", {{0, 0}, {1, 0}, {1, 1}}}}, 0.0f, error));
+
+    // A huge zone at a tiny cell size grows the cell instead of the grid
+    CHECK(grid.build({ZoneConfig{"a", {{0, 0}, {5000, 0}, {5000, 5000}}}}, 0.01f, error));
+    CHECK(grid.columns() * grid.rows() <= ZoneGrid::kMaxCells);
+}
+
+static void checkParse() {
+    std::istringstream in(R"(
+[[zone]]
+name = "door"
+polygon = [[0, 0], [4, 0], [4, 2], [0, 2]]
+intrusion = true
+
+[[zone]]
+polygon = [[10, 0], [14, 0], [12, 3]]
+max_dwell = 2.5
+)");
+    toml::table data = toml::parse(in);
+    std::vector<ZoneConfig> zones;
+    std::string error;
+    CHECK(parseZones(data, zones, error));
+    CHECK(zones.size() == 2);
+    CHECK(zones.size() == 2 && zones[0].name == "door" && zones[0].intrusion && zones[0].polygon.size() == 4);
+    CHECK(zones.size() == 2 && zones[1].name == "zone1" && !zones[1].intrusion && zones[1].max_dwell_s == 2.5);
+
+    std::istringstream bad("[[zone]]\npolygon = [[0, 0], [1, 1]]\n");
+    data = toml::parse(bad);
+    CHECK(!parseZones(data, zones, error));
+    CHECK(!error.empty());
+
+    std::istringstream none("tiles = [2, 2]\n");
+    data = toml::parse(none);
+    CHECK(parseZones(data, zones, error) && zones.empty());
+}
+
+static size_t countEvents(const ZoneEngine &engine, ZoneEventKind kind) {
+    size_t n = 0;
+    for (const ZoneEvent &e : engine.events())
+        n += e.kind == kind;
+    return n;
+}
+
+static void checkAccumulators() {
+    std::vector<ZoneConfig> zones = {
+        ZoneConfig{"door", {{0, 0}, {4, 0}, {4, 4}, {0, 4}}, true, 0.0},
+        ZoneConfig{"queue", {{2, 0}, {10, 0}, {10, 4}, {2, 4}}, false, 2.0},
+    };
+    ZoneEngineConfig cfg;
+    cfg.lost_s = 1.0;
+    ZoneEngine engine;
+    std::string error;
+    CHECK(engine.configure(zones, cfg, error));
+    const uint64_t s = 1000000000ULL;
+
+    // Object 7 on source 0 walks from outside through the door into the queue; two untracked objects on source 1
+    float path[] = {-2.0f, 1.0f, 3.0f, 6.0f, 6.0f, 6.0f, 6.0f, 12.0f};
+    for (int f = 0; f < 8; ++f) {
+        engine.beginFrame(0, f * s);
+        engine.add(7, path[f], 2.0f);
+        engine.endFrame();
+        if (f == 1) {
+            CHECK(countEvents(engine, ZoneEventKind::Enter) == 1);
+            CHECK(countEvents(engine, ZoneEventKind::Intrusion) == 1);
+        }
+        if (f == 2)
+            CHECK(countEvents(engine, ZoneEventKind::Enter) == 1);  // into the queue, still in the door
+        if (f == 3)
+            CHECK(countEvents(engine, ZoneEventKind::Exit) == 1 && engine.events()[0].dwell_s == 2.0);
+        if (f == 4)
+            CHECK(countEvents(engine, ZoneEventKind::Loiter) == 1);  // 2 s in the queue
+        if (f == 5 || f == 6)
+            CHECK(countEvents(engine, ZoneEventKind::Loiter) == 0);
+
+        engine.beginFrame(1, f * s);
+        engine.add(ZONE_NO_ID, 5.0f, 1.0f);
+        engine.add(ZONE_NO_ID, 3.0f, 1.0f);
+        engine.endFrame();
+        CHECK(engine.events().empty());
+    }
+
+    ZoneCounters door = engine.counters(0), queue = engine.counters(1);
+    CHECK(door.entries == 1 && door.exits == 1 && door.intrusions == 1 && door.dwell_count == 1);
+    CHECK(std::fabs(door.dwell_sum_s - 2.0) < 1e-9);
+    CHECK(queue.entries == 1 && queue.exits == 1 && queue.intrusions == 0 && queue.loiters == 1);
+    CHECK(std::fabs(queue.dwell_max_s - 5.0) < 1e-9);
+    CHECK(door.occupancy == 1 && queue.occupancy == 2);  // source 1's objects, object 7 left
+    CHECK(engine.trackedObjects() == 1);
+
+    // Another visitor loiters, alerted once
+    size_t loiters = 0;
+    for (int f = 0; f < 6; ++f) {
+        engine.beginFrame(0, (10 + f) * s);
+        engine.add(9, 6.0f, 2.0f);
+        engine.endFrame();
+        loiters += countEvents(engine, ZoneEventKind::Loiter);
+    }
+    CHECK(loiters == 1);
+    CHECK(engine.counters(1).loiters == 2);
+    CHECK(engine.counters(1).occupancy == 3);
+
+    // Source 0 stops seeing it: it leaves the queue lost_s later, dwell up to the last sighting
+    engine.beginFrame(0, 17 * s);
+    engine.endFrame();
+    CHECK(engine.counters(1).exits == 2);
+    CHECK(std::fabs(engine.counters(1).dwell_sum_s - 10.0) < 1e-9);
+    CHECK(engine.counters(1).occupancy == 2);
+    CHECK(engine.trackedObjects() == 0);
+
+    // The same id on two sources is two objects
+    engine.beginFrame(0, 20 * s);
+    engine.add(5, 1.0f, 1.0f);
+    engine.endFrame();
+    engine.beginFrame(1, 20 * s);
+    engine.add(5, 1.0f, 1.0f);
+    engine.endFrame();
+    CHECK(engine.trackedObjects() == 2);
+    CHECK(engine.counters(0).entries == 3);
+}
+
+int main() {
+    checkGrid(12, 0.25f);
+    checkGrid(12, 1.0f);
+    checkGrid(40, 0.5f);
+    checkGrid(100, 0.5f);
+    checkGrid(256, 2.0f);
+    checkOffGrid();
+    checkParse();
+    checkAccumulators();
+
+    return checkResult();
+}
@@ -0,0 +1,463 @@
+// apps/real_world_overlay/tracker.hpp
+// IoU multi-object tracker run in the probe: SORT's constant-velocity Kalman prediction with ByteTrack's two-stage
+// association. Detections above high_threshold are matched to every track first; the low-confidence ones are then
+// matched to the confirmed tracks still unmatched, so partly occluded objects keep their identity. Only
+// high-confidence detections start tracks. On frames nvinfer skipped (interval > 0) the tracks are only predicted and
+// the confirmed ones stand in for the detections.
+//
+// Tracks live in a fixed-capacity pool and every work buffer is sized at construction: update() and predict() do not
+// allocate. Boxes are in nvstreammux pixels, time is counted in frames.
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+constexpr uint64_t TRACKER_NO_ID = ~0ULL;  // DeepStream's UNTRACKED_OBJECT_ID
+
+struct TrackBox {
+    float left = 0.0f, top = 0.0f, width = 0.0f, height = 0.0f;
+};
+
+struct TrackerDetection {
+    TrackBox box;
+    int32_t class_id = 0;
+    float confidence = 0.0f;
+    uint64_t track_id = TRACKER_NO_ID;  // set by update() when the detection belongs to a confirmed track
+};
+
+struct TrackOutput {
+    TrackBox box;
+    int32_t class_id;
+    float confidence;         // of the last matched detection
+    uint64_t track_id;
+    int frames_since_update;  // 0 = matched on this frame
+};
+
+enum class TrackerAssociation { Greedy, Hungarian };
+
+inline bool parseTrackerAssociation(const std::string &name, TrackerAssociation &out) {
+    if (name == "greedy") {
+        out = TrackerAssociation::Greedy;
+    } else if (name == "hungarian") {
+        out = TrackerAssociation::Hungarian;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline const char *trackerAssociationName(TrackerAssociation a) {
+    return a == TrackerAssociation::Greedy ? "greedy" : "hungarian";
+}
+
+struct TrackerConfig {
+    int capacity = 256;          // tracks
+    int max_detections = 256;    // per frame, the rest stay untracked
+    float high_threshold = 0.5f;
+    float low_threshold = 0.1f;  // detections below are ignored
+    float iou_threshold = 0.3f;  // first stage; the low-confidence stage needs at least 0.5
+    int min_hits = 2;            // matched detections before a track is confirmed
+    int max_age = 30;            // frames without a match before a track is deleted
+    int max_coast = 6;           // frames a confirmed track is still output without a match
+    TrackerAssociation association = TrackerAssociation::Greedy;
+};
+
+inline float trackIou(const TrackBox &a, const TrackBox &b) {
+    float w = std::min(a.left + a.width, b.left + b.width) - std::max(a.left, b.left);
+    float h = std::min(a.top + a.height, b.top + b.height) - std::max(a.top, b.top);
+    if (w <= 0.0f || h <= 0.0f)
+        return 0.0f;
+    float inter = w * h;
+    return inter / (a.width * a.height + b.width * b.height - inter);
+}
+
+namespace tracker_detail {
+
+// One coordinate of the constant-velocity model. The box state (cx, cy, w, h and their velocities) has
+// block-diagonal noise, so four independent 2x2 filters are the full 8-state filter.
+struct KalmanAxis {
+    float x, v;           // position, velocity per frame
+    float p00, p01, p11;  // covariance
+
+    void init(float z, float pos_var, float vel_var) {
+        x = z;
+        v = 0.0f;
+        p00 = pos_var;
+        p01 = 0.0f;
+        p11 = vel_var;
+    }
+
+    // x += v; P = F P F^T + Q
+    void predict(float q_pos, float q_vel) {
+        x += v;
+        p00 += 2.0f * p01 + p11 + q_pos;
+        p01 += p11;
+        p11 += q_vel;
+    }
+
+    void update(float z, float r) {
+        float s = p00 + r;
+        float k0 = p00 / s, k1 = p01 / s;
+        float y = z - x;
+        x += k0 * y;
+        v += k1 * y;
+        p11 -= k1 * p01;
+        p01 -= k0 * p01;
+        p00 -= k0 * p00;
+    }
+};
+
+// Noise relative to the box height, as in ByteTrack
+constexpr float kStdPosition = 1.0f / 20.0f;
+constexpr float kStdVelocity = 1.0f / 160.0f;
+
+struct Track {
+    KalmanAxis axis[4];  // cx, cy, w, h
+    uint64_t id;
+    int32_t class_id;
+    float confidence;
+    int hits;
+    int since_update;
+    bool confirmed;
+    bool matched;  // during update()
+
+    TrackBox box() const {
+        float w = std::max(axis[2].x, 1.0f), h = std::max(axis[3].x, 1.0f);
+        return TrackBox{axis[0].x - w / 2.0f, axis[1].x - h / 2.0f, w, h};
+    }
+
+    float scale() const { return std::max(axis[3].x, 1.0f); }
+};
+
+}  // namespace tracker_detail
+
+class Tracker {
+public:
+    // Track ids are first_id, first_id + 1, ...
+    explicit Tracker(const TrackerConfig &cfg = TrackerConfig(), uint64_t first_id = 1)
+        : cfg_(cfg), next_id_(first_id) {
+        cfg_.capacity = std::max(cfg_.capacity, 1);
+        cfg_.max_detections = std::max(cfg_.max_detections, 1);
+        size_t tracks = static_cast<size_t>(cfg_.capacity), dets = static_cast<size_t>(cfg_.max_detections);
+        pool_.resize(tracks);
+        active_.reserve(tracks);
+        free_.reserve(tracks);
+        for (size_t i = tracks; i-- > 0;)
+            free_.push_back(static_cast<uint32_t>(i));
+        rows_.resize(tracks);
+        cols_.resize(dets);
+        det_track_.resize(dets);
+        iou_.resize(tracks * dets);
+        pairs_.resize(tracks * dets);
+        row_match_.resize(tracks);
+        size_t n = std::max(tracks, dets) + 1;
+        u_.resize(n);
+        v_.resize(n);
+        minv_.resize(n);
+        p_.resize(n);
+        way_.resize(n);
+        used_.resize(n);
+    }
+
+    // Frame with inference. Detections past max_detections are left untracked.
+    void update(TrackerDetection *dets, size_t n) {
+        using namespace tracker_detail;
+        n = std::min(n, static_cast<size_t>(cfg_.max_detections));
+        predictAll();
+        for (size_t i = 0; i < n; ++i) {
+            dets[i].track_id = TRACKER_NO_ID;
+            det_track_[i] = -1;
+        }
+
+        // Stage 1: confident detections against every track
+        size_t rows = 0, cols = 0;
+        for (uint32_t t : active_)
+            rows_[rows++] = t;
+        for (size_t i = 0; i < n; ++i) {
+            if (dets[i].confidence >= cfg_.high_threshold)
+                cols_[cols++] = static_cast<uint32_t>(i);
+        }
+        associate(dets, rows, cols, cfg_.iou_threshold);
+
+        // Stage 2: low-confidence detections against the confirmed tracks left over
+        rows = cols = 0;
+        for (uint32_t t : active_) {
+            if (pool_[t].confirmed && !pool_[t].matched)
+                rows_[rows++] = t;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (dets[i].confidence >= cfg_.low_threshold && dets[i].confidence < cfg_.high_threshold)
+                cols_[cols++] = static_cast<uint32_t>(i);
+        }
+        associate(dets, rows, cols, std::max(cfg_.iou_threshold, 0.5f));
+
+        // Unmatched tentative tracks were one-frame false positives
+        for (size_t k = 0; k < active_.size();) {
+            Track &t = pool_[active_[k]];
+            if (!t.matched && !t.confirmed) {
+                release(k);
+                continue;
+            }
+            ++k;
+        }
+
+        // New tracks from the confident detections nobody claimed
+        for (size_t i = 0; i < n; ++i) {
+            if (det_track_[i] >= 0 || dets[i].confidence < cfg_.high_threshold)
+                continue;
+            if (free_.empty()) {
+                ++pool_full_;
+                continue;
+            }
+            uint32_t slot = free_.back();
+            free_.pop_back();
+            active_.push_back(slot);
+            start(pool_[slot], dets[i]);
+            det_track_[i] = static_cast<int32_t>(slot);
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            if (det_track_[i] >= 0 && pool_[det_track_[i]].confirmed)
+                dets[i].track_id = pool_[det_track_[i]].id;
+        }
+        expire();
+    }
+
+    // Frame without inference
+    void predict() {
+        predictAll();
+        expire();
+    }
+
+    // Confirmed tracks matched within max_coast frames; returns how many were written
+    size_t output(TrackOutput *out, size_t max) const {
+        size_t n = 0;
+        for (uint32_t slot : active_) {
+            const tracker_detail::Track &t = pool_[slot];
+            if (!t.confirmed || t.since_update > cfg_.max_coast)
+                continue;
+            if (n == max)
+                break;
+            out[n++] = TrackOutput{t.box(), t.class_id, t.confidence, t.id, t.since_update};
+        }
+        return n;
+    }
+
+    const TrackerConfig &config() const { return cfg_; }
+    size_t active() const { return active_.size(); }
+    uint64_t created() const { return created_; }
+    uint64_t poolFull() const { return pool_full_; }
+
+private:
+    void predictAll() {
+        using namespace tracker_detail;
+        for (uint32_t slot : active_) {
+            Track &t = pool_[slot];
+            float s = t.scale();
+            float q_pos = (kStdPosition * s) * (kStdPosition * s);
+            float q_vel = (kStdVelocity * s) * (kStdVelocity * s);
+            for (KalmanAxis &a : t.axis)
+                a.predict(q_pos, q_vel);
+            ++t.since_update;
+            t.matched = false;
+        }
+    }
+
+    void expire() {
+        for (size_t k = 0; k < active_.size();) {
+            if (pool_[active_[k]].since_update > cfg_.max_age) {
+                release(k);
+                continue;
+            }
+            ++k;
+        }
+    }
+
+    void release(size_t k) {
+        free_.push_back(active_[k]);
+        active_[k] = active_.back();
+        active_.pop_back();
+    }
+
+    void start(tracker_detail::Track &t, const TrackerDetection &d) {
+        using namespace tracker_detail;
+        float s = std::max(d.box.height, 1.0f);
+        float pos_var = (2.0f * kStdPosition * s) * (2.0f * kStdPosition * s);
+        float vel_var = (10.0f * kStdVelocity * s) * (10.0f * kStdVelocity * s);
+        t.axis[0].init(d.box.left + d.box.width / 2.0f, pos_var, vel_var);
+        t.axis[1].init(d.box.top + d.box.height / 2.0f, pos_var, vel_var);
+        t.axis[2].init(d.box.width, pos_var, vel_var);
+        t.axis[3].init(d.box.height, pos_var, vel_var);
+        t.id = next_id_++;
+        t.class_id = d.class_id;
+        t.confidence = d.confidence;
+        t.hits = 1;
+        t.since_update = 0;
+        t.confirmed = cfg_.min_hits <= 1;
+        t.matched = true;
+        ++created_;
+    }
+
+    void correct(tracker_detail::Track &t, const TrackerDetection &d) {
+        using namespace tracker_detail;
+        float s = t.scale();
+        float r = (kStdPosition * s) * (kStdPosition * s);
+        t.axis[0].update(d.box.left + d.box.width / 2.0f, r);
+        t.axis[1].update(d.box.top + d.box.height / 2.0f, r);
+        t.axis[2].update(d.box.width, r);
+        t.axis[3].update(d.box.height, r);
+        t.confidence = d.confidence;
+        t.since_update = 0;
+        t.matched = true;
+        t.confirmed = t.confirmed || ++t.hits >= cfg_.min_hits;
+    }
+
+    // Matches rows_[0, rows) (track slots) to cols_[0, cols) (detection indices) of the same class with IoU >= min_iou
+    void associate(TrackerDetection *dets, size_t rows, size_t cols, float min_iou) {
+        if (rows == 0 || cols == 0)
+            return;
+        for (size_t r = 0; r < rows; ++r) {
+            const tracker_detail::Track &t = pool_[rows_[r]];
+            TrackBox box = t.box();
+            for (size_t c = 0; c < cols; ++c) {
+                const TrackerDetection &d = dets[cols_[c]];
+                iou_[r * cols + c] = d.class_id == t.class_id ? trackIou(box, d.box) : 0.0f;
+            }
+            row_match_[r] = -1;
+        }
+
+        if (cfg_.association == TrackerAssociation::Hungarian) {
+            hungarian(rows, cols);
+        } else {
+            greedy(rows, cols, min_iou);
+        }
+
+        for (size_t r = 0; r < rows; ++r) {
+            int32_t c = row_match_[r];
+            if (c < 0 || iou_[r * cols + c] < min_iou)
+                continue;
+            uint32_t slot = rows_[r], det = cols_[c];
+            correct(pool_[slot], dets[det]);
+            det_track_[det] = static_cast<int32_t>(slot);
+        }
+    }
+
+    // Highest IoU first
+    void greedy(size_t rows, size_t cols, float min_iou) {
+        size_t n = 0;
+        for (size_t r = 0; r < rows; ++r) {
+            for (size_t c = 0; c < cols; ++c) {
+                float iou = iou_[r * cols + c];
+                if (iou >= min_iou)
+                    pairs_[n++] = Pair{iou, static_cast<uint32_t>(r), static_cast<uint32_t>(c)};
+            }
+        }
+        std::sort(pairs_.begin(), pairs_.begin() + n, [](const Pair &a, const Pair &b) {
+            return a.iou > b.iou || (a.iou == b.iou && (a.r < b.r || (a.r == b.r && a.c < b.c)));
+        });
+        for (size_t k = 0; k < cols; ++k)
+            used_[k] = 0;
+        for (size_t k = 0; k < n; ++k) {
+            const Pair &p = pairs_[k];
+            if (row_match_[p.r] >= 0 || used_[p.c])
+                continue;
+            row_match_[p.r] = static_cast<int32_t>(p.c);
+            used_[p.c] = 1;
+        }
+    }
+
+    // Minimum total (1 - IoU) assignment, O(n^2 m) shortest augmenting paths over the smaller side. Pairs below the
+    // IoU threshold are dropped afterwards, as in SORT.
+    void hungarian(size_t rows, size_t cols) {
+        bool transposed = rows > cols;
+        size_t n = transposed ? cols : rows, m = transposed ? rows : cols;
+        auto cost = [&](size_t i, size_t j) {
+            return 1.0f - (transposed ? iou_[j * cols + i] : iou_[i * cols + j]);
+        };
+        const float inf = std::numeric_limits<float>::infinity();
+        for (size_t j = 0; j <= m; ++j) {
+            v_[j] = 0.0f;
+            p_[j] = 0;
+        }
+        for (size_t i = 0; i <= n; ++i)
+            u_[i] = 0.0f;
+
+        for (size_t i = 1; i <= n; ++i) {
+            p_[0] = static_cast<uint32_t>(i);
+            size_t j0 = 0;
+            for (size_t j = 0; j <= m; ++j) {
+                minv_[j] = inf;
+                used_[j] = 0;
+            }
+            do {
+                used_[j0] = 1;
+                size_t i0 = p_[j0], j1 = 0;
+                float delta = inf;
+                for (size_t j = 1; j <= m; ++j) {
+                    if (used_[j])
+                        continue;
+                    float cur = cost(i0 - 1, j - 1) - u_[i0] - v_[j];
+                    if (cur < minv_[j]) {
+                        minv_[j] = cur;
+                        way_[j] = static_cast<uint32_t>(j0);
+                    }
+                    if (minv_[j] < delta) {
+                        delta = minv_[j];
+                        j1 = j;
+                    }
+                }
+                for (size_t j = 0; j <= m; ++j) {
+                    if (used_[j]) {
+                        u_[p_[j]] += delta;
+                        v_[j] -= delta;
+                    } else {
+                        minv_[j] -= delta;
+                    }
+                }
+                j0 = j1;
+            } while (p_[j0] != 0);
+            do {
+                size_t j1 = way_[j0];
+                p_[j0] = p_[j1];
+                j0 = j1;
+            } while (j0 != 0);
+        }
+
+        for (size_t j = 1; j <= m; ++j) {
+            if (p_[j] == 0)
+                continue;
+            size_t i = p_[j] - 1;
+            if (transposed) {
+                row_match_[j - 1] = static_cast<int32_t>(i);
+            } else {
+                row_match_[i] = static_cast<int32_t>(j - 1);
+            }
+        }
+    }
+
+    struct Pair {
+        float iou;
+        uint32_t r, c;
+    };
+
+    TrackerConfig cfg_;
+    uint64_t next_id_;
+    uint64_t created_ = 0;
+    uint64_t pool_full_ = 0;
+
+    std::vector<tracker_detail::Track> pool_;
+    std::vector<uint32_t> active_;     // slots in use
+    std::vector<uint32_t> free_;       // slots available
+    std::vector<uint32_t> rows_;       // association candidates: track slots
+    std::vector<uint32_t> cols_;       //   and detection indices
+    std::vector<int32_t> det_track_;   // track slot of each detection, -1 = none
+    std::vector<float> iou_;           // rows x cols
+    std::vector<Pair> pairs_;
+    std::vector<int32_t> row_match_;   // column matched to each row, -1 = none
+    std::vector<float> u_, v_, minv_;  // Hungarian potentials
+    std::vector<uint32_t> p_, way_;
+    std::vector<uint8_t> used_;
+};
@@ -0,0 +1,64 @@
+// apps/real_world_overlay/world_meta.hpp
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+// Object user meta with the world position of the object box centre. Fixed-size POD so message converters and
+// exporters can memcpy it; bump WORLD_COORD_META_VERSION when the layout changes.
+#define WORLD_COORD_META_NAME "REAL_WORLD_OVERLAY.WORLD_COORD"
+constexpr uint32_t WORLD_COORD_META_VERSION = 1;
+
+struct WorldCoordMeta {
+    uint32_t version;
+    uint32_t camera_id;  // NvDsFrameMeta::source_id
+    float x, y, z;       // metres, world frame
+    float cov[4];        // 2x2 covariance of (x, y) in m^2, row-major, NaN when unknown
+};
+
+static_assert(std::is_trivially_copyable<WorldCoordMeta>::value && std::is_standard_layout<WorldCoordMeta>::value,
+              "WorldCoordMeta must stay POD");
+static_assert(sizeof(WorldCoordMeta) == 36, "WorldCoordMeta layout changed, bump WORLD_COORD_META_VERSION");
+
+// Covariance of the ground position for isotropic pixel noise: sigma^2 * J * J^T, J = d(x, y) / d(u, v) row-major
+inline void worldCovariance(const float j[4], float pixel_sigma, float cov[4]) {
+    float s2 = pixel_sigma * pixel_sigma;
+    cov[0] = s2 * (j[0] * j[0] + j[1] * j[1]);
+    cov[1] = s2 * (j[0] * j[2] + j[1] * j[3]);
+    cov[2] = cov[1];
+    cov[3] = s2 * (j[2] * j[2] + j[3] * j[3]);
+}
+
+// Copy and release functions of the user meta. Templated on the user meta type (NvDsUserMeta in the app) so the
+// lifecycle can be exercised with stand-in structs without DeepStream.
+template <typename UserMeta>
+void *copyWorldCoordMeta(void *data, void *) {
+    const UserMeta *user_meta = static_cast<const UserMeta *>(data);
+    return new WorldCoordMeta(*static_cast<const WorldCoordMeta *>(user_meta->user_meta_data));
+}
+
+template <typename UserMeta>
+void releaseWorldCoordMeta(void *data, void *) {
+    UserMeta *user_meta = static_cast<UserMeta *>(data);
+    delete static_cast<WorldCoordMeta *>(user_meta->user_meta_data);
+    user_meta->user_meta_data = nullptr;
+}
+
+// Fills a user meta acquired from the batch meta pool; the caller adds it to the object
+template <typename UserMeta, typename MetaType>
+void setWorldCoordUserMeta(UserMeta *user_meta, MetaType meta_type, const WorldCoordMeta &payload) {
+    user_meta->user_meta_data = new WorldCoordMeta(payload);
+    user_meta->base_meta.meta_type = meta_type;
+    user_meta->base_meta.copy_func = copyWorldCoordMeta<UserMeta>;
+    user_meta->base_meta.release_func = releaseWorldCoordMeta<UserMeta>;
+}
+
+// Finds the payload in an object user meta list (NvDsUserMetaList or a stand-in with data and next)
+template <typename UserMeta, typename List>
+const WorldCoordMeta *findWorldCoordMeta(const List *list, int meta_type) {
+    for (; list != nullptr; list = list->next) {
+        const auto *user_meta = static_cast<const UserMeta *>(list->data);
+        if (user_meta && static_cast<int>(user_meta->base_meta.meta_type) == meta_type)
+            return static_cast<const WorldCoordMeta *>(user_meta->user_meta_data);
+    }
+    return nullptr;
+}
@@ -0,0 +1,478 @@
+// apps/real_world_overlay/zone_engine.hpp
+// Zone analytics on the world coordinates of the detections: per-zone occupancy, entries, dwell time and intrusion /
+// loitering alerts for polygon zones on the ground plane, configured as
+//   [[zone]]  name = "door", polygon = [[x, y], ...] (metres, at least 3 points), intrusion = false, max_dwell = 0 (s)
+//
+// ZoneGrid precomputes a uniform grid over the bounds of all zones. Every cell holds two bitmasks: zones that contain
+// the whole cell and zones whose boundary crosses it. A lookup reads one cell and runs the exact point-in-polygon test
+// only for the crossing zones, so the cost per point does not grow with the number of zones away from their edges.
+//
+// ZoneEngine keeps the accumulators. Occupancy is the number of objects in the zone on the last frame of every source.
+// Entries, exits, dwell and alerts need object ids (the probe tracker or nvtracker): an object enters a zone on the
+// first frame its world point is inside, and leaves on the first frame it is outside or once it has not been seen for
+// `lost_s`. Untracked objects (ZONE_NO_ID) only count towards occupancy.
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <toml.hpp>
+
+constexpr uint64_t ZONE_NO_ID = ~0ULL;  // DeepStream's UNTRACKED_OBJECT_ID
+constexpr size_t kMaxZones = 256;
+constexpr size_t kZoneWords = kMaxZones / 64;
+
+struct ZoneConfig {
+    std::string name;
+    std::vector<std::pair<float, float>> polygon;  // world metres
+    bool intrusion = false;                        // alert on every entry
+    double max_dwell_s = 0.0;                      // alert once an object stays longer, 0 = never
+};
+
+struct ZoneEngineConfig {
+    float cell = 0.25f;   // metres, grown when the zones would need more than kMaxCells cells
+    double lost_s = 1.0;  // a tracked object not seen for this long has left its zones
+};
+
+// Reads the [[zone]] array, if any
+inline bool parseZones(const toml::table &data, std::vector<ZoneConfig> &zones, std::string &error) {
+    zones.clear();
+    error.clear();
+    auto list = data["zone"];
+    if (!list)
+        return true;
+    auto array = list.as_array();
+    if (!array || !array->is_array_of_tables() || array->size() > kMaxZones) {
+        error = "Invalid [[zone]] array in config.toml (at most " + std::to_string(kMaxZones) + " zones)";
+        return false;
+    }
+    for (size_t i = 0; i < array->size(); ++i) {
+        toml::node_view<const toml::node> node(array->at(i));
+        ZoneConfig z;
+        z.name = node["name"].value_or("zone" + std::to_string(i));
+        z.intrusion = node["intrusion"].value_or(z.intrusion);
+        z.max_dwell_s = node["max_dwell"].value_or(z.max_dwell_s);
+        auto polygon = node["polygon"].as_array();
+        for (size_t k = 0; polygon && k < polygon->size(); ++k) {
+            auto point = polygon->at(k).as_array();
+            if (!point || point->size() != 2)
+                break;
+            z.polygon.emplace_back(static_cast<float>(point->at(0).value_or(0.0)),
+                                   static_cast<float>(point->at(1).value_or(0.0)));
+        }
+        if (!polygon || z.polygon.size() != polygon->size() || z.polygon.size() < 3 || z.max_dwell_s < 0.0) {
+            error = "zone " + std::to_string(i) + ": invalid polygon or max_dwell in config.toml (at least 3 [x, y] "
+                    "points)";
+            return false;
+        }
+        zones.push_back(std::move(z));
+    }
+    return true;
+}
+
+namespace zone_engine_detail {
+
+// Crossing number, the same rule for grid cells and exact tests
+inline bool pointInPolygon(const float *xs, const float *ys, size_t n, float x, float y) {
+    bool in = false;
+    for (size_t i = 0, j = n - 1; i < n; j = i++) {
+        if ((ys[i] > y) != (ys[j] > y) && x < (xs[j] - xs[i]) * (y - ys[i]) / (ys[j] - ys[i]) + xs[i])
+            in = !in;
+    }
+    return in;
+}
+
+// Liang-Barsky: does segment (x0, y0)-(x1, y1) touch the closed rectangle?
+inline bool segmentHitsRect(double x0, double y0, double x1, double y1, double rx0, double ry0, double rx1,
+                            double ry1) {
+    double t0 = 0.0, t1 = 1.0;
+    auto clip = [&](double p, double q) {
+        if (p == 0.0)
+            return q >= 0.0;
+        double r = q / p;
+        if (p < 0.0) {
+            if (r > t1)
+                return false;
+            t0 = std::max(t0, r);
+        } else {
+            if (r < t0)
+                return false;
+            t1 = std::min(t1, r);
+        }
+        return true;
+    };
+    double dx = x1 - x0, dy = y1 - y0;
+    return clip(-dx, x0 - rx0) && clip(dx, rx1 - x0) && clip(-dy, y0 - ry0) && clip(dy, ry1 - y0);
+}
+
+}  // namespace zone_engine_detail
+
+class ZoneGrid {
+public:
+    static constexpr size_t kMaxCells = 1u << 20;
+
+    bool build(const std::vector<ZoneConfig> &zones, float cell, std::string &error) {
+        using namespace zone_engine_detail;
+        if (zones.empty() || zones.size() > kMaxZones || !(cell > 0.0f)) {
+            error = "zone grid needs 1 to " + std::to_string(kMaxZones) + " zones and a positive cell size";
+            return false;
+        }
+        zones_ = zones.size();
+        words_ = (zones_ + 63) / 64;
+        xs_.clear();
+        ys_.clear();
+        offsets_.assign(1, 0);
+
+        float x0 = INFINITY, y0 = INFINITY, x1 = -INFINITY, y1 = -INFINITY;
+        for (const ZoneConfig &z : zones) {
+            for (const auto &p : z.polygon) {
+                x0 = std::min(x0, p.first);
+                y0 = std::min(y0, p.second);
+                x1 = std::max(x1, p.first);
+                y1 = std::max(y1, p.second);
+                xs_.push_back(p.first);
+                ys_.push_back(p.second);
+            }
+            offsets_.push_back(xs_.size());
+        }
+        if (!std::isfinite(x0) || !std::isfinite(y0) || !std::isfinite(x1) || !std::isfinite(y1)) {
+            error = "zone polygon with non-finite coordinates";
+            return false;
+        }
+
+        // One cell of margin so boundary points never fall off the grid
+        cell_ = cell;
+        for (;;) {
+            nx_ = static_cast<size_t>(std::ceil((x1 - x0) / cell_)) + 2;
+            ny_ = static_cast<size_t>(std::ceil((y1 - y0) / cell_)) + 2;
+            if (nx_ * ny_ <= kMaxCells)
+                break;
+            cell_ *= 1.5f;
+        }
+        x0_ = x0 - cell_;
+        y0_ = y0 - cell_;
+        inv_cell_ = 1.0f / cell_;
+        cells_.assign(nx_ * ny_ * 2 * words_, 0);
+
+        const double eps = 1e-3 * cell_;
+        for (size_t z = 0; z < zones_; ++z) {
+            const float *xs = xs_.data() + offsets_[z];
+            const float *ys = ys_.data() + offsets_[z];
+            size_t n = offsets_[z + 1] - offsets_[z];
+            uint64_t bit = 1ull << (z % 64);
+            size_t word = z / 64;
+
+            // Cells an edge passes through (closed, slightly grown, so points on a cell border are covered)
+            for (size_t i = 0, j = n - 1; i < n; j = i++) {
+                size_t cx0, cy0, cx1, cy1;
+                cellRange(std::min(xs[i], xs[j]), std::min(ys[i], ys[j]), std::max(xs[i], xs[j]),
+                          std::max(ys[i], ys[j]), cx0, cy0, cx1, cy1);
+                double dx = static_cast<double>(xs[i]) - xs[j], dy = static_cast<double>(ys[i]) - ys[j];
+                for (size_t cy = cy0; cy <= cy1; ++cy) {
+                    // Only the columns the edge spans within this row of cells, not its whole bounding box
+                    double ry = y0_ + static_cast<double>(cy) * cell_;
+                    double ta = 0.0, tb = 1.0;
+                    if (dy != 0.0) {
+                        ta = std::min(std::max((ry - eps - ys[j]) / dy, 0.0), 1.0);
+                        tb = std::min(std::max((ry + cell_ + eps - ys[j]) / dy, 0.0), 1.0);
+                    }
+                    size_t rx0, rx1, unused0, unused1;
+                    double xa = xs[j] + ta * dx, xb = xs[j] + tb * dx;
+                    cellRange(static_cast<float>(std::min(xa, xb)), ry, static_cast<float>(std::max(xa, xb)), ry, rx0,
+                              unused0, rx1, unused1);
+                    for (size_t cx = std::max(rx0, cx0); cx <= std::min(rx1, cx1); ++cx) {
+                        double rx = x0_ + static_cast<double>(cx) * cell_;
+                        if (segmentHitsRect(xs[j], ys[j], xs[i], ys[i], rx - eps, ry - eps, rx + cell_ + eps,
+                                            ry + cell_ + eps))
+                            edgeWords(cy * nx_ + cx)[word] |= bit;
+                    }
+                }
+            }
+
+            // Cells no edge touches are entirely inside or outside; their centre decides
+            float zx0 = *std::min_element(xs, xs + n), zx1 = *std::max_element(xs, xs + n);
+            float zy0 = *std::min_element(ys, ys + n), zy1 = *std::max_element(ys, ys + n);
+            size_t cx0, cy0, cx1, cy1;
+            cellRange(zx0, zy0, zx1, zy1, cx0, cy0, cx1, cy1);
+            for (size_t cy = cy0; cy <= cy1; ++cy) {
+                for (size_t cx = cx0; cx <= cx1; ++cx) {
+                    size_t c = cy * nx_ + cx;
+                    if (edgeWords(c)[word] & bit)
+                        continue;
+                    float px = x0_ + (static_cast<float>(cx) + 0.5f) * cell_;
+                    float py = y0_ + (static_cast<float>(cy) + 0.5f) * cell_;
+                    if (pointInPolygon(xs, ys, n, px, py))
+                        insideWords(c)[word] |= bit;
+                }
+            }
+        }
+        return true;
+    }
+
+    size_t zones() const { return zones_; }
+    size_t words() const { return words_; }
+    float cellSize() const { return cell_; }
+    size_t columns() const { return nx_; }
+    size_t rows() const { return ny_; }
+
+    // Fraction of cells with at least one edge test
+    double edgeCellFraction() const {
+        size_t edge = 0;
+        for (size_t c = 0; c < nx_ * ny_; ++c) {
+            const uint64_t *e = cells_.data() + c * 2 * words_ + words_;
+            edge += std::any_of(e, e + words_, [](uint64_t w) { return w != 0; });
+        }
+        return nx_ * ny_ > 0 ? static_cast<double>(edge) / static_cast<double>(nx_ * ny_) : 0.0;
+    }
+
+    // Zones containing (x, y) as `words()` bitmask words; returns the number of exact polygon tests it needed
+    size_t lookup(float x, float y, uint64_t *mask) const {
+        float fx = (x - x0_) * inv_cell_, fy = (y - y0_) * inv_cell_;
+        std::fill(mask, mask + words_, 0);
+        if (!(fx >= 0.0f && fy >= 0.0f && fx < static_cast<float>(nx_) && fy < static_cast<float>(ny_)))
+            return 0;  // off the grid (or NaN): no zone
+        const uint64_t *c = cells_.data() + (static_cast<size_t>(fy) * nx_ + static_cast<size_t>(fx)) * 2 * words_;
+        size_t tests = 0;
+        for (size_t w = 0; w < words_; ++w) {
+            uint64_t m = c[w];
+            for (uint64_t e = c[words_ + w]; e; e &= e - 1) {
+                size_t z = w * 64 + static_cast<size_t>(__builtin_ctzll(e));
+                ++tests;
+                if (contains(z, x, y))
+                    m |= e & (~e + 1);
+            }
+            mask[w] = m;
+        }
+        return tests;
+    }
+
+    // Exact test against one zone, no grid
+    bool contains(size_t zone, float x, float y) const {
+        return zone_engine_detail::pointInPolygon(xs_.data() + offsets_[zone], ys_.data() + offsets_[zone],
+                                                  offsets_[zone + 1] - offsets_[zone], x, y);
+    }
+
+private:
+    uint64_t *insideWords(size_t c) { return cells_.data() + c * 2 * words_; }
+    uint64_t *edgeWords(size_t c) { return cells_.data() + c * 2 * words_ + words_; }
+
+    void cellRange(float ax, float ay, float bx, float by, size_t &cx0, size_t &cy0, size_t &cx1,
+                   size_t &cy1) const {
+        auto clampCell = [](float v, size_t n) {
+            return v <= 0.0f ? size_t(0) : std::min(static_cast<size_t>(v), n - 1);
+        };
+        // One extra cell on each side for the grown edge test
+        cx0 = clampCell((ax - x0_) * inv_cell_ - 1.0f, nx_);
+        cy0 = clampCell((ay - y0_) * inv_cell_ - 1.0f, ny_);
+        cx1 = clampCell((bx - x0_) * inv_cell_ + 1.0f, nx_);
+        cy1 = clampCell((by - y0_) * inv_cell_ + 1.0f, ny_);
+    }
+
+    size_t zones_ = 0, words_ = 0;
+    float x0_ = 0.0f, y0_ = 0.0f, cell_ = 1.0f, inv_cell_ = 1.0f;
+    size_t nx_ = 0, ny_ = 0;
+    std::vector<uint64_t> cells_;  // per cell: inside words, then edge words
+    std::vector<float> xs_, ys_;   // polygon vertices of all zones
+    std::vector<size_t> offsets_;  // zone z owns vertices [offsets_[z], offsets_[z + 1])
+};
+
+enum class ZoneEventKind { Enter, Exit, Intrusion, Loiter };
+
+struct ZoneEvent {
+    ZoneEventKind kind;
+    uint32_t zone;
+    uint32_t source;
+    uint64_t object_id;
+    double dwell_s;  // Exit and Loiter: time in the zone so far
+};
+
+// Snapshot of one zone's accumulators
+struct ZoneCounters {
+    uint32_t occupancy = 0;
+    uint64_t entries = 0, exits = 0, intrusions = 0, loiters = 0;
+    uint64_t dwell_count = 0;  // completed visits
+    double dwell_sum_s = 0.0, dwell_max_s = 0.0;
+};
+
+// Fed by one thread (the osd probe or the offload worker); counters() may be read from any thread
+class ZoneEngine {
+public:
+    bool configure(const std::vector<ZoneConfig> &zones, const ZoneEngineConfig &cfg, std::string &error) {
+        if (!grid_.build(zones, cfg.cell, error))
+            return false;
+        zones_ = zones;
+        lost_ns_ = static_cast<uint64_t>(cfg.lost_s * 1e9);
+        acc_.reset(new Accumulator[zones.size()]);
+        total_.assign(zones.size(), 0);
+        frame_counts_.assign(zones.size(), 0);
+        source_counts_.clear();
+        objects_.clear();
+        return true;
+    }
+
+    bool empty() const { return zones_.empty(); }
+    size_t size() const { return zones_.size(); }
+    const ZoneConfig &zone(size_t z) const { return zones_[z]; }
+    const ZoneGrid &grid() const { return grid_; }
+
+    // One frame of `source` at CLOCK_MONOTONIC `t_ns`: beginFrame, add() every object, endFrame
+    void beginFrame(uint32_t source, uint64_t t_ns) {
+        source_ = source;
+        t_ns_ = t_ns;
+        events_.clear();
+        std::fill(frame_counts_.begin(), frame_counts_.end(), 0);
+    }
+
+    void add(uint64_t object_id, float x, float y) {
+        uint64_t mask[kZoneWords];
+        grid_.lookup(x, y, mask);
+        size_t words = grid_.words();
+        for (size_t w = 0; w < words; ++w) {
+            for (uint64_t m = mask[w]; m; m &= m - 1)
+                ++frame_counts_[w * 64 + static_cast<size_t>(__builtin_ctzll(m))];
+        }
+        if (object_id == ZONE_NO_ID)
+            return;
+
+        ObjectState &s = objects_[ObjectKey(source_, object_id)];
+        s.source = source_;
+        s.object_id = object_id;
+        s.last_seen_ns = t_ns_;
+        for (size_t w = 0; w < words; ++w) {
+            for (uint64_t m = mask[w] & ~s.mask[w]; m; m &= m - 1)
+                enter(s, static_cast<uint32_t>(w * 64 + static_cast<size_t>(__builtin_ctzll(m))));
+            for (uint64_t m = s.mask[w] & ~mask[w]; m; m &= m - 1)
+                exit(s, static_cast<uint32_t>(w * 64 + static_cast<size_t>(__builtin_ctzll(m))), t_ns_);
+            s.mask[w] = mask[w];
+        }
+        for (Visit &v : s.visits) {
+            const ZoneConfig &z = zones_[v.zone];
+            double dwell = static_cast<double>(t_ns_ - v.enter_ns) * 1e-9;
+            if (!v.loitered && z.max_dwell_s > 0.0 && dwell >= z.max_dwell_s) {
+                v.loitered = true;
+                acc_[v.zone].loiters.fetch_add(1, std::memory_order_relaxed);
+                events_.push_back(ZoneEvent{ZoneEventKind::Loiter, v.zone, s.source, s.object_id, dwell});
+            }
+        }
+    }
+
+    // Publishes this source's occupancy and lets objects unseen for lost_s leave their zones
+    void endFrame() {
+        if (source_ >= source_counts_.size())
+            source_counts_.resize(source_ + 1, std::vector<uint32_t>(zones_.size(), 0));
+        std::vector<uint32_t> &last = source_counts_[source_];
+        for (size_t z = 0; z < zones_.size(); ++z) {
+            total_[z] += frame_counts_[z] - last[z];
+            last[z] = frame_counts_[z];
+            acc_[z].occupancy.store(total_[z], std::memory_order_relaxed);
+        }
+
+        for (auto it = objects_.begin(); it != objects_.end();) {
+            ObjectState &s = it->second;
+            if (t_ns_ > s.last_seen_ns + lost_ns_) {
+                while (!s.visits.empty())
+                    exit(s, s.visits.back().zone, s.last_seen_ns);
+                it = objects_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Events of the last frame, in the order they happened
+    const std::vector<ZoneEvent> &events() const { return events_; }
+    size_t trackedObjects() const { return objects_.size(); }
+
+    ZoneCounters counters(size_t z) const {
+        const Accumulator &a = acc_[z];
+        ZoneCounters c;
+        c.occupancy = a.occupancy.load(std::memory_order_relaxed);
+        c.entries = a.entries.load(std::memory_order_relaxed);
+        c.exits = a.exits.load(std::memory_order_relaxed);
+        c.intrusions = a.intrusions.load(std::memory_order_relaxed);
+        c.loiters = a.loiters.load(std::memory_order_relaxed);
+        c.dwell_count = a.dwell_count.load(std::memory_order_relaxed);
+        c.dwell_sum_s = static_cast<double>(a.dwell_sum_ns.load(std::memory_order_relaxed)) * 1e-9;
+        c.dwell_max_s = static_cast<double>(a.dwell_max_ns.load(std::memory_order_relaxed)) * 1e-9;
+        return c;
+    }
+
+private:
+    struct Accumulator {
+        std::atomic<uint32_t> occupancy{0};
+        std::atomic<uint64_t> entries{0}, exits{0}, intrusions{0}, loiters{0};
+        std::atomic<uint64_t> dwell_count{0}, dwell_sum_ns{0}, dwell_max_ns{0};
+    };
+
+    struct Visit {
+        uint32_t zone;
+        bool loitered;
+        uint64_t enter_ns;
+    };
+
+    struct ObjectState {
+        uint32_t source = 0;
+        uint64_t object_id = ZONE_NO_ID;
+        uint64_t last_seen_ns = 0;
+        uint64_t mask[kZoneWords] = {};
+        std::vector<Visit> visits;  // zones the object is in
+    };
+
+    // Tracker ids are per source
+    using ObjectKey = std::pair<uint32_t, uint64_t>;
+    struct ObjectKeyHash {
+        size_t operator()(const ObjectKey &k) const {
+            return std::hash<uint64_t>()(k.second ^ (static_cast<uint64_t>(k.first) * 0x9e3779b97f4a7c15ULL));
+        }
+    };
+
+    void enter(ObjectState &s, uint32_t zone) {
+        s.visits.push_back(Visit{zone, false, t_ns_});
+        acc_[zone].entries.fetch_add(1, std::memory_order_relaxed);
+        events_.push_back(ZoneEvent{ZoneEventKind::Enter, zone, s.source, s.object_id, 0.0});
+        if (zones_[zone].intrusion) {
+            acc_[zone].intrusions.fetch_add(1, std::memory_order_relaxed);
+            events_.push_back(ZoneEvent{ZoneEventKind::Intrusion, zone, s.source, s.object_id, 0.0});
+        }
+    }
+
+    void exit(ObjectState &s, uint32_t zone, uint64_t t_ns) {
+        auto it = std::find_if(s.visits.begin(), s.visits.end(), [zone](const Visit &v) { return v.zone == zone; });
+        if (it == s.visits.end())
+            return;
+        uint64_t dwell = t_ns > it->enter_ns ? t_ns - it->enter_ns : 0;
+        *it = s.visits.back();
+        s.visits.pop_back();
+        s.mask[zone / 64] &= ~(1ull << (zone % 64));
+
+        Accumulator &a = acc_[zone];
+        a.exits.fetch_add(1, std::memory_order_relaxed);
+        a.dwell_count.fetch_add(1, std::memory_order_relaxed);
+        a.dwell_sum_ns.fetch_add(dwell, std::memory_order_relaxed);
+        if (dwell > a.dwell_max_ns.load(std::memory_order_relaxed))
+            a.dwell_max_ns.store(dwell, std::memory_order_relaxed);
+        events_.push_back(
+            ZoneEvent{ZoneEventKind::Exit, zone, s.source, s.object_id, static_cast<double>(dwell) * 1e-9});
+    }
+
+    ZoneGrid grid_;
+    std::vector<ZoneConfig> zones_;
+    uint64_t lost_ns_ = 1000000000ULL;
+    std::unique_ptr<Accumulator[]> acc_;
+
+    uint32_t source_ = 0;
+    uint64_t t_ns_ = 0;
+    std::vector<uint32_t> frame_counts_;                // this frame, per zone
+    std::vector<std::vector<uint32_t>> source_counts_;  // last frame of each source, per zone
+    std::vector<uint32_t> total_;                       // sum over sources
+    std::unordered_map<ObjectKey, ObjectState, ObjectKeyHash> objects_;
+    std::vector<ZoneEvent> events_;
+};
@@ -0,0 +1,183 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#include "dynamic_range.h"
+#include "json_reader.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+// Accepted values: a scalar (symmetric range), [min, max] or {"min": min, "max": max}
+static bool
+rangeFromJson(const JsonValue& value, DynamicRange& range)
+{
+  if (value.type == JsonValue::kNUMBER) {
+    range.min = -std::fabs(static_cast<float>(value.number));
+    range.max = std::fabs(static_cast<float>(value.number));
+    return true;
+  }
+  if (value.type == JsonValue::kARRAY) {
+    if (value.array.size() != 2 || value.array[0].type != JsonValue::kNUMBER ||
+        value.array[1].type != JsonValue::kNUMBER) {
+      return false;
+    }
+    range.min = static_cast<float>(value.array[0].number);
+    range.max = static_cast<float>(value.array[1].number);
+    return true;
+  }
+  if (value.type == JsonValue::kOBJECT) {
+    const JsonValue* min = value.get("min");
+    const JsonValue* max = value.get("max");
+    if (!min || !max || min->type != JsonValue::kNUMBER || max->type != JsonValue::kNUMBER) {
+      return false;
+    }
+    range.min = static_cast<float>(min->number);
+    range.max = static_cast<float>(max->number);
+    return true;
+  }
+  return false;
+}
+
+bool
+parseDynamicRangeJson(const std::string& text, DynamicRangeMap& ranges)
+{
+  JsonValue root;
+  if (!parseJson(text, root) || root.type != JsonValue::kOBJECT) {
+    std::cerr << "Dynamic range JSON must be an object of tensor name -> range" << std::endl;
+    return false;
+  }
+  for (const auto& member : root.object) {
+    DynamicRange range;
+    if (!rangeFromJson(member.second, range)) {
+      std::cerr << "Invalid dynamic range JSON entry \"" << member.first << "\"" << std::endl;
+      return false;
+    }
+    if (range.min > range.max) {
+      std::swap(range.min, range.max);
+    }
+    ranges[member.first] = range;
+  }
+  return true;
+}
+
+bool
+parseCalibrationCache(const std::string& text, DynamicRangeMap& ranges)
+{
+  std::istringstream stream(text);
+  std::string line;
+
+  // First line is the calibrator header (TRT-<version>-EntropyCalibration2), entries are "<tensor>: <hex scale>"
+  if (!std::getline(stream, line) || line.compare(0, 4, "TRT-") != 0) {
+    std::cerr << "Invalid calibration cache header" << std::endl;
+    return false;
+  }
+
+  while (std::getline(stream, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    size_t cpos = line.rfind(": ");
+    if (cpos == std::string::npos) {
+      std::cerr << "Invalid calibration cache line: " << line << std::endl;
+      return false;
+    }
+    std::string key = line.substr(0, cpos);
+    const char* hex = line.c_str() + cpos + 2;
+    char* end = nullptr;
+    uint32_t bits = static_cast<uint32_t>(std::strtoul(hex, &end, 16));
+    if (end == hex || (*end != '\0' && *end != '\r')) {
+      std::cerr << "Invalid calibration cache scale: " << line << std::endl;
+      return false;
+    }
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    DynamicRange range;
+    range.max = scale * 127.0f;
+    range.min = -range.max;
+    ranges[key] = range;
+  }
+
+  return true;
+}
+
+bool
+loadDynamicRanges(const std::string& filePath, DynamicRangeMap& ranges)
+{
+  std::ifstream file(filePath);
+  if (!file.good()) {
+    std::cerr << "Could not open dynamic range file: " << filePath << std::endl;
+    return false;
+  }
+
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  std::string text = buffer.str();
+
+  size_t first = text.find_first_not_of(" \t\r\n");
+  if (first != std::string::npos && text[first] == '{') {
+    return parseDynamicRangeJson(text, ranges);
+  }
+  return parseCalibrationCache(text, ranges);
+}
+
+DynamicRangeReport
+matchDynamicRanges(const std::vector<DynamicRangeTarget>& targets, const DynamicRangeMap& ranges)
+{
+  DynamicRangeReport report;
+  std::map<std::string, bool> used;
+
+  for (const DynamicRangeTarget& target : targets) {
+    DynamicRangeMatch match;
+    DynamicRangeMap::const_iterator it = ranges.find(target.tensorName);
+    if (it == ranges.end() && !target.layerName.empty()) {
+      it = ranges.find(target.layerName);
+    }
+    if (it != ranges.end()) {
+      match.key = it->first;
+      match.range = it->second;
+      match.found = true;
+      used[it->first] = true;
+      ++report.numMatched;
+    }
+    report.matches.push_back(match);
+  }
+
+  for (const auto& range : ranges) {
+    if (used.find(range.first) == used.end()) {
+      report.unusedKeys.push_back(range.first);
+    }
+  }
+
+  return report;
+}
+
+void
+printDynamicRangeReport(const std::vector<DynamicRangeTarget>& targets, const DynamicRangeReport& report,
+    std::ostream& out)
+{
+  out << "\nDynamic ranges set for " << report.numMatched << " of " << targets.size() << " tensors" << std::endl;
+
+  for (size_t i = 0; i < targets.size(); ++i) {
+    const DynamicRangeMatch& match = report.matches.at(i);
+    std::string name = targets.at(i).layerName.empty() ? targets.at(i).tensorName : targets.at(i).layerName;
+    if (match.found) {
+      out << std::setw(40) << std::left << name << "[" << match.range.min << ", " << match.range.max << "]" <<
+          std::endl;
+    }
+    else {
+      out << std::setw(40) << std::left << name << "no range" << std::endl;
+    }
+  }
+
+  for (const std::string& key : report.unusedKeys) {
+    out << "WARNING: Unused dynamic range entry: " << key << std::endl;
+  }
+}
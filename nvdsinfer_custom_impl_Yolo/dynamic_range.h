@@ -0,0 +1,55 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#ifndef __DYNAMIC_RANGE_H__
+#define __DYNAMIC_RANGE_H__
+
+#include <map>
+#include <vector>
+#include <string>
+#include <iostream>
+
+struct DynamicRange
+{
+  float min;
+  float max;
+};
+
+typedef std::map<std::string, DynamicRange> DynamicRangeMap;
+
+// A tensor that can receive a dynamic range. Layer outputs can be matched by the layer name assigned by the layer
+// builders (conv_12, batchnorm_12, ...) or by the tensor name (TensorRT calibration cache entries)
+struct DynamicRangeTarget
+{
+  std::string layerName;
+  std::string tensorName;
+};
+
+struct DynamicRangeMatch
+{
+  std::string key;
+  DynamicRange range {0.0, 0.0};
+  bool found {false};
+};
+
+struct DynamicRangeReport
+{
+  std::vector<DynamicRangeMatch> matches;
+  std::vector<std::string> unusedKeys;
+  uint numMatched {0};
+};
+
+bool parseDynamicRangeJson(const std::string& text, DynamicRangeMap& ranges);
+
+bool parseCalibrationCache(const std::string& text, DynamicRangeMap& ranges);
+
+bool loadDynamicRanges(const std::string& filePath, DynamicRangeMap& ranges);
+
+DynamicRangeReport matchDynamicRanges(const std::vector<DynamicRangeTarget>& targets, const DynamicRangeMap& ranges);
+
+void printDynamicRangeReport(const std::vector<DynamicRangeTarget>& targets, const DynamicRangeReport& report,
+    std::ostream& out);
+
+#endif
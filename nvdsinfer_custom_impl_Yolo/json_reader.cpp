@@ -0,0 +1,201 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#include "json_reader.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+const JsonValue*
+JsonValue::get(const std::string& key) const
+{
+  for (const auto& member : object) {
+    if (member.first == key) {
+      return &member.second;
+    }
+  }
+  return nullptr;
+}
+
+std::string
+JsonValue::getString(const std::string& key, const std::string& defaultValue) const
+{
+  const JsonValue* value = get(key);
+  return value && value->type == kSTRING ? value->string : defaultValue;
+}
+
+double
+JsonValue::getNumber(const std::string& key, double defaultValue) const
+{
+  const JsonValue* value = get(key);
+  return value && value->type == kNUMBER ? value->number : defaultValue;
+}
+
+static void
+skipSpaces(const std::string& s, size_t& pos)
+{
+  while (pos < s.size() && isspace(static_cast<unsigned char>(s[pos]))) {
+    ++pos;
+  }
+}
+
+static bool
+parseString(const std::string& s, size_t& pos, std::string& out)
+{
+  if (s[pos] != '"') {
+    return false;
+  }
+  ++pos;
+  out.clear();
+  while (pos < s.size() && s[pos] != '"') {
+    if (s[pos] == '\\' && pos + 1 < s.size()) {
+      ++pos;
+      switch (s[pos]) {
+        case 'n': out += '\n'; break;
+        case 't': out += '\t'; break;
+        case 'r': out += '\r'; break;
+        case 'u': out += '?'; pos += 4; break;
+        default: out += s[pos]; break;
+      }
+      ++pos;
+    }
+    else {
+      out += s[pos++];
+    }
+  }
+  if (pos >= s.size()) {
+    return false;
+  }
+  ++pos;
+  return true;
+}
+
+static bool
+parseValue(const std::string& s, size_t& pos, JsonValue& value, int depth)
+{
+  skipSpaces(s, pos);
+  if (pos >= s.size() || depth > 64) {
+    return false;
+  }
+
+  char c = s[pos];
+  if (c == '{') {
+    value.type = JsonValue::kOBJECT;
+    ++pos;
+    skipSpaces(s, pos);
+    if (pos < s.size() && s[pos] == '}') {
+      ++pos;
+      return true;
+    }
+    while (pos < s.size()) {
+      skipSpaces(s, pos);
+      std::pair<std::string, JsonValue> member;
+      if (!parseString(s, pos, member.first)) {
+        return false;
+      }
+      skipSpaces(s, pos);
+      if (pos >= s.size() || s[pos] != ':') {
+        return false;
+      }
+      ++pos;
+      if (!parseValue(s, pos, member.second, depth + 1)) {
+        return false;
+      }
+      value.object.push_back(member);
+      skipSpaces(s, pos);
+      if (pos < s.size() && s[pos] == ',') {
+        ++pos;
+      }
+      else if (pos < s.size() && s[pos] == '}') {
+        ++pos;
+        return true;
+      }
+      else {
+        return false;
+      }
+    }
+    return false;
+  }
+  if (c == '[') {
+    value.type = JsonValue::kARRAY;
+    ++pos;
+    skipSpaces(s, pos);
+    if (pos < s.size() && s[pos] == ']') {
+      ++pos;
+      return true;
+    }
+    while (pos < s.size()) {
+      JsonValue element;
+      if (!parseValue(s, pos, element, depth + 1)) {
+        return false;
+      }
+      value.array.push_back(element);
+      skipSpaces(s, pos);
+      if (pos < s.size() && s[pos] == ',') {
+        ++pos;
+      }
+      else if (pos < s.size() && s[pos] == ']') {
+        ++pos;
+        return true;
+      }
+      else {
+        return false;
+      }
+    }
+    return false;
+  }
+  if (c == '"') {
+    value.type = JsonValue::kSTRING;
+    return parseString(s, pos, value.string);
+  }
+  if (s.compare(pos, 4, "true") == 0 || s.compare(pos, 5, "false") == 0) {
+    value.type = JsonValue::kBOOL;
+    value.boolean = s[pos] == 't';
+    pos += value.boolean ? 4 : 5;
+    return true;
+  }
+  if (s.compare(pos, 4, "null") == 0) {
+    value.type = JsonValue::kNULL;
+    pos += 4;
+    return true;
+  }
+
+  const char* begin = s.c_str() + pos;
+  char* end = nullptr;
+  value.number = std::strtod(begin, &end);
+  if (end == begin) {
+    return false;
+  }
+  value.type = JsonValue::kNUMBER;
+  pos += end - begin;
+  return true;
+}
+
+bool
+parseJson(const std::string& text, JsonValue& value)
+{
+  size_t pos = 0;
+  if (!parseValue(text, pos, value, 0)) {
+    std::cerr << "Invalid JSON at offset " << pos << std::endl;
+    return false;
+  }
+  skipSpaces(text, pos);
+  return pos == text.size();
+}
+
+bool
+readJsonFile(const std::string& filePath, JsonValue& value)
+{
+  std::ifstream file(filePath);
+  if (!file.good()) {
+    std::cerr << "Could not open " << filePath << std::endl;
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  return parseJson(buffer.str(), value);
+}
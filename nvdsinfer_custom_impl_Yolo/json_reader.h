@@ -0,0 +1,36 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#ifndef __JSON_READER_H__
+#define __JSON_READER_H__
+
+#include <vector>
+#include <string>
+#include <utility>
+
+// Minimal JSON DOM: dynamic range files, and the TensorRT inspector and profiler dumps of the offline tools
+struct JsonValue
+{
+  enum Type { kNULL, kBOOL, kNUMBER, kSTRING, kARRAY, kOBJECT };
+
+  Type type {kNULL};
+  bool boolean {false};
+  double number {0.0};
+  std::string string;
+  std::vector<JsonValue> array;
+  std::vector<std::pair<std::string, JsonValue>> object;
+
+  const JsonValue* get(const std::string& key) const;
+
+  std::string getString(const std::string& key, const std::string& defaultValue = "") const;
+
+  double getNumber(const std::string& key, double defaultValue = 0.0) const;
+};
+
+bool parseJson(const std::string& text, JsonValue& value);
+
+bool readJsonFile(const std::string& filePath, JsonValue& value);
+
+#endif
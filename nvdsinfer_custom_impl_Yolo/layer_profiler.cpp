@@ -0,0 +1,158 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#include "layer_profiler.h"
+
+#include <fstream>
+#include <iomanip>
+
+#include "yoloPlugins.h"
+
+void
+LayerProfiler::reportLayerTime(const char* layerName, float ms) noexcept
+{
+  std::map<std::string, uint>::iterator it = m_LayerIndex.find(layerName);
+  if (it == m_LayerIndex.end()) {
+    LayerTime layerTime;
+    layerTime.name = layerName;
+    it = m_LayerIndex.insert(std::make_pair(layerTime.name, m_LayerTimes.size())).first;
+    m_LayerTimes.push_back(layerTime);
+  }
+  else if (it->second == 0) {
+    ++m_NumRuns;
+  }
+  m_LayerTimes.at(it->second).timeMs += ms;
+}
+
+static std::string
+escapeJson(const std::string& s)
+{
+  std::string out;
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out;
+}
+
+bool
+LayerProfiler::writeJson(const std::string& filePath) const
+{
+  std::ofstream file(filePath);
+  if (!file.good()) {
+    return false;
+  }
+
+  uint count = m_NumRuns + (m_LayerTimes.empty() ? 0 : 1);
+
+  float totalMs = 0.0;
+  for (const LayerTime& layerTime : m_LayerTimes) {
+    totalMs += layerTime.timeMs;
+  }
+
+  file << "[\n  { \"count\" : " << count << " }";
+  for (const LayerTime& layerTime : m_LayerTimes) {
+    file << ",\n  { \"name\" : \"" << escapeJson(layerTime.name) << "\", \"timeMs\" : " << layerTime.timeMs <<
+        ", \"averageMs\" : " << layerTime.timeMs / count << ", \"percentage\" : " <<
+        (totalMs > 0 ? layerTime.timeMs * 100 / totalMs : 0) << " }";
+  }
+  file << "\n]\n";
+
+  return file.good();
+}
+
+static size_t
+dataTypeSize(nvinfer1::DataType dataType)
+{
+  switch (dataType) {
+    case nvinfer1::DataType::kFLOAT:
+    case nvinfer1::DataType::kINT32:
+      return 4;
+    case nvinfer1::DataType::kHALF:
+      return 2;
+    default:
+      return 1;
+  }
+}
+
+static size_t
+volume(const nvinfer1::Dims& dims)
+{
+  size_t v = 1;
+  for (int i = 0; i < dims.nbDims; ++i) {
+    v *= dims.d[i] > 0 ? dims.d[i] : 1;
+  }
+  return v;
+}
+
+bool
+profileEngine(nvinfer1::ICudaEngine* engine, nvinfer1::IExecutionContext* context, const uint& batchSize,
+    const uint& iterations, const std::string& filePath)
+{
+  LayerProfiler profiler;
+  std::vector<void*> buffers;
+  bool status = true;
+
+#if NV_TENSORRT_MAJOR >= 10
+  cudaStream_t stream;
+  CUDA_CHECK(cudaStreamCreate(&stream));
+
+  for (int i = 0; i < engine->getNbIOTensors(); ++i) {
+    const char* name = engine->getIOTensorName(i);
+    nvinfer1::Dims dims = engine->getTensorShape(name);
+    if (engine->getTensorIOMode(name) == nvinfer1::TensorIOMode::kINPUT && dims.d[0] == -1) {
+      dims.d[0] = batchSize;
+      context->setInputShape(name, dims);
+    }
+    dims = context->getTensorShape(name);
+    void* buffer;
+    CUDA_CHECK(cudaMalloc(&buffer, volume(dims) * dataTypeSize(engine->getTensorDataType(name))));
+    CUDA_CHECK(cudaMemset(buffer, 0, volume(dims) * dataTypeSize(engine->getTensorDataType(name))));
+    context->setTensorAddress(name, buffer);
+    buffers.push_back(buffer);
+  }
+
+  context->setProfiler(&profiler);
+  for (uint i = 0; i < iterations && status; ++i) {
+    status = context->enqueueV3(stream);
+    CUDA_CHECK(cudaStreamSynchronize(stream));
+  }
+
+  CUDA_CHECK(cudaStreamDestroy(stream));
+#else
+  for (int i = 0; i < engine->getNbBindings(); ++i) {
+    nvinfer1::Dims dims = engine->getBindingDimensions(i);
+    if (engine->bindingIsInput(i) && dims.d[0] == -1) {
+      dims.d[0] = batchSize;
+      context->setBindingDimensions(i, dims);
+    }
+    dims = context->getBindingDimensions(i);
+    void* buffer;
+    CUDA_CHECK(cudaMalloc(&buffer, volume(dims) * dataTypeSize(engine->getBindingDataType(i))));
+    CUDA_CHECK(cudaMemset(buffer, 0, volume(dims) * dataTypeSize(engine->getBindingDataType(i))));
+    buffers.push_back(buffer);
+  }
+
+  context->setProfiler(&profiler);
+  for (uint i = 0; i < iterations && status; ++i) {
+    status = context->executeV2(buffers.data());
+  }
+#endif
+
+  context->setProfiler(nullptr);
+
+  for (void* buffer : buffers) {
+    CUDA_CHECK(cudaFree(buffer));
+  }
+
+  if (!status) {
+    std::cerr << "Engine profiling run failed" << std::endl;
+    return false;
+  }
+
+  return profiler.writeJson(filePath);
+}
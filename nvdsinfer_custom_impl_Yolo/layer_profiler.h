@@ -0,0 +1,36 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#ifndef __LAYER_PROFILER_H__
+#define __LAYER_PROFILER_H__
+
+#include <map>
+#include <vector>
+#include <string>
+
+#include "NvInfer.h"
+
+class LayerProfiler : public nvinfer1::IProfiler {
+  public:
+    void reportLayerTime(const char* layerName, float ms) noexcept override;
+
+    // Same layout as trtexec --exportProfile
+    bool writeJson(const std::string& filePath) const;
+
+  private:
+    struct LayerTime {
+      std::string name;
+      float timeMs {0.0};
+    };
+
+    std::vector<LayerTime> m_LayerTimes;
+    std::map<std::string, uint> m_LayerIndex;
+    uint m_NumRuns {0};
+};
+
+bool profileEngine(nvinfer1::ICudaEngine* engine, nvinfer1::IExecutionContext* context, const uint& batchSize,
+    const uint& iterations, const std::string& filePath);
+
+#endif
@@ -26,6 +26,8 @@
 #include "nvdsinfer_custom_impl.h"
 
 #include "utils.h"
+#include "parse_recorder.h"
+#include "parse_stats.h"
 
 extern "C" bool
 NvDsInferParseYolo(std::vector<NvDsInferLayerInfo> const& outputLayersInfo, NvDsInferNetworkInfo const& networkInfo,
@@ -123,7 +125,16 @@ extern "C" bool
 NvDsInferParseYolo(std::vector<NvDsInferLayerInfo> const& outputLayersInfo, NvDsInferNetworkInfo const& networkInfo,
     NvDsInferParseDetectionParams const& detectionParams, std::vector<NvDsInferParseObjectInfo>& objectList)
 {
-  return NvDsInferParseCustomYolo(outputLayersInfo, networkInfo, detectionParams, objectList);
+  uint64_t start = parseStatsNowNs();
+  bool status = NvDsInferParseCustomYolo(outputLayersInfo, networkInfo, detectionParams, objectList);
+  recordParseStats(parseStatsNowNs() - start, status ? objectList.size() : 0, status);
+
+  ParseRecorder* recorder = ParseRecorder::get();
+  if (recorder && status) {
+    recorder->record(outputLayersInfo, networkInfo, detectionParams, objectList);
+  }
+
+  return status;
 }
 
 CHECK_CUSTOM_PARSE_FUNC_PROTOTYPE(NvDsInferParseYolo);
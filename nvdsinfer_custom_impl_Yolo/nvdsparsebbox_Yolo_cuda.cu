@@ -27,6 +27,7 @@
 #include <thrust/device_vector.h>
 
 #include "nvdsinfer_custom_impl.h"
+#include "parse_stats.h"
 
 extern "C" bool
 NvDsInferParseYoloCuda(std::vector<NvDsInferLayerInfo> const& outputLayersInfo, NvDsInferNetworkInfo const& networkInfo,
@@ -100,7 +101,10 @@ extern "C" bool
 NvDsInferParseYoloCuda(std::vector<NvDsInferLayerInfo> const& outputLayersInfo, NvDsInferNetworkInfo const& networkInfo,
     NvDsInferParseDetectionParams const& detectionParams, std::vector<NvDsInferParseObjectInfo>& objectList)
 {
-  return NvDsInferParseCustomYoloCuda(outputLayersInfo, networkInfo, detectionParams, objectList);
+  uint64_t start = parseStatsNowNs();
+  bool status = NvDsInferParseCustomYoloCuda(outputLayersInfo, networkInfo, detectionParams, objectList);
+  recordParseStats(parseStatsNowNs() - start, status ? objectList.size() : 0, status);
+  return status;
 }
 
 CHECK_CUSTOM_PARSE_FUNC_PROTOTYPE(NvDsInferParseYoloCuda);
@@ -0,0 +1,134 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#include "parse_record.h"
+
+#include <iostream>
+
+namespace {
+
+class RecordReader {
+  public:
+    RecordReader(const std::vector<char>& buffer) : data(buffer), pos(0) { }
+
+    template <typename T>
+    bool read(T& value) {
+      if (pos + sizeof(T) > data.size()) {
+        return false;
+      }
+      std::memcpy(&value, data.data() + pos, sizeof(T));
+      pos += sizeof(T);
+      return true;
+    }
+
+    bool read(void* out, size_t size) {
+      if (pos + size > data.size()) {
+        return false;
+      }
+      std::memcpy(out, data.data() + pos, size);
+      pos += size;
+      return true;
+    }
+
+  private:
+    const std::vector<char>& data;
+    size_t pos;
+};
+
+}
+
+size_t
+parseRecordDataTypeSize(int32_t dataType)
+{
+  // NvDsInferDataType: FLOAT, HALF, INT8, INT32
+  switch (dataType) {
+    case 0:
+    case 3:
+      return 4;
+    case 1:
+      return 2;
+    default:
+      return 1;
+  }
+}
+
+bool
+readParseRecordHeader(std::istream& stream)
+{
+  char magic[8];
+  uint32_t version;
+  stream.read(magic, sizeof(magic));
+  stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+  if (!stream.good() || std::memcmp(magic, PARSE_RECORD_MAGIC, sizeof(magic)) != 0) {
+    std::cerr << "Invalid parser record file" << std::endl;
+    return false;
+  }
+  if (version != PARSE_RECORD_VERSION) {
+    std::cerr << "Unsupported parser record version " << version << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool
+readParseRecord(std::istream& stream, ParseRecord& record)
+{
+  uint32_t size;
+  stream.read(reinterpret_cast<char*>(&size), sizeof(size));
+  if (stream.gcount() != sizeof(size)) {
+    return false;
+  }
+
+  std::vector<char> buffer(size);
+  stream.read(buffer.data(), size);
+  if (static_cast<uint32_t>(stream.gcount()) != size) {
+    std::cerr << "Truncated parser record" << std::endl;
+    return false;
+  }
+
+  RecordReader reader(buffer);
+  uint32_t numThresholds;
+  uint32_t numLayers;
+  uint32_t numObjects;
+
+  if (!reader.read(record.timestamp) || !reader.read(record.netW) || !reader.read(record.netH) ||
+      !reader.read(record.netC) || !reader.read(record.numClassesConfigured) || !reader.read(numThresholds)) {
+    return false;
+  }
+
+  record.preclusterThreshold.resize(numThresholds);
+  if (!reader.read(record.preclusterThreshold.data(), numThresholds * sizeof(float)) || !reader.read(numLayers)) {
+    return false;
+  }
+
+  record.layers.resize(numLayers);
+  for (ParseRecordLayer& layer : record.layers) {
+    uint32_t nameSize;
+    uint32_t numDims;
+    uint32_t dataSize;
+    if (!reader.read(nameSize)) {
+      return false;
+    }
+    layer.name.resize(nameSize);
+    if (!reader.read(&layer.name[0], nameSize) || !reader.read(layer.dataType) || !reader.read(layer.isInput) ||
+        !reader.read(layer.bindingIndex) || !reader.read(numDims)) {
+      return false;
+    }
+    layer.dims.resize(numDims);
+    if (!reader.read(layer.dims.data(), numDims * sizeof(uint32_t)) || !reader.read(dataSize)) {
+      return false;
+    }
+    layer.data.resize(dataSize);
+    if (!reader.read(layer.data.data(), dataSize)) {
+      return false;
+    }
+  }
+
+  if (!reader.read(numObjects)) {
+    return false;
+  }
+  record.objects.resize(numObjects);
+  return reader.read(record.objects.data(), numObjects * sizeof(ParseRecordObject));
+}
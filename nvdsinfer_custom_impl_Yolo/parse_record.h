@@ -0,0 +1,73 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#ifndef __PARSE_RECORD_H__
+#define __PARSE_RECORD_H__
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <istream>
+
+// Binary log of the bbox parser inputs and outputs. The file starts with PARSE_RECORD_MAGIC and PARSE_RECORD_VERSION
+// (uint32), followed by records prefixed by their size (uint32)
+#define PARSE_RECORD_MAGIC "YOLOREC1"
+#define PARSE_RECORD_VERSION 1
+
+struct ParseRecordLayer
+{
+  std::string name;
+  int32_t dataType {0};
+  int32_t isInput {0};
+  uint32_t bindingIndex {0};
+  std::vector<uint32_t> dims;
+  std::vector<char> data;
+};
+
+struct ParseRecordObject
+{
+  float left;
+  float top;
+  float width;
+  float height;
+  float confidence;
+  int32_t classId;
+};
+
+struct ParseRecord
+{
+  uint64_t timestamp {0};
+  uint32_t netW {0};
+  uint32_t netH {0};
+  uint32_t netC {0};
+  uint32_t numClassesConfigured {0};
+  std::vector<float> preclusterThreshold;
+  std::vector<ParseRecordLayer> layers;
+  std::vector<ParseRecordObject> objects;
+};
+
+template <typename T>
+inline void
+appendRecord(std::vector<char>& buffer, const T& value)
+{
+  const char* p = reinterpret_cast<const char*>(&value);
+  buffer.insert(buffer.end(), p, p + sizeof(T));
+}
+
+inline void
+appendRecord(std::vector<char>& buffer, const void* data, size_t size)
+{
+  const char* p = static_cast<const char*>(data);
+  buffer.insert(buffer.end(), p, p + size);
+}
+
+bool readParseRecordHeader(std::istream& stream);
+
+bool readParseRecord(std::istream& stream, ParseRecord& record);
+
+size_t parseRecordDataTypeSize(int32_t dataType);
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#include "parse_recorder.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+ParseRecorder*
+ParseRecorder::get()
+{
+  static std::unique_ptr<ParseRecorder> recorder([] () -> ParseRecorder* {
+    const char* filePath = getenv("YOLO_PARSER_RECORD");
+    if (!filePath || filePath[0] == '\0') {
+      return nullptr;
+    }
+    uint numSlots = getenv("YOLO_PARSER_RECORD_SLOTS") ? std::stoul(getenv("YOLO_PARSER_RECORD_SLOTS")) : 64;
+    ParseRecorder* r = new ParseRecorder(filePath, numSlots);
+    if (!r->m_File.good()) {
+      std::cerr << "ERROR: Could not open parser record file " << filePath << std::endl;
+      delete r;
+      return nullptr;
+    }
+    std::cout << "Recording bbox parser inputs to " << filePath << std::endl;
+    return r;
+  }());
+  return recorder.get();
+}
+
+ParseRecorder::ParseRecorder(const std::string& filePath, const uint& numSlots) : m_Mask(0), m_EnqueuePos(0),
+    m_DequeuePos(0), m_File(filePath, std::ios::binary), m_Running(true), m_NumRecorded(0), m_NumDropped(0)
+{
+  size_t size = 2;
+  while (size < numSlots) {
+    size <<= 1;
+  }
+  m_Mask = size - 1;
+
+  m_Slots.reset(new Slot[size]);
+  for (size_t i = 0; i < size; ++i) {
+    m_Slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  if (m_File.good()) {
+    uint32_t version = PARSE_RECORD_VERSION;
+    m_File.write(PARSE_RECORD_MAGIC, 8);
+    m_File.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    m_Writer = std::thread(&ParseRecorder::writerLoop, this);
+  }
+}
+
+ParseRecorder::~ParseRecorder()
+{
+  m_Running.store(false, std::memory_order_release);
+  if (m_Writer.joinable()) {
+    m_Writer.join();
+  }
+  if (m_NumRecorded.load() > 0 || m_NumDropped.load() > 0) {
+    std::cout << "Parser recorder: " << m_NumRecorded.load() << " records written, " << m_NumDropped.load() <<
+        " dropped" << std::endl;
+  }
+}
+
+void
+ParseRecorder::record(std::vector<NvDsInferLayerInfo> const& outputLayersInfo, NvDsInferNetworkInfo const& networkInfo,
+    NvDsInferParseDetectionParams const& detectionParams, std::vector<NvDsInferParseObjectInfo> const& objectList)
+{
+  // Bounded MPMC ring (Vyukov), the parser can be called from more than one nvinfer instance
+  size_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+  Slot* slot;
+  for (;;) {
+    slot = &m_Slots[pos & m_Mask];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    else if (diff < 0) {
+      m_NumDropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    else {
+      pos = m_EnqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  // The slot buffer keeps its capacity, no allocation after the first records
+  std::vector<char>& buffer = slot->data;
+  buffer.clear();
+
+  uint32_t size = 0;
+  appendRecord(buffer, size);
+
+  uint64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  appendRecord(buffer, timestamp);
+  appendRecord(buffer, static_cast<uint32_t>(networkInfo.width));
+  appendRecord(buffer, static_cast<uint32_t>(networkInfo.height));
+  appendRecord(buffer, static_cast<uint32_t>(networkInfo.channels));
+  appendRecord(buffer, static_cast<uint32_t>(detectionParams.numClassesConfigured));
+
+  const std::vector<float>& thresholds = detectionParams.perClassPreclusterThreshold;
+  appendRecord(buffer, static_cast<uint32_t>(thresholds.size()));
+  appendRecord(buffer, thresholds.data(), thresholds.size() * sizeof(float));
+
+  appendRecord(buffer, static_cast<uint32_t>(outputLayersInfo.size()));
+  for (const NvDsInferLayerInfo& layer : outputLayersInfo) {
+    uint32_t nameSize = layer.layerName ? strlen(layer.layerName) : 0;
+    appendRecord(buffer, nameSize);
+    appendRecord(buffer, layer.layerName, nameSize);
+    appendRecord(buffer, static_cast<int32_t>(layer.dataType));
+    appendRecord(buffer, static_cast<int32_t>(layer.isInput));
+    appendRecord(buffer, static_cast<uint32_t>(layer.bindingIndex));
+    appendRecord(buffer, static_cast<uint32_t>(layer.inferDims.numDims));
+    uint32_t numElements = 1;
+    for (uint i = 0; i < layer.inferDims.numDims; ++i) {
+      appendRecord(buffer, static_cast<uint32_t>(layer.inferDims.d[i]));
+      numElements *= layer.inferDims.d[i];
+    }
+    uint32_t dataSize = layer.buffer ? numElements * parseRecordDataTypeSize(layer.dataType) : 0;
+    appendRecord(buffer, dataSize);
+    appendRecord(buffer, layer.buffer, dataSize);
+  }
+
+  appendRecord(buffer, static_cast<uint32_t>(objectList.size()));
+  for (const NvDsInferParseObjectInfo& obj : objectList) {
+    ParseRecordObject object;
+    object.left = obj.left;
+    object.top = obj.top;
+    object.width = obj.width;
+    object.height = obj.height;
+    object.confidence = obj.detectionConfidence;
+    object.classId = obj.classId;
+    appendRecord(buffer, object);
+  }
+
+  size = buffer.size() - sizeof(size);
+  std::memcpy(buffer.data(), &size, sizeof(size));
+
+  slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+bool
+ParseRecorder::writeSlot()
+{
+  Slot& slot = m_Slots[m_DequeuePos & m_Mask];
+  if (slot.sequence.load(std::memory_order_acquire) != m_DequeuePos + 1) {
+    return false;
+  }
+
+  m_File.write(slot.data.data(), slot.data.size());
+  slot.sequence.store(m_DequeuePos + m_Mask + 1, std::memory_order_release);
+  ++m_DequeuePos;
+  m_NumRecorded.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void
+ParseRecorder::writerLoop()
+{
+  while (m_Running.load(std::memory_order_acquire)) {
+    if (!writeSlot()) {
+      m_File.flush();
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+  }
+  while (writeSlot()) { }
+  m_File.flush();
+}
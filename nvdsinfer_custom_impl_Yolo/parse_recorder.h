@@ -0,0 +1,59 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#ifndef __PARSE_RECORDER_H__
+#define __PARSE_RECORDER_H__
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <fstream>
+
+#include "nvdsinfer_custom_impl.h"
+
+#include "parse_record.h"
+
+// Opt-in recorder of the bbox parser inputs and outputs (YOLO_PARSER_RECORD=<file>). The parser thread only copies the
+// tensors into a free slot of a lock-free ring, a background thread writes the slots to the file. Records are dropped
+// (never blocking) when the ring is full
+class ParseRecorder {
+  public:
+    // nullptr when recording is disabled
+    static ParseRecorder* get();
+
+    ~ParseRecorder();
+
+    void record(std::vector<NvDsInferLayerInfo> const& outputLayersInfo, NvDsInferNetworkInfo const& networkInfo,
+        NvDsInferParseDetectionParams const& detectionParams, std::vector<NvDsInferParseObjectInfo> const& objectList);
+
+    uint64_t numRecorded() const { return m_NumRecorded.load(std::memory_order_relaxed); }
+
+    uint64_t numDropped() const { return m_NumDropped.load(std::memory_order_relaxed); }
+
+  private:
+    ParseRecorder(const std::string& filePath, const uint& numSlots);
+
+    void writerLoop();
+
+    bool writeSlot();
+
+    struct Slot {
+      std::atomic<size_t> sequence;
+      std::vector<char> data;
+    };
+
+    std::unique_ptr<Slot[]> m_Slots;
+    size_t m_Mask;
+    std::atomic<size_t> m_EnqueuePos;
+    size_t m_DequeuePos;
+
+    std::ofstream m_File;
+    std::thread m_Writer;
+    std::atomic<bool> m_Running;
+    std::atomic<uint64_t> m_NumRecorded;
+    std::atomic<uint64_t> m_NumDropped;
+};
+
+#endif
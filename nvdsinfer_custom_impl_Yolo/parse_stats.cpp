@@ -0,0 +1,46 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#include "parse_stats.h"
+
+#include <atomic>
+#include <chrono>
+
+static std::atomic<uint64_t> g_Calls(0);
+static std::atomic<uint64_t> g_Failures(0);
+static std::atomic<uint64_t> g_Objects(0);
+static std::atomic<uint64_t> g_TotalNs(0);
+static std::atomic<uint64_t> g_MaxNs(0);
+
+uint64_t
+parseStatsNowNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void
+recordParseStats(uint64_t ns, uint64_t objects, bool ok)
+{
+  g_Calls.fetch_add(1, std::memory_order_relaxed);
+  if (!ok) {
+    g_Failures.fetch_add(1, std::memory_order_relaxed);
+  }
+  g_Objects.fetch_add(objects, std::memory_order_relaxed);
+  g_TotalNs.fetch_add(ns, std::memory_order_relaxed);
+  uint64_t max = g_MaxNs.load(std::memory_order_relaxed);
+  while (ns > max && !g_MaxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+  }
+}
+
+extern "C" void
+NvDsInferYoloParseStats(NvDsInferYoloParseStatsData* stats)
+{
+  stats->calls = g_Calls.load(std::memory_order_relaxed);
+  stats->failures = g_Failures.load(std::memory_order_relaxed);
+  stats->objects = g_Objects.load(std::memory_order_relaxed);
+  stats->totalNs = g_TotalNs.load(std::memory_order_relaxed);
+  stats->maxNs = g_MaxNs.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,31 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#ifndef __PARSE_STATS_H__
+#define __PARSE_STATS_H__
+
+#include <stdint.h>
+
+// Cumulative bbox parser counters since the lib was loaded. The app reads them with
+// dlsym(handle, "NvDsInferYoloParseStats") on the lib already loaded by nvinfer (dlopen with RTLD_NOLOAD)
+struct NvDsInferYoloParseStatsData {
+  uint64_t calls;
+  uint64_t failures;
+  uint64_t objects;
+  uint64_t totalNs;
+  uint64_t maxNs;
+};
+
+extern "C" void
+NvDsInferYoloParseStats(NvDsInferYoloParseStatsData* stats);
+
+typedef void (*NvDsInferYoloParseStatsFunc)(NvDsInferYoloParseStatsData* stats);
+
+// Parser side, relaxed atomics only
+void recordParseStats(uint64_t ns, uint64_t objects, bool ok);
+
+uint64_t parseStatsNowNs();
+
+#endif
@@ -0,0 +1,182 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#include "precision_policy.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+static std::string
+trimSpaces(const std::string& s)
+{
+  size_t begin = s.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  size_t end = s.find_last_not_of(" \t\r");
+  return s.substr(begin, end - begin + 1);
+}
+
+bool
+globMatch(const std::string& pattern, const std::string& name)
+{
+  // Iterative '*' / '?' matcher with single backtrack point
+  size_t p = 0;
+  size_t n = 0;
+  size_t starP = std::string::npos;
+  size_t starN = 0;
+
+  while (n < name.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+      ++p;
+      ++n;
+    }
+    else if (p < pattern.size() && pattern[p] == '*') {
+      starP = p++;
+      starN = n;
+    }
+    else if (starP != std::string::npos) {
+      p = starP + 1;
+      n = ++starN;
+    }
+    else {
+      return false;
+    }
+  }
+
+  while (p < pattern.size() && pattern[p] == '*') {
+    ++p;
+  }
+
+  return p == pattern.size();
+}
+
+bool
+parsePrecisionPolicy(const std::string& text, std::vector<PrecisionRule>& rules)
+{
+  std::istringstream stream(text);
+  std::string line;
+  int lineNumber = 0;
+
+  while (std::getline(stream, line)) {
+    ++lineNumber;
+    line = trimSpaces(line);
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+
+    size_t cpos = line.find('=');
+    if (cpos == std::string::npos) {
+      std::cerr << "Invalid precision policy line " << lineNumber << ": " << line << std::endl;
+      return false;
+    }
+
+    PrecisionRule rule;
+    rule.pattern = trimSpaces(line.substr(0, cpos));
+    rule.precision = trimSpaces(line.substr(cpos + 1));
+    std::transform(rule.precision.begin(), rule.precision.end(), rule.precision.begin(), ::toupper);
+
+    if (rule.pattern.empty() || (rule.precision != "FP32" && rule.precision != "FP16" && rule.precision != "INT8")) {
+      std::cerr << "Invalid precision policy line " << lineNumber << ": " << line << std::endl;
+      return false;
+    }
+
+    rules.push_back(rule);
+  }
+
+  return true;
+}
+
+bool
+loadPrecisionPolicy(const std::string& filePath, std::vector<PrecisionRule>& rules)
+{
+  std::ifstream file(filePath);
+  if (!file.good()) {
+    std::cerr << "Could not open precision policy file: " << filePath << std::endl;
+    return false;
+  }
+
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  return parsePrecisionPolicy(buffer.str(), rules);
+}
+
+std::vector<PrecisionAssignment>
+resolvePrecisions(const std::vector<PrecisionLayer>& layers, const std::vector<PrecisionRule>& rules,
+    const std::string& defaultPrecision)
+{
+  std::vector<PrecisionAssignment> assignments;
+
+  for (const PrecisionLayer& layer : layers) {
+    PrecisionAssignment assignment;
+    assignment.precision = defaultPrecision;
+
+    // First matching rule wins
+    for (uint i = 0; i < rules.size(); ++i) {
+      const std::string& pattern = rules.at(i).pattern;
+      bool matched = false;
+      if (pattern.front() == '@') {
+        matched = std::find(layer.tags.begin(), layer.tags.end(), pattern) != layer.tags.end();
+      }
+      else {
+        matched = globMatch(pattern, layer.name);
+      }
+      if (matched) {
+        assignment.precision = rules.at(i).precision;
+        assignment.rule = i;
+        break;
+      }
+    }
+
+    assignments.push_back(assignment);
+  }
+
+  return assignments;
+}
+
+bool
+pinsUnmatchedLayers(const std::vector<PrecisionAssignment>& assignments, const std::string& networkMode)
+{
+  if (networkMode == "FP16") {
+    return false;
+  }
+  for (const PrecisionAssignment& assignment : assignments) {
+    if (assignment.rule >= 0 && assignment.precision == "FP16") {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+printPrecisionReport(const std::vector<PrecisionLayer>& layers, const std::vector<PrecisionRule>& rules,
+    const std::vector<PrecisionAssignment>& assignments, std::ostream& out)
+{
+  out << "\nLayer precision policy" << std::endl;
+  out << std::setw(40) << std::left << "Layer" << std::setw(10) << std::left << "Precision" << "Rule" << std::endl;
+
+  std::vector<uint> ruleHits(rules.size(), 0);
+
+  for (uint i = 0; i < layers.size(); ++i) {
+    const PrecisionAssignment& assignment = assignments.at(i);
+    out << std::setw(40) << std::left << layers.at(i).name << std::setw(10) << std::left << assignment.precision;
+    if (assignment.rule >= 0) {
+      out << rules.at(assignment.rule).pattern;
+      ++ruleHits.at(assignment.rule);
+    }
+    else {
+      out << "-";
+    }
+    out << std::endl;
+  }
+
+  for (uint i = 0; i < rules.size(); ++i) {
+    if (ruleHits.at(i) == 0) {
+      out << "WARNING: Precision rule does not match any layer: " << rules.at(i).pattern << std::endl;
+    }
+  }
+}
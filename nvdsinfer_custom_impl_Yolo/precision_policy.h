@@ -0,0 +1,49 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#ifndef __PRECISION_POLICY_H__
+#define __PRECISION_POLICY_H__
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+// One "<glob> = <FP32|FP16|INT8>" line of the policy file. Patterns starting with '@' match a layer tag instead of the
+// layer name (@yolo_input = layers feeding the YoloLayer plugin)
+struct PrecisionRule
+{
+  std::string pattern;
+  std::string precision;
+};
+
+struct PrecisionLayer
+{
+  std::string name;
+  std::vector<std::string> tags;
+};
+
+struct PrecisionAssignment
+{
+  std::string precision;
+  int rule {-1};
+};
+
+bool globMatch(const std::string& pattern, const std::string& name);
+
+bool parsePrecisionPolicy(const std::string& text, std::vector<PrecisionRule>& rules);
+
+bool loadPrecisionPolicy(const std::string& filePath, std::vector<PrecisionRule>& rules);
+
+std::vector<PrecisionAssignment> resolvePrecisions(const std::vector<PrecisionLayer>& layers,
+    const std::vector<PrecisionRule>& rules, const std::string& defaultPrecision);
+
+// True when the layers without a matching rule must be pinned to the network-mode precision: an FP16 rule enables
+// FP16 for the whole builder, which network-mode FP32 or INT8 would not
+bool pinsUnmatchedLayers(const std::vector<PrecisionAssignment>& assignments, const std::string& networkMode);
+
+void printPrecisionReport(const std::vector<PrecisionLayer>& layers, const std::vector<PrecisionRule>& rules,
+    const std::vector<PrecisionAssignment>& assignments, std::ostream& out);
+
+#endif
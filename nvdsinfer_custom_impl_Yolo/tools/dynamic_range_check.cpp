@@ -0,0 +1,158 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+// Checks of the INT8 dynamic range import without TensorRT: the JSON and calibration cache parsers (fixtures/), bad
+// input, and the tensor / layer name matching with its report. Exits non-zero on failure.
+
+#include "dynamic_range.h"
+
+#include <sstream>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::cerr << "FAILED " << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+      ++failures; \
+    } \
+  } while (0)
+
+static bool
+hasRange(const DynamicRangeMap& ranges, const std::string& key, float min, float max)
+{
+  DynamicRangeMap::const_iterator it = ranges.find(key);
+  return it != ranges.end() && it->second.min == min && it->second.max == max;
+}
+
+static void
+checkJson(const std::string& fixtures)
+{
+  DynamicRangeMap ranges;
+  CHECK(loadDynamicRanges(fixtures + "/dynamic_range.json", ranges));
+  CHECK(ranges.size() == 7);
+  CHECK(hasRange(ranges, "input", -2.5f, 2.5f));
+  CHECK(hasRange(ranges, "conv_0", -4.0f, 6.0f));
+  CHECK(hasRange(ranges, "batchnorm_0", -3.0f, 3.5f));
+  CHECK(hasRange(ranges, "conv_1", -2.0f, 2.0f));
+  CHECK(hasRange(ranges, "model.0/conv/Conv_output_0", -0.1f, 0.1f));
+  CHECK(hasRange(ranges, "leaky_2:1", -8.0f, 8.0f));
+  CHECK(hasRange(ranges, "unused \"quoted\"", -1.0f, 1.0f));
+
+  const char* bad[] = {
+    "",
+    "[1.0]",
+    "{\"conv_0\" 1.0}",
+    "{\"conv_0\": }",
+    "{\"conv_0\": [1.0]}",
+    "{\"conv_0\": [1.0, 2.0}",
+    "{\"conv_0\": {\"min\": 1.0}}",
+    "{\"conv_0\": {\"min\": 1.0, \"max\": x}}",
+    "{\"conv_0\": 1.0 \"conv_1\": 2.0}",
+    "{\"conv_0\": 1.0",
+    "{\"conv_0\": 1.0} trailing",
+  };
+  for (const char* text : bad) {
+    DynamicRangeMap rejected;
+    CHECK(!parseDynamicRangeJson(text, rejected));
+  }
+}
+
+static void
+checkCalibrationCache(const std::string& fixtures)
+{
+  // Scales are the hex bits of a float, the range is scale * 127
+  DynamicRangeMap ranges;
+  CHECK(loadDynamicRanges(fixtures + "/calib.table", ranges));
+  CHECK(ranges.size() == 4);
+  CHECK(hasRange(ranges, "input", -0.9921875f, 0.9921875f));
+  CHECK(hasRange(ranges, "conv_0", -127.0f, 127.0f));
+  CHECK(hasRange(ranges, "/model.0/act/Mul_output_0", -7.9375f, 7.9375f));
+  CHECK(hasRange(ranges, "unused", -254.0f, 254.0f));
+
+  ranges.clear();
+  CHECK(parseCalibrationCache("TRT-8601-EntropyCalibration2\r\nconv_0: 3f800000\r\n", ranges));
+  CHECK(hasRange(ranges, "conv_0", -127.0f, 127.0f));
+
+  const char* bad[] = {
+    "",
+    "conv_0: 3f800000\n",
+    "TRT-8601-EntropyCalibration2\nconv_0 3f800000\n",
+    "TRT-8601-EntropyCalibration2\nconv_0: \n",
+    "TRT-8601-EntropyCalibration2\nconv_0: zz\n",
+    "TRT-8601-EntropyCalibration2\nconv_0: 3f80 0000\n",
+  };
+  for (const char* text : bad) {
+    DynamicRangeMap rejected;
+    CHECK(!parseCalibrationCache(text, rejected));
+  }
+
+  ranges.clear();
+  CHECK(!loadDynamicRanges(fixtures + "/missing.table", ranges));
+}
+
+static DynamicRangeTarget
+target(const std::string& layerName, const std::string& tensorName)
+{
+  DynamicRangeTarget t;
+  t.layerName = layerName;
+  t.tensorName = tensorName;
+  return t;
+}
+
+static void
+checkMatching(const std::string& fixtures)
+{
+  DynamicRangeMap ranges;
+  CHECK(loadDynamicRanges(fixtures + "/dynamic_range.json", ranges));
+
+  // The tensor name wins over the layer name, second outputs are matched as <layer>:<index>
+  std::vector<DynamicRangeTarget> targets = {
+    target("", "input"),
+    target("conv_0", "model.0/conv/Conv_output_0"),
+    target("batchnorm_0", "(Unnamed Layer* 3) [Scale]_output"),
+    target("leaky_2", "(Unnamed Layer* 7) [Activation]_output"),
+    target("leaky_2:1", "(Unnamed Layer* 7) [Activation]_output_1"),
+    target("conv_3", "(Unnamed Layer* 9) [Convolution]_output"),
+  };
+  DynamicRangeReport report = matchDynamicRanges(targets, ranges);
+  CHECK(report.matches.size() == targets.size());
+  CHECK(report.numMatched == 4);
+  if (report.matches.size() == targets.size()) {
+    CHECK(report.matches[0].found && report.matches[0].key == "input");
+    CHECK(report.matches[1].found && report.matches[1].key == "model.0/conv/Conv_output_0");
+    CHECK(report.matches[1].range.max == 0.1f);
+    CHECK(report.matches[2].found && report.matches[2].key == "batchnorm_0" && report.matches[2].range.min == -3.0f);
+    CHECK(!report.matches[3].found);
+    CHECK(report.matches[4].found && report.matches[4].key == "leaky_2:1");
+    CHECK(!report.matches[5].found && report.matches[5].key.empty());
+  }
+
+  // conv_0 lost to the tensor name of its layer, conv_1 and the quoted key match nothing
+  CHECK((report.unusedKeys == std::vector<std::string> {"conv_0", "conv_1", "unused \"quoted\""}));
+
+  std::ostringstream out;
+  printDynamicRangeReport(targets, report, out);
+  std::string text = out.str();
+  CHECK(text.find("Dynamic ranges set for 4 of 6 tensors") != std::string::npos);
+  CHECK(text.find("leaky_2") != std::string::npos && text.find("no range") != std::string::npos);
+  CHECK(text.find("WARNING: Unused dynamic range entry: conv_1") != std::string::npos);
+
+  report = matchDynamicRanges(targets, DynamicRangeMap());
+  CHECK(report.numMatched == 0 && report.unusedKeys.empty());
+}
+
+int
+main(int argc, char* argv[])
+{
+  std::string fixtures = argc > 1 ? argv[1] : "fixtures";
+
+  checkJson(fixtures);
+  checkCalibrationCache(fixtures);
+  checkMatching(fixtures);
+
+  std::cout << (failures ? "FAILED" : "OK") << " (" << failures << " failures)" << std::endl;
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,246 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+// Round trip of the bbox parser record file without DeepStream: synthetic parses are recorded through ParseRecorder
+// (YOLO_PARSER_RECORD), read back with readParseRecord and compared byte for byte with the recorded tensors and
+// objects. A file truncated in the last record keeps the records before it. Exits non-zero on failure.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+#include "parse_recorder.h"
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::cerr << "FAILED " << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+      ++failures; \
+    } \
+  } while (0)
+
+struct SyntheticLayer
+{
+  std::string name;
+  NvDsInferDataType dataType;
+  std::vector<uint> dims;
+  std::vector<char> data;
+  bool hasBuffer;
+};
+
+struct SyntheticParse
+{
+  NvDsInferNetworkInfo networkInfo;
+  NvDsInferParseDetectionParams detectionParams;
+  std::vector<SyntheticLayer> layers;
+  std::vector<NvDsInferParseObjectInfo> objects;
+};
+
+static SyntheticLayer
+makeLayer(const std::string& name, NvDsInferDataType dataType, const std::vector<uint>& dims, uint seed,
+    bool hasBuffer = true)
+{
+  SyntheticLayer layer;
+  layer.name = name;
+  layer.dataType = dataType;
+  layer.dims = dims;
+  layer.hasBuffer = hasBuffer;
+  size_t numElements = 1;
+  for (uint d : dims) {
+    numElements *= d;
+  }
+  layer.data.resize(numElements * parseRecordDataTypeSize(dataType));
+  for (size_t i = 0; i < layer.data.size(); ++i) {
+    layer.data[i] = static_cast<char>((i * 31 + seed * 7) & 0xff);
+  }
+  return layer;
+}
+
+static std::vector<SyntheticParse>
+makeParses()
+{
+  std::vector<SyntheticParse> parses(3);
+
+  parses[0].networkInfo = {640, 640, 3};
+  parses[0].detectionParams.numClassesConfigured = 80;
+  parses[0].detectionParams.perClassPreclusterThreshold.assign(80, 0.25f);
+  parses[0].layers.push_back(makeLayer("output", FLOAT, {100, 6}, 1));
+  for (uint i = 0; i < 4; ++i) {
+    NvDsInferParseObjectInfo obj = {i % 2, 10.0f * i, 20.5f, 30.25f, 40.0f + i, 0.5f + 0.1f * i};
+    parses[0].objects.push_back(obj);
+  }
+
+  // Several layers of each data type, one without buffer, no objects
+  parses[1].networkInfo = {416, 256, 3};
+  parses[1].detectionParams.numClassesConfigured = 2;
+  parses[1].detectionParams.perClassPreclusterThreshold = {0.4f, 0.6f};
+  parses[1].layers.push_back(makeLayer("boxes", HALF, {1, 50, 4}, 2));
+  parses[1].layers.push_back(makeLayer("scores", INT8, {1, 50}, 3));
+  parses[1].layers.push_back(makeLayer("classes", INT32, {50}, 4));
+  parses[1].layers.push_back(makeLayer("unused", FLOAT, {8}, 5, false));
+
+  parses[2].networkInfo = {1280, 736, 1};
+  parses[2].detectionParams.numClassesConfigured = 1;
+  parses[2].layers.push_back(makeLayer("", FLOAT, {3, 7}, 6));
+  NvDsInferParseObjectInfo obj = {0, -1.0f, -2.0f, 1280.0f, 736.0f, 1.0f};
+  parses[2].objects.push_back(obj);
+
+  return parses;
+}
+
+static std::vector<NvDsInferLayerInfo>
+layersInfo(SyntheticParse& parse)
+{
+  std::vector<NvDsInferLayerInfo> infos;
+  for (uint l = 0; l < parse.layers.size(); ++l) {
+    SyntheticLayer& layer = parse.layers[l];
+    NvDsInferLayerInfo info = {};
+    info.dataType = layer.dataType;
+    info.inferDims.numDims = layer.dims.size();
+    info.inferDims.numElements = 1;
+    for (uint i = 0; i < layer.dims.size(); ++i) {
+      info.inferDims.d[i] = layer.dims[i];
+      info.inferDims.numElements *= layer.dims[i];
+    }
+    info.bindingIndex = l + 1;
+    info.layerName = layer.name.c_str();
+    info.buffer = layer.hasBuffer ? layer.data.data() : nullptr;
+    info.isInput = 0;
+    infos.push_back(info);
+  }
+  return infos;
+}
+
+static bool
+sameRecord(const ParseRecord& record, const SyntheticParse& parse)
+{
+  const NvDsInferParseDetectionParams& params = parse.detectionParams;
+  if (record.netW != parse.networkInfo.width || record.netH != parse.networkInfo.height ||
+      record.netC != parse.networkInfo.channels || record.numClassesConfigured != params.numClassesConfigured ||
+      record.preclusterThreshold != params.perClassPreclusterThreshold || record.layers.size() != parse.layers.size() ||
+      record.objects.size() != parse.objects.size()) {
+    return false;
+  }
+
+  for (uint l = 0; l < parse.layers.size(); ++l) {
+    const ParseRecordLayer& recorded = record.layers[l];
+    const SyntheticLayer& layer = parse.layers[l];
+    std::vector<uint32_t> dims(layer.dims.begin(), layer.dims.end());
+    if (recorded.name != layer.name || recorded.dataType != layer.dataType || recorded.isInput != 0 ||
+        recorded.bindingIndex != l + 1 || recorded.dims != dims) {
+      return false;
+    }
+    if (recorded.data != (layer.hasBuffer ? layer.data : std::vector<char>())) {
+      return false;
+    }
+  }
+
+  for (uint i = 0; i < parse.objects.size(); ++i) {
+    const NvDsInferParseObjectInfo& obj = parse.objects[i];
+    ParseRecordObject expected = {obj.left, obj.top, obj.width, obj.height, obj.detectionConfidence,
+        static_cast<int32_t>(obj.classId)};
+    if (std::memcmp(&record.objects[i], &expected, sizeof(expected)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Reads the records of a file content, the number read before the first failure
+static uint
+readRecords(const std::string& content, const std::vector<SyntheticParse>& parses, bool& header)
+{
+  std::istringstream stream(content);
+  header = readParseRecordHeader(stream);
+  uint numRead = 0;
+  ParseRecord record;
+  while (header && readParseRecord(stream, record)) {
+    CHECK(numRead < parses.size() && sameRecord(record, parses[numRead]));
+    ++numRead;
+  }
+  return numRead;
+}
+
+static std::string
+readFile(const std::string& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  std::ostringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+int
+main()
+{
+  std::string path = "/tmp/parse_record_check_" + std::to_string(getpid()) + ".rec";
+  setenv("YOLO_PARSER_RECORD", path.c_str(), 1);
+  setenv("YOLO_PARSER_RECORD_SLOTS", "8", 1);
+
+  ParseRecorder* recorder = ParseRecorder::get();
+  CHECK(recorder != nullptr);
+  if (!recorder) {
+    std::cout << "FAILED (" << failures << " failures)" << std::endl;
+    return 1;
+  }
+
+  std::vector<SyntheticParse> parses = makeParses();
+  for (SyntheticParse& parse : parses) {
+    recorder->record(layersInfo(parse), parse.networkInfo, parse.detectionParams, parse.objects);
+  }
+
+  // The writer thread flushes the file once the ring is empty
+  std::string content;
+  bool header = false;
+  uint numRead = 0;
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (numRead < parses.size() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    content = readFile(path);
+    numRead = readRecords(content, parses, header);
+  }
+  std::remove(path.c_str());
+
+  CHECK(header && numRead == parses.size());
+  CHECK(recorder->numRecorded() == parses.size() && recorder->numDropped() == 0);
+
+  // Header, then each record prefixed by its size: nothing else in the file
+  size_t offset = 12;
+  std::vector<size_t> recordEnds;
+  while (offset + sizeof(uint32_t) <= content.size()) {
+    uint32_t size;
+    std::memcpy(&size, content.data() + offset, sizeof(size));
+    offset += sizeof(size) + size;
+    recordEnds.push_back(offset);
+  }
+  CHECK(recordEnds.size() == parses.size() && offset == content.size());
+
+  // Truncated tail: the complete records are still read, cut in the size prefix or the body of the last one
+  if (recordEnds.size() == parses.size()) {
+    size_t lastStart = recordEnds[recordEnds.size() - 2];
+    const size_t cuts[] = {lastStart, lastStart + 2, lastStart + 4, lastStart + 40, content.size() - 1};
+    for (size_t cut : cuts) {
+      uint numTruncated = readRecords(content.substr(0, cut), parses, header);
+      CHECK(header && numTruncated == parses.size() - 1);
+    }
+  }
+
+  std::string badMagic = content;
+  badMagic[0] = 'X';
+  std::string badVersion = content;
+  badVersion[8] = 2;
+  CHECK(readRecords(badMagic, parses, header) == 0 && !header);
+  CHECK(readRecords(badVersion, parses, header) == 0 && !header);
+  CHECK(readRecords(content.substr(0, 10), parses, header) == 0 && !header);
+
+  std::cout << (failures ? "FAILED" : "OK") << " (" << failures << " failures)" << std::endl;
+  return failures ? 1 : 0;
+}
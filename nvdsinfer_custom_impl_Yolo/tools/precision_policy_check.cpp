@@ -0,0 +1,151 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+// Checks of the per-layer precision policy without TensorRT: glob matching, the policy file parser (fixtures/) and
+// bad lines, the resolved precision of each layer with its report, and when the layers without a rule are pinned to
+// the network-mode precision. Exits non-zero on failure.
+
+#include "precision_policy.h"
+
+#include <sstream>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::cerr << "FAILED " << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+      ++failures; \
+    } \
+  } while (0)
+
+static void
+checkGlob()
+{
+  CHECK(globMatch("conv_12", "conv_12"));
+  CHECK(!globMatch("conv_12", "conv_123"));
+  CHECK(!globMatch("conv_123", "conv_12"));
+  CHECK(globMatch("conv_1*", "conv_1"));
+  CHECK(globMatch("conv_1*", "conv_105"));
+  CHECK(!globMatch("conv_1*", "conv_21"));
+  CHECK(globMatch("conv_?", "conv_7"));
+  CHECK(!globMatch("conv_?", "conv_"));
+  CHECK(!globMatch("conv_?", "conv_10"));
+  CHECK(globMatch("*", ""));
+  CHECK(globMatch("*", "batchnorm_3"));
+  CHECK(!globMatch("", "conv_1"));
+  CHECK(globMatch("", ""));
+  CHECK(globMatch("*_3", "batchnorm_3"));
+  CHECK(!globMatch("*_3", "batchnorm_31"));
+  CHECK(globMatch("*norm*", "batchnorm_3"));
+  CHECK(globMatch("c*v*_*1", "conv_101"));  // backtracks over the first candidates
+  CHECK(!globMatch("c*v*_*1", "conv_100"));
+  CHECK(globMatch("**?", "a"));
+  CHECK(!globMatch("**?", ""));
+}
+
+static void
+checkParse(const std::string& fixtures)
+{
+  std::vector<PrecisionRule> rules;
+  CHECK(loadPrecisionPolicy(fixtures + "/precision.txt", rules));
+  CHECK(rules.size() == 5);
+  if (rules.size() == 5) {
+    CHECK(rules[0].pattern == "@yolo_input" && rules[0].precision == "FP16");
+    CHECK(rules[1].pattern == "conv_1*" && rules[1].precision == "FP16");  // trimmed, precision upper-cased
+    CHECK(rules[2].pattern == "conv_?_head" && rules[2].precision == "FP32");
+    CHECK(rules[3].pattern == "route_*" && rules[3].precision == "INT8");
+  }
+
+  const char* bad[] = {
+    "conv_1*\n",
+    "conv_1* = FP8\n",
+    " = FP16\n",
+    "conv_1* =\n",
+    "conv_0 = INT8\nconv_1* FP16\n",
+  };
+  for (const char* text : bad) {
+    std::vector<PrecisionRule> rejected;
+    CHECK(!parsePrecisionPolicy(text, rejected));
+  }
+
+  rules.clear();
+  CHECK(parsePrecisionPolicy("\n# only comments\n\r\n", rules) && rules.empty());
+  CHECK(!loadPrecisionPolicy(fixtures + "/missing.txt", rules));
+}
+
+static PrecisionLayer
+layer(const std::string& name, const std::vector<std::string>& tags = std::vector<std::string>())
+{
+  PrecisionLayer l;
+  l.name = name;
+  l.tags = tags;
+  return l;
+}
+
+static void
+checkResolve(const std::string& fixtures)
+{
+  std::vector<PrecisionRule> rules;
+  CHECK(loadPrecisionPolicy(fixtures + "/precision.txt", rules));
+
+  std::vector<PrecisionLayer> layers = {
+    layer("conv_0"),
+    layer("conv_1"),
+    layer("conv_12", {"@yolo_input"}),
+    layer("conv_3_head"),
+    layer("conv_13_head"),
+    layer("route_4"),
+    layer("upsample_5", {"@other"}),
+  };
+  std::vector<PrecisionAssignment> assignments = resolvePrecisions(layers, rules, "INT8");
+  CHECK(assignments.size() == layers.size());
+  if (assignments.size() != layers.size()) {
+    return;
+  }
+
+  // First matching rule wins, the tag rule before the name globs
+  CHECK(assignments[0].precision == "INT8" && assignments[0].rule == -1);
+  CHECK(assignments[1].precision == "FP16" && assignments[1].rule == 1);
+  CHECK(assignments[2].precision == "FP16" && assignments[2].rule == 0);
+  CHECK(assignments[3].precision == "FP32" && assignments[3].rule == 2);
+  CHECK(assignments[4].precision == "FP16" && assignments[4].rule == 1);
+  CHECK(assignments[5].precision == "INT8" && assignments[5].rule == 3);
+  CHECK(assignments[6].precision == "INT8" && assignments[6].rule == -1);
+
+  std::ostringstream out;
+  printPrecisionReport(layers, rules, assignments, out);
+  std::string text = out.str();
+  CHECK(text.find("Layer precision policy") != std::string::npos);
+  CHECK(text.find("conv_12") != std::string::npos && text.find("@yolo_input") != std::string::npos);
+  CHECK(text.find("WARNING: Precision rule does not match any layer: shortcut_99") != std::string::npos);
+  CHECK(text.find("does not match any layer: conv_1*") == std::string::npos);
+
+  // FP16 rules in an FP32 or INT8 network pin the layers without a rule, an FP16 network or no FP16 rule does not
+  CHECK(pinsUnmatchedLayers(assignments, "INT8"));
+  CHECK(pinsUnmatchedLayers(resolvePrecisions(layers, rules, "FP32"), "FP32"));
+  CHECK(!pinsUnmatchedLayers(resolvePrecisions(layers, rules, "FP16"), "FP16"));
+
+  std::vector<PrecisionRule> noFp16 = {rules[2], rules[3]};
+  CHECK(!pinsUnmatchedLayers(resolvePrecisions(layers, noFp16, "INT8"), "INT8"));
+  CHECK(!pinsUnmatchedLayers(resolvePrecisions(layers, std::vector<PrecisionRule>(), "FP32"), "FP32"));
+
+  // An FP16 default alone is no FP16 rule
+  std::vector<PrecisionAssignment> defaults = resolvePrecisions(layers, noFp16, "FP16");
+  CHECK(defaults[0].precision == "FP16" && !pinsUnmatchedLayers(defaults, "INT8"));
+}
+
+int
+main(int argc, char* argv[])
+{
+  std::string fixtures = argc > 1 ? argv[1] : "fixtures";
+
+  checkGlob();
+  checkParse(fixtures);
+  checkResolve(fixtures);
+
+  std::cout << (failures ? "FAILED" : "OK") << " (" << failures << " failures)" << std::endl;
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,273 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#include "profile_analyzer.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+bool
+parseEngineGraph(const JsonValue& graph, std::vector<ProfileLayer>& layers)
+{
+  const JsonValue* graphLayers = graph.get("Layers");
+  if (!graphLayers || graphLayers->type != JsonValue::kARRAY) {
+    std::cerr << "Missing 'Layers' in engine graph" << std::endl;
+    return false;
+  }
+
+  for (const JsonValue& graphLayer : graphLayers->array) {
+    ProfileLayer layer;
+    if (graphLayer.type == JsonValue::kSTRING) {
+      // Engine built without detailed profiling verbosity, only the layer names are available
+      layer.name = graphLayer.string;
+    }
+    else {
+      layer.name = graphLayer.getString("Name");
+      layer.type = graphLayer.getString("LayerType");
+      layer.precision = layerPrecision(graphLayer);
+    }
+    layer.reformat = layer.type == "Reformat" || layer.name.find("Reformatting CopyNode") != std::string::npos;
+    layer.blocks = layerBlockIndices(layer.name);
+    layers.push_back(layer);
+  }
+
+  return true;
+}
+
+bool
+parseLayerTimes(const JsonValue& profile, std::map<std::string, float>& layerTimes, uint& numRuns)
+{
+  if (profile.type != JsonValue::kARRAY) {
+    std::cerr << "Layer profile must be an array" << std::endl;
+    return false;
+  }
+
+  numRuns = 1;
+  for (const JsonValue& entry : profile.array) {
+    if (entry.get("count")) {
+      numRuns = std::max(1, static_cast<int>(entry.getNumber("count")));
+      continue;
+    }
+    std::string name = entry.getString("name");
+    if (name.empty()) {
+      continue;
+    }
+    if (entry.get("averageMs")) {
+      layerTimes[name] += entry.getNumber("averageMs");
+    }
+    else {
+      layerTimes[name] += entry.getNumber("timeMs") / numRuns;
+    }
+  }
+
+  return true;
+}
+
+bool
+parseCfgBlockTypes(const std::string& cfgFilePath, std::vector<std::string>& blockTypes)
+{
+  std::ifstream file(cfgFilePath);
+  if (!file.good()) {
+    std::cerr << "Could not open " << cfgFilePath << std::endl;
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.size() == 0 || line.front() == ' ' || line.front() == '#') {
+      continue;
+    }
+    size_t begin = line.find('[');
+    size_t end = line.find(']');
+    if (begin == 0 && end != std::string::npos) {
+      blockTypes.push_back(line.substr(1, end - 1));
+    }
+  }
+
+  return !blockTypes.empty();
+}
+
+static bool
+isWordChar(char c)
+{
+  return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+std::vector<int>
+layerBlockIndices(const std::string& layerName)
+{
+  // The layer builders name the layers "<op>_[<name>]<block index>" in lower case, fused layers join them with " + "
+  // and wrap them in "PWN(...)". ONNX-style names ("/model.0/conv/Conv_output_0", "Conv_12") carry no cfg block
+  std::vector<int> blocks;
+  size_t pos = 0;
+
+  while (pos < layerName.size()) {
+    if (!isWordChar(layerName[pos])) {
+      ++pos;
+      continue;
+    }
+    size_t begin = pos;
+    while (pos < layerName.size() && isWordChar(layerName[pos])) {
+      ++pos;
+    }
+    std::string word = layerName.substr(begin, pos - begin);
+    bool inPath = (begin > 0 && (layerName[begin - 1] == '/' || layerName[begin - 1] == '.')) ||
+        (pos < layerName.size() && (layerName[pos] == '/' || layerName[pos] == '.'));
+
+    size_t underscore = word.rfind('_');
+    if (inPath || !islower(static_cast<unsigned char>(word[0])) || underscore == std::string::npos ||
+        underscore + 1 == word.size() || word.size() - underscore - 1 > 6 ||
+        word.find_first_not_of("0123456789", underscore + 1) != std::string::npos) {
+      continue;
+    }
+    int block = std::stoi(word.substr(underscore + 1));
+    if (std::find(blocks.begin(), blocks.end(), block) == blocks.end()) {
+      blocks.push_back(block);
+    }
+  }
+
+  return blocks;
+}
+
+std::string
+layerPrecision(const JsonValue& layer)
+{
+  const JsonValue* outputs = layer.get("Outputs");
+  if (!outputs || outputs->type != JsonValue::kARRAY || outputs->array.empty()) {
+    return "-";
+  }
+
+  std::string format = outputs->array.front().getString("Format/Datatype");
+  if (format.find("Int8") != std::string::npos || format.find("INT8") != std::string::npos) {
+    return "INT8";
+  }
+  if (format.find("FP16") != std::string::npos || format.find("Half") != std::string::npos) {
+    return "FP16";
+  }
+  if (format.find("FP32") != std::string::npos || format.find("Float") != std::string::npos) {
+    return "FP32";
+  }
+  if (format.find("Int32") != std::string::npos || format.find("INT32") != std::string::npos) {
+    return "INT32";
+  }
+  return format.empty() ? "-" : format;
+}
+
+ProfileReport
+analyzeProfile(const std::vector<ProfileLayer>& layers, const std::map<std::string, float>& layerTimes,
+    const std::vector<std::string>& blockTypes)
+{
+  ProfileReport report;
+  report.layers = layers;
+
+  for (ProfileLayer& layer : report.layers) {
+    std::map<std::string, float>::const_iterator it = layerTimes.find(layer.name);
+    if (it != layerTimes.end()) {
+      layer.timeMs = it->second;
+    }
+
+    report.totalMs += layer.timeMs;
+    report.precisionMs[layer.precision] += layer.timeMs;
+
+    if (layer.reformat) {
+      report.reformatMs += layer.timeMs;
+    }
+
+    std::vector<int> blocks;
+    for (int block : layer.blocks) {
+      if (blockTypes.empty() || (block >= 0 && block < static_cast<int>(blockTypes.size()))) {
+        blocks.push_back(block);
+      }
+    }
+
+    if (blocks.empty()) {
+      report.unattributedMs += layer.timeMs;
+      continue;
+    }
+
+    // Fused layers split their time evenly between the cfg blocks they cover
+    float share = layer.timeMs / blocks.size();
+    for (int block : blocks) {
+      ProfileBlock& profileBlock = report.blocks[block];
+      profileBlock.type = blockTypes.empty() ? "-" : blockTypes.at(block);
+      profileBlock.timeMs += share;
+      profileBlock.precisionMs[layer.precision] += share;
+      ++profileBlock.numLayers;
+    }
+  }
+
+  return report;
+}
+
+static std::string
+formatPercent(float value, float total)
+{
+  std::ostringstream s;
+  s << std::fixed << std::setprecision(1) << (total > 0 ? value * 100 / total : 0.0) << "%";
+  return s.str();
+}
+
+void
+printProfileReport(const ProfileReport& report, bool hasTimes, std::ostream& out)
+{
+  out << std::fixed << std::setprecision(4);
+
+  out << "\nEngine layers" << std::endl;
+  out << std::setw(7) << std::left << "Index" << std::setw(60) << std::left << "Layer" << std::setw(20) <<
+      std::left << "Type" << std::setw(10) << std::left << "Precision" << std::setw(12) << std::left << "Time (ms)" <<
+      "Blocks" << std::endl;
+  for (uint i = 0; i < report.layers.size(); ++i) {
+    const ProfileLayer& layer = report.layers.at(i);
+    std::string name = layer.name.size() > 58 ? layer.name.substr(0, 55) + "..." : layer.name;
+    std::string blocks;
+    for (int block : layer.blocks) {
+      blocks += (blocks.empty() ? "" : ",") + std::to_string(block);
+    }
+    out << std::setw(7) << std::left << i << std::setw(60) << std::left << name << std::setw(20) << std::left <<
+        (layer.reformat ? "Reformat" : layer.type) << std::setw(10) << std::left << layer.precision << std::setw(12) <<
+        std::left << layer.timeMs << (blocks.empty() ? "-" : blocks) << std::endl;
+  }
+
+  std::vector<std::pair<int, ProfileBlock>> blocks(report.blocks.begin(), report.blocks.end());
+  if (hasTimes) {
+    std::stable_sort(blocks.begin(), blocks.end(), [] (const std::pair<int, ProfileBlock>& a,
+        const std::pair<int, ProfileBlock>& b) { return a.second.timeMs > b.second.timeMs; });
+  }
+
+  out << "\nTime per cfg block" << std::endl;
+  out << std::setw(7) << std::left << "Block" << std::setw(20) << std::left << "Type" << std::setw(12) << std::left <<
+      "Time (ms)" << std::setw(10) << std::left << "Share" << std::setw(8) << std::left << "Layers" << "Precision" <<
+      std::endl;
+  for (const auto& block : blocks) {
+    std::string precision;
+    for (const auto& p : block.second.precisionMs) {
+      precision += (precision.empty() ? "" : ",") + p.first;
+    }
+    out << std::setw(7) << std::left << block.first << std::setw(20) << std::left << block.second.type <<
+        std::setw(12) << std::left << block.second.timeMs << std::setw(10) << std::left <<
+        formatPercent(block.second.timeMs, report.totalMs) << std::setw(8) << std::left << block.second.numLayers <<
+        precision << std::endl;
+  }
+
+  out << "\nTime per precision" << std::endl;
+  for (const auto& p : report.precisionMs) {
+    out << std::setw(10) << std::left << p.first << std::setw(12) << std::left << p.second <<
+        formatPercent(p.second, report.totalMs) << std::endl;
+  }
+
+  uint numReformats = std::count_if(report.layers.begin(), report.layers.end(),
+      [] (const ProfileLayer& layer) { return layer.reformat; });
+
+  out << "\nTotal time (ms): " << report.totalMs << std::endl;
+  out << "Reformat layers: " << numReformats << " (" << report.reformatMs << " ms, " <<
+      formatPercent(report.reformatMs, report.totalMs) << ")" << std::endl;
+  out << "Not attributed to cfg blocks (ms): " << report.unattributedMs << std::endl;
+
+  if (!hasTimes) {
+    out << "\nNOTE: No layer profile set, only the layer structure is reported" << std::endl;
+  }
+}
@@ -0,0 +1,64 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#ifndef __PROFILE_ANALYZER_H__
+#define __PROFILE_ANALYZER_H__
+
+#include <map>
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "json_reader.h"
+
+struct ProfileLayer
+{
+  std::string name;
+  std::string type;
+  std::string precision;
+  bool reformat {false};
+  float timeMs {0.0};
+  std::vector<int> blocks;
+};
+
+struct ProfileBlock
+{
+  std::string type;
+  float timeMs {0.0};
+  uint numLayers {0};
+  std::map<std::string, float> precisionMs;
+};
+
+struct ProfileReport
+{
+  std::vector<ProfileLayer> layers;
+  std::map<int, ProfileBlock> blocks;
+  std::map<std::string, float> precisionMs;
+  float totalMs {0.0};
+  float reformatMs {0.0};
+  float unattributedMs {0.0};
+  uint numRuns {0};
+};
+
+// Layers of the engine inspector JSON (graph.json saved with GRAPH=1)
+bool parseEngineGraph(const JsonValue& graph, std::vector<ProfileLayer>& layers);
+
+// Per-layer times from profile.json (LayerProfiler or trtexec --exportProfile), averaged per run
+bool parseLayerTimes(const JsonValue& profile, std::map<std::string, float>& layerTimes, uint& numRuns);
+
+// Block types of the Darknet cfg, indexed the same way as Yolo::m_ConfigBlocks
+bool parseCfgBlockTypes(const std::string& cfgFilePath, std::vector<std::string>& blockTypes);
+
+// cfg block indices referenced by a (possibly fused) TensorRT layer name, e.g. "conv_12 + batchnorm_12 + PWN(leaky_12)"
+std::vector<int> layerBlockIndices(const std::string& layerName);
+
+std::string layerPrecision(const JsonValue& layer);
+
+ProfileReport analyzeProfile(const std::vector<ProfileLayer>& layers, const std::map<std::string, float>& layerTimes,
+    const std::vector<std::string>& blockTypes);
+
+void printProfileReport(const ProfileReport& report, bool hasTimes, std::ostream& out);
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+// Checks of the layer profile analyzer without TensorRT: the shared JSON reader, the cfg block of layer names (fused
+// Darknet layers, ONNX-style names), the engine inspector, profile and cfg parsers (fixtures/) and the time per block,
+// precision and reformat layer of the report. Exits non-zero on failure.
+
+#include "profile_analyzer.h"
+
+#include <cmath>
+#include <sstream>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::cerr << "FAILED " << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+      ++failures; \
+    } \
+  } while (0)
+
+static bool
+near(float a, float b)
+{
+  return std::fabs(a - b) < 1e-4f;
+}
+
+static void
+checkJson()
+{
+  JsonValue value;
+  CHECK(parseJson(" {\"a\": [1, -2.5e1, true, null], \"b\\\"c\": {\"d\": \"x\\ty\"}} ", value));
+  CHECK(value.type == JsonValue::kOBJECT && value.object.size() == 2);
+  const JsonValue* a = value.get("a");
+  CHECK(a && a->type == JsonValue::kARRAY && a->array.size() == 4);
+  if (a && a->array.size() == 4) {
+    CHECK(a->array[1].number == -25.0 && a->array[2].boolean && a->array[3].type == JsonValue::kNULL);
+  }
+  const JsonValue* b = value.get("b\"c");
+  CHECK(b && b->getString("d") == "x\ty" && b->getNumber("missing", 7.0) == 7.0);
+
+  const char* bad[] = {"", "{", "[1, 2", "{\"a\" 1}", "{\"a\": 1,}", "[1] 2", "{a: 1}", "\"open"};
+  for (const char* text : bad) {
+    JsonValue rejected;
+    CHECK(!parseJson(text, rejected));
+  }
+}
+
+static void
+checkBlockIndices()
+{
+  CHECK((layerBlockIndices("conv_12") == std::vector<int> {12}));
+  CHECK((layerBlockIndices("conv_12 + batchnorm_12 + PWN(leaky_12)") == std::vector<int> {12}));
+  CHECK((layerBlockIndices("route_5 + shortcut_7") == std::vector<int> {5, 7}));
+  CHECK((layerBlockIndices("cast_shape_scale_3") == std::vector<int> {3}));
+  CHECK((layerBlockIndices("shuffle1_4") == std::vector<int> {4}));
+  CHECK((layerBlockIndices("leaky_2:1") == std::vector<int> {2}));
+  CHECK((layerBlockIndices("Reformatting CopyNode for Input Tensor 0 to conv_1") == std::vector<int> {1}));
+
+  // ONNX-style and unnamed layers have no cfg block
+  CHECK(layerBlockIndices("/model.0/conv/Conv_output_0").empty());
+  CHECK(layerBlockIndices("/model.22/Concat_3").empty());
+  CHECK(layerBlockIndices("Conv_12").empty());
+  CHECK(layerBlockIndices("(Unnamed Layer* 3) [Scale]_output").empty());
+  CHECK(layerBlockIndices("conv_").empty() && layerBlockIndices("_12").empty() && layerBlockIndices("yolo").empty());
+  CHECK(layerBlockIndices("conv_12a").empty());
+}
+
+static void
+checkReport(const std::string& fixtures)
+{
+  JsonValue graph;
+  std::vector<ProfileLayer> layers;
+  CHECK(readJsonFile(fixtures + "/engine_graph.json", graph) && parseEngineGraph(graph, layers));
+  CHECK(layers.size() == 6);
+  if (layers.size() != 6) {
+    return;
+  }
+  CHECK(layers[0].precision == "FP32" && layers[0].type == "CaskConvolution" && !layers[0].reformat);
+  CHECK(layers[1].precision == "FP16" && layers[1].reformat && (layers[1].blocks == std::vector<int> {1}));
+  CHECK(layers[2].precision == "INT8");
+  CHECK(layers[3].precision == "FP16" && layers[3].blocks.empty());
+  CHECK(layers[4].precision == "-" && (layers[4].blocks == std::vector<int> {2}));
+
+  JsonValue profile;
+  std::map<std::string, float> layerTimes;
+  uint numRuns = 0;
+  CHECK(readJsonFile(fixtures + "/profile.json", profile) && parseLayerTimes(profile, layerTimes, numRuns));
+  CHECK(numRuns == 10 && layerTimes.size() == 5 && near(layerTimes["conv_1 + PWN(leaky_1)"], 3.0f));
+
+  // Without averageMs (LayerProfiler) the total time is divided by the runs
+  JsonValue totals;
+  std::map<std::string, float> totalTimes;
+  CHECK(parseJson("[{\"count\": 4}, {\"name\": \"conv_0\", \"timeMs\": 2.0}, {\"timeMs\": 1.0}]", totals));
+  CHECK(parseLayerTimes(totals, totalTimes, numRuns) && numRuns == 4 && totalTimes.size() == 1);
+  CHECK(near(totalTimes["conv_0"], 0.5f));
+  CHECK(!parseLayerTimes(graph, totalTimes, numRuns));
+
+  std::vector<std::string> blockTypes;
+  CHECK(parseCfgBlockTypes(fixtures + "/profile.cfg", blockTypes));
+  CHECK((blockTypes == std::vector<std::string> {"net", "convolutional", "convolutional", "route", "yolo"}));
+  std::vector<std::string> missing;
+  CHECK(!parseCfgBlockTypes(fixtures + "/missing.cfg", missing));
+
+  ProfileReport report = analyzeProfile(layers, layerTimes, blockTypes);
+  CHECK(near(report.totalMs, 6.9f) && near(report.reformatMs, 0.5f) && near(report.unattributedMs, 1.4f));
+  CHECK(report.blocks.size() == 3 && report.blocks.count(2) && near(report.blocks[2].timeMs, 0.0f));
+  CHECK(near(report.blocks[0].timeMs, 2.0f) && report.blocks[0].type == "net");
+  CHECK(near(report.blocks[1].timeMs, 3.5f) && report.blocks[1].numLayers == 2);
+  CHECK(near(report.blocks[1].precisionMs["INT8"], 3.0f) && near(report.blocks[1].precisionMs["FP16"], 0.5f));
+  CHECK(near(report.precisionMs["FP32"], 2.4f) && near(report.precisionMs["FP16"], 1.5f));
+
+  // Fused layers split their time, blocks past the cfg are not attributed
+  ProfileLayer fused;
+  fused.name = "conv_3 + shortcut_4 + conv_9";
+  fused.precision = "FP16";
+  fused.blocks = layerBlockIndices(fused.name);
+  std::map<std::string, float> fusedTime = {{fused.name, 3.0f}};
+  report = analyzeProfile(std::vector<ProfileLayer> {fused}, fusedTime, blockTypes);
+  CHECK(report.blocks.size() == 2 && near(report.blocks[3].timeMs, 1.5f) && near(report.blocks[4].timeMs, 1.5f));
+  CHECK(near(report.unattributedMs, 0.0f));
+  report = analyzeProfile(std::vector<ProfileLayer> {fused}, fusedTime, std::vector<std::string>());
+  CHECK(report.blocks.size() == 3 && near(report.blocks[9].timeMs, 1.0f) && report.blocks[9].type == "-");
+
+  std::ostringstream out;
+  printProfileReport(analyzeProfile(layers, layerTimes, blockTypes), true, out);
+  std::string text = out.str();
+  CHECK(text.find("Time per cfg block") != std::string::npos && text.find("convolutional") != std::string::npos);
+  CHECK(text.find("Reformat layers: 1") != std::string::npos);
+  CHECK(text.find("No layer profile set") == std::string::npos);
+}
+
+int
+main(int argc, char* argv[])
+{
+  std::string fixtures = argc > 1 ? argv[1] : "fixtures";
+
+  checkJson();
+  checkBlockIndices();
+  checkReport(fixtures);
+
+  std::cout << (failures ? "FAILED" : "OK") << " (" << failures << " failures)" << std::endl;
+  return failures ? 1 : 0;
+}
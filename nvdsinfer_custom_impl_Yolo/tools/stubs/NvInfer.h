@@ -0,0 +1,33 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+// Minimal stand-in for the TensorRT NvInfer.h, only the types used by utils.h. Used to build the CPU tools without
+// TensorRT installed
+
+#ifndef __NVINFER_STUB_H__
+#define __NVINFER_STUB_H__
+
+#include <cstdint>
+
+namespace nvinfer1 {
+
+struct Dims
+{
+  static const int32_t MAX_DIMS = 8;
+  int32_t nbDims;
+  int64_t d[MAX_DIMS];
+};
+
+class ITensor {
+  public:
+    virtual Dims getDimensions() const noexcept = 0;
+
+  protected:
+    virtual ~ITensor() noexcept { }
+};
+
+} // namespace nvinfer1
+
+#endif
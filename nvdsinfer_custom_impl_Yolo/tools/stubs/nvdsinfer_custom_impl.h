@@ -0,0 +1,78 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+// Minimal stand-in for the DeepStream nvdsinfer_custom_impl.h, only the types used by the bbox parser. Used to build
+// the CPU tools without DeepStream installed
+
+#ifndef __NVDSINFER_CUSTOM_IMPL_STUB_H__
+#define __NVDSINFER_CUSTOM_IMPL_STUB_H__
+
+#include <vector>
+#include <string>
+
+#define NVDSINFER_MAX_DIMS 8
+
+typedef enum
+{
+  FLOAT = 0,
+  HALF = 1,
+  INT8 = 2,
+  INT32 = 3
+} NvDsInferDataType;
+
+typedef struct
+{
+  unsigned int numDims;
+  unsigned int d[NVDSINFER_MAX_DIMS];
+  unsigned int numElements;
+} NvDsInferDims;
+
+typedef struct
+{
+  NvDsInferDataType dataType;
+  union {
+    NvDsInferDims inferDims;
+    NvDsInferDims dims;
+  };
+  int bindingIndex;
+  const char* layerName;
+  void* buffer;
+  int isInput;
+} NvDsInferLayerInfo;
+
+typedef struct
+{
+  unsigned int width;
+  unsigned int height;
+  unsigned int channels;
+} NvDsInferNetworkInfo;
+
+typedef struct
+{
+  unsigned int classId;
+  float left;
+  float top;
+  float width;
+  float height;
+  float detectionConfidence;
+} NvDsInferObjectDetectionInfo;
+
+typedef NvDsInferObjectDetectionInfo NvDsInferParseObjectInfo;
+
+typedef struct
+{
+  unsigned int numClassesConfigured;
+  std::vector<float> perClassPreclusterThreshold;
+  std::vector<float> perClassPostclusterThreshold;
+} NvDsInferParseDetectionParams;
+
+typedef bool (*NvDsInferParseCustomFunc)(std::vector<NvDsInferLayerInfo> const& outputLayersInfo,
+    NvDsInferNetworkInfo const& networkInfo, NvDsInferParseDetectionParams const& detectionParams,
+    std::vector<NvDsInferObjectDetectionInfo>& objectList);
+
+#define CHECK_CUSTOM_PARSE_FUNC_PROTOTYPE(customParseFunc) \
+    static NvDsInferParseCustomFunc checkFunc_ ## customParseFunc __attribute__((unused)) = customParseFunc
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "nvdsinfer_custom_impl.h"
+
+extern "C" bool
+NvDsInferParseYolo(std::vector<NvDsInferLayerInfo> const& outputLayersInfo, NvDsInferNetworkInfo const& networkInfo,
+    NvDsInferParseDetectionParams const& detectionParams, std::vector<NvDsInferParseObjectInfo>& objectList);
+
+static std::atomic<uint64_t> numAllocations(0);
+
+void*
+operator new(size_t size)
+{
+  numAllocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = std::malloc(size);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void
+operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void
+operator delete(void* p, size_t) noexcept
+{
+  std::free(p);
+}
+
+struct ParserPath
+{
+  const char* name;
+  NvDsInferParseCustomFunc func;
+};
+
+static const ParserPath parserPaths[] = {
+  {"cpu", NvDsInferParseYolo},
+};
+
+// Output rows of the models in the config_infer_primary_*.txt files, all exported as [rows, 6] (x1, y1, x2, y2,
+// score, class)
+struct ModelShape
+{
+  const char* name;
+  uint rows;
+  uint netW;
+  uint netH;
+};
+
+static const ModelShape modelShapes[] = {
+  {"YOLOv2 (608)", 1805, 608, 608},
+  {"YOLOv4 Darknet (608)", 22743, 608, 608},
+  {"YOLOv5/v7/YOLOR (640)", 25200, 640, 640},
+  {"YOLOv8/v9/11/YOLOX/PP-YOLOE (640)", 8400, 640, 640},
+  {"YOLOv10/RT-DETR/D-FINE (top-300)", 300, 640, 640},
+};
+
+// Fraction of rows above the pre-cluster-threshold
+static const float scoreDistributions[] = {0.001, 0.01, 0.1, 0.5};
+
+static const uint classCounts[] = {1, 80, 1000};
+
+static const float preclusterThreshold = 0.25;
+
+static std::vector<float>
+generateOutput(const ModelShape& model, float aboveFraction, uint numClasses, std::mt19937& generator)
+{
+  std::uniform_real_distribution<float> uniform(0.0, 1.0);
+  std::vector<float> output(model.rows * 6);
+
+  for (uint b = 0; b < model.rows; ++b) {
+    float w = 8 + uniform(generator) * model.netW / 4;
+    float h = 8 + uniform(generator) * model.netH / 4;
+    float x = uniform(generator) * (model.netW - w);
+    float y = uniform(generator) * (model.netH - h);
+    bool above = uniform(generator) < aboveFraction;
+    output[b * 6 + 0] = x;
+    output[b * 6 + 1] = y;
+    output[b * 6 + 2] = x + w;
+    output[b * 6 + 3] = y + h;
+    output[b * 6 + 4] = above ? preclusterThreshold + uniform(generator) * (1 - preclusterThreshold) :
+        uniform(generator) * preclusterThreshold * 0.99;
+    output[b * 6 + 5] = static_cast<float>(generator() % numClasses);
+  }
+
+  return output;
+}
+
+int
+main(int argc, char* argv[])
+{
+  double minSeconds = argc > 1 ? std::stod(argv[1]) : 0.2;
+
+  std::mt19937 generator(1234);
+
+  std::cout << std::left << std::setw(36) << "Model" << std::setw(8) << "Rows" << std::setw(9) << "Classes" <<
+      std::setw(8) << "Above" << std::setw(6) << "Path" << std::setw(12) << "ns/frame" << std::setw(9) << "ns/row" <<
+      std::setw(12) << "allocs/call" << std::setw(10) << "objects" << "output bytes" << std::endl;
+  std::cout << std::fixed;
+
+  for (const ModelShape& model : modelShapes) {
+    for (uint numClasses : classCounts) {
+      for (float aboveFraction : scoreDistributions) {
+        std::vector<float> output = generateOutput(model, aboveFraction, numClasses, generator);
+
+        NvDsInferLayerInfo layer = {};
+        layer.dataType = FLOAT;
+        layer.inferDims.numDims = 2;
+        layer.inferDims.d[0] = model.rows;
+        layer.inferDims.d[1] = 6;
+        layer.inferDims.numElements = model.rows * 6;
+        layer.layerName = "output";
+        layer.buffer = output.data();
+
+        std::vector<NvDsInferLayerInfo> outputLayersInfo(1, layer);
+        NvDsInferNetworkInfo networkInfo = {model.netW, model.netH, 3};
+        NvDsInferParseDetectionParams detectionParams;
+        detectionParams.numClassesConfigured = numClasses;
+        detectionParams.perClassPreclusterThreshold.assign(numClasses, preclusterThreshold);
+
+        for (const ParserPath& path : parserPaths) {
+          std::vector<NvDsInferParseObjectInfo> objectList;
+          path.func(outputLayersInfo, networkInfo, detectionParams, objectList);
+
+          uint64_t calls = 0;
+          uint64_t allocationsStart = numAllocations.load();
+          std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+          double elapsed = 0;
+          while (elapsed < minSeconds) {
+            for (uint i = 0; i < 16; ++i) {
+              path.func(outputLayersInfo, networkInfo, detectionParams, objectList);
+            }
+            calls += 16;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+          }
+          uint64_t allocations = numAllocations.load() - allocationsStart;
+
+          double nsPerFrame = elapsed * 1e9 / calls;
+          std::cout << std::setw(36) << model.name << std::setw(8) << model.rows << std::setw(9) << numClasses <<
+              std::setw(8) << std::setprecision(3) << aboveFraction << std::setw(6) << path.name << std::setw(12) <<
+              std::setprecision(0) << nsPerFrame << std::setw(9) << std::setprecision(2) << nsPerFrame / model.rows <<
+              std::setw(12) << std::setprecision(1) << static_cast<double>(allocations) / calls << std::setw(10) <<
+              objectList.size() << objectList.size() * sizeof(NvDsInferParseObjectInfo) << std::endl;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
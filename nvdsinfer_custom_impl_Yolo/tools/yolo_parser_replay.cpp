@@ -0,0 +1,179 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#include <cmath>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "nvdsinfer_custom_impl.h"
+
+#include "parse_record.h"
+
+extern "C" bool
+NvDsInferParseYolo(std::vector<NvDsInferLayerInfo> const& outputLayersInfo, NvDsInferNetworkInfo const& networkInfo,
+    NvDsInferParseDetectionParams const& detectionParams, std::vector<NvDsInferParseObjectInfo>& objectList);
+
+struct ParserMode
+{
+  const char* name;
+  NvDsInferParseCustomFunc func;
+};
+
+static const ParserMode parserModes[] = {
+  {"cpu", NvDsInferParseYolo},
+};
+
+struct ReplayFrame
+{
+  ParseRecord record;
+  std::vector<NvDsInferLayerInfo> layersInfo;
+  NvDsInferNetworkInfo networkInfo;
+  NvDsInferParseDetectionParams detectionParams;
+};
+
+static void
+prepareFrame(ReplayFrame& frame)
+{
+  const ParseRecord& record = frame.record;
+
+  frame.networkInfo.width = record.netW;
+  frame.networkInfo.height = record.netH;
+  frame.networkInfo.channels = record.netC;
+
+  frame.detectionParams.numClassesConfigured = record.numClassesConfigured;
+  frame.detectionParams.perClassPreclusterThreshold = record.preclusterThreshold;
+
+  for (const ParseRecordLayer& layer : record.layers) {
+    NvDsInferLayerInfo info = {};
+    info.dataType = static_cast<NvDsInferDataType>(layer.dataType);
+    info.inferDims.numDims = layer.dims.size();
+    info.inferDims.numElements = 1;
+    for (uint i = 0; i < layer.dims.size() && i < NVDSINFER_MAX_DIMS; ++i) {
+      info.inferDims.d[i] = layer.dims.at(i);
+      info.inferDims.numElements *= layer.dims.at(i);
+    }
+    info.bindingIndex = layer.bindingIndex;
+    info.layerName = layer.name.c_str();
+    info.buffer = const_cast<char*>(layer.data.data());
+    info.isInput = layer.isInput;
+    frame.layersInfo.push_back(info);
+  }
+}
+
+struct OutputDiff
+{
+  uint framesCountMismatch {0};
+  uint64_t objectsCompared {0};
+  uint64_t classMismatch {0};
+  float maxBoxDelta {0.0};
+  float maxConfidenceDelta {0.0};
+};
+
+static void
+diffObjects(const std::vector<ParseRecordObject>& expected, const std::vector<NvDsInferParseObjectInfo>& actual,
+    OutputDiff& diff)
+{
+  if (expected.size() != actual.size()) {
+    ++diff.framesCountMismatch;
+  }
+
+  size_t n = std::min(expected.size(), actual.size());
+  for (size_t i = 0; i < n; ++i) {
+    const ParseRecordObject& e = expected.at(i);
+    const NvDsInferParseObjectInfo& a = actual.at(i);
+    diff.maxBoxDelta = std::max(diff.maxBoxDelta, std::fabs(e.left - a.left));
+    diff.maxBoxDelta = std::max(diff.maxBoxDelta, std::fabs(e.top - a.top));
+    diff.maxBoxDelta = std::max(diff.maxBoxDelta, std::fabs(e.width - a.width));
+    diff.maxBoxDelta = std::max(diff.maxBoxDelta, std::fabs(e.height - a.height));
+    diff.maxConfidenceDelta = std::max(diff.maxConfidenceDelta, std::fabs(e.confidence - a.detectionConfidence));
+    if (static_cast<uint>(e.classId) != a.classId) {
+      ++diff.classMismatch;
+    }
+  }
+  diff.objectsCompared += n;
+}
+
+int
+main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " record.bin [iterations] [mode]" << std::endl;
+    std::cerr << "Modes:";
+    for (const ParserMode& mode : parserModes) {
+      std::cerr << " " << mode.name;
+    }
+    std::cerr << " (default all)" << std::endl;
+    return 1;
+  }
+
+  uint iterations = argc > 2 ? std::stoul(argv[2]) : 10;
+  std::string modeName = argc > 3 ? argv[3] : "";
+
+  std::ifstream file(argv[1], std::ios::binary);
+  if (!file.good() || !readParseRecordHeader(file)) {
+    std::cerr << "Could not read " << argv[1] << std::endl;
+    return 1;
+  }
+
+  std::vector<ReplayFrame> frames;
+  uint64_t numRows = 0;
+  for (;;) {
+    ReplayFrame frame;
+    if (!readParseRecord(file, frame.record)) {
+      break;
+    }
+    prepareFrame(frame);
+    if (!frame.layersInfo.empty()) {
+      numRows += frame.layersInfo.front().inferDims.d[0];
+    }
+    frames.push_back(std::move(frame));
+  }
+
+  if (frames.empty()) {
+    std::cerr << "No records in " << argv[1] << std::endl;
+    return 1;
+  }
+
+  std::cout << "Records: " << frames.size() << ", rows: " << numRows << ", iterations: " << iterations << std::endl;
+  std::cout << std::fixed << std::setprecision(2);
+
+  for (const ParserMode& mode : parserModes) {
+    if (!modeName.empty() && modeName != mode.name) {
+      continue;
+    }
+
+    std::vector<NvDsInferParseObjectInfo> objectList;
+    OutputDiff diff;
+    uint64_t numObjects = 0;
+
+    for (ReplayFrame& frame : frames) {
+      mode.func(frame.layersInfo, frame.networkInfo, frame.detectionParams, objectList);
+      diffObjects(frame.record.objects, objectList, diff);
+      numObjects += objectList.size();
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint i = 0; i < iterations; ++i) {
+      for (ReplayFrame& frame : frames) {
+        mode.func(frame.layersInfo, frame.networkInfo, frame.detectionParams, objectList);
+      }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    double numFrames = static_cast<double>(frames.size()) * iterations;
+
+    std::cout << "\nMode: " << mode.name << std::endl;
+    std::cout << "  ns/frame: " << ns / numFrames << std::endl;
+    std::cout << "  ns/row: " << ns / (static_cast<double>(numRows) * iterations) << std::endl;
+    std::cout << "  frames/s: " << numFrames * 1e9 / ns << std::endl;
+    std::cout << "  objects/frame: " << static_cast<double>(numObjects) / frames.size() << std::endl;
+    std::cout << "  diff vs recorded: " << diff.framesCountMismatch << " frames with count mismatch, " <<
+        diff.classMismatch << " class mismatches in " << diff.objectsCompared << " objects, max box delta " <<
+        diff.maxBoxDelta << ", max confidence delta " << diff.maxConfidenceDelta << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,46 @@
+/*
+ * Created by Marcos Luciano
+ * https://www.github.com/marcoslucianops
+ */
+
+#include "profile_analyzer.h"
+
+int
+main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " graph.json [profile.json] [model.cfg]" << std::endl;
+    return 1;
+  }
+
+  JsonValue graph;
+  std::vector<ProfileLayer> layers;
+  if (!readJsonFile(argv[1], graph) || !parseEngineGraph(graph, layers)) {
+    return 1;
+  }
+
+  std::map<std::string, float> layerTimes;
+  std::vector<std::string> blockTypes;
+
+  for (int i = 2; i < argc; ++i) {
+    std::string path = argv[i];
+    if (path.size() > 4 && path.substr(path.size() - 4) == ".cfg") {
+      if (!parseCfgBlockTypes(path, blockTypes)) {
+        return 1;
+      }
+    }
+    else {
+      JsonValue profile;
+      uint numRuns;
+      if (!readJsonFile(path, profile) || !parseLayerTimes(profile, layerTimes, numRuns)) {
+        return 1;
+      }
+      std::cout << "Layer profile: " << path << " (" << numRuns << " runs)" << std::endl;
+    }
+  }
+
+  ProfileReport report = analyzeProfile(layers, layerTimes, blockTypes);
+  printProfileReport(report, !layerTimes.empty(), std::cout);
+
+  return 0;
+}
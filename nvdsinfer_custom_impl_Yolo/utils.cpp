@@ -25,6 +25,7 @@
 
 #include "utils.h"
 
+#include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <experimental/filesystem>
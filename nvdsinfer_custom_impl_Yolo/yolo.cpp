@@ -23,10 +23,13 @@
  * https://www.github.com/marcoslucianops
  */
 
+#include <algorithm>
+
 #include "NvOnnxParser.h"
 
 #include "yolo.h"
 #include "yoloPlugins.h"
+#include "layer_profiler.h"
 
 #ifdef OPENCV
 #include "calibrator.h"
@@ -158,7 +161,13 @@ Yolo::createEngine(nvinfer1::IBuilder* builder)
   else if (m_NetworkMode == "INT8") {
     assert(builder->platformHasFastInt8());
     config->setFlag(nvinfer1::BuilderFlag::kINT8);
-    if (m_Int8CalibPath != "") {
+    if (getenv("INT8_DYNAMIC_RANGE_PATH")) {
+      if (!setDynamicRanges(*network, getenv("INT8_DYNAMIC_RANGE_PATH"))) {
+        std::cerr << "Failed to set INT8 dynamic ranges" << std::endl;
+        assert(0);
+      }
+    }
+    else if (m_Int8CalibPath != "") {
 
 #ifdef OPENCV
       fileExists(m_Int8CalibPath);
@@ -183,12 +192,25 @@ Yolo::createEngine(nvinfer1::IBuilder* builder)
           m_InputW, m_ScaleFactor, m_Offsets, m_InputFormat, calib_image_list, m_Int8CalibPath);
       config->setInt8Calibrator(calibrator);
 #else
-      assert(0 && "OpenCV is required to run INT8 calibrator\n");
+      if (!fileExists(m_Int8CalibPath, false)) {
+        assert(0 && "OpenCV is required to run INT8 calibrator\n");
+      }
+      else if (!setDynamicRanges(*network, m_Int8CalibPath)) {
+        std::cerr << "Failed to set INT8 dynamic ranges from " << m_Int8CalibPath << std::endl;
+        assert(0);
+      }
 #endif
 
     }
   }
 
+  if (getenv("PRECISION_POLICY_PATH")) {
+    if (!setPrecisionPolicy(*network, config, getenv("PRECISION_POLICY_PATH"))) {
+      std::cerr << "Failed to set layer precision policy" << std::endl;
+      assert(0);
+    }
+  }
+
 #ifdef GRAPH
   config->setProfilingVerbosity(nvinfer1::ProfilingVerbosity::kDETAILED);
 #endif
@@ -227,6 +249,16 @@ Yolo::createEngine(nvinfer1::IBuilder* builder)
   graph.close();
   std::cout << "Network graph saved to graph.json\n" << std::endl;
 
+  uint profileIterations = getenv("PROFILE_ITERATIONS") ? std::stoul(getenv("PROFILE_ITERATIONS")) : 10;
+  if (profileIterations > 0) {
+    if (profileEngine(engine, context, m_BatchSize, profileIterations, "profile.json")) {
+      std::cout << "Layer profile saved to profile.json\n" << std::endl;
+    }
+    else {
+      std::cerr << "Could not save layer profile\n" << std::endl;
+    }
+  }
+
 #if NV_TENSORRT_MAJOR >= 8
   delete inpector;
   delete context;
@@ -629,6 +661,159 @@ Yolo::parseConfigBlocks()
   }
 }
 
+bool
+Yolo::setDynamicRanges(nvinfer1::INetworkDefinition& network, const std::string& rangeFilePath)
+{
+  DynamicRangeMap ranges;
+  if (!loadDynamicRanges(rangeFilePath, ranges)) {
+    return false;
+  }
+
+  std::cout << "Loaded " << ranges.size() << " dynamic ranges from " << rangeFilePath << std::endl;
+
+  std::vector<DynamicRangeTarget> targets;
+  std::vector<nvinfer1::ITensor*> tensors;
+
+  for (INT i = 0; i < network.getNbInputs(); ++i) {
+    nvinfer1::ITensor* input = network.getInput(i);
+    DynamicRangeTarget target;
+    target.tensorName = input->getName();
+    targets.push_back(target);
+    tensors.push_back(input);
+  }
+
+  for (INT i = 0; i < network.getNbLayers(); ++i) {
+    nvinfer1::ILayer* layer = network.getLayer(i);
+    for (INT j = 0; j < layer->getNbOutputs(); ++j) {
+      nvinfer1::ITensor* output = layer->getOutput(j);
+      DynamicRangeTarget target;
+      target.layerName = j == 0 ? layer->getName() : std::string(layer->getName()) + ":" + std::to_string(j);
+      target.tensorName = output->getName();
+      targets.push_back(target);
+      tensors.push_back(output);
+    }
+  }
+
+  DynamicRangeReport report = matchDynamicRanges(targets, ranges);
+  printDynamicRangeReport(targets, report, std::cout);
+
+  for (uint i = 0; i < tensors.size(); ++i) {
+    const DynamicRangeMatch& match = report.matches.at(i);
+    if (match.found && !tensors.at(i)->setDynamicRange(match.range.min, match.range.max)) {
+      std::cerr << "Could not set dynamic range for " << match.key << std::endl;
+      return false;
+    }
+  }
+
+  return report.numMatched > 0;
+}
+
+bool
+Yolo::setPrecisionPolicy(nvinfer1::INetworkDefinition& network, nvinfer1::IBuilderConfig* config,
+    const std::string& policyFilePath)
+{
+  std::vector<PrecisionRule> rules;
+  if (!loadPrecisionPolicy(policyFilePath, rules)) {
+    return false;
+  }
+
+  std::vector<nvinfer1::ITensor*> yoloInputs;
+  for (INT i = 0; i < network.getNbLayers(); ++i) {
+    nvinfer1::ILayer* layer = network.getLayer(i);
+    if (layer->getType() == nvinfer1::LayerType::kPLUGIN_V2 && m_WtsFilePath == layer->getName()) {
+      for (INT j = 0; j < layer->getNbInputs(); ++j) {
+        yoloInputs.push_back(layer->getInput(j));
+      }
+    }
+  }
+
+  std::vector<PrecisionLayer> layers;
+  std::vector<nvinfer1::ILayer*> trtLayers;
+
+  for (INT i = 0; i < network.getNbLayers(); ++i) {
+    nvinfer1::ILayer* layer = network.getLayer(i);
+    if (layer->getType() == nvinfer1::LayerType::kPLUGIN_V2 ||
+        layer->getOutput(0)->getType() != nvinfer1::DataType::kFLOAT) {
+      continue;
+    }
+    PrecisionLayer precisionLayer;
+    precisionLayer.name = layer->getName();
+    for (INT j = 0; j < layer->getNbOutputs(); ++j) {
+      if (std::find(yoloInputs.begin(), yoloInputs.end(), layer->getOutput(j)) != yoloInputs.end()) {
+        precisionLayer.tags.push_back("@yolo_input");
+      }
+    }
+    layers.push_back(precisionLayer);
+    trtLayers.push_back(layer);
+  }
+
+  std::vector<PrecisionAssignment> assignments = resolvePrecisions(layers, rules, m_NetworkMode);
+  printPrecisionReport(layers, rules, assignments, std::cout);
+
+  // With FP16 rules the global kFP16 flag is set. Layers no rule matches are then pinned to the network-mode
+  // precision, unless that is FP16 too, so TensorRT can't move them to FP16
+  bool hasInt8 = false;
+  bool hasFp16 = false;
+  for (const PrecisionAssignment& assignment : assignments) {
+    hasInt8 |= assignment.rule >= 0 && assignment.precision == "INT8";
+    hasFp16 |= assignment.rule >= 0 && assignment.precision == "FP16";
+  }
+
+  // Without the INT8 builder flag (network-mode=1) INT8 layers can't be built
+  if (hasInt8 && m_NetworkMode != "INT8") {
+    std::cerr << "INT8 layers in the precision policy need network-mode=1 on the config_infer file" << std::endl;
+    return false;
+  }
+
+  bool pinUnmatched = pinsUnmatchedLayers(assignments, m_NetworkMode);
+  if (hasFp16) {
+    config->setFlag(nvinfer1::BuilderFlag::kFP16);
+  }
+
+  for (uint i = 0; i < trtLayers.size(); ++i) {
+    const PrecisionAssignment& assignment = assignments.at(i);
+    if (assignment.rule < 0 && !pinUnmatched) {
+      continue;
+    }
+
+    nvinfer1::DataType dataType = nvinfer1::DataType::kFLOAT;
+    if (assignment.precision == "FP16") {
+      dataType = nvinfer1::DataType::kHALF;
+    }
+    else if (assignment.precision == "INT8") {
+      dataType = nvinfer1::DataType::kINT8;
+    }
+
+    trtLayers.at(i)->setPrecision(dataType);
+    for (INT j = 0; j < trtLayers.at(i)->getNbOutputs(); ++j) {
+      // Network outputs and YoloLayer inputs of unmatched INT8 layers keep the type TensorRT picks for them
+      nvinfer1::ITensor* output = trtLayers.at(i)->getOutput(j);
+      if (assignment.rule < 0 && dataType == nvinfer1::DataType::kINT8 && (output->isNetworkOutput() ||
+          std::find(yoloInputs.begin(), yoloInputs.end(), output) != yoloInputs.end())) {
+        continue;
+      }
+      trtLayers.at(i)->setOutputType(j, dataType);
+    }
+  }
+
+  // The pinned layers include activations, resizes, concats and slices that may have no kernel in the network-mode
+  // precision: with them the constraints are only preferred, so TensorRT falls back for those instead of failing
+#if NV_TENSORRT_MAJOR > 8 || (NV_TENSORRT_MAJOR == 8 && NV_TENSORRT_MINOR >= 2)
+  if (pinUnmatched) {
+    config->setFlag(nvinfer1::BuilderFlag::kPREFER_PRECISION_CONSTRAINTS);
+  }
+  else {
+    config->setFlag(nvinfer1::BuilderFlag::kOBEY_PRECISION_CONSTRAINTS);
+  }
+#else
+  if (!pinUnmatched) {
+    config->setFlag(nvinfer1::BuilderFlag::kSTRICT_TYPES);
+  }
+#endif
+
+  return true;
+}
+
 void
 Yolo::destroyNetworkUtils()
 {
@@ -41,6 +41,9 @@
 #include "layers/pooling_layer.h"
 #include "layers/reorg_layer.h"
 
+#include "dynamic_range.h"
+#include "precision_policy.h"
+
 #if NV_TENSORRT_MAJOR >= 8
 #define INT int32_t
 #else
@@ -147,6 +150,11 @@ class Yolo : public IModelParser {
 
     void parseConfigBlocks();
 
+    bool setDynamicRanges(nvinfer1::INetworkDefinition& network, const std::string& rangeFilePath);
+
+    bool setPrecisionPolicy(nvinfer1::INetworkDefinition& network, nvinfer1::IBuilderConfig* config,
+        const std::string& policyFilePath);
+
     void destroyNetworkUtils();
 };
 